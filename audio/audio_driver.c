@@ -255,11 +255,15 @@ static void report_audio_buffer_statistics(void)
    RARCH_LOG("[Audio]: Average audio buffer saturation: %.2f %%,"
          " standard deviation (percentage points): %.2f %%.\n"
          "[Audio]: Amount of time spent close to underrun: %.2f %%."
-         " Close to blocking: %.2f %%.\n",
+         " Close to blocking: %.2f %%.\n"
+         "[Audio]: Underruns: %u, rate adjustment range: %.5f - %.5f.\n",
          audio_stats.average_buffer_saturation,
          audio_stats.std_deviation_percentage,
          audio_stats.close_to_underrun,
-         audio_stats.close_to_blocking);
+         audio_stats.close_to_blocking,
+         audio_driver_st.rate_control.underruns,
+         audio_driver_st.rate_control.adjust_min,
+         audio_driver_st.rate_control.adjust_max);
 }
 #endif
 
@@ -393,6 +397,77 @@ bool audio_driver_find_driver(
    return true;
 }
 
+/**
+ * Computes the driver free space dynamic rate control should aim
+ * for, from the configured target latency (in milliseconds).
+ * A target of 0 keeps the buffer half full.
+ **/
+static unsigned audio_driver_rate_control_target(
+      audio_driver_state_t *audio_st,
+      unsigned out_rate, unsigned target_latency)
+{
+   size_t fill;
+   size_t buffer_size = audio_st->buffer_size;
+
+   if (!target_latency)
+      return (unsigned)(buffer_size / 2);
+
+   fill = ((size_t)out_rate * 2 * audio_driver_get_sample_size()
+         * target_latency) / 1000;
+   /* Leave some room on both sides for the controller to work with */
+   fill = MAX(buffer_size / 8, MIN(buffer_size * 7 / 8, fill));
+
+   return (unsigned)(buffer_size - fill);
+}
+
+static void audio_driver_rate_control_reset(
+      audio_driver_state_t *audio_st,
+      unsigned out_rate, unsigned target_latency)
+{
+   audio_rate_control_t *rc = &audio_st->rate_control;
+
+   memset(rc, 0, sizeof(*rc));
+   rc->adjust_min   = 1.0;
+   rc->adjust_max   = 1.0;
+   rc->target_avail = audio_driver_rate_control_target(
+         audio_st, out_rate, target_latency);
+}
+
+static void audio_driver_rate_control_update(
+      audio_driver_state_t *audio_st,
+      int avail, double adjust)
+{
+   audio_rate_control_t *rc = &audio_st->rate_control;
+   size_t buffer_size       = audio_st->buffer_size;
+   size_t fill              = (avail < (int)buffer_size)
+         ? buffer_size - avail : 0;
+   unsigned bin             = (unsigned)((fill
+         * AUDIO_RATE_CONTROL_HISTOGRAM_BINS) / (buffer_size + 1));
+
+   rc->fill_histogram[bin]++;
+   rc->last_avail           = (unsigned)avail;
+
+   if (adjust < rc->adjust_min)
+      rc->adjust_min        = adjust;
+   if (adjust > rc->adjust_max)
+      rc->adjust_max        = adjust;
+
+   /* Driver buffer ran dry; log once per underrun */
+   if (fill == 0)
+   {
+      if (!rc->in_underrun)
+      {
+         rc->underrun_time[rc->underruns
+            % AUDIO_RATE_CONTROL_UNDERRUN_LOG] =
+            cpu_features_get_time_usec();
+         rc->underruns++;
+      }
+      rc->in_underrun       = true;
+   }
+   else
+      rc->in_underrun       = false;
+}
+
 /**
  * Writes audio samples to audio driver's output.
  * Will first perform DSP processing (if enabled) and resampling.
@@ -469,18 +544,47 @@ static void audio_driver_flush(
 
       if (audio_st->flags & AUDIO_FLAG_CONTROL)
       {
-         /* Readjust the audio input rate. */
+         /* Readjust the audio input rate with a PI controller
+          * steering the driver buffer towards the target fill. */
+         audio_rate_control_t *rc    = &audio_st->rate_control;
          int avail                   = (int)audio_st->current_audio->write_avail(
                audio_st->context_audio_data);
-         int half_size               = (int)(audio_st->buffer_size / 2);
-         int delta_mid               = avail - half_size;
-         double direction            = (double)delta_mid / half_size;
-         double adjust               = 1.0 + audio_st->rate_control_delta * direction;
+         int target                  = (int)rc->target_avail;
+         int range                   = MAX(target,
+               (int)audio_st->buffer_size - target);
+         double error                = (range > 0)
+               ? (double)(avail - target) / range : 0.0;
+         double integral             = rc->integral
+               + error * AUDIO_RATE_CONTROL_KI;
+         double output               = error + integral;
+         double adjust;
+
+         /* Keep the correction within the configured +/- delta.
+          * While saturated, stop integrating in the direction
+          * that pushes further into the limit (anti-windup). */
+         if (output > 1.0)
+         {
+            output                   = 1.0;
+            if (error > 0.0)
+               integral              = rc->integral;
+         }
+         else if (output < -1.0)
+         {
+            output                   = -1.0;
+            if (error < 0.0)
+               integral              = rc->integral;
+         }
+
+         rc->integral                = MAX(-1.0, MIN(1.0, integral));
+         adjust                      = 1.0
+               + audio_st->rate_control_delta * output;
 
          audio_st->free_samples_buf[write_idx]
                                      = avail;
          audio_st->source_ratio_current
                                      = audio_st->source_ratio_original * adjust;
+
+         audio_driver_rate_control_update(audio_st, avail, adjust);
       }
 
 #if 0
@@ -552,8 +656,14 @@ static void audio_driver_flush(
          mixer_gain                       = audio_st->mixer_volume_gain;
 
       }
-      audio_mixer_mix(audio_st->output_samples_buf,
-            src_data.output_frames, mixer_gain, override);
+      /* Integer output saturates while converting to s16 below,
+       * so only clamp here when the driver takes float directly */
+      if (audio_st->flags & AUDIO_FLAG_USE_FLOAT)
+         audio_mixer_mix(audio_st->output_samples_buf,
+               src_data.output_frames, mixer_gain, override);
+      else
+         audio_mixer_mix_unclamped(audio_st->output_samples_buf,
+               src_data.output_frames, mixer_gain, override);
    }
 #endif
 
@@ -598,6 +708,29 @@ const char *audio_driver_mixer_get_stream_name(unsigned i)
 
 #endif
 
+/**
+ * Picks the sample format handed to the audio driver.
+ * The resampler, DSP and mixer all work in float, so drivers
+ * that accept float get the processed buffer as-is; only the
+ * others need the final (saturating) float to s16 conversion.
+ **/
+static void audio_driver_negotiate_format(audio_driver_state_t *audio_st)
+{
+   audio_st->flags    &= ~AUDIO_FLAG_USE_FLOAT;
+
+   if (     !(audio_st->flags & AUDIO_FLAG_ACTIVE)
+         || !audio_st->context_audio_data)
+      return;
+
+   if (     audio_st->current_audio->use_float
+         && audio_st->current_audio->use_float(
+            audio_st->context_audio_data))
+      audio_st->flags |=  AUDIO_FLAG_USE_FLOAT;
+
+   RARCH_LOG("[Audio]: Output sample format: %s.\n",
+         (audio_st->flags & AUDIO_FLAG_USE_FLOAT) ? "float" : "s16");
+}
+
 bool audio_driver_init_internal(
       void *settings_data,
       bool audio_cb_inited)
@@ -712,11 +845,7 @@ bool audio_driver_init_internal(
       audio_driver_st.flags &= ~AUDIO_FLAG_ACTIVE;
    }
 
-   audio_driver_st.flags    &= ~AUDIO_FLAG_USE_FLOAT;
-   if (     (audio_driver_st.flags & AUDIO_FLAG_ACTIVE)
-         && audio_driver_st.current_audio->use_float(
-            audio_driver_st.context_audio_data))
-      audio_driver_st.flags |=  AUDIO_FLAG_USE_FLOAT;
+   audio_driver_negotiate_format(&audio_driver_st);
 
    if (     !audio_sync
          && (audio_driver_st.flags & AUDIO_FLAG_ACTIVE))
@@ -791,6 +920,9 @@ bool audio_driver_init_internal(
             audio_driver_st.current_audio->buffer_size(
                   audio_driver_st.context_audio_data);
          audio_driver_st.flags |= AUDIO_FLAG_CONTROL;
+         audio_driver_rate_control_reset(&audio_driver_st,
+               settings->uints.audio_output_sample_rate,
+               settings->uints.audio_rate_control_latency);
       }
       else
          RARCH_WARN("[Audio]: Rate control was desired, but driver does not support needed features.\n");
@@ -44,6 +44,17 @@
 
 #define AUDIO_BUFFER_FREE_SAMPLES_COUNT (8 * 1024)
 
+/* Number of buckets in the buffer fill histogram
+ * kept by dynamic rate control */
+#define AUDIO_RATE_CONTROL_HISTOGRAM_BINS 10
+/* Number of most recent underrun timestamps kept */
+#define AUDIO_RATE_CONTROL_UNDERRUN_LOG   16
+/* Integral gain of the rate control PI controller,
+ * relative to the proportional gain (rate_control_delta).
+ * The integral term is accumulated once per flush and held
+ * while the combined output is clamped to +/- rate_control_delta. */
+#define AUDIO_RATE_CONTROL_KI             (1.0 / 512.0)
+
 RETRO_BEGIN_DECLS
 
 #ifdef HAVE_AUDIOMIXER
@@ -167,11 +178,38 @@ typedef struct audio_driver
    size_t (*buffer_size)(void *data);
 } audio_driver_t;
 
+/**
+ * State and telemetry of dynamic rate control.
+ * Written on every audio flush while rate control is active,
+ * and reset whenever the audio driver is (re)initialized.
+ **/
+typedef struct audio_rate_control
+{
+   /* Time of the most recent underruns, in microseconds;
+    * a ring buffer indexed by underruns */
+   retro_time_t underrun_time[AUDIO_RATE_CONTROL_UNDERRUN_LOG];
+   /* Number of flushes seen at each buffer fill level */
+   uint64_t fill_histogram[AUDIO_RATE_CONTROL_HISTOGRAM_BINS];
+   /* Accumulated integral term of the controller */
+   double integral;
+   /* Extremes of the adjusted ratio, relative to the original ratio */
+   double adjust_min;
+   double adjust_max;
+   /* Driver free space the controller aims for, in bytes */
+   unsigned target_avail;
+   /* Driver free space at the last flush, in bytes */
+   unsigned last_avail;
+   unsigned underruns;
+   bool in_underrun;
+} audio_rate_control_t;
+
 typedef struct
 {
    double source_ratio_original;
    double source_ratio_current;
 
+   audio_rate_control_t rate_control;
+
    uint64_t free_samples_count;
 
    struct string_list *devices_list;
@@ -242,6 +242,17 @@ static void mic_driver_microphone_handle_free(retro_microphone_t *microphone, bo
    microphone->resampler      = NULL;
    microphone->resampler_data = NULL;
 
+   if (microphone->stats.frames_delivered)
+      RARCH_LOG("[Microphone]: Delivered %llu frames from %llu captured in %llu driver reads"
+            " (%llu direct). Queued latency: %.2f ms average, %.2f ms peak.\n",
+            (unsigned long long)microphone->stats.frames_delivered,
+            (unsigned long long)microphone->stats.frames_captured,
+            (unsigned long long)microphone->stats.driver_reads,
+            (unsigned long long)microphone->stats.direct_reads,
+            microphone->stats.queued_usec_avg / 1000.0,
+            microphone->stats.queued_usec_max / 1000.0);
+   memset(&microphone->stats, 0, sizeof(microphone->stats));
+
    /* If the mic driver is being reset and the microphone was already valid... */
    if ((microphone->flags & MICROPHONE_FLAG_ACTIVE) && is_reset)
       microphone->flags |= MICROPHONE_FLAG_PENDING;
@@ -511,6 +522,31 @@ bool microphone_driver_get_mic_state(const retro_microphone_t *microphone)
    return microphone->flags & MICROPHONE_FLAG_ENABLED;
 }
 
+/**
+ * Updates the capture statistics after \c frames
+ * were handed to the core.
+ */
+static void microphone_driver_update_stats(
+      retro_microphone_t *microphone, size_t frames)
+{
+   microphone_capture_stats_t *stats = &microphone->stats;
+   size_t queued                     = FIFO_READ_AVAIL(microphone->outgoing_samples)
+      / sizeof(int16_t);
+   double queued_usec                = microphone->effective_params.rate
+      ? (queued * 1000000.0) / microphone->effective_params.rate : 0.0;
+
+   /* Exponential moving average over roughly the last 64 reads */
+   if (stats->frames_delivered == 0)
+      stats->queued_usec_avg  = queued_usec;
+   else
+      stats->queued_usec_avg += (queued_usec - stats->queued_usec_avg) / 64.0;
+
+   if (queued_usec > stats->queued_usec_max)
+      stats->queued_usec_max  = queued_usec;
+
+   stats->frames_delivered   += frames;
+}
+
 /**
  * Pull queued microphone samples from the driver
  * and copy them to the provided buffer(s).
@@ -538,10 +574,13 @@ static size_t microphone_driver_flush(
          bytes_to_read);
    /* First, get the most recent mic data */
 
+   microphone->stats.driver_reads++;
+
    if (bytes_read <= 0)
       return 0;
 
    resampler_data.input_frames = bytes_read / sample_size;
+   microphone->stats.frames_captured += resampler_data.input_frames;
    /* This is in frames, not samples or bytes;
     * we're up-channeling the audio to stereo,
     * so this number still applies. */
@@ -553,7 +592,7 @@ static size_t microphone_driver_flush(
    resampler_data.data_out = mic_st->resampled_frames;
    /* The buffers that will be used for the resampler's input and output */
 
-   resampler_data.ratio    = (double)microphone->effective_params.rate / (double)microphone->actual_params.rate;
+   resampler_data.ratio    = microphone->original_ratio;
 
    if (fabs(resampler_data.ratio - 1.0f) < 1e-8)
    { /* If the mic's native rate is practically the same as the requested one... */
@@ -606,7 +645,6 @@ static size_t microphone_driver_flush(
 int microphone_driver_read(retro_microphone_t *microphone, int16_t* frames, size_t num_frames)
 {
    uint32_t runloop_flags            = runloop_get_flags();
-   size_t frames_remaining           = num_frames;
    microphone_driver_state_t *mic_st = &mic_driver_st;
    const microphone_driver_t *driver = mic_st->driver;
    bool core_paused                  = (runloop_flags & RUNLOOP_FLAG_PAUSED)           ? true : false;
@@ -668,21 +706,56 @@ int microphone_driver_read(retro_microphone_t *microphone, int16_t* frames, size
 
    retro_assert(mic_st->input_frames != NULL);
 
+   if (     !core_paused
+         && FIFO_READ_AVAIL(microphone->outgoing_samples) == 0
+         && !(microphone->flags & MICROPHONE_FLAG_USE_FLOAT)
+         && fabs(microphone->original_ratio - 1.0) < 1e-8)
+   { /* Nothing is queued and the device already provides what the core wants,
+      * so let the driver write straight into the core's buffer. */
+      int bytes_read = driver->read(
+            mic_st->driver_context,
+            microphone->microphone_context,
+            frames,
+            num_frames * sizeof(int16_t));
+
+      microphone->stats.driver_reads++;
+
+      if (bytes_read > 0)
+      {
+         size_t frames_read = bytes_read / sizeof(int16_t);
+
+         microphone->stats.frames_captured += frames_read;
+
+         if (frames_read >= num_frames)
+         {
+            microphone->stats.direct_reads++;
+            microphone_driver_update_stats(microphone, num_frames);
+            return (int)num_frames;
+         }
+
+         /* Short read; queue what we got and top it up below */
+         fifo_write(microphone->outgoing_samples, frames,
+               frames_read * sizeof(int16_t));
+      }
+   }
+
    while (FIFO_READ_AVAIL(microphone->outgoing_samples) < num_frames * sizeof(int16_t))
    { /* Until we can give the core the frames it asked for... */
-      size_t frames_to_read = MIN(AUDIO_CHUNK_SIZE_NONBLOCKING, frames_remaining);
-      size_t frames_read    = 0;
+      size_t frames_queued  = FIFO_READ_AVAIL(microphone->outgoing_samples) / sizeof(int16_t);
+      /* Only pull as many device frames as are needed
+       * to produce the frames that are still missing */
+      size_t frames_to_read = (size_t)ceil(
+            (num_frames - frames_queued) / microphone->original_ratio);
+
+      frames_to_read = MIN(AUDIO_CHUNK_SIZE_NONBLOCKING, MAX(frames_to_read, 1));
 
       /* If the game is running and the mic driver is active... */
       if (!core_paused)
-         frames_read = microphone_driver_flush(mic_st, microphone, frames_to_read);
-
-      /* Otherwise, advance the counters. We're not gonna get new data,
-       * but we still need to finish this loop */
-      frames_remaining -= frames_read;
+         microphone_driver_flush(mic_st, microphone, frames_to_read);
    } /* If the queue already has enough samples to give, the loop will be skipped */
 
    fifo_read(microphone->outgoing_samples, frames, num_frames * sizeof(int16_t));
+   microphone_driver_update_stats(microphone, num_frames);
    return (int)num_frames;
 }
 
@@ -121,6 +121,42 @@ enum microphone_state_flags
    MICROPHONE_FLAG_SUSPENDED = (1 << 4)
 };
 
+/**
+ * Capture statistics for a microphone,
+ * reported in the log when it's closed.
+ */
+typedef struct microphone_capture_stats
+{
+   /**
+    * Number of frames handed to the core.
+    */
+   uint64_t frames_delivered;
+
+   /**
+    * Number of frames pulled from the driver, at the device's rate.
+    */
+   uint64_t frames_captured;
+
+   /**
+    * Number of calls to \c microphone_driver_t::read.
+    */
+   uint64_t driver_reads;
+
+   /**
+    * Number of core reads that were served straight from the driver,
+    * without going through \c retro_microphone::outgoing_samples.
+    */
+   uint64_t direct_reads;
+
+   /**
+    * Moving average and peak of the audio left queued
+    * for the core after each read, in microseconds.
+    * This is the capture latency added by the frontend.
+    */
+   double queued_usec_avg;
+   double queued_usec_max;
+} microphone_capture_stats_t;
+
 /**
  * Driver object that tracks a microphone's state.
  * Pointers to this object are provided to cores
@@ -191,6 +227,8 @@ struct retro_microphone
     * If this is (almost) equal to 1, then resampling will be skipped.
     */
    double original_ratio;
+
+   microphone_capture_stats_t stats;
 };
 
 /**
@@ -953,6 +953,128 @@ bool command_get_status(command_t *cmd, const char* arg)
    return true;
 }
 
+bool command_get_audio_stats(command_t *cmd, const char* arg)
+{
+   unsigned i, first;
+   size_t _len;
+   char reply[2048];
+   audio_driver_state_t *audio_st = audio_state_get_ptr();
+   audio_rate_control_t *rc       = &audio_st->rate_control;
+
+   if (!(audio_st->flags & AUDIO_FLAG_CONTROL))
+   {
+      _len = strlcpy(reply, "GET_AUDIO_STATS DISABLED\n", sizeof(reply));
+      cmd->replier(cmd, reply, _len);
+      return true;
+   }
+
+   _len  = snprintf(reply, sizeof(reply),
+         "GET_AUDIO_STATS buffer=%u avail=%u target=%u"
+         " ratio=%.6f drift_ppm=%.1f integral=%.6f"
+         " adjust_min=%.6f adjust_max=%.6f underruns=%u histogram=",
+         (unsigned)audio_st->buffer_size,
+         rc->last_avail,
+         rc->target_avail,
+         audio_st->source_ratio_current,
+         (audio_st->source_ratio_current
+          / audio_st->source_ratio_original - 1.0) * 1000000.0,
+         rc->integral,
+         rc->adjust_min,
+         rc->adjust_max,
+         rc->underruns);
+
+   for (i = 0; i < AUDIO_RATE_CONTROL_HISTOGRAM_BINS
+         && _len < sizeof(reply); i++)
+      _len += snprintf(reply + _len, sizeof(reply) - _len,
+            (i == 0) ? "%llu" : ",%llu",
+            (unsigned long long)rc->fill_histogram[i]);
+
+   /* Underrun timestamps, oldest first */
+   if (_len < sizeof(reply))
+      _len += strlcpy(reply + _len, " underrun_times=",
+            sizeof(reply) - _len);
+   first = (rc->underruns > AUDIO_RATE_CONTROL_UNDERRUN_LOG)
+         ? rc->underruns - AUDIO_RATE_CONTROL_UNDERRUN_LOG : 0;
+   for (i = first; i < rc->underruns && _len < sizeof(reply); i++)
+      _len += snprintf(reply + _len, sizeof(reply) - _len,
+            (i == first) ? "%lld" : ",%lld",
+            (long long)rc->underrun_time[
+            i % AUDIO_RATE_CONTROL_UNDERRUN_LOG]);
+
+   if (_len < sizeof(reply))
+      _len += strlcpy(reply + _len, "\n", sizeof(reply) - _len);
+   if (_len >= sizeof(reply))
+      _len  = sizeof(reply) - 1;
+
+   cmd->replier(cmd, reply, _len);
+   return true;
+}
+
+bool command_get_frame_delay_stats(command_t *cmd, const char* arg)
+{
+   size_t _len;
+   char reply[256];
+   video_frame_delay_stats_t stats;
+   settings_t *settings = config_get_ptr();
+   const char *mode     = "manual";
+
+   if (video_frame_delay_model_get_stats(&stats))
+      mode = "model";
+   else if (settings->bools.video_frame_delay_auto)
+      mode = stats.miss_target ? "learning" : "reactive";
+
+   _len = snprintf(reply, sizeof(reply),
+         "GET_FRAME_DELAY_STATS mode=%s delay=%u pick=%u target=%u"
+         " miss_target=%u p50=%u p90=%u p99=%u"
+         " samples=%u frames=%u misses=%u\n",
+         mode,
+         (unsigned)stats.delay,
+         (unsigned)stats.pick,
+         (unsigned)stats.target,
+         stats.miss_target,
+         stats.run_time_p50,
+         stats.run_time_p90,
+         stats.run_time_p99,
+         stats.samples,
+         stats.frames,
+         stats.misses);
+   if (_len >= sizeof(reply))
+      _len = sizeof(reply) - 1;
+
+   cmd->replier(cmd, reply, _len);
+   return true;
+}
+
+bool command_get_frame_diff_stats(command_t *cmd, const char* arg)
+{
+   size_t _len;
+   char reply[256];
+   const video_frame_dirty_t *dirty = video_frame_dirty_get_stats();
+
+   if (!dirty)
+      _len = strlcpy(reply, "GET_FRAME_DIFF_STATS -1\n", sizeof(reply));
+   else
+   {
+      _len = snprintf(reply, sizeof(reply),
+            "GET_FRAME_DIFF_STATS frames=%" PRIu64 " dupes=%" PRIu64
+            " bytes_in=%" PRIu64 " bytes_upload=%" PRIu64
+            " saved=%.1f%%\n",
+            dirty->frames,
+            dirty->dupes,
+            dirty->bytes_in,
+            dirty->bytes_upload,
+            dirty->bytes_in
+            ? 100.0 * (double)(dirty->bytes_in - dirty->bytes_upload)
+               / (double)dirty->bytes_in
+            : 0.0);
+      if (_len >= sizeof(reply))
+         _len = sizeof(reply) - 1;
+   }
+
+   cmd->replier(cmd, reply, _len);
+   return true;
+}
+
 bool command_read_memory(command_t *cmd, const char *arg)
 {
    unsigned i;
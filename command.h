@@ -404,6 +404,9 @@ struct cmd_action_map
 bool command_version(command_t *cmd, const char* arg);
 bool command_get_status(command_t *cmd, const char* arg);
 bool command_get_config_param(command_t *cmd, const char* arg);
+bool command_get_audio_stats(command_t *cmd, const char* arg);
+bool command_get_frame_delay_stats(command_t *cmd, const char* arg);
+bool command_get_frame_diff_stats(command_t *cmd, const char* arg);
 bool command_show_osd_msg(command_t *cmd, const char* arg);
 bool command_load_state_slot(command_t *cmd, const char* arg);
 bool command_play_replay_slot(command_t *cmd, const char* arg);
@@ -421,6 +424,9 @@ static const struct cmd_action_map action_map[] = {
    { "VERSION",          command_version,          "No argument"},
    { "GET_STATUS",       command_get_status,       "No argument" },
    { "GET_CONFIG_PARAM", command_get_config_param, "<param name>" },
+   { "GET_AUDIO_STATS",  command_get_audio_stats,  "No argument" },
+   { "GET_FRAME_DELAY_STATS", command_get_frame_delay_stats, "No argument" },
+   { "GET_FRAME_DIFF_STATS",  command_get_frame_diff_stats,  "No argument" },
    { "SHOW_MSG",         command_show_osd_msg,     "No argument" },
 #if defined(HAVE_CHEEVOS)
    /* These functions use achievement addresses and only work if a game with achievements is
@@ -405,6 +405,22 @@
 #define MAXIMUM_FRAME_DELAY 99
 #define DEFAULT_FRAME_DELAY_AUTO false
 
+/* Late frames per 1000 that automatic frame delay aims for
+ * once it has learned the core's run time distribution.
+ * 0 keeps the purely reactive adjustment. */
+#define DEFAULT_FRAME_DELAY_AUTO_MISS_TARGET 10
+
+/* Compares each software frame with the previous one.
+ * Drivers that support it only upload the rows that
+ * changed, and nothing at all for identical frames. Costs a
+ * copy of the frame, so it is only enabled by default
+ * where uploading dominates. */
+#if defined(EMSCRIPTEN)
+#define DEFAULT_VIDEO_FRAME_DIFF true
+#else
+#define DEFAULT_VIDEO_FRAME_DIFF false
+#endif
+
 /* Duplicates frames for the purposes of running Shaders at a higher framerate
  * than content framerate. Requires running screen at multiple of 60hz, and
  * don't combine with Swap_interval > 1, or BFI. (Though BFI can be done in a shader
@@ -1001,6 +1017,21 @@
 /* Screenshots post-shaded GPU output if available. */
 #define DEFAULT_GPU_SCREENSHOT true
 
+/* Read GPU screenshots back over the following frames
+ * instead of stalling on the GPU, on drivers that can. */
+#define DEFAULT_GPU_SCREENSHOT_ASYNC true
+
+/* Consecutive frames captured per screenshot (burst mode).
+ * Needs asynchronous GPU screenshots. */
+#define DEFAULT_SCREENSHOT_BURST_FRAMES 1
+
+/* zlib compression level of PNG screenshots, 0-9. */
+#define DEFAULT_SCREENSHOT_PNG_COMPRESSION 6
+
+/* Only try the Sub and Up PNG row filters, encoding
+ * screenshots faster at a small cost in file size. */
+#define DEFAULT_SCREENSHOT_PNG_FAST_FILTER false
+
 /* Watch shader files for changes and auto-apply as necessary. */
 #define DEFAULT_VIDEO_SHADER_WATCH_FILES false
 
@@ -1196,6 +1227,11 @@
  * is allowed to adjust input rate. */
 #define DEFAULT_RATE_CONTROL_DELTA  0.005f
 
+/* Audio latency (in ms) rate control aims to keep
+ * buffered in the audio driver. 0 keeps the driver
+ * buffer half full. */
+#define DEFAULT_RATE_CONTROL_LATENCY 0
+
 /* Maximum timing skew. Defines how much adjust_system_rates
  * is allowed to adjust input rate. */
 #define DEFAULT_MAX_TIMING_SKEW  0.05f
@@ -1628,6 +1664,25 @@
 
 #define DEFAULT_GFX_THUMBNAIL_UPSCALE_THRESHOLD 0
 
+/* Memory in MB kept for decoded thumbnails,
+ * 0 disables the thumbnail cache */
+#define DEFAULT_GFX_THUMBNAIL_CACHE_SIZE 64
+
+/* Memory in MB of thumbnail textures kept
+ * uploaded after they go off-screen */
+#define DEFAULT_GFX_THUMBNAIL_TEXTURE_BUDGET 64
+
+/* Keep copies of thumbnails shrunk to the size the
+ * menu draws them at in the cache directory */
+#define DEFAULT_GFX_THUMBNAIL_DISK_CACHE false
+
+/* Disk space in MB used by shrunk thumbnail copies */
+#define DEFAULT_GFX_THUMBNAIL_DISK_CACHE_SIZE 256
+
+/* Keep the last menu frame on screen instead of
+ * redrawing it while nothing in it changes */
+#define DEFAULT_MENU_SKIP_STATIC_FRAMES false
+
 #ifdef HAVE_MENU
 #if defined(RS90) || defined(MIYOO)
 /* The RS-90 has a hardware clock that is neither
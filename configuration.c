@@ -1876,6 +1876,7 @@ static struct config_bool_setting *populate_settings_bool(
    SETTING_BOOL("video_ctx_scaling",             &settings->bools.video_ctx_scaling, true, DEFAULT_VIDEO_CTX_SCALING, false);
    SETTING_BOOL("video_force_aspect",            &settings->bools.video_force_aspect, true, DEFAULT_FORCE_ASPECT, false);
    SETTING_BOOL("video_frame_delay_auto",        &settings->bools.video_frame_delay_auto, true, DEFAULT_FRAME_DELAY_AUTO, false);
+   SETTING_BOOL("video_frame_diff",              &settings->bools.video_frame_diff, true, DEFAULT_VIDEO_FRAME_DIFF, false);
 #if defined(DINGUX)
    SETTING_BOOL("video_dingux_ipu_keep_aspect",  &settings->bools.video_dingux_ipu_keep_aspect, true, DEFAULT_DINGUX_IPU_KEEP_ASPECT, false);
 #endif
@@ -1895,6 +1896,8 @@ static struct config_bool_setting *populate_settings_bool(
    SETTING_BOOL("video_waitable_swapchains",     &settings->bools.video_waitable_swapchains, true, DEFAULT_WAITABLE_SWAPCHAINS, false);
    SETTING_BOOL("video_disable_composition",     &settings->bools.video_disable_composition, true, DEFAULT_DISABLE_COMPOSITION, false);
    SETTING_BOOL("video_gpu_screenshot",          &settings->bools.video_gpu_screenshot, true, DEFAULT_GPU_SCREENSHOT, false);
+   SETTING_BOOL("video_gpu_screenshot_async",    &settings->bools.video_gpu_screenshot_async, true, DEFAULT_GPU_SCREENSHOT_ASYNC, false);
+   SETTING_BOOL("screenshot_png_fast_filter",    &settings->bools.screenshot_png_fast_filter, true, DEFAULT_SCREENSHOT_PNG_FAST_FILTER, false);
    SETTING_BOOL("video_post_filter_record",      &settings->bools.video_post_filter_record, true, DEFAULT_POST_FILTER_RECORD, false);
    SETTING_BOOL("video_notch_write_over_enable", &settings->bools.video_notch_write_over_enable, true, DEFAULT_NOTCH_WRITE_OVER_ENABLE, false);
    SETTING_BOOL("video_msg_bgcolor_enable",      &settings->bools.video_msg_bgcolor_enable, true, DEFAULT_MESSAGE_BGCOLOR_ENABLE, false);
@@ -1905,6 +1908,7 @@ static struct config_bool_setting *populate_settings_bool(
    SETTING_BOOL("menu_enable_widgets",           &settings->bools.menu_enable_widgets, true, DEFAULT_MENU_ENABLE_WIDGETS, false);
    SETTING_BOOL("menu_widget_scale_auto",        &settings->bools.menu_widget_scale_auto, true, DEFAULT_MENU_WIDGET_SCALE_AUTO, false);
    SETTING_BOOL("menu_show_load_content_animation", &settings->bools.menu_show_load_content_animation, true, DEFAULT_MENU_SHOW_LOAD_CONTENT_ANIMATION, false);
+   SETTING_BOOL("menu_thumbnail_disk_cache",     &settings->bools.gfx_thumbnail_disk_cache, true, DEFAULT_GFX_THUMBNAIL_DISK_CACHE, false);
    SETTING_BOOL("notification_show_autoconfig",  &settings->bools.notification_show_autoconfig, true, DEFAULT_NOTIFICATION_SHOW_AUTOCONFIG, false);
    SETTING_BOOL("notification_show_cheats_applied", &settings->bools.notification_show_cheats_applied, true, DEFAULT_NOTIFICATION_SHOW_CHEATS_APPLIED, false);
    SETTING_BOOL("notification_show_patch_applied", &settings->bools.notification_show_patch_applied, true, DEFAULT_NOTIFICATION_SHOW_PATCH_APPLIED, false);
@@ -1934,6 +1938,7 @@ static struct config_bool_setting *populate_settings_bool(
    SETTING_BOOL("menu_linear_filter",            &settings->bools.menu_linear_filter, true, DEFAULT_VIDEO_SMOOTH, false);
    SETTING_BOOL("menu_horizontal_animation",     &settings->bools.menu_horizontal_animation, true, DEFAULT_MENU_HORIZONTAL_ANIMATION, false);
    SETTING_BOOL("menu_pause_libretro",           &settings->bools.menu_pause_libretro, true, true, false);
+   SETTING_BOOL("menu_skip_static_frames",       &settings->bools.menu_skip_static_frames, true, DEFAULT_MENU_SKIP_STATIC_FRAMES, false);
    SETTING_BOOL("menu_savestate_resume",         &settings->bools.menu_savestate_resume, true, DEFAULT_MENU_SAVESTATE_RESUME, false);
    SETTING_BOOL("menu_insert_disk_resume",       &settings->bools.menu_insert_disk_resume, true, DEFAULT_MENU_INSERT_DISK_RESUME, false);
    SETTING_BOOL("menu_mouse_enable",             &settings->bools.menu_mouse_enable, true, DEFAULT_MOUSE_ENABLE, false);
@@ -2374,6 +2379,9 @@ static struct config_uint_setting *populate_settings_uint(
    SETTING_UINT("menu_left_thumbnails",          &settings->uints.menu_left_thumbnails, true, DEFAULT_MENU_LEFT_THUMBNAILS_DEFAULT, false);
    SETTING_UINT("menu_icon_thumbnails",          &settings->uints.menu_icon_thumbnails, true, DEFAULT_MENU_ICON_THUMBNAILS_DEFAULT, false);
    SETTING_UINT("menu_thumbnail_upscale_threshold", &settings->uints.gfx_thumbnail_upscale_threshold, true, DEFAULT_GFX_THUMBNAIL_UPSCALE_THRESHOLD, false);
+   SETTING_UINT("menu_thumbnail_cache_size",     &settings->uints.gfx_thumbnail_cache_size, true, DEFAULT_GFX_THUMBNAIL_CACHE_SIZE, false);
+   SETTING_UINT("menu_thumbnail_texture_budget", &settings->uints.gfx_thumbnail_texture_budget, true, DEFAULT_GFX_THUMBNAIL_TEXTURE_BUDGET, false);
+   SETTING_UINT("menu_thumbnail_disk_cache_size", &settings->uints.gfx_thumbnail_disk_cache_size, true, DEFAULT_GFX_THUMBNAIL_DISK_CACHE_SIZE, false);
    SETTING_UINT("menu_timedate_style",           &settings->uints.menu_timedate_style, true, DEFAULT_MENU_TIMEDATE_STYLE, false);
    SETTING_UINT("menu_timedate_date_separator",  &settings->uints.menu_timedate_date_separator, true, DEFAULT_MENU_TIMEDATE_DATE_SEPARATOR, false);
    SETTING_UINT("menu_ticker_type",              &settings->uints.menu_ticker_type, true, DEFAULT_MENU_TICKER_TYPE, false);
@@ -2423,6 +2431,7 @@ static struct config_uint_setting *populate_settings_uint(
 
    SETTING_UINT("audio_out_rate",                &settings->uints.audio_output_sample_rate, true, DEFAULT_OUTPUT_RATE, false);
    SETTING_UINT("audio_latency",                 &settings->uints.audio_latency, false, 0 /* TODO */, false);
+   SETTING_UINT("audio_rate_control_latency",    &settings->uints.audio_rate_control_latency, true, DEFAULT_RATE_CONTROL_LATENCY, false);
    SETTING_UINT("audio_resampler_quality",       &settings->uints.audio_resampler_quality, true, DEFAULT_AUDIO_RESAMPLER_QUALITY_LEVEL, false);
    SETTING_UINT("audio_block_frames",            &settings->uints.audio_block_frames, true, 0, false);
    SETTING_UINT("midi_volume",                   &settings->uints.midi_volume, true, DEFAULT_MIDI_VOLUME, false);
@@ -2475,6 +2484,9 @@ static struct config_uint_setting *populate_settings_uint(
 #endif
    SETTING_UINT("video_hard_sync_frames",        &settings->uints.video_hard_sync_frames, true, DEFAULT_HARD_SYNC_FRAMES, false);
    SETTING_UINT("video_frame_delay",             &settings->uints.video_frame_delay,      true, DEFAULT_FRAME_DELAY, false);
+   SETTING_UINT("video_frame_delay_auto_miss_target", &settings->uints.video_frame_delay_auto_miss_target, true, DEFAULT_FRAME_DELAY_AUTO_MISS_TARGET, false);
+   SETTING_UINT("screenshot_burst_frames",      &settings->uints.screenshot_burst_frames, true, DEFAULT_SCREENSHOT_BURST_FRAMES, false);
+   SETTING_UINT("screenshot_png_compression",   &settings->uints.screenshot_png_compression, true, DEFAULT_SCREENSHOT_PNG_COMPRESSION, false);
    SETTING_UINT("video_max_swapchain_images",    &settings->uints.video_max_swapchain_images, true, DEFAULT_MAX_SWAPCHAIN_IMAGES, false);
    SETTING_UINT("video_max_frame_latency",       &settings->uints.video_max_frame_latency, true, DEFAULT_MAX_FRAME_LATENCY, false);
    SETTING_UINT("video_black_frame_insertion",   &settings->uints.video_black_frame_insertion, true, DEFAULT_BLACK_FRAME_INSERTION, false);
@@ -3893,6 +3905,15 @@ static bool config_load_file(global_t *global,
 
    if (settings->uints.video_frame_delay > MAXIMUM_FRAME_DELAY)
       settings->uints.video_frame_delay = MAXIMUM_FRAME_DELAY;
+   if (settings->uints.video_frame_delay_auto_miss_target > 1000)
+      settings->uints.video_frame_delay_auto_miss_target = 1000;
+
+   if (settings->uints.screenshot_burst_frames < 1)
+      settings->uints.screenshot_burst_frames = 1;
+   if (settings->uints.screenshot_burst_frames > VIDEO_READBACK_QUEUE_SIZE)
+      settings->uints.screenshot_burst_frames = VIDEO_READBACK_QUEUE_SIZE;
+   if (settings->uints.screenshot_png_compression > 9)
+      settings->uints.screenshot_png_compression = 9;
 
    settings->uints.video_swap_interval = MAX(settings->uints.video_swap_interval, 0);
    settings->uints.video_swap_interval = MIN(settings->uints.video_swap_interval, 4);
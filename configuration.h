@@ -169,6 +169,7 @@ typedef struct settings
       unsigned audio_output_sample_rate;
       unsigned audio_block_frames;
       unsigned audio_latency;
+      unsigned audio_rate_control_latency;
 
 #ifdef HAVE_WASAPI
       unsigned audio_wasapi_sh_buffer_length;
@@ -249,6 +250,9 @@ typedef struct settings
       unsigned video_swap_interval;
       unsigned video_hard_sync_frames;
       unsigned video_frame_delay;
+      unsigned video_frame_delay_auto_miss_target;
+      unsigned screenshot_burst_frames;
+      unsigned screenshot_png_compression;
       unsigned video_viwidth;
       unsigned video_aspect_ratio_idx;
       unsigned video_rotation;
@@ -284,6 +288,9 @@ typedef struct settings
       unsigned menu_left_thumbnails;
       unsigned menu_icon_thumbnails;
       unsigned gfx_thumbnail_upscale_threshold;
+      unsigned gfx_thumbnail_cache_size;
+      unsigned gfx_thumbnail_texture_budget;
+      unsigned gfx_thumbnail_disk_cache_size;
       unsigned menu_rgui_thumbnail_downscaler;
       unsigned menu_rgui_thumbnail_delay;
       unsigned menu_rgui_color_theme;
@@ -617,6 +624,7 @@ typedef struct settings
       bool video_ctx_scaling;
       bool video_force_aspect;
       bool video_frame_delay_auto;
+      bool video_frame_diff;
       bool video_crop_overscan;
       bool video_aspect_ratio_auto;
       bool video_dingux_ipu_keep_aspect;
@@ -632,6 +640,8 @@ typedef struct settings
       bool video_post_filter_record;
       bool video_gpu_record;
       bool video_gpu_screenshot;
+      bool video_gpu_screenshot_async;
+      bool screenshot_png_fast_filter;
       bool video_allow_rotate;
       bool video_shared_context;
       bool video_force_srgb_disable;
@@ -732,6 +742,7 @@ typedef struct settings
       bool filter_by_current_core;
       bool menu_enable_widgets;
       bool menu_show_load_content_animation;
+      bool gfx_thumbnail_disk_cache;
       bool notification_show_autoconfig;
       bool notification_show_cheats_applied;
       bool notification_show_patch_applied;
@@ -752,6 +763,7 @@ typedef struct settings
       bool menu_widget_scale_auto;
       bool menu_show_start_screen;
       bool menu_pause_libretro;
+      bool menu_skip_static_frames;
       bool menu_savestate_resume;
       bool menu_insert_disk_resume;
       bool menu_timedate_enable;
@@ -191,6 +191,7 @@ enum gl2_flags
 
 struct gl2
 {
+   uint64_t texture_dirty[GFX_MAX_TEXTURES]; /* Row diff stamp per texture */
    const shader_backend_t *shader;
    void *shader_data;
    void *renderchain_data;
@@ -216,6 +217,7 @@ struct gl2
    GLuint *overlay_tex;
    GLuint menu_texture;
    GLuint pbo_readback[4];
+   GLuint pbo_screenshot[2];
    GLuint texture[GFX_MAX_TEXTURES];
    GLuint hw_render_fbo[GFX_MAX_TEXTURES];
 
@@ -235,6 +237,7 @@ struct gl2
    unsigned base_size; /* 2 or 4 */
    unsigned overlays;
    unsigned pbo_readback_index;
+   unsigned pbo_screenshot_index;
    unsigned last_width[GFX_MAX_TEXTURES];
    unsigned last_height[GFX_MAX_TEXTURES];
 
@@ -246,6 +249,8 @@ struct gl2
    GLenum wrap_mode;
 
    struct scaler_ctx pbo_readback_scaler;
+   video_readback_queue_t screenshot_queue;           /* ptr alignment */
+   video_readback_request_t screenshot_inflight[2];   /* ptr alignment */
    struct video_viewport vp;                          /* int alignment */
    math_matrix_4x4 mvp, mvp_no_rot;
    struct video_coords coords;                        /* ptr alignment */
@@ -62,6 +62,7 @@ enum gl3_flags
 
 struct gl3_streamed_texture
 {
+   uint64_t dirty_stamp; /* See video_frame_dirty_rows() */
    GLuint tex;
    unsigned width;
    unsigned height;
@@ -0,0 +1,344 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <retro_inline.h>
+
+#ifdef HAVE_ZLIB
+#include <streams/trans_stream.h>
+#endif
+
+#include "network_video_codec.h"
+
+/* Run headers are u16 counts; tiles never hold more words than this */
+#define NETWORK_VIDEO_MAX_RUN 0xFFFF
+
+typedef struct network_video_codec
+{
+   uint32_t *delta;   /* XOR of the tile against the previous frame */
+   uint8_t *rle;      /* Run-length coded delta */
+#ifdef HAVE_ZLIB
+   const struct trans_stream_backend *backend;
+   void *stream;
+#endif
+   size_t rle_size;
+   unsigned tile_size;
+   bool encode;
+} network_video_codec_t;
+
+static INLINE void network_video_put_u16(uint8_t *out, unsigned val)
+{
+   out[0] = (uint8_t)(val);
+   out[1] = (uint8_t)(val >> 8);
+}
+
+static INLINE void network_video_put_u32(uint8_t *out, uint32_t val)
+{
+   out[0] = (uint8_t)(val);
+   out[1] = (uint8_t)(val >>  8);
+   out[2] = (uint8_t)(val >> 16);
+   out[3] = (uint8_t)(val >> 24);
+}
+
+static INLINE unsigned network_video_get_u16(const uint8_t *in)
+{
+   return in[0] | (in[1] << 8);
+}
+
+static INLINE uint32_t network_video_get_u32(const uint8_t *in)
+{
+   return (uint32_t)in[0]
+      | ((uint32_t)in[1] <<  8)
+      | ((uint32_t)in[2] << 16)
+      | ((uint32_t)in[3] << 24);
+}
+
+/* Worst case is one run header per literal stretch, plus the literals */
+static size_t network_video_rle_bound(unsigned tile_size)
+{
+   return (size_t)tile_size * tile_size * 4 + 4;
+}
+
+size_t network_video_tile_bound(unsigned tile_size)
+{
+   /* Codec byte, size, data */
+   return 1 + 4 + network_video_rle_bound(tile_size);
+}
+
+void network_video_write_stream_header(uint8_t *out)
+{
+   network_video_put_u32(out,     NETWORK_VIDEO_STREAM_MAGIC);
+   network_video_put_u32(out + 4, NETWORK_VIDEO_VERSION);
+}
+
+bool network_video_read_stream_header(const uint8_t *in)
+{
+   return network_video_get_u32(in)     == NETWORK_VIDEO_STREAM_MAGIC
+       && network_video_get_u32(in + 4) == NETWORK_VIDEO_VERSION;
+}
+
+void network_video_write_frame_header(uint8_t *out,
+      const network_video_frame_header_t *header)
+{
+   network_video_put_u32(out,      NETWORK_VIDEO_FRAME_MAGIC);
+   network_video_put_u32(out +  4, header->size);
+   network_video_put_u16(out +  8, header->width);
+   network_video_put_u16(out + 10, header->height);
+   out[12] = header->tile_size;
+   out[13] = header->flags;
+   network_video_put_u16(out + 14, 0);
+}
+
+bool network_video_read_frame_header(const uint8_t *in,
+      network_video_frame_header_t *header)
+{
+   if (network_video_get_u32(in) != NETWORK_VIDEO_FRAME_MAGIC)
+      return false;
+   header->size      = network_video_get_u32(in + 4);
+   header->width     = network_video_get_u16(in + 8);
+   header->height    = network_video_get_u16(in + 10);
+   header->tile_size = in[12];
+   header->flags     = in[13];
+   return header->tile_size > 0;
+}
+
+void *network_video_codec_new(bool encode, unsigned tile_size)
+{
+   network_video_codec_t *codec = (network_video_codec_t*)
+      calloc(1, sizeof(*codec));
+
+   if (!codec)
+      return NULL;
+
+   codec->tile_size = tile_size;
+   codec->encode    = encode;
+   codec->rle_size  = network_video_rle_bound(tile_size);
+   codec->delta     = (uint32_t*)malloc(
+         (size_t)tile_size * tile_size * sizeof(uint32_t));
+   codec->rle       = (uint8_t*)malloc(codec->rle_size);
+
+   if (!codec->delta || !codec->rle)
+   {
+      network_video_codec_free(codec);
+      return NULL;
+   }
+
+#ifdef HAVE_ZLIB
+   codec->backend   = encode
+      ? trans_stream_get_zlib_deflate_backend()
+      : trans_stream_get_zlib_inflate_backend();
+#endif
+
+   return codec;
+}
+
+void network_video_codec_free(void *data)
+{
+   network_video_codec_t *codec = (network_video_codec_t*)data;
+
+   if (!codec)
+      return;
+
+#ifdef HAVE_ZLIB
+   if (codec->stream)
+      codec->backend->stream_free(codec->stream);
+#endif
+   if (codec->delta)
+      free(codec->delta);
+   if (codec->rle)
+      free(codec->rle);
+   free(codec);
+}
+
+#ifdef HAVE_ZLIB
+/* Runs the whole of @in through zlib in one go.
+ * Returns the output size, 0 if it did not fit in @out_size. */
+static uint32_t network_video_zlib(network_video_codec_t *codec,
+      const uint8_t *in, uint32_t in_size,
+      uint8_t *out, uint32_t out_size)
+{
+   uint32_t rd, wn;
+   enum trans_stream_error err = TRANS_STREAM_ERROR_NONE;
+
+   if (!codec->stream)
+   {
+      if (!(codec->stream = codec->backend->stream_new()))
+         return 0;
+      /* Tiles are small and latency matters more than ratio */
+      if (codec->encode)
+      {
+         codec->backend->define(codec->stream, "level", 1);
+         codec->backend->define(codec->stream, "window_bits", 12);
+      }
+   }
+
+   codec->backend->set_in(codec->stream, in, in_size);
+   codec->backend->set_out(codec->stream, out, out_size);
+
+   if (     !codec->backend->trans(codec->stream, true, &rd, &wn, &err)
+         || err != TRANS_STREAM_ERROR_NONE)
+   {
+      /* The stream is left mid-way, start over with a fresh one */
+      codec->backend->stream_free(codec->stream);
+      codec->stream = NULL;
+      return 0;
+   }
+
+   return wn;
+}
+#endif
+
+size_t network_video_encode_tile(void *data, uint8_t *out,
+      const uint32_t *frame, uint32_t *prev, unsigned stride,
+      unsigned width, unsigned height)
+{
+   unsigned x, y;
+   size_t i, rle_len;
+   network_video_codec_t *codec = (network_video_codec_t*)data;
+   uint32_t *delta              = codec->delta;
+   size_t count                 = (size_t)width * height;
+   uint32_t changed             = 0;
+   uint8_t *rle                 = codec->rle;
+
+   /* XOR against the previous frame and take over the new pixels */
+   for (y = 0; y < height; y++)
+   {
+      const uint32_t *src = frame + (size_t)y * stride;
+      uint32_t *dst       = delta + (size_t)y * width;
+      uint32_t *ref       = prev  + (size_t)y * stride;
+
+      for (x = 0; x < width; x++)
+      {
+         dst[x]           = src[x] ^ ref[x];
+         changed         |= dst[x];
+         ref[x]           = src[x];
+      }
+   }
+
+   if (!changed)
+   {
+      out[0] = NETWORK_VIDEO_TILE_SKIP;
+      return 1;
+   }
+
+   /* Zero-run coding, the delta is mostly zero */
+   rle_len = 0;
+   for (i = 0; i < count; )
+   {
+      size_t zeros = 0;
+      size_t lits  = 0;
+
+      while (     i + zeros < count
+            &&    zeros < NETWORK_VIDEO_MAX_RUN
+            &&   !delta[i + zeros])
+         zeros++;
+      i += zeros;
+
+      while (     i + lits < count
+            &&    lits < NETWORK_VIDEO_MAX_RUN
+            &&    delta[i + lits])
+         lits++;
+
+      network_video_put_u16(rle + rle_len,     (unsigned)zeros);
+      network_video_put_u16(rle + rle_len + 2, (unsigned)lits);
+      rle_len += 4;
+
+      for (; lits; lits--, i++, rle_len += 4)
+         network_video_put_u32(rle + rle_len, delta[i]);
+   }
+
+#ifdef HAVE_ZLIB
+   {
+      uint32_t deflated = network_video_zlib(codec, rle, (uint32_t)rle_len,
+            out + 5, (uint32_t)rle_len - 1);
+      if (deflated)
+      {
+         out[0] = NETWORK_VIDEO_TILE_DEFLATE;
+         network_video_put_u32(out + 1, deflated);
+         return 5 + deflated;
+      }
+   }
+#endif
+
+   out[0] = NETWORK_VIDEO_TILE_ZRLE;
+   network_video_put_u32(out + 1, (uint32_t)rle_len);
+   memcpy(out + 5, rle, rle_len);
+   return 5 + rle_len;
+}
+
+size_t network_video_decode_tile(void *data, const uint8_t *in,
+      size_t in_size, uint32_t *frame, unsigned stride,
+      unsigned width, unsigned height)
+{
+   size_t i, len, rle_len;
+   const uint8_t *rle;
+   size_t count = (size_t)width * height;
+
+   if (in_size < 1)
+      return 0;
+   if (in[0] == NETWORK_VIDEO_TILE_SKIP)
+      return 1;
+   if (in_size < 5)
+      return 0;
+
+   len = network_video_get_u32(in + 1);
+   if (len > in_size - 5)
+      return 0;
+
+   switch (in[0])
+   {
+      case NETWORK_VIDEO_TILE_ZRLE:
+         rle     = in + 5;
+         rle_len = len;
+         break;
+#ifdef HAVE_ZLIB
+      case NETWORK_VIDEO_TILE_DEFLATE:
+         {
+            network_video_codec_t *codec = (network_video_codec_t*)data;
+            rle     = codec->rle;
+            rle_len = network_video_zlib(codec, in + 5, (uint32_t)len,
+                  codec->rle, (uint32_t)codec->rle_size);
+            if (!rle_len)
+               return 0;
+         }
+         break;
+#endif
+      default:
+         return 0;
+   }
+
+   /* Apply the runs to the pixels of the previous frame */
+   for (i = 0; i < count && rle_len >= 4; )
+   {
+      size_t zeros = network_video_get_u16(rle);
+      size_t lits  = network_video_get_u16(rle + 2);
+
+      rle         += 4;
+      rle_len     -= 4;
+      i           += zeros;
+
+      if (i + lits > count || lits * 4 > rle_len)
+         return 0;
+
+      for (; lits; lits--, i++, rle += 4, rle_len -= 4)
+         frame[(i / width) * stride + (i % width)]
+            ^= network_video_get_u32(rle);
+   }
+
+   return 5 + len;
+}
@@ -0,0 +1,145 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __NETWORK_VIDEO_CODEC_H
+#define __NETWORK_VIDEO_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <boolean.h>
+#include <retro_common_api.h>
+
+RETRO_BEGIN_DECLS
+
+/* Encoded network video stream.
+ *
+ * The stream starts with an 8 byte stream header:
+ *    u32 magic "RANV", u32 version
+ * followed by frames. Every frame is a 16 byte frame header:
+ *    u32 magic "RANF", u32 payload size,
+ *    u16 width, u16 height, u8 tile size, u8 flags, u16 reserved
+ * followed by one record per tile, in raster order:
+ *    u8 codec, and unless the codec is SKIP: u32 size, data
+ *
+ * All integers are little endian. Pixels are 32-bit BGRA8888,
+ * the same as the raw stream.
+ *
+ * A tile is XORed against the same tile of the previous frame,
+ * or against zero on key frames. The XOR delta is run-length coded
+ * as a list of (u16 zero words, u16 literal words, literals...)
+ * covering the tile's pixels row by row. With zlib that is deflated
+ * too, if it makes it smaller.
+ */
+
+#define NETWORK_VIDEO_STREAM_MAGIC   0x564E4152 /* "RANV" */
+#define NETWORK_VIDEO_FRAME_MAGIC    0x464E4152 /* "RANF" */
+#define NETWORK_VIDEO_VERSION        1
+
+#define NETWORK_VIDEO_STREAM_HEADER_SIZE 8
+#define NETWORK_VIDEO_FRAME_HEADER_SIZE  16
+
+#define NETWORK_VIDEO_TILE_SIZE      64
+
+enum network_video_tile_codec
+{
+   NETWORK_VIDEO_TILE_SKIP = 0,
+   NETWORK_VIDEO_TILE_ZRLE,
+   NETWORK_VIDEO_TILE_DEFLATE
+};
+
+enum network_video_frame_flags
+{
+   /* Tiles are XORed against zero, not the previous frame */
+   NETWORK_VIDEO_FRAME_KEY = (1 << 0)
+};
+
+typedef struct network_video_frame_header
+{
+   uint32_t size;
+   uint16_t width;
+   uint16_t height;
+   uint8_t tile_size;
+   uint8_t flags;
+} network_video_frame_header_t;
+
+/**
+ * network_video_tile_bound:
+ * @tile_size    : tile edge in pixels.
+ *
+ * Returns: the most bytes one encoded tile record can take.
+ **/
+size_t network_video_tile_bound(unsigned tile_size);
+
+void network_video_write_stream_header(uint8_t *out);
+
+bool network_video_read_stream_header(const uint8_t *in);
+
+void network_video_write_frame_header(uint8_t *out,
+      const network_video_frame_header_t *header);
+
+bool network_video_read_frame_header(const uint8_t *in,
+      network_video_frame_header_t *header);
+
+/**
+ * network_video_codec_new:
+ *
+ * Creates the per-thread state an encoder or decoder needs
+ * (scratch space and the zlib stream, if available).
+ * Every thread encoding or decoding tiles needs its own.
+ **/
+void *network_video_codec_new(bool encode, unsigned tile_size);
+
+void network_video_codec_free(void *codec);
+
+/**
+ * network_video_encode_tile:
+ * @codec        : state from network_video_codec_new().
+ * @out          : receives the tile record, at least
+ *                 network_video_tile_bound() bytes.
+ * @frame        : first pixel of the tile in the new frame.
+ * @prev         : first pixel of the tile in the previous frame,
+ *                 zeroed on key frames. Updated to the new frame.
+ * @stride       : row length of @frame and @prev, in pixels.
+ * @width        : tile width.
+ * @height       : tile height.
+ *
+ * Returns: bytes written to @out.
+ **/
+size_t network_video_encode_tile(void *codec, uint8_t *out,
+      const uint32_t *frame, uint32_t *prev, unsigned stride,
+      unsigned width, unsigned height);
+
+/**
+ * network_video_decode_tile:
+ * @codec        : state from network_video_codec_new().
+ * @in           : tile record.
+ * @in_size      : bytes left in the frame payload.
+ * @frame        : first pixel of the tile in the frame being
+ *                 rebuilt, holding the previous frame (or zero on
+ *                 key frames).
+ * @stride       : row length of @frame, in pixels.
+ * @width        : tile width.
+ * @height       : tile height.
+ *
+ * Returns: bytes of @in consumed, 0 on malformed input.
+ **/
+size_t network_video_decode_tile(void *codec, const uint8_t *in,
+      size_t in_size, uint32_t *frame, unsigned stride,
+      unsigned width, unsigned height);
+
+RETRO_END_DECLS
+
+#endif
@@ -522,6 +522,7 @@ struct vk_per_frame
    struct vk_buffer_chain vbo;         /* uint64_t alignment */
    struct vk_buffer_chain ubo;
    struct vk_descriptor_manager descriptor_manager;
+   uint64_t texture_dirty; /* See video_frame_dirty_rows() */
 
    VkCommandPool cmd_pool; /* ptr alignment */
    VkCommandBuffer cmd;    /* ptr alignment */
@@ -594,6 +595,10 @@ typedef struct vk
       struct scaler_ctx scaler_bgr;
       struct scaler_ctx scaler_rgb;
       struct vk_texture staging[VULKAN_MAX_SWAPCHAIN_IMAGES];
+      /* Screenshots waiting for a frame, and the ones read back
+       * into staging[] waiting for their frame's fence */
+      video_readback_queue_t queue;
+      video_readback_request_t inflight[VULKAN_MAX_SWAPCHAIN_IMAGES];
    } readback;
 
    struct
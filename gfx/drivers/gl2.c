@@ -2244,7 +2244,7 @@ static void gl2_renderchain_copy_frame(
       gl2_t *gl,
       gl2_renderchain_data_t *chain,
       bool use_rgba,
-      const void *frame,
+      const void *frame, unsigned y,
       unsigned width, unsigned height, unsigned pitch)
 {
 #if defined(HAVE_PSGL)
@@ -2256,7 +2256,8 @@ static void gl2_renderchain_copy_frame(
       const uint8_t *frame_copy = frame;
       size_t frame_copy_size    = width * gl->base_size;
       uint8_t           *buffer = (uint8_t*)glMapBuffer(
-            GL_TEXTURE_REFERENCE_BUFFER_SCE, GL_READ_WRITE) + buffer_addr;
+            GL_TEXTURE_REFERENCE_BUFFER_SCE, GL_READ_WRITE) + buffer_addr
+            + y * buffer_stride;
       for (h = 0; h < height; h++, buffer += buffer_stride, frame_copy += pitch)
          memcpy(buffer, frame_copy, frame_copy_size);
 
@@ -2300,14 +2301,14 @@ static void gl2_renderchain_copy_frame(
                gl->conv_buffer,
                frame, width, height, pitch);
          glTexSubImage2D(GL_TEXTURE_2D,
-               0, 0, 0, width, height, gl->texture_type,
+               0, 0, y, width, height, gl->texture_type,
                gl->texture_fmt, gl->conv_buffer);
       }
       else if (gl->flags & GL2_FLAG_HAVE_UNPACK_ROW_LENGTH)
       {
          glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch / gl->base_size);
          glTexSubImage2D(GL_TEXTURE_2D,
-               0, 0, 0, width, height, gl->texture_type,
+               0, 0, y, width, height, gl->texture_type,
                gl->texture_fmt, frame);
 
          glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
@@ -2335,7 +2336,7 @@ static void gl2_renderchain_copy_frame(
          }
 
          glTexSubImage2D(GL_TEXTURE_2D,
-               0, 0, 0, width, height, gl->texture_type,
+               0, 0, y, width, height, gl->texture_type,
                gl->texture_fmt, data_buf);
       }
    }
@@ -2364,7 +2365,7 @@ static void gl2_renderchain_copy_frame(
          glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch / gl->base_size);
 
       glTexSubImage2D(GL_TEXTURE_2D,
-            0, 0, 0, width, height, gl->texture_type,
+            0, 0, y, width, height, gl->texture_type,
             gl->texture_fmt, data_buf);
 
       glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
@@ -3031,8 +3032,9 @@ static void gl2_init_textures_data(gl2_t *gl)
    size_t i;
    for (i = 0; i < gl->textures; i++)
    {
-      gl->last_width[i]  = gl->tex_w;
-      gl->last_height[i] = gl->tex_h;
+      gl->last_width[i]    = gl->tex_w;
+      gl->last_height[i]   = gl->tex_h;
+      gl->texture_dirty[i] = 0;
    }
 
    for (i = 0; i < gl->textures; i++)
@@ -3374,6 +3376,76 @@ static void gl2_pbo_async_readback(gl2_t *gl)
    gl2_renderchain_unbind_pbo();
 }
 
+#ifdef HAVE_GL_ASYNC_READBACK
+/* Hands a screenshot read back on an earlier frame to its callback.
+ * The PBO has had a whole frame to fill, so mapping it rarely waits. */
+static void gl2_screenshot_async_complete(gl2_t *gl, unsigned slot)
+{
+   video_readback_request_t *req = &gl->screenshot_inflight[slot];
+   unsigned num_pixels           = req->width * req->height;
+   uint8_t *buffer               = (uint8_t*)malloc(num_pixels * 3);
+   const void *ptr               = NULL;
+
+   gl2_renderchain_bind_pbo(gl->pbo_screenshot[slot]);
+#ifdef HAVE_OPENGLES3
+   ptr = glMapBufferRange(GL_PIXEL_PACK_BUFFER,
+         0, num_pixels * sizeof(uint32_t), GL_MAP_READ_BIT);
+#else
+   ptr = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+#endif
+
+   if (ptr)
+   {
+      if (buffer)
+         video_frame_convert_rgba_to_bgr(ptr, buffer, num_pixels);
+      glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+   }
+   else
+   {
+      RARCH_ERR("[GL]: Failed to map screenshot buffer.\n");
+      free(buffer);
+      buffer = NULL;
+   }
+   gl2_renderchain_unbind_pbo();
+
+   req->cb(req->userdata, buffer, req->width, req->height);
+   req->cb = NULL;
+}
+
+/* Double-buffered screenshot readback: each frame collects the
+ * readback issued on the previous one and issues the next queued
+ * one into the other PBO, so a burst never stalls on the GPU. */
+static void gl2_screenshot_async_iterate(gl2_t *gl)
+{
+   video_readback_request_t req;
+   unsigned slot = gl->pbo_screenshot_index;
+
+   if (gl->screenshot_inflight[slot ^ 1].cb)
+      gl2_screenshot_async_complete(gl, slot ^ 1);
+
+   if (!video_readback_queue_pop(&gl->screenshot_queue, &req))
+      return;
+
+   if (!gl->pbo_screenshot[0])
+      glGenBuffers(2, gl->pbo_screenshot);
+
+   req.width  = (gl->vp.width  > gl->video_width)
+      ? gl->video_width  : gl->vp.width;
+   req.height = (gl->vp.height > gl->video_height)
+      ? gl->video_height : gl->vp.height;
+
+   gl2_renderchain_bind_pbo(gl->pbo_screenshot[slot]);
+   gl2_renderchain_init_pbo(req.width * req.height * sizeof(uint32_t),
+         NULL);
+   gl2_renderchain_readback(gl, gl->renderchain_data,
+         4, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+   gl2_renderchain_unbind_pbo();
+
+   gl->screenshot_inflight[slot] = req;
+   gl->pbo_screenshot_index      = slot ^ 1;
+}
+#endif
+
 static bool gl2_frame(void *data, const void *frame,
       unsigned frame_width, unsigned frame_height,
       uint64_t frame_count,
@@ -3506,10 +3578,29 @@ static bool gl2_frame(void *data, const void *frame,
    {
       if (!(gl->flags & GL2_FLAG_HW_RENDER_FBO_INIT))
       {
+         unsigned dirty_y      = 0;
+         unsigned dirty_height = frame_height;
+         bool partial          = video_frame_dirty_rows(video_info,
+               &gl->texture_dirty[gl->tex_index], &dirty_y, &dirty_height);
+#if defined(HAVE_OPENGLES) && defined(HAVE_EGL)
+         /* EGL images are always written whole */
+         if (chain->flags & GL2_CHAIN_FLAG_EGL_IMAGES)
+            partial             = false;
+#endif
+         if (!partial)
+         {
+            dirty_y             = 0;
+            dirty_height        = frame_height;
+         }
+
          gl2_update_input_size(gl, frame_width, frame_height, pitch, true);
 
-         gl2_renderchain_copy_frame(gl, chain, use_rgba,
-               frame, frame_width, frame_height, pitch);
+         /* Only the rows that changed since this texture
+          * was last filled need uploading */
+         if (dirty_height)
+            gl2_renderchain_copy_frame(gl, chain, use_rgba,
+                  (const uint8_t*)frame + dirty_y * pitch, dirty_y,
+                  frame_width, dirty_height, pitch);
       }
 
       /* No point regenerating mipmaps
@@ -3645,6 +3736,13 @@ static bool gl2_frame(void *data, const void *frame,
       glBindTexture(GL_TEXTURE_2D, 0);
    }
 
+#ifdef HAVE_GL_ASYNC_READBACK
+   if (     gl->screenshot_queue.count
+         || gl->screenshot_inflight[0].cb
+         || gl->screenshot_inflight[1].cb)
+      gl2_screenshot_async_iterate(gl);
+#endif
+
    /* Screenshots. */
    if (gl->readback_buffer_screenshot)
       gl2_renderchain_readback(gl,
@@ -3803,6 +3901,17 @@ static void gl2_free(void *data)
       scaler_ctx_gen_reset(&gl->pbo_readback_scaler);
    }
 
+#ifdef HAVE_GL_ASYNC_READBACK
+   /* Screenshots already read back are still good */
+   if (gl->screenshot_inflight[0].cb)
+      gl2_screenshot_async_complete(gl, 0);
+   if (gl->screenshot_inflight[1].cb)
+      gl2_screenshot_async_complete(gl, 1);
+   if (gl->pbo_screenshot[0])
+      glDeleteBuffers(2, gl->pbo_screenshot);
+#endif
+   video_readback_queue_flush(&gl->screenshot_queue);
+
 #ifndef HAVE_OPENGLES
    if (gl->flags & GL2_FLAG_CORE_CONTEXT_IN_USE)
    {
@@ -4861,6 +4970,17 @@ static void gl2_viewport_info(void *data, struct video_viewport *vp)
    vp->y           = top_dist;
 }
 
+static bool gl2_read_viewport_async(void *data,
+      video_viewport_read_cb_t cb, void *userdata)
+{
+#ifdef HAVE_GL_ASYNC_READBACK
+   gl2_t *gl = (gl2_t*)data;
+   if (gl)
+      return video_readback_queue_push(&gl->screenshot_queue, cb, userdata);
+#endif
+   return false;
+}
+
 static bool gl2_read_viewport(void *data, uint8_t *buffer, bool is_idle)
 {
    gl2_t *gl             = (gl2_t*)data;
@@ -5266,7 +5386,8 @@ static const video_poke_interface_t gl2_poke_interface = {
    NULL, /* set_hdr_max_nits */
    NULL, /* set_hdr_paper_white_nits */
    NULL, /* set_hdr_contrast */
-   NULL  /* set_hdr_expand_gamut */
+   NULL, /* set_hdr_expand_gamut */
+   gl2_read_viewport_async
 };
 
 static void gl2_get_poke_interface(void *data,
@@ -2559,8 +2559,12 @@ error:
 
 static void gl3_update_cpu_texture(gl3_t *gl,
       struct gl3_streamed_texture *streamed,
-      const void *frame, unsigned width, unsigned height, unsigned pitch)
+      const void *frame, unsigned width, unsigned height, unsigned pitch,
+      video_frame_info_t *video_info)
 {
+   unsigned y      = 0;
+   unsigned rows   = height;
+
    if (width != streamed->width || height != streamed->height)
    {
       if (streamed->tex != 0)
@@ -2572,8 +2576,9 @@ static void gl3_update_cpu_texture(gl3_t *gl,
             ? GL_RGBA8
             : GL_RGB565,
             width, height);
-      streamed->width = width;
-      streamed->height = height;
+      streamed->width       = width;
+      streamed->height      = height;
+      streamed->dirty_stamp = 0;
 
       if (gl->video_info.rgb32)
       {
@@ -2584,20 +2589,32 @@ static void gl3_update_cpu_texture(gl3_t *gl,
    else
       glBindTexture(GL_TEXTURE_2D, streamed->tex);
 
+   /* Only upload the rows that changed since this
+    * texture was last filled */
+   if (!video_frame_dirty_rows(video_info,
+            &streamed->dirty_stamp, &y, &rows))
+   {
+      y    = 0;
+      rows = height;
+   }
+   if (!rows)
+      return;
+   frame = (const uint8_t*)frame + y * pitch;
+
    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
    if (gl->video_info.rgb32)
    {
       glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch >> 2);
       glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
-                      width, height, GL_RGBA, GL_UNSIGNED_BYTE, frame);
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y,
+                      width, rows, GL_RGBA, GL_UNSIGNED_BYTE, frame);
    }
    else
    {
       glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch >> 1);
       glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
-      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
-                      width, height, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, frame);
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y,
+                      width, rows, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, frame);
    }
 }
 
@@ -2703,7 +2720,7 @@ static bool gl3_frame(void *data, const void *frame,
       }
       else
          gl3_update_cpu_texture(gl, streamed, frame,
-               frame_width, frame_height, pitch);
+               frame_width, frame_height, pitch, video_info);
    }
 
    if (gl->flags & GL3_FLAG_SHOULD_RESIZE)
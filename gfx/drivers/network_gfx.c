@@ -29,6 +29,14 @@
 #include "../../config.h"
 #endif
 
+#ifdef NETWORK_VIDEO_ENCODE
+#include <features/features_cpu.h>
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+#include "../common/network_video_codec.h"
+#endif
+
 #ifdef HAVE_MENU
 #include "../../menu/menu_driver.h"
 #endif
@@ -50,8 +58,56 @@ enum
    NETWORK_VIDEO_PIXELFORMAT_RGB565
 } network_video_pixelformat;
 
+#ifdef NETWORK_VIDEO_ENCODE
+/* Upper bound on threads encoding tiles, the calling thread included */
+#define NETWORK_VIDEO_MAX_THREADS 8
+
+typedef struct network_encoder network_encoder_t;
+
+typedef struct network_encode_worker
+{
+   network_encoder_t *enc;
+   void *codec;
+#ifdef HAVE_THREADS
+   sthread_t *thread;
+#endif
+} network_encode_worker_t;
+
+/* Delta/tile encoder for the encoded stream, see network_video_codec.h.
+ * Tiles are independent, so they are shared out to a pool of workers
+ * pulling tile indices off a counter; the calling thread works too. */
+struct network_encoder
+{
+   network_encode_worker_t workers[NETWORK_VIDEO_MAX_THREADS];
+   const uint32_t *frame;
+   uint32_t *prev;      /* Last frame sent, the delta reference */
+   uint8_t *tiles;      /* One record slot of tile_bound bytes per tile */
+   size_t *tile_len;
+   uint8_t *send_buf;
+#ifdef HAVE_THREADS
+   slock_t *lock;
+   scond_t *cond_work;
+   scond_t *cond_done;
+#endif
+   uint64_t frames;
+   uint64_t bytes;
+   size_t tile_bound;
+   unsigned width;
+   unsigned height;
+   unsigned tiles_x;
+   unsigned num_tiles;
+   unsigned num_workers;
+   unsigned next;
+   unsigned pending;
+   bool die;
+};
+#endif
+
 typedef struct network
 {
+#ifdef NETWORK_VIDEO_ENCODE
+   network_encoder_t *encoder;
+#endif
    int fd;
    unsigned video_width;
    unsigned video_height;
@@ -73,6 +129,262 @@ static unsigned network_menu_bits        = 0;
 static bool network_rgb32                = false;
 static unsigned *network_video_temp_buf  = NULL;
 
+#ifdef NETWORK_VIDEO_ENCODE
+static void network_encoder_tile(network_encoder_t *enc,
+      void *codec, unsigned i)
+{
+   unsigned x      = (i % enc->tiles_x) * NETWORK_VIDEO_TILE_SIZE;
+   unsigned y      = (i / enc->tiles_x) * NETWORK_VIDEO_TILE_SIZE;
+   size_t offset   = (size_t)y * enc->width + x;
+
+   enc->tile_len[i] = network_video_encode_tile(codec,
+         enc->tiles + i * enc->tile_bound,
+         enc->frame + offset, enc->prev + offset, enc->width,
+         MIN(NETWORK_VIDEO_TILE_SIZE, enc->width  - x),
+         MIN(NETWORK_VIDEO_TILE_SIZE, enc->height - y));
+}
+
+#ifdef HAVE_THREADS
+/* Encodes tiles until none are left. Called with the lock held,
+ * returns with it held. */
+static void network_encoder_drain(network_encoder_t *enc, void *codec)
+{
+   while (enc->next < enc->num_tiles)
+   {
+      unsigned i = enc->next++;
+
+      slock_unlock(enc->lock);
+      network_encoder_tile(enc, codec, i);
+      slock_lock(enc->lock);
+
+      if (--enc->pending == 0)
+         scond_signal(enc->cond_done);
+   }
+}
+
+static void network_encoder_thread_loop(void *data)
+{
+   network_encode_worker_t *worker = (network_encode_worker_t*)data;
+   network_encoder_t *enc          = worker->enc;
+
+   slock_lock(enc->lock);
+
+   for (;;)
+   {
+      while (!enc->die && enc->next >= enc->num_tiles)
+         scond_wait(enc->cond_work, enc->lock);
+
+      if (enc->die)
+         break;
+
+      network_encoder_drain(enc, worker->codec);
+   }
+
+   slock_unlock(enc->lock);
+}
+#endif
+
+static void network_encoder_free(network_encoder_t *enc)
+{
+   unsigned i;
+
+   if (!enc)
+      return;
+
+#ifdef HAVE_THREADS
+   if (enc->lock)
+   {
+      slock_lock(enc->lock);
+      enc->die = true;
+      if (enc->cond_work)
+         scond_broadcast(enc->cond_work);
+      slock_unlock(enc->lock);
+   }
+#endif
+
+   for (i = 0; i < enc->num_workers; i++)
+   {
+#ifdef HAVE_THREADS
+      if (enc->workers[i].thread)
+         sthread_join(enc->workers[i].thread);
+#endif
+      network_video_codec_free(enc->workers[i].codec);
+   }
+
+#ifdef HAVE_THREADS
+   if (enc->cond_work)
+      scond_free(enc->cond_work);
+   if (enc->cond_done)
+      scond_free(enc->cond_done);
+   if (enc->lock)
+      slock_free(enc->lock);
+#endif
+
+   if (enc->frames)
+      RARCH_LOG("[Network]: Sent %u encoded frames, %u bytes per frame"
+            " on average (%u raw).\n",
+            (unsigned)enc->frames,
+            (unsigned)(enc->bytes / enc->frames),
+            enc->width * enc->height * 4);
+
+   free(enc->prev);
+   free(enc->tiles);
+   free(enc->tile_len);
+   free(enc->send_buf);
+   free(enc);
+}
+
+static network_encoder_t *network_encoder_new(void)
+{
+   unsigned num_workers   = 1;
+   network_encoder_t *enc = (network_encoder_t*)calloc(1, sizeof(*enc));
+
+   if (!enc)
+      return NULL;
+
+   enc->tile_bound        = network_video_tile_bound(NETWORK_VIDEO_TILE_SIZE);
+
+#ifdef HAVE_THREADS
+   num_workers            = cpu_features_get_core_amount();
+   if (num_workers > NETWORK_VIDEO_MAX_THREADS)
+      num_workers         = NETWORK_VIDEO_MAX_THREADS;
+   if (num_workers < 1)
+      num_workers         = 1;
+
+   if (num_workers > 1)
+   {
+      if (   !(enc->lock      = slock_new())
+          || !(enc->cond_work = scond_new())
+          || !(enc->cond_done = scond_new()))
+         goto error;
+   }
+#endif
+
+   /* Worker 0 is the calling thread */
+   for (; enc->num_workers < num_workers; enc->num_workers++)
+   {
+      network_encode_worker_t *worker = &enc->workers[enc->num_workers];
+
+      worker->enc   = enc;
+      if (!(worker->codec = network_video_codec_new(true,
+                  NETWORK_VIDEO_TILE_SIZE)))
+         goto error;
+#ifdef HAVE_THREADS
+      if (     enc->num_workers > 0
+            && !(worker->thread = sthread_create(
+                  network_encoder_thread_loop, worker)))
+      {
+         network_video_codec_free(worker->codec);
+         goto error;
+      }
+#endif
+   }
+
+   RARCH_LOG("[Network]: Encoding %ux%u tiles on %u threads.\n",
+         NETWORK_VIDEO_TILE_SIZE, NETWORK_VIDEO_TILE_SIZE, enc->num_workers);
+
+   return enc;
+
+error:
+   network_encoder_free(enc);
+   return NULL;
+}
+
+static bool network_encoder_resize(network_encoder_t *enc,
+      unsigned width, unsigned height)
+{
+   unsigned tiles_x   = (width  + NETWORK_VIDEO_TILE_SIZE - 1)
+      / NETWORK_VIDEO_TILE_SIZE;
+   unsigned tiles_y   = (height + NETWORK_VIDEO_TILE_SIZE - 1)
+      / NETWORK_VIDEO_TILE_SIZE;
+   unsigned num_tiles = tiles_x * tiles_y;
+
+   free(enc->prev);
+   free(enc->tiles);
+   free(enc->tile_len);
+   free(enc->send_buf);
+
+   /* A zeroed reference makes the next frame a key frame */
+   enc->prev      = (uint32_t*)calloc((size_t)width * height, sizeof(uint32_t));
+   enc->tiles     = (uint8_t*)malloc(num_tiles * enc->tile_bound);
+   enc->tile_len  = (size_t*)calloc(num_tiles, sizeof(size_t));
+   enc->send_buf  = (uint8_t*)malloc(NETWORK_VIDEO_FRAME_HEADER_SIZE
+         + num_tiles * enc->tile_bound);
+   enc->width     = width;
+   enc->height    = height;
+   enc->tiles_x   = tiles_x;
+   enc->num_tiles = num_tiles;
+   enc->next      = num_tiles;
+
+   if (!enc->prev || !enc->tiles || !enc->tile_len || !enc->send_buf)
+   {
+      enc->width  = 0;
+      enc->height = 0;
+      return false;
+   }
+   return true;
+}
+
+static void network_encoder_send(network_encoder_t *enc, int fd,
+      const uint32_t *frame, unsigned width, unsigned height)
+{
+   unsigned i;
+   network_video_frame_header_t header;
+   size_t _len   = NETWORK_VIDEO_FRAME_HEADER_SIZE;
+
+   header.flags  = 0;
+
+   if (width != enc->width || height != enc->height)
+   {
+      if (!network_encoder_resize(enc, width, height))
+         return;
+      header.flags |= NETWORK_VIDEO_FRAME_KEY;
+   }
+
+   enc->frame    = frame;
+
+#ifdef HAVE_THREADS
+   if (enc->num_workers > 1)
+   {
+      slock_lock(enc->lock);
+      enc->next    = 0;
+      enc->pending = enc->num_tiles;
+      scond_broadcast(enc->cond_work);
+
+      network_encoder_drain(enc, enc->workers[0].codec);
+
+      while (enc->pending)
+         scond_wait(enc->cond_done, enc->lock);
+      slock_unlock(enc->lock);
+   }
+   else
+#endif
+   {
+      for (i = 0; i < enc->num_tiles; i++)
+         network_encoder_tile(enc, enc->workers[0].codec, i);
+   }
+
+   /* Pack the tile records back to back behind the header */
+   for (i = 0; i < enc->num_tiles; i++)
+   {
+      memcpy(enc->send_buf + _len,
+            enc->tiles + i * enc->tile_bound, enc->tile_len[i]);
+      _len += enc->tile_len[i];
+   }
+
+   header.size      = (uint32_t)(_len - NETWORK_VIDEO_FRAME_HEADER_SIZE);
+   header.width     = width;
+   header.height    = height;
+   header.tile_size = NETWORK_VIDEO_TILE_SIZE;
+   network_video_write_frame_header(enc->send_buf, &header);
+
+   socket_send_all_blocking(fd, enc->send_buf, _len, true);
+
+   enc->frames++;
+   enc->bytes      += _len;
+}
+#endif
+
 static void gfx_ctx_network_input_driver(
       const char *joypad_driver,
       input_driver_t **input, void **input_data)
@@ -154,6 +466,18 @@ try_connect:
       goto try_connect;
    }
 
+#ifdef NETWORK_VIDEO_ENCODE
+   /* The stream header tells the receiver to expect encoded
+    * frames; without it, it gets the raw stream */
+   if ((network->encoder = network_encoder_new()))
+   {
+      uint8_t stream_header[NETWORK_VIDEO_STREAM_HEADER_SIZE];
+      network_video_write_stream_header(stream_header);
+      socket_send_all_blocking(network->fd, stream_header,
+            sizeof(stream_header), true);
+   }
+#endif
+
    RARCH_LOG("[Network]: Init complete.\n");
 
    return network;
@@ -329,7 +653,16 @@ static bool network_gfx_frame(void *data, const void *frame,
    if (draw && network->screen_width > 0 && network->screen_height > 0)
    {
       if (network->fd > 0)
-         socket_send_all_blocking(network->fd, frame_to_copy, network->screen_width * network->screen_height * 4, true);
+      {
+#ifdef NETWORK_VIDEO_ENCODE
+         if (network->encoder)
+            network_encoder_send(network->encoder, network->fd,
+                  (const uint32_t*)frame_to_copy,
+                  network->screen_width, network->screen_height);
+         else
+#endif
+            socket_send_all_blocking(network->fd, frame_to_copy, network->screen_width * network->screen_height * 4, true);
+      }
    }
 
    if (msg)
@@ -375,6 +708,10 @@ static void network_gfx_free(void *data)
 
    font_driver_free_osd();
 
+#ifdef NETWORK_VIDEO_ENCODE
+   network_encoder_free(network->encoder);
+#endif
+
    if (network->fd >= 0)
       socket_close(network->fd);
 
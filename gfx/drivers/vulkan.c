@@ -2661,6 +2661,7 @@ static void vulkan_init_textures(vk_t *vk)
          vk->swapchain[i].texture = vulkan_create_texture(
                vk, NULL, vk->tex_w, vk->tex_h, vk->tex_fmt,
                NULL, NULL, VULKAN_TEXTURE_STREAMED);
+         vk->swapchain[i].texture_dirty = 0;
 
          {
             struct vk_texture *texture = &vk->swapchain[i].texture;
@@ -3024,6 +3025,97 @@ static void vulkan_init_static_resources(vk_t *vk)
          blank, NULL, VULKAN_TEXTURE_STATIC);
 }
 
+/* Converts a readback staging buffer to the bottom-up
+ * BGR24 layout read_viewport hands out */
+static bool vulkan_readback_to_bgr24(vk_t *vk,
+      struct vk_texture *staging, uint8_t *buffer,
+      unsigned vp_width, unsigned vp_height)
+{
+   int y;
+   const uint8_t *src = (const uint8_t*)staging->mapped;
+   bool ret           = true;
+   VkFormat format    = vk->context->swapchain_format;
+#ifdef VULKAN_HDR_SWAPCHAIN
+   /* Hdr readback is implemented through format conversion on the GPU */
+   if (vk->context->flags & VK_CTX_FLAG_HDR_ENABLE)
+      format = VK_FORMAT_B8G8R8A8_UNORM;
+#endif /* VULKAN_HDR_SWAPCHAIN */
+
+   if (staging->memory == VK_NULL_HANDLE)
+      return false;
+
+   if (!src)
+      vkMapMemory(vk->context->device, staging->memory,
+            staging->offset, staging->size, 0, (void**)&src);
+
+   if (staging->flags & VK_TEX_FLAG_NEED_MANUAL_CACHE_MANAGEMENT)
+      VULKAN_SYNC_TEXTURE_TO_CPU(vk->context->device, staging->memory);
+
+   buffer += 3 * (vp_height - 1) * vp_width;
+
+   switch (format)
+   {
+      case VK_FORMAT_B8G8R8A8_UNORM:
+         for (y = 0; y < (int) vp_height; y++,
+               src += staging->stride, buffer -= 3 * vp_width)
+         {
+            int x;
+            for (x = 0; x < (int) vp_width; x++)
+            {
+               buffer[3 * x + 0] = src[4 * x + 0];
+               buffer[3 * x + 1] = src[4 * x + 1];
+               buffer[3 * x + 2] = src[4 * x + 2];
+            }
+         }
+         break;
+
+      case VK_FORMAT_R8G8B8A8_UNORM:
+      case VK_FORMAT_A8B8G8R8_UNORM_PACK32:
+         for (y = 0; y < (int) vp_height; y++,
+               src += staging->stride, buffer -= 3 * vp_width)
+         {
+            int x;
+            for (x = 0; x < (int) vp_width; x++)
+            {
+               buffer[3 * x + 2] = src[4 * x + 0];
+               buffer[3 * x + 1] = src[4 * x + 1];
+               buffer[3 * x + 0] = src[4 * x + 2];
+            }
+         }
+         break;
+
+      default:
+         RARCH_ERR("[Vulkan]: Unexpected swapchain format.\n");
+         ret = false;
+         break;
+   }
+
+   if (!staging->mapped)
+      vkUnmapMemory(vk->context->device, staging->memory);
+   return ret;
+}
+
+/* Hands a screenshot read back on an earlier use of
+ * this frame index to its callback. The frame's fence
+ * has signalled by now, so this never waits. */
+static void vulkan_readback_async_complete(vk_t *vk, unsigned index)
+{
+   video_readback_request_t *req = &vk->readback.inflight[index];
+   uint8_t *buffer               = (uint8_t*)malloc(
+         req->width * req->height * 3);
+
+   if (buffer && !vulkan_readback_to_bgr24(vk,
+            &vk->readback.staging[index], buffer,
+            req->width, req->height))
+   {
+      free(buffer);
+      buffer = NULL;
+   }
+
+   req->cb(req->userdata, buffer, req->width, req->height);
+   req->cb = NULL;
+}
+
 static void vulkan_deinit_static_resources(vk_t *vk)
 {
    int i;
@@ -3040,10 +3132,15 @@ static void vulkan_deinit_static_resources(vk_t *vk)
    free(vk->hw.semaphores);
 
    for (i = 0; i < VULKAN_MAX_SWAPCHAIN_IMAGES; i++)
+   {
+      if (vk->readback.inflight[i].cb)
+         vulkan_readback_async_complete(vk, i);
       if (vk->readback.staging[i].memory != VK_NULL_HANDLE)
          vulkan_destroy_texture(
                vk->context->device,
                &vk->readback.staging[i]);
+   }
+   video_readback_queue_flush(&vk->readback.queue);
 }
 
 static void vulkan_deinit_menu(vk_t *vk)
@@ -4417,6 +4514,10 @@ static bool vulkan_frame(void *data, const void *frame,
    VK_BUFFER_CHAIN_DISCARD(buff_chain_vbo);
    VK_BUFFER_CHAIN_DISCARD(buff_chain_ubo);
 
+   /* Screenshot read back the last time this frame index came up */
+   if (vk->readback.inflight[frame_index].cb)
+      vulkan_readback_async_complete(vk, frame_index);
+
    /* Start recording the command buffer. */
    vk->cmd                                       = chain->cmd;
 
@@ -4468,9 +4569,11 @@ static bool vulkan_frame(void *data, const void *frame,
    if (frame && (!(vk->flags & VK_FLAG_HW_ENABLE)))
    {
       unsigned y;
-      uint8_t *dst        = NULL;
-      const uint8_t *src  = (const uint8_t*)frame;
-      unsigned bpp        = vk->video.rgb32 ? 4 : 2;
+      unsigned dirty_y      = 0;
+      unsigned dirty_height = frame_height;
+      uint8_t *dst          = NULL;
+      const uint8_t *src    = (const uint8_t*)frame;
+      unsigned bpp          = vk->video.rgb32 ? 4 : 2;
 
       if (     chain->texture.width  != frame_width
             || chain->texture.height != frame_height)
@@ -4492,16 +4595,28 @@ static bool vulkan_frame(void *data, const void *frame,
                   frame_width, frame_height,
                   chain->texture.format, /* Ensure we use the original format and not any remapped format. */
                   NULL, NULL, VULKAN_TEXTURE_DYNAMIC);
+         chain->texture_dirty = 0;
+      }
+
+      /* Each swapchain image has its own staging texture,
+       * only copy the rows that changed since it was filled */
+      if (!video_frame_dirty_rows(video_info,
+               &chain->texture_dirty, &dirty_y, &dirty_height))
+      {
+         dirty_y      = 0;
+         dirty_height = frame_height;
       }
 
       if (frame != chain->texture.mapped)
       {
-         dst = (uint8_t*)chain->texture.mapped;
+         dst  = (uint8_t*)chain->texture.mapped
+              + dirty_y * chain->texture.stride;
+         src += dirty_y * pitch;
          if (     (chain->texture.stride == pitch )
                && pitch == frame_width * bpp)
-            memcpy(dst, src, frame_width * frame_height * bpp);
+            memcpy(dst, src, frame_width * dirty_height * bpp);
          else
-            for (y = 0; y < frame_height; y++,
+            for (y = 0; y < dirty_height; y++,
                   dst += chain->texture.stride, src += pitch)
                memcpy(dst, src, frame_width * bpp);
       }
@@ -4815,7 +4930,8 @@ static bool vulkan_frame(void *data, const void *frame,
       )
    {
       if (     (vk->flags & VK_FLAG_READBACK_PENDING)
-            || (vk->flags & VK_FLAG_READBACK_STREAMED))
+            || (vk->flags & VK_FLAG_READBACK_STREAMED)
+            || (vk->readback.queue.count))
       {
          VkImageLayout backbuffer_layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 #ifdef VULKAN_HDR_SWAPCHAIN
@@ -4861,6 +4977,18 @@ static bool vulkan_frame(void *data, const void *frame,
 
          vulkan_readback(vk, readback_source);
 
+         /* Collected when this frame index comes up again */
+         if (video_readback_queue_pop(&vk->readback.queue,
+                  &vk->readback.inflight[frame_index]))
+         {
+            video_readback_request_t *req =
+               &vk->readback.inflight[frame_index];
+            req->width  = (vk->vp.width  > vk->video_width)
+               ? vk->video_width  : vk->vp.width;
+            req->height = (vk->vp.height > vk->video_height)
+               ? vk->video_height : vk->vp.height;
+         }
+
          /* Prepare for presentation after transfers are complete. */
          VULKAN_IMAGE_LAYOUT_TRANSITION(
                vk->cmd,
@@ -5499,6 +5627,15 @@ static void vulkan_get_video_output_next(void *data)
       vk->ctx_driver->get_video_output_next(vk->ctx_data);
 }
 
+static bool vulkan_read_viewport_async(void *data,
+      video_viewport_read_cb_t cb, void *userdata)
+{
+   vk_t *vk = (vk_t*)data;
+   if (!vk)
+      return false;
+   return video_readback_queue_push(&vk->readback.queue, cb, userdata);
+}
+
 static const video_poke_interface_t vulkan_poke_interface = {
    vulkan_get_flags,
    vulkan_load_texture,
@@ -5525,13 +5662,14 @@ static const video_poke_interface_t vulkan_poke_interface = {
    vulkan_set_hdr_max_nits,
    vulkan_set_hdr_paper_white_nits,
    vulkan_set_hdr_contrast,
-   vulkan_set_hdr_expand_gamut
+   vulkan_set_hdr_expand_gamut,
 #else
    NULL, /* set_hdr_max_nits */
    NULL, /* set_hdr_paper_white_nits */
    NULL, /* set_hdr_contrast */
-   NULL  /* set_hdr_expand_gamut */
+   NULL, /* set_hdr_expand_gamut */
 #endif /* VULKAN_HDR_SWAPCHAIN */
+   vulkan_read_viewport_async
 };
 
 static void vulkan_get_poke_interface(void *data,
@@ -5648,54 +5786,10 @@ static bool vulkan_read_viewport(void *data, uint8_t *buffer, bool is_idle)
          VK_MAP_PERSISTENT_TEXTURE(vk->context->device, staging);
       }
 
-      if (     (staging->flags & VK_TEX_FLAG_NEED_MANUAL_CACHE_MANAGEMENT)
-            && (staging->memory != VK_NULL_HANDLE))
-         VULKAN_SYNC_TEXTURE_TO_CPU(vk->context->device, staging->memory);
-
-      {
-         int y;
-         unsigned vp_width  = (vk->vp.width  > vk->video_width)  ? vk->video_width  : vk->vp.width;
-         unsigned vp_height = (vk->vp.height > vk->video_height) ? vk->video_height : vk->vp.height;
-         const uint8_t *src = (const uint8_t*)staging->mapped;
+      vulkan_readback_to_bgr24(vk, staging, buffer,
+            (vk->vp.width  > vk->video_width)  ? vk->video_width  : vk->vp.width,
+            (vk->vp.height > vk->video_height) ? vk->video_height : vk->vp.height);
 
-         buffer            += 3 * (vp_height - 1) * vp_width;
-
-         switch (format)
-         {
-            case VK_FORMAT_B8G8R8A8_UNORM:
-               for (y = 0; y < (int) vp_height; y++,
-                     src += staging->stride, buffer -= 3 * vp_width)
-               {
-                  int x;
-                  for (x = 0; x < (int) vp_width; x++)
-                  {
-                     buffer[3 * x + 0] = src[4 * x + 0];
-                     buffer[3 * x + 1] = src[4 * x + 1];
-                     buffer[3 * x + 2] = src[4 * x + 2];
-                  }
-               }
-               break;
-
-            case VK_FORMAT_R8G8B8A8_UNORM:
-            case VK_FORMAT_A8B8G8R8_UNORM_PACK32:
-               for (y = 0; y < (int) vp_height; y++,
-                     src += staging->stride, buffer -= 3 * vp_width)
-               {
-                  int x;
-                  for (x = 0; x < (int) vp_width; x++)
-                  {
-                     buffer[3 * x + 2] = src[4 * x + 0];
-                     buffer[3 * x + 1] = src[4 * x + 1];
-                     buffer[3 * x + 0] = src[4 * x + 2];
-                  }
-               }
-               break;
-
-            default:
-               RARCH_ERR("[Vulkan]: Unexpected swapchain format.\n");
-               break;
-         }
-      }
       vulkan_destroy_texture(
             vk->context->device, staging);
    }
@@ -15,18 +15,170 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
 #ifdef HAVE_CONFIG_H
 #include "../config.h"
 #endif
 
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+
 #include "font_driver.h"
+#include "gfx_display.h"
 #include "video_thread_wrapper.h"
 
+/* Menus draw and measure the same labels every frame.
+ * Measured widths, and the shaped copies of right-to-left
+ * strings, are kept in small set associative caches (LRU
+ * within a set) instead of being redone each time. */
+#define FONT_CACHE_SET_BITS 7
+#define FONT_CACHE_SETS     (1 << FONT_CACHE_SET_BITS)
+#define FONT_CACHE_WAYS     4
+#define FONT_CACHE_MAX_LEN  512
+
+/* Labels often differ only in their last character,
+ * so take the set from the top bits of a multiplicative hash */
+#define FONT_CACHE_SET(hash) ((uint32_t)((hash) * 2654435761U) >> (32 - FONT_CACHE_SET_BITS))
+
+typedef struct font_cache_entry
+{
+   const void *font; /* NULL for shaped strings */
+   char *msg;        /* NULL if the entry is unused */
+   char *shaped;
+   size_t len;
+   uint32_t hash;
+   unsigned last_used;
+   float scale;
+   int width;
+} font_cache_entry_t;
+
+typedef struct font_cache
+{
+   font_cache_entry_t entries[FONT_CACHE_SETS * FONT_CACHE_WAYS];
+   unsigned stamp;
+} font_cache_t;
+
 /* TODO/FIXME - global */
 static void *video_font_driver = NULL;
 
+static font_cache_t font_width_cache;
+#ifdef HAVE_LANGEXTRA
+static font_cache_t font_shape_cache;
+#endif
+/* With threaded video, text is measured on both the
+ * main and the video thread */
+#ifdef HAVE_THREADS
+static slock_t *font_cache_lock = NULL;
+#endif
+static unsigned font_driver_count = 0;
+
+static INLINE void font_cache_lock_acquire(void)
+{
+#ifdef HAVE_THREADS
+   slock_lock(font_cache_lock);
+#endif
+}
+
+static INLINE void font_cache_lock_release(void)
+{
+#ifdef HAVE_THREADS
+   slock_unlock(font_cache_lock);
+#endif
+}
+
+static uint32_t font_cache_hash(const char *msg, size_t len)
+{
+   uint32_t hash = 5381;
+   while (len--)
+      hash = ((hash << 5) + hash) + (unsigned char)*msg++;
+   return hash;
+}
+
+static font_cache_entry_t *font_cache_find(font_cache_t *cache,
+      const void *font, const char *msg, size_t len,
+      uint32_t hash, float scale)
+{
+   unsigned i;
+   font_cache_entry_t *set = cache->entries
+      + FONT_CACHE_SET(hash) * FONT_CACHE_WAYS;
+
+   for (i = 0; i < FONT_CACHE_WAYS; i++)
+   {
+      if (     set[i].msg
+            && set[i].hash  == hash
+            && set[i].len   == len
+            && set[i].font  == font
+            && set[i].scale == scale
+            && !memcmp(set[i].msg, msg, len))
+      {
+         set[i].last_used = ++cache->stamp;
+         return &set[i];
+      }
+   }
+
+   return NULL;
+}
+
+static void font_cache_entry_free(font_cache_entry_t *entry)
+{
+   if (entry->msg)
+      free(entry->msg);
+   if (entry->shaped)
+      free(entry->shaped);
+   entry->msg    = NULL;
+   entry->shaped = NULL;
+   entry->font   = NULL;
+}
+
+/* Takes over the unused or least recently used entry of the set */
+static font_cache_entry_t *font_cache_insert(font_cache_t *cache,
+      const void *font, const char *msg, size_t len,
+      uint32_t hash, float scale)
+{
+   unsigned i;
+   font_cache_entry_t *set   = cache->entries
+      + FONT_CACHE_SET(hash) * FONT_CACHE_WAYS;
+   font_cache_entry_t *entry = &set[0];
+
+   for (i = 0; i < FONT_CACHE_WAYS; i++)
+   {
+      if (!set[i].msg)
+      {
+         entry = &set[i];
+         break;
+      }
+      if (     (cache->stamp - set[i].last_used)
+             > (cache->stamp - entry->last_used))
+         entry = &set[i];
+   }
+
+   font_cache_entry_free(entry);
+
+   if (!(entry->msg = (char*)malloc(len + 1)))
+      return NULL;
+   memcpy(entry->msg, msg, len);
+   entry->msg[len]  = '\0';
+   entry->font      = font;
+   entry->len       = len;
+   entry->hash      = hash;
+   entry->scale     = scale;
+   entry->width     = 0;
+   entry->last_used = ++cache->stamp;
+   return entry;
+}
+
+/* Drops the entries of one font, or all of them if @font is NULL */
+static void font_cache_clear(font_cache_t *cache, const void *font)
+{
+   unsigned i;
+   for (i = 0; i < FONT_CACHE_SETS * FONT_CACHE_WAYS; i++)
+      if (!font || cache->entries[i].font == font)
+         font_cache_entry_free(&cache->entries[i]);
+}
+
 int font_renderer_create_default(
       const font_renderer_driver_t **drv,
       void **handle, const char *font_path, unsigned font_size)
@@ -589,7 +741,7 @@ static INLINE unsigned font_get_arabic_replacement(
    const char*   prev           = src - 2;
    const char*   next           = src + 2;
 
-   if (IS_ARABIC(prev) && (prev >= start))
+   if ((prev >= start) && IS_ARABIC(prev))
    {
       unsigned char prev_id = GET_ID_ARABIC(prev);
 
@@ -760,6 +912,62 @@ static char* font_driver_reshape_msg(const char* msg, unsigned char *buffer, siz
 
    return (char*)dst_buffer;
 }
+
+/* Only strings with Hebrew or Arabic in them need reshaping.
+ * Their lead bytes never occur inside other characters. */
+static bool font_driver_msg_has_rtl(const char *msg)
+{
+   const unsigned char *src = (const unsigned char*)msg;
+
+   for (; *src; src++)
+      if (IS_RTL(src))
+         return true;
+
+   return false;
+}
+
+/* Same as font_driver_reshape_msg(), through the shaped string cache */
+static char *font_driver_get_shaped_msg(const char *msg,
+      unsigned char *buffer, size_t buffer_size)
+{
+   font_cache_entry_t *entry;
+   char *shaped   = NULL;
+   size_t len     = strlen(msg);
+   uint32_t hash;
+
+   if (len > FONT_CACHE_MAX_LEN)
+      return font_driver_reshape_msg(msg, buffer, buffer_size);
+
+   hash           = font_cache_hash(msg, len);
+
+   font_cache_lock_acquire();
+   if (     (entry = font_cache_find(&font_shape_cache,
+               NULL, msg, len, hash, 0.0f))
+         && entry->shaped)
+   {
+      size_t shaped_size = strlen(entry->shaped) + 1;
+
+      shaped = (buffer_size < shaped_size)
+         ? (char*)malloc(shaped_size)
+         : (char*)buffer;
+      if (shaped)
+         memcpy(shaped, entry->shaped, shaped_size);
+   }
+   font_cache_lock_release();
+
+   if (shaped)
+      return shaped;
+
+   shaped         = font_driver_reshape_msg(msg, buffer, buffer_size);
+
+   font_cache_lock_acquire();
+   if ((entry = font_cache_insert(&font_shape_cache,
+               NULL, msg, len, hash, 0.0f)))
+      entry->shaped = strdup(shaped);
+   font_cache_lock_release();
+
+   return shaped;
+}
 #endif
 
 void font_driver_render_msg(void *data, const char *msg,
@@ -770,16 +978,22 @@ void font_driver_render_msg(void *data, const char *msg,
 
    if (msg && *msg && font && font->renderer && font->renderer->render_msg)
    {
+      char *new_msg = (char*)msg;
 #ifdef HAVE_LANGEXTRA
       unsigned char tmp_buffer[64];
-      char *new_msg = font_driver_reshape_msg(msg, tmp_buffer, sizeof(tmp_buffer));
-#else
-      char *new_msg = (char*)msg;
+      if (font_driver_msg_has_rtl(msg))
+         new_msg = font_driver_get_shaped_msg(msg,
+               tmp_buffer, sizeof(tmp_buffer));
 #endif
+      /* Unless it only goes into a raster block,
+       * the text is drawn right away */
+      if (!font->block)
+         gfx_display_flush(disp_get_ptr());
       font->renderer->render_msg(data,
             font->renderer_data, new_msg, params);
 #ifdef HAVE_LANGEXTRA
-      if (new_msg != (char*)tmp_buffer)
+      if (     new_msg != msg
+            && new_msg != (char*)tmp_buffer)
          free(new_msg);
 #endif
    }
@@ -790,7 +1004,10 @@ void font_driver_bind_block(void *font_data, void *block)
    font_data_t *font = (font_data_t*)(font_data ? font_data : video_font_driver);
 
    if (font && font->renderer && font->renderer->bind_block)
+   {
       font->renderer->bind_block(font->renderer_data, block);
+      font->block = block;
+   }
 }
 
 /* Flushing is slow - only do it if font has actually been used */
@@ -801,6 +1018,7 @@ void font_flush(
 {
    if (font_data->raster_block.carr.coords.vertices == 0)
       return;
+   gfx_display_flush(disp_get_ptr());
    if (font_data->font && font_data->font->renderer && font_data->font->renderer->flush)
       font_data->font->renderer->flush(video_width, video_height, font_data->font->renderer_data);
    font_data->raster_block.carr.coords.vertices = 0;
@@ -813,7 +1031,36 @@ int font_driver_get_message_width(void *font_data,
    if (len == 0 && msg)
       len = strlen(msg);
    if (font && font->renderer && font->renderer->get_message_width)
-      return font->renderer->get_message_width(font->renderer_data, msg, len, scale);
+   {
+      font_cache_entry_t *entry;
+      uint32_t hash;
+      int width;
+
+      if (!msg || len > FONT_CACHE_MAX_LEN)
+         return font->renderer->get_message_width(
+               font->renderer_data, msg, len, scale);
+
+      hash = font_cache_hash(msg, len);
+
+      font_cache_lock_acquire();
+      entry = font_cache_find(&font_width_cache, font, msg, len, hash, scale);
+      width = entry ? entry->width : 0;
+      font_cache_lock_release();
+
+      if (entry)
+         return width;
+
+      width = font->renderer->get_message_width(
+            font->renderer_data, msg, len, scale);
+
+      font_cache_lock_acquire();
+      if ((entry = font_cache_insert(&font_width_cache,
+                  font, msg, len, hash, scale)))
+         entry->width = width;
+      font_cache_lock_release();
+
+      return width;
+   }
    return -1;
 }
 
@@ -887,6 +1134,23 @@ void font_driver_free(font_data_t *font)
       font->renderer      = NULL;
       font->renderer_data = NULL;
 
+      /* The next font may well get the same address */
+      font_cache_lock_acquire();
+      font_cache_clear(&font_width_cache, font);
+      font_cache_lock_release();
+
+      if (font_driver_count && --font_driver_count == 0)
+      {
+         font_cache_clear(&font_width_cache, NULL);
+#ifdef HAVE_LANGEXTRA
+         font_cache_clear(&font_shape_cache, NULL);
+#endif
+#ifdef HAVE_THREADS
+         slock_free(font_cache_lock);
+         font_cache_lock = NULL;
+#endif
+      }
+
       free(font);
    }
 }
@@ -919,7 +1183,13 @@ font_data_t *font_driver_init_first(
       {
          font->renderer      = (const font_renderer_t*)font_driver;
          font->renderer_data = font_handle;
+         font->block         = NULL;
          font->size          = font_size;
+#ifdef HAVE_THREADS
+         if (!font_cache_lock)
+            font_cache_lock  = slock_new();
+#endif
+         font_driver_count++;
          return font;
       }
    }
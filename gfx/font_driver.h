@@ -71,6 +71,8 @@ typedef struct
 {
    const font_renderer_t *renderer;
    void *renderer_data;
+   /* Raster block text is collected in, if any */
+   void *block;
    float size;
 } font_data_t;
 
@@ -24,12 +24,19 @@
 #include <string/stdstring.h>
 #include <features/features_cpu.h>
 #include <array/rbuf.h>
+#include <retro_inline.h>
 
 #include "gfx_animation.h"
 #include "../performance_counters.h"
 
 #define TICKER_SLOW_SPEED  1666666
 
+/* Smallest tag hash, in bits */
+#define TWEEN_BUCKET_BITS_MIN 6
+/* Killed tweens left in their groups before they get
+ * swept outside of gfx_animation_update() */
+#define TWEEN_DEAD_MAX        256
+
 static gfx_animation_t anim_st = {
    0,      /* ticker_idx            */
    0,      /* ticker_slow_idx       */
@@ -38,8 +45,16 @@ static gfx_animation_t anim_st = {
    0,      /* cur_time              */
    0,      /* old_time              */
    NULL,   /* updatetime_cb         */
-   NULL,   /* list                  */
+   NULL,   /* pool                  */
    NULL,   /* pending               */
+   NULL,   /* buckets               */
+   {{0}},  /* groups                */
+   0,      /* pool_size             */
+   0,      /* pool_used             */
+   0,      /* free_slot             */
+   0,      /* bucket_bits           */
+   0,      /* count                 */
+   0,      /* dead                  */
    0.0f,   /* delta_time            */
    0       /* flags                 */
 };
@@ -779,143 +794,412 @@ void gfx_animation_push_delayed(
    gfx_animation_timer_start(&delayed_animation->timer, &timer_entry);
 }
 
-bool gfx_animation_push(gfx_animation_ctx_entry_t *entry)
+static INLINE unsigned gfx_animation_tag_hash(uintptr_t tag, unsigned bits)
 {
-   struct tween t;
-   gfx_animation_t *p_anim = &anim_st;
+   /* Tags are mostly pointers, fold the upper half in
+    * and keep the top bits of a Fibonacci hash */
+   uint32_t h = (uint32_t)tag ^ (uint32_t)((uint64_t)tag >> 32);
+   return (uint32_t)(h * 2654435769u) >> (32 - bits);
+}
+
+static void gfx_animation_hash_link(gfx_animation_t *p_anim, unsigned slot)
+{
+   struct tween *t = &p_anim->pool[slot];
+   unsigned *head  = &p_anim->buckets[
+      gfx_animation_tag_hash(t->tag, p_anim->bucket_bits)];
+
+   t->prev         = 0;
+   t->next         = *head;
+   if (*head)
+      p_anim->pool[*head].prev = slot;
+   *head           = slot;
+}
+
+static void gfx_animation_hash_unlink(gfx_animation_t *p_anim, unsigned slot)
+{
+   struct tween *t = &p_anim->pool[slot];
+
+   if (t->prev)
+      p_anim->pool[t->prev].next = t->next;
+   else
+      p_anim->buckets[
+         gfx_animation_tag_hash(t->tag, p_anim->bucket_bits)] = t->next;
+   if (t->next)
+      p_anim->pool[t->next].prev = t->prev;
+}
+
+/* Keeps about one tween per bucket */
+static bool gfx_animation_hash_grow(gfx_animation_t *p_anim)
+{
+   unsigned i;
+   unsigned bits      = p_anim->bucket_bits
+      ? p_anim->bucket_bits + 1 : TWEEN_BUCKET_BITS_MIN;
+   unsigned *buckets  = (unsigned*)calloc((size_t)1 << bits,
+         sizeof(unsigned));
+
+   if (!buckets)
+      return false;
+
+   free(p_anim->buckets);
+   p_anim->buckets     = buckets;
+   p_anim->bucket_bits = bits;
+
+   for (i = 1; i < p_anim->pool_used; i++)
+      if (!p_anim->pool[i].deleted)
+         gfx_animation_hash_link(p_anim, i);
+
+   return true;
+}
+
+static unsigned gfx_animation_alloc_slot(gfx_animation_t *p_anim)
+{
+   unsigned slot;
+
+   if (p_anim->free_slot)
+   {
+      slot              = p_anim->free_slot;
+      p_anim->free_slot = p_anim->pool[slot].next;
+      return slot;
+   }
+
+   if (p_anim->pool_used >= p_anim->pool_size)
+   {
+      unsigned size      = p_anim->pool_size ? p_anim->pool_size * 2 : 64;
+      struct tween *pool = (struct tween*)realloc(p_anim->pool,
+            size * sizeof(*pool));
+      if (!pool)
+         return 0;
+      p_anim->pool       = pool;
+      p_anim->pool_size  = size;
+      if (!p_anim->pool_used)
+         p_anim->pool_used = 1;
+   }
+
+   return p_anim->pool_used++;
+}
+
+static void gfx_animation_free_slot(gfx_animation_t *p_anim, unsigned slot)
+{
+   p_anim->pool[slot].next = p_anim->free_slot;
+   p_anim->free_slot       = slot;
+   p_anim->dead--;
+}
+
+/* Takes a live tween out of the tag hash. Its slot is
+ * released once it is no longer held by a group */
+static void gfx_animation_retire(gfx_animation_t *p_anim, unsigned slot)
+{
+   gfx_animation_hash_unlink(p_anim, slot);
+   p_anim->pool[slot].deleted = true;
+   p_anim->count--;
+   p_anim->dead++;
+}
+
+static bool gfx_animation_group_append(struct tween_group *group,
+      unsigned slot, float duration, float initial_value, float delta_value)
+{
+   unsigned k;
+
+   if (group->count >= group->capacity)
+   {
+      unsigned capacity = group->capacity ? group->capacity * 2 : 16;
+      float *running    = (float*)realloc(group->running_since,
+            capacity * sizeof(float));
+      float *dur        = running ? (float*)realloc(group->duration,
+            capacity * sizeof(float)) : NULL;
+      float *initial    = dur     ? (float*)realloc(group->initial_value,
+            capacity * sizeof(float)) : NULL;
+      float *delta      = initial ? (float*)realloc(group->delta_value,
+            capacity * sizeof(float)) : NULL;
+      float *value      = delta   ? (float*)realloc(group->value,
+            capacity * sizeof(float)) : NULL;
+      unsigned *slots   = value   ? (unsigned*)realloc(group->slot,
+            capacity * sizeof(unsigned)) : NULL;
+
+      /* Arrays that did grow are kept, the old capacity stays valid */
+      if (running)
+         group->running_since = running;
+      if (dur)
+         group->duration      = dur;
+      if (initial)
+         group->initial_value = initial;
+      if (delta)
+         group->delta_value   = delta;
+      if (value)
+         group->value         = value;
+      if (!slots)
+         return false;
+      group->slot             = slots;
+      group->capacity         = capacity;
+   }
+
+   k                       = group->count++;
+   group->running_since[k] = 0.0f;
+   group->duration[k]      = duration;
+   group->initial_value[k] = initial_value;
+   group->delta_value[k]   = delta_value;
+   group->slot[k]          = slot;
+   return true;
+}
+
+/* Drops the killed tweens a group still holds, in order */
+static void gfx_animation_group_sweep(gfx_animation_t *p_anim,
+      struct tween_group *group)
+{
+   unsigned k, j;
+
+   for (k = j = 0; k < group->count; k++)
+   {
+      unsigned slot = group->slot[k];
+
+      if (p_anim->pool[slot].deleted)
+      {
+         gfx_animation_free_slot(p_anim, slot);
+         continue;
+      }
+
+      if (j != k)
+      {
+         group->running_since[j] = group->running_since[k];
+         group->duration[j]      = group->duration[k];
+         group->initial_value[j] = group->initial_value[k];
+         group->delta_value[j]   = group->delta_value[k];
+         group->slot[j]          = slot;
+      }
+      j++;
+   }
+
+   group->count = j;
+}
 
-   t.duration           = entry->duration;
-   t.running_since      = 0;
-   t.initial_value      = *entry->subject;
-   t.target_value       = entry->target_value;
-   t.subject            = entry->subject;
-   t.tag                = entry->tag;
-   t.cb                 = entry->cb;
-   t.userdata           = entry->userdata;
-   t.easing             = NULL;
-   t.deleted            = false;
-
-   switch (entry->easing_enum)
+#define TWEEN_GROUP_EASE(fn) \
+   for (k = 0; k < count; k++) \
+      value[k] = fn(running_since[k], initial_value[k], \
+            delta_value[k], duration[k])
+
+/* Advances every tween of one easing type. The easing
+ * function is fixed for the whole loop, so it gets inlined
+ * and the simpler curves vectorise */
+static void gfx_animation_group_update(gfx_animation_t *p_anim,
+      enum gfx_animation_easing_type easing, float delta_time)
+{
+   unsigned k, j;
+   struct tween_group *group = &p_anim->groups[easing];
+   unsigned count            = group->count;
+   float *running_since      = group->running_since;
+   float *duration           = group->duration;
+   float *initial_value      = group->initial_value;
+   float *delta_value        = group->delta_value;
+   float *value              = group->value;
+
+   if (!count)
+      return;
+
+   for (k = 0; k < count; k++)
+      running_since[k] += delta_time;
+
+   switch (easing)
    {
       case EASING_LINEAR:
-         t.easing       = &easing_linear;
+         TWEEN_GROUP_EASE(easing_linear);
          break;
-         /* Quad */
       case EASING_IN_QUAD:
-         t.easing       = &easing_in_quad;
+         TWEEN_GROUP_EASE(easing_in_quad);
          break;
       case EASING_OUT_QUAD:
-         t.easing       = &easing_out_quad;
+         TWEEN_GROUP_EASE(easing_out_quad);
          break;
       case EASING_IN_OUT_QUAD:
-         t.easing       = &easing_in_out_quad;
+         TWEEN_GROUP_EASE(easing_in_out_quad);
          break;
       case EASING_OUT_IN_QUAD:
-         t.easing       = &easing_out_in_quad;
+         TWEEN_GROUP_EASE(easing_out_in_quad);
          break;
-         /* Cubic */
       case EASING_IN_CUBIC:
-         t.easing       = &easing_in_cubic;
+         TWEEN_GROUP_EASE(easing_in_cubic);
          break;
       case EASING_OUT_CUBIC:
-         t.easing       = &easing_out_cubic;
+         TWEEN_GROUP_EASE(easing_out_cubic);
          break;
       case EASING_IN_OUT_CUBIC:
-         t.easing       = &easing_in_out_cubic;
+         TWEEN_GROUP_EASE(easing_in_out_cubic);
          break;
       case EASING_OUT_IN_CUBIC:
-         t.easing       = &easing_out_in_cubic;
+         TWEEN_GROUP_EASE(easing_out_in_cubic);
          break;
-         /* Quart */
       case EASING_IN_QUART:
-         t.easing       = &easing_in_quart;
+         TWEEN_GROUP_EASE(easing_in_quart);
          break;
       case EASING_OUT_QUART:
-         t.easing       = &easing_out_quart;
+         TWEEN_GROUP_EASE(easing_out_quart);
          break;
       case EASING_IN_OUT_QUART:
-         t.easing       = &easing_in_out_quart;
+         TWEEN_GROUP_EASE(easing_in_out_quart);
          break;
       case EASING_OUT_IN_QUART:
-         t.easing       = &easing_out_in_quart;
+         TWEEN_GROUP_EASE(easing_out_in_quart);
          break;
-         /* Quint */
       case EASING_IN_QUINT:
-         t.easing       = &easing_in_quint;
+         TWEEN_GROUP_EASE(easing_in_quint);
          break;
       case EASING_OUT_QUINT:
-         t.easing       = &easing_out_quint;
+         TWEEN_GROUP_EASE(easing_out_quint);
          break;
       case EASING_IN_OUT_QUINT:
-         t.easing       = &easing_in_out_quint;
+         TWEEN_GROUP_EASE(easing_in_out_quint);
          break;
       case EASING_OUT_IN_QUINT:
-         t.easing       = &easing_out_in_quint;
+         TWEEN_GROUP_EASE(easing_out_in_quint);
          break;
-         /* Sine */
       case EASING_IN_SINE:
-         t.easing       = &easing_in_sine;
+         TWEEN_GROUP_EASE(easing_in_sine);
          break;
       case EASING_OUT_SINE:
-         t.easing       = &easing_out_sine;
+         TWEEN_GROUP_EASE(easing_out_sine);
          break;
       case EASING_IN_OUT_SINE:
-         t.easing       = &easing_in_out_sine;
+         TWEEN_GROUP_EASE(easing_in_out_sine);
          break;
       case EASING_OUT_IN_SINE:
-         t.easing       = &easing_out_in_sine;
+         TWEEN_GROUP_EASE(easing_out_in_sine);
          break;
-         /* Expo */
       case EASING_IN_EXPO:
-         t.easing       = &easing_in_expo;
+         TWEEN_GROUP_EASE(easing_in_expo);
          break;
       case EASING_OUT_EXPO:
-         t.easing       = &easing_out_expo;
+         TWEEN_GROUP_EASE(easing_out_expo);
          break;
       case EASING_IN_OUT_EXPO:
-         t.easing       = &easing_in_out_expo;
+         TWEEN_GROUP_EASE(easing_in_out_expo);
          break;
       case EASING_OUT_IN_EXPO:
-         t.easing       = &easing_out_in_expo;
+         TWEEN_GROUP_EASE(easing_out_in_expo);
          break;
-         /* Circ */
       case EASING_IN_CIRC:
-         t.easing       = &easing_in_circ;
+         TWEEN_GROUP_EASE(easing_in_circ);
          break;
       case EASING_OUT_CIRC:
-         t.easing       = &easing_out_circ;
+         TWEEN_GROUP_EASE(easing_out_circ);
          break;
       case EASING_IN_OUT_CIRC:
-         t.easing       = &easing_in_out_circ;
+         TWEEN_GROUP_EASE(easing_in_out_circ);
          break;
       case EASING_OUT_IN_CIRC:
-         t.easing       = &easing_out_in_circ;
+         TWEEN_GROUP_EASE(easing_out_in_circ);
          break;
-         /* Bounce */
       case EASING_IN_BOUNCE:
-         t.easing       = &easing_in_bounce;
+         TWEEN_GROUP_EASE(easing_in_bounce);
          break;
       case EASING_OUT_BOUNCE:
-         t.easing       = &easing_out_bounce;
+         TWEEN_GROUP_EASE(easing_out_bounce);
          break;
       case EASING_IN_OUT_BOUNCE:
-         t.easing       = &easing_in_out_bounce;
+         TWEEN_GROUP_EASE(easing_in_out_bounce);
          break;
       case EASING_OUT_IN_BOUNCE:
-         t.easing       = &easing_out_in_bounce;
+         TWEEN_GROUP_EASE(easing_out_in_bounce);
          break;
       default:
          break;
    }
 
+   /* Write the values back and drop finished and killed
+    * tweens. Callbacks may kill tweens of this group, so
+    * the pool is looked up afresh for every tween; tweens
+    * they push are only pending and leave the arrays alone */
+   for (k = j = 0; k < count; k++)
+   {
+      unsigned slot   = group->slot[k];
+      struct tween *t = &p_anim->pool[slot];
+
+      if (t->deleted)
+      {
+         gfx_animation_free_slot(p_anim, slot);
+         continue;
+      }
+
+      if (running_since[k] >= duration[k])
+      {
+         tween_cb cb    = t->cb;
+         void *userdata = t->userdata;
+
+         *t->subject    = t->target_value;
+
+         gfx_animation_retire(p_anim, slot);
+         gfx_animation_free_slot(p_anim, slot);
+
+         if (cb)
+            cb(userdata);
+         continue;
+      }
+
+      *t->subject = value[k];
+
+      if (j != k)
+      {
+         running_since[j] = running_since[k];
+         duration[j]      = duration[k];
+         initial_value[j] = initial_value[k];
+         delta_value[j]   = delta_value[k];
+         group->slot[j]   = slot;
+      }
+      j++;
+   }
+
+   group->count = j;
+}
+
+bool gfx_animation_push(gfx_animation_ctx_entry_t *entry)
+{
+   unsigned slot;
+   struct tween *t;
+   gfx_animation_t *p_anim = &anim_st;
+   float initial_value     = *entry->subject;
+
    /* ignore born dead tweens */
-   if (!t.easing || t.duration == 0 || t.initial_value == t.target_value)
+   if (     (unsigned)entry->easing_enum >= EASING_LAST
+         || entry->duration == 0
+         || initial_value == entry->target_value)
       return false;
 
+   if (p_anim->count >= ((unsigned)1 << p_anim->bucket_bits)
+         || !p_anim->buckets)
+      if (!gfx_animation_hash_grow(p_anim))
+         return false;
+
+   if (!(slot = gfx_animation_alloc_slot(p_anim)))
+      return false;
+
+   t                    = &p_anim->pool[slot];
+   t->cb                = entry->cb;
+   t->userdata          = entry->userdata;
+   t->subject           = entry->subject;
+   t->tag               = entry->tag;
+   t->target_value      = entry->target_value;
+   t->easing            = (uint8_t)entry->easing_enum;
+   t->deleted           = false;
+
    if (p_anim->flags & GFX_ANIM_FLAG_IN_UPDATE)
-      RBUF_PUSH(p_anim->pending, t);
-   else
-      RBUF_PUSH(p_anim->list, t);
+   {
+      struct tween_pending pending;
+      pending.slot          = slot;
+      pending.duration      = entry->duration;
+      pending.initial_value = initial_value;
+      RBUF_PUSH(p_anim->pending, pending);
+   }
+   else if (!gfx_animation_group_append(
+            &p_anim->groups[entry->easing_enum], slot, entry->duration,
+            initial_value, entry->target_value - initial_value))
+   {
+      /* Back on the free list */
+      p_anim->pool[slot].deleted = true;
+      p_anim->dead++;
+      gfx_animation_free_slot(p_anim, slot);
+      return false;
+   }
+
+   gfx_animation_hash_link(p_anim, slot);
+   p_anim->count++;
 
    return true;
 }
@@ -930,6 +1214,7 @@ bool gfx_animation_update(
    unsigned i;
    gfx_animation_t *p_anim                     = &anim_st;
    const bool ticker_is_active                 = (p_anim->flags & GFX_ANIM_FLAG_TICKER_IS_ACTIVE) ? true : false;
+   bool clock_update                           = false;
 
    static retro_time_t last_clock_update       = 0;
    static retro_time_t last_ticker_update      = 0;
@@ -964,7 +1249,7 @@ bool gfx_animation_update(
    if (((p_anim->cur_time - last_clock_update) > 1000000) /* 1000000 us == 1 second */
          && timedate_enable)
    {
-      p_anim->flags                |= GFX_ANIM_FLAG_IS_ACTIVE;
+      clock_update                  = true;
       last_clock_update             = p_anim->cur_time;
    }
 
@@ -1034,61 +1319,33 @@ bool gfx_animation_update(
    }
 
    p_anim->flags           |=  GFX_ANIM_FLAG_IN_UPDATE;
-   p_anim->flags           &= ~GFX_ANIM_FLAG_PENDING_DELETES;
 
-   for (i = 0; i < RBUF_LEN(p_anim->list); i++)
-   {
-      struct tween *tween   = &p_anim->list[i];
+   for (i = 0; i < EASING_LAST; i++)
+      gfx_animation_group_update(p_anim,
+            (enum gfx_animation_easing_type)i, p_anim->delta_time);
 
-      if (tween->deleted)
-         continue;
-
-      tween->running_since += p_anim->delta_time;
-
-      *tween->subject       = tween->easing(
-            tween->running_since,
-            tween->initial_value,
-            tween->target_value - tween->initial_value,
-            tween->duration);
-
-      if (tween->running_since >= tween->duration)
-      {
-         *tween->subject = tween->target_value;
-
-         if (tween->cb)
-            tween->cb(tween->userdata);
-
-         RBUF_REMOVE(p_anim->list, i);
-         i--;
-      }
-   }
-
-   if (p_anim->flags & GFX_ANIM_FLAG_PENDING_DELETES)
+   for (i = 0; i < RBUF_LEN(p_anim->pending); i++)
    {
-      for (i = 0; i < RBUF_LEN(p_anim->list); i++)
+      struct tween_pending *pending = &p_anim->pending[i];
+      unsigned slot                 = pending->slot;
+      struct tween *t               = &p_anim->pool[slot];
+
+      /* Killed before it ever ran */
+      if (t->deleted)
+         gfx_animation_free_slot(p_anim, slot);
+      else if (!gfx_animation_group_append(&p_anim->groups[t->easing],
+               slot, pending->duration, pending->initial_value,
+               t->target_value - pending->initial_value))
       {
-         struct tween *tween = &p_anim->list[i];
-         if (tween->deleted)
-         {
-            RBUF_REMOVE(p_anim->list, i);
-            i--;
-         }
+         gfx_animation_retire(p_anim, slot);
+         gfx_animation_free_slot(p_anim, slot);
       }
-      p_anim->flags &= ~GFX_ANIM_FLAG_PENDING_DELETES;
-   }
-
-   if (RBUF_LEN(p_anim->pending) > 0)
-   {
-      size_t list_len    = RBUF_LEN(p_anim->list);
-      size_t pending_len = RBUF_LEN(p_anim->pending);
-      RBUF_RESIZE(p_anim->list, list_len + pending_len);
-      memcpy(p_anim->list + list_len, p_anim->pending,
-            sizeof(*p_anim->pending) * pending_len);
-      RBUF_CLEAR(p_anim->pending);
    }
+   RBUF_CLEAR(p_anim->pending);
 
    p_anim->flags              &= ~GFX_ANIM_FLAG_IN_UPDATE;
-   if (RBUF_LEN(p_anim->list) > 0)
+   /* The clock counts as an animation once a second */
+   if (p_anim->count > 0 || clock_update)
 	   p_anim->flags      |=  GFX_ANIM_FLAG_IS_ACTIVE;
    else
 	   p_anim->flags      &= ~GFX_ANIM_FLAG_IS_ACTIVE;
@@ -1587,54 +1844,35 @@ end:
 
 bool gfx_animation_kill_by_tag(uintptr_t *tag)
 {
-   unsigned i;
+   unsigned slot;
    gfx_animation_t *p_anim = &anim_st;
 
    if (!tag || *tag == (uintptr_t)-1)
       return false;
 
-   /* Scan animation list */
-   for (i = 0; i < RBUF_LEN(p_anim->list); ++i)
-   {
-      struct tween *t = &p_anim->list[i];
+   if (!p_anim->buckets)
+      return true;
 
-      if (t->tag != *tag)
-         continue;
-
-      /* If we are currently inside gfx_animation_update(),
-       * we are already looping over p_anim->list entries
-       * > Cannot modify p_anim->list now, so schedule a
-       *   delete for when the gfx_animation_update() loop
-       *   is complete */
-      if (p_anim->flags & GFX_ANIM_FLAG_IN_UPDATE)
-      {
-         t->deleted              = true;
-         p_anim->flags          |= GFX_ANIM_FLAG_PENDING_DELETES;
-      }
-      else
-      {
-         RBUF_REMOVE(p_anim->list, i);
-         --i;
-      }
+   /* Only marks the tweens dead, the groups (or the pending
+    * list, inside gfx_animation_update()) drop them later */
+   slot = p_anim->buckets[gfx_animation_tag_hash(*tag, p_anim->bucket_bits)];
+   while (slot)
+   {
+      unsigned next = p_anim->pool[slot].next;
+      if (p_anim->pool[slot].tag == *tag)
+         gfx_animation_retire(p_anim, slot);
+      slot          = next;
    }
 
-   /* If we are currently inside gfx_animation_update(),
-    * also have to scan *pending* animation list
-    * (otherwise any entries that are simultaneously added
-    * and deleted inside gfx_animation_update() won't get
-    * deleted at all, producing utter chaos) */
-   if (p_anim->flags & GFX_ANIM_FLAG_IN_UPDATE)
+   /* Tweens only get killed and pushed while nothing
+    * updates them (e.g. menu drivers run without the
+    * menu being shown), keep the groups from filling up */
+   if (     p_anim->dead > TWEEN_DEAD_MAX
+         && !(p_anim->flags & GFX_ANIM_FLAG_IN_UPDATE))
    {
-      for (i = 0; i < RBUF_LEN(p_anim->pending); ++i)
-      {
-         struct tween *t = &p_anim->pending[i];
-
-         if (t->tag != *tag)
-            continue;
-
-         RBUF_REMOVE(p_anim->pending, i);
-         --i;
-      }
+      unsigned i;
+      for (i = 0; i < EASING_LAST; i++)
+         gfx_animation_group_sweep(p_anim, &p_anim->groups[i]);
    }
 
    return true;
@@ -1642,10 +1880,22 @@ bool gfx_animation_kill_by_tag(uintptr_t *tag)
 
 void gfx_animation_deinit(void)
 {
+   unsigned i;
    gfx_animation_t *p_anim = &anim_st;
    if (!p_anim)
       return;
-   RBUF_FREE(p_anim->list);
+   for (i = 0; i < EASING_LAST; i++)
+   {
+      struct tween_group *group = &p_anim->groups[i];
+      free(group->running_since);
+      free(group->duration);
+      free(group->initial_value);
+      free(group->delta_value);
+      free(group->value);
+      free(group->slot);
+   }
+   free(p_anim->pool);
+   free(p_anim->buckets);
    RBUF_FREE(p_anim->pending);
    if (p_anim->updatetime_cb)
       p_anim->updatetime_cb = NULL;
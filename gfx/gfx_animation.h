@@ -103,10 +103,9 @@ enum gfx_animation_ticker_type
 
 enum gfx_animation_flags
 {
-   GFX_ANIM_FLAG_PENDING_DELETES    = (1 << 0),
-   GFX_ANIM_FLAG_IN_UPDATE          = (1 << 1),
-   GFX_ANIM_FLAG_IS_ACTIVE          = (1 << 2),
-   GFX_ANIM_FLAG_TICKER_IS_ACTIVE   = (1 << 3)
+   GFX_ANIM_FLAG_IN_UPDATE          = (1 << 0),
+   GFX_ANIM_FLAG_IS_ACTIVE          = (1 << 1),
+   GFX_ANIM_FLAG_TICKER_IS_ACTIVE   = (1 << 2)
 };
 
 typedef void  (*tween_cb)  (void*);
@@ -203,20 +202,46 @@ typedef struct gfx_delayed_animation
 
 typedef float (*easing_cb) (float, float, float, float);
 
+/* Per-tween data that the update loop only touches
+ * when writing back or finishing a tween. Tweens are
+ * slots in a pool, recycled through a free list;
+ * slot 0 is never used so that 0 can mean 'none' */
 struct tween
 {
-   easing_cb   easing;
    tween_cb    cb;
    void        *userdata;
+   float       *subject;
    uintptr_t   tag;
-   float       duration;
-   float       running_since;
-   float       initial_value;
    float       target_value;
-   float       *subject;
+   unsigned    next;        /* Next slot in the tag bucket (or free list) */
+   unsigned    prev;        /* Previous slot in the tag bucket */
+   uint8_t     easing;
    bool        deleted;
 };
 
+/* Running tweens sharing one easing function, as
+ * parallel arrays so they can be stepped in one pass */
+struct tween_group
+{
+   float       *running_since;
+   float       *duration;
+   float       *initial_value;
+   float       *delta_value;
+   float       *value;      /* Eased values of the current update */
+   unsigned    *slot;
+   unsigned    count;
+   unsigned    capacity;
+};
+
+/* Tween pushed from inside gfx_animation_update(),
+ * added to its group once the update is done */
+struct tween_pending
+{
+   unsigned    slot;
+   float       duration;
+   float       initial_value;
+};
+
 struct gfx_animation
 {
    uint64_t ticker_idx;            /* updated every TICKER_SPEED us */
@@ -227,8 +252,17 @@ struct gfx_animation
    retro_time_t old_time;
    update_time_cb updatetime_cb;   /* ptr alignment */
                                    /* By default, this should be a NOOP */
-   struct tween* list;
-   struct tween* pending;
+   struct tween *pool;
+   struct tween_pending *pending;  /* RBUF */
+   unsigned *buckets;              /* Tag hash, heads of slot chains */
+   struct tween_group groups[EASING_LAST];
+
+   unsigned pool_size;
+   unsigned pool_used;
+   unsigned free_slot;
+   unsigned bucket_bits;
+   unsigned count;                 /* Live tweens, pending ones included */
+   unsigned dead;                  /* Killed tweens still held by a group */
 
    float delta_time;
 
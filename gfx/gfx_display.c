@@ -1175,9 +1175,362 @@ void gfx_display_init_white_texture(void)
          TEXTURE_FILTER_NEAREST, &gfx_white_texture);
 }
 
+/* Quad batching
+ *
+ * Menus and widgets draw hundreds of small quads per frame, each
+ * as its own draw call with its own viewport. The display driver
+ * handed out to them is a thin wrapper around the real one: untransformed,
+ * blended quads that use the same texture are collected into one
+ * triangle list in screen space and sent to the real driver as a
+ * single draw with a full-screen viewport. Anything else first
+ * sends the pending quads, so drawing order is unchanged.
+ *
+ * Only drivers that draw explicit vertices and triangle lists the
+ * same way they draw viewport quads take part, the others are
+ * just counted. */
+#define GFX_DISPLAY_BATCH_MIN_QUADS 64
+
+typedef struct gfx_display_batch
+{
+   float *vertex;
+   float *tex_coord;
+   float *color;
+   void *data;
+   gfx_display_ctx_driver_t *backend;
+   uintptr_t texture;
+   size_t capacity;  /* in quads */
+   size_t quads;
+   unsigned video_width;
+   unsigned video_height;
+   bool enabled;
+   /* The driver truncates the viewport to whole pixels */
+   bool snap;
+   /* Blending as last requested by the caller; the driver
+    * only sees changes while nothing is pending */
+   bool blend;
+} gfx_display_batch_t;
+
+static gfx_display_batch_t gfx_display_batch_st;
+static gfx_display_ctx_driver_t gfx_display_ctx_batch;
+
+static void gfx_display_count_draw(gfx_display_t *p_disp,
+      unsigned vertices, unsigned batched_quads)
+{
+   uint64_t frame_count = video_state_get_ptr()->frame_count;
+
+   if (p_disp->stats_frame != frame_count)
+   {
+      p_disp->stats       = p_disp->frame_stats;
+      p_disp->stats_frame = frame_count;
+      memset(&p_disp->frame_stats, 0, sizeof(p_disp->frame_stats));
+   }
+
+   p_disp->frame_stats.draw_calls++;
+   p_disp->frame_stats.vertices      += vertices;
+   p_disp->frame_stats.batched_quads += batched_quads;
+}
+
+static void gfx_display_batch_flush(gfx_display_batch_t *batch)
+{
+   gfx_display_ctx_draw_t draw;
+   struct video_coords coords;
+   gfx_display_ctx_driver_t *backend = batch->backend;
+
+   if (!batch->quads)
+      return;
+
+   coords.vertices         = (unsigned)(batch->quads * 6);
+   coords.vertex           = batch->vertex;
+   coords.tex_coord        = batch->tex_coord;
+   coords.lut_tex_coord    = batch->tex_coord;
+   coords.color            = batch->color;
+
+   draw.color              = NULL;
+   draw.vertex             = NULL;
+   draw.tex_coord          = NULL;
+   draw.backend_data       = NULL;
+   draw.coords             = &coords;
+   draw.matrix_data        = NULL;
+   draw.texture            = batch->texture;
+   draw.vertex_count       = coords.vertices;
+   draw.backend_data_size  = 0;
+   draw.width              = batch->video_width;
+   draw.height             = batch->video_height;
+   draw.pipeline_id        = 0;
+   draw.x                  = 0.0f;
+   draw.y                  = 0.0f;
+   draw.rotation           = 0.0f;
+   draw.scale_factor       = 1.0f;
+   draw.prim_type          = GFX_DISPLAY_PRIM_TRIANGLES;
+   draw.pipeline_active    = false;
+
+   /* Quads are only collected with blending on,
+    * the caller may have turned it off since */
+   backend->blend_begin(batch->data);
+   backend->draw(&draw, batch->data,
+         batch->video_width, batch->video_height);
+   if (!batch->blend)
+      backend->blend_end(batch->data);
+
+   gfx_display_count_draw(&dispgfx_st, coords.vertices,
+         (unsigned)batch->quads);
+   batch->quads            = 0;
+}
+
+static bool gfx_display_batch_can_merge(gfx_display_batch_t *batch,
+      gfx_display_ctx_draw_t *draw, void *data)
+{
+   const struct video_coords *coords = draw->coords;
+
+   if (     !batch->enabled
+         || !batch->blend
+         || !coords
+         ||  coords->vertices != 4
+         ||  draw->prim_type  != GFX_DISPLAY_PRIM_TRIANGLESTRIP
+         ||  draw->pipeline_id
+         || !draw->texture
+         || !draw->width
+         || !draw->height)
+      return false;
+
+   /* The viewport is folded into the vertices, which only
+    * works if the matrix does nothing but map it to the screen */
+   if (draw->matrix_data)
+   {
+      const math_matrix_4x4 *mvp = (const math_matrix_4x4*)
+         batch->backend->get_default_mvp(data);
+      if (     !mvp
+            || (     draw->matrix_data != (const void*)mvp
+                  && memcmp(draw->matrix_data, mvp->data,
+                     sizeof(mvp->data))))
+         return false;
+   }
+
+   /* The viewport clips, the full-screen one would not */
+   if (coords->vertex)
+   {
+      unsigned i;
+      for (i = 0; i < 8; i++)
+         if (coords->vertex[i] < 0.0f || coords->vertex[i] > 1.0f)
+            return false;
+   }
+
+   return true;
+}
+
+static bool gfx_display_batch_add(gfx_display_batch_t *batch,
+      gfx_display_ctx_draw_t *draw, void *data,
+      unsigned video_width, unsigned video_height)
+{
+   /* Strip order is bottom left, bottom right, top left, top right */
+   static const unsigned strip_to_list[6] = { 0, 1, 2, 2, 1, 3 };
+   static const float white[16]           = {
+      1.0f, 1.0f, 1.0f, 1.0f,
+      1.0f, 1.0f, 1.0f, 1.0f,
+      1.0f, 1.0f, 1.0f, 1.0f,
+      1.0f, 1.0f, 1.0f, 1.0f,
+   };
+   unsigned i;
+   float *vertex, *tex_coord, *color;
+   const struct video_coords *coords = draw->coords;
+   const float *src_vertex           = coords->vertex
+      ? coords->vertex    : batch->backend->get_default_vertices();
+   const float *src_tex_coord        = coords->tex_coord
+      ? coords->tex_coord : batch->backend->get_default_tex_coords();
+   const float *src_color            = coords->color
+      ? coords->color     : white;
+   float x                           = draw->x;
+   float y                           = draw->y;
+   float scale_x, scale_y;
+
+   if (     batch->quads
+         && (     batch->texture      != draw->texture
+               || batch->data         != data
+               || batch->video_width  != video_width
+               || batch->video_height != video_height))
+      gfx_display_batch_flush(batch);
+
+   if (batch->quads == batch->capacity)
+   {
+      size_t capacity = batch->capacity
+         ? batch->capacity * 2 : GFX_DISPLAY_BATCH_MIN_QUADS;
+      float *new_vertex, *new_tex_coord, *new_color;
+
+      if (!(new_vertex = (float*)realloc(batch->vertex,
+                  capacity * 6 * 2 * sizeof(float))))
+         return false;
+      batch->vertex    = new_vertex;
+      if (!(new_tex_coord = (float*)realloc(batch->tex_coord,
+                  capacity * 6 * 2 * sizeof(float))))
+         return false;
+      batch->tex_coord = new_tex_coord;
+      if (!(new_color = (float*)realloc(batch->color,
+                  capacity * 6 * 4 * sizeof(float))))
+         return false;
+      batch->color     = new_color;
+      batch->capacity  = capacity;
+   }
+
+   if (batch->snap)
+   {
+      x = (float)(int)x;
+      y = (float)(int)y;
+   }
+
+   scale_x             = (float)draw->width  / video_width;
+   scale_y             = (float)draw->height / video_height;
+   x                  /= video_width;
+   y                  /= video_height;
+
+   vertex              = batch->vertex    + batch->quads * 6 * 2;
+   tex_coord           = batch->tex_coord + batch->quads * 6 * 2;
+   color               = batch->color     + batch->quads * 6 * 4;
+
+   for (i = 0; i < 6; i++)
+   {
+      unsigned k       = strip_to_list[i];
+      *vertex++        = x + src_vertex[k * 2]     * scale_x;
+      *vertex++        = y + src_vertex[k * 2 + 1] * scale_y;
+      *tex_coord++     = src_tex_coord[k * 2];
+      *tex_coord++     = src_tex_coord[k * 2 + 1];
+      memcpy(color, src_color + k * 4, 4 * sizeof(float));
+      color           += 4;
+   }
+
+   batch->texture      = draw->texture;
+   batch->data         = data;
+   batch->video_width  = video_width;
+   batch->video_height = video_height;
+   batch->quads++;
+   return true;
+}
+
+static void gfx_display_batch_draw(gfx_display_ctx_draw_t *draw,
+      void *data, unsigned video_width, unsigned video_height)
+{
+   gfx_display_batch_t *batch = &gfx_display_batch_st;
+
+   if (!draw)
+      return;
+
+   if (     gfx_display_batch_can_merge(batch, draw, data)
+         && gfx_display_batch_add(batch, draw, data,
+            video_width, video_height))
+      return;
+
+   gfx_display_batch_flush(batch);
+   batch->backend->draw(draw, data, video_width, video_height);
+   gfx_display_count_draw(&dispgfx_st,
+         draw->coords ? draw->coords->vertices : 0, 0);
+}
+
+static void gfx_display_batch_draw_pipeline(gfx_display_ctx_draw_t *draw,
+      gfx_display_t *p_disp,
+      void *data, unsigned video_width, unsigned video_height)
+{
+   gfx_display_batch_flush(&gfx_display_batch_st);
+   /* Menu shaders are animated */
+   dispgfx_st.flags |= GFX_DISP_FLAG_ANIMATED;
+   gfx_display_batch_st.backend->draw_pipeline(draw, p_disp,
+         data, video_width, video_height);
+}
+
+static void gfx_display_batch_blend_begin(void *data)
+{
+   gfx_display_batch_t *batch = &gfx_display_batch_st;
+   batch->blend               = true;
+   if (!batch->quads)
+      batch->backend->blend_begin(data);
+}
+
+static void gfx_display_batch_blend_end(void *data)
+{
+   gfx_display_batch_t *batch = &gfx_display_batch_st;
+   batch->blend               = false;
+   if (!batch->quads)
+      batch->backend->blend_end(data);
+}
+
+static void gfx_display_batch_scissor_begin(void *data,
+      unsigned video_width, unsigned video_height,
+      int x, int y, unsigned width, unsigned height)
+{
+   gfx_display_batch_flush(&gfx_display_batch_st);
+   gfx_display_batch_st.backend->scissor_begin(data,
+         video_width, video_height, x, y, width, height);
+}
+
+static void gfx_display_batch_scissor_end(void *data,
+      unsigned video_width, unsigned video_height)
+{
+   gfx_display_batch_flush(&gfx_display_batch_st);
+   gfx_display_batch_st.backend->scissor_end(data,
+         video_width, video_height);
+}
+
+/* Returns the wrapper the rest of RetroArch should use
+ * in place of @backend */
+static gfx_display_ctx_driver_t *gfx_display_batch_init(
+      gfx_display_ctx_driver_t *backend)
+{
+   gfx_display_batch_t *batch   = &gfx_display_batch_st;
+   gfx_display_ctx_driver_t *ctx = &gfx_display_ctx_batch;
+
+   batch->backend               = backend;
+   batch->quads                 = 0;
+   batch->blend                 = false;
+   batch->snap                  = backend->type != GFX_VIDEO_DRIVER_VULKAN;
+
+   switch (backend->type)
+   {
+#ifndef MALI_BUG
+      case GFX_VIDEO_DRIVER_OPENGL:
+#endif
+      case GFX_VIDEO_DRIVER_OPENGL_CORE:
+      case GFX_VIDEO_DRIVER_VULKAN:
+         batch->enabled         =
+               backend->draw
+            && backend->blend_begin
+            && backend->blend_end
+            && backend->get_default_mvp
+            && backend->get_default_vertices
+            && backend->get_default_tex_coords;
+         break;
+      default:
+         batch->enabled         = false;
+         break;
+   }
+
+   *ctx                         = *backend;
+   if (backend->draw)
+      ctx->draw                 = gfx_display_batch_draw;
+   if (backend->draw_pipeline)
+      ctx->draw_pipeline        = gfx_display_batch_draw_pipeline;
+   if (backend->blend_begin)
+      ctx->blend_begin          = gfx_display_batch_blend_begin;
+   if (backend->blend_end)
+      ctx->blend_end            = gfx_display_batch_blend_end;
+   if (backend->scissor_begin)
+      ctx->scissor_begin        = gfx_display_batch_scissor_begin;
+   if (backend->scissor_end)
+      ctx->scissor_end          = gfx_display_batch_scissor_end;
+
+   if (batch->enabled)
+      RARCH_LOG("[Display]: Batching quads for \"%s\".\n", backend->ident);
+
+   return ctx;
+}
+
+void gfx_display_flush(gfx_display_t *p_disp)
+{
+   if (p_disp->dispctx)
+      gfx_display_batch_flush(&gfx_display_batch_st);
+}
+
 void gfx_display_free(void)
 {
    gfx_display_t *p_disp       = &dispgfx_st;
+   gfx_display_batch_t *batch  = &gfx_display_batch_st;
    video_coord_array_free(&p_disp->dispca);
 
    p_disp->flags              &= ~(GFX_DISP_FLAG_MSG_FORCE
@@ -1188,6 +1541,16 @@ void gfx_display_free(void)
    p_disp->framebuf_height     = 0;
    p_disp->framebuf_pitch      = 0;
    p_disp->dispctx             = NULL;
+
+   /* The driver may already be gone, drop whatever is pending */
+   free(batch->vertex);
+   free(batch->tex_coord);
+   free(batch->color);
+   batch->vertex               = NULL;
+   batch->tex_coord            = NULL;
+   batch->color                = NULL;
+   batch->capacity             = 0;
+   batch->quads                = 0;
 }
 
 void gfx_display_init(void)
@@ -1217,7 +1580,7 @@ bool gfx_display_init_first_driver(gfx_display_t *p_disp,
             && (!string_is_equal(video_driver, ident)))
          continue;
       RARCH_LOG("[Display]: Found display driver: \"%s\".\n", ident);
-      p_disp->dispctx = dispctx;
+      p_disp->dispctx = gfx_display_batch_init(dispctx);
       return true;
    }
    return false;
@@ -72,7 +72,13 @@ enum gfx_display_flags
 {
    GFX_DISP_FLAG_HAS_WINDOWED     = (1 << 0),
    GFX_DISP_FLAG_MSG_FORCE        = (1 << 1),
-   GFX_DISP_FLAG_FB_DIRTY         = (1 << 2)
+   GFX_DISP_FLAG_FB_DIRTY         = (1 << 2),
+   /* Something on screen changed since the last frame
+    * that was presented */
+   GFX_DISP_FLAG_DAMAGED          = (1 << 3),
+   /* The last frame drew something that changes every
+    * frame (scrolling text, shader backgrounds) */
+   GFX_DISP_FLAG_ANIMATED         = (1 << 4)
 };
 
 enum menu_driver_id_type
@@ -188,11 +194,26 @@ typedef struct gfx_display_ctx_powerstate
    bool charging;
 } gfx_display_ctx_powerstate_t;
 
+typedef struct gfx_display_stats
+{
+   unsigned draw_calls;
+   unsigned vertices;
+   /* Quads that were merged into batched draw calls */
+   unsigned batched_quads;
+} gfx_display_stats_t;
+
 struct gfx_display
 {
    gfx_display_ctx_driver_t *dispctx;
    video_coord_array_t dispca; /* ptr alignment */
 
+   /* Video frame the counters below belong to */
+   uint64_t stats_frame;
+   /* Backend work of the last frame that drew anything,
+    * and of the frame being drawn */
+   gfx_display_stats_t stats;
+   gfx_display_stats_t frame_stats;
+
    /* Width, height and pitch of the display framebuffer */
    size_t   framebuf_pitch;
    unsigned framebuf_width;
@@ -210,6 +231,16 @@ void gfx_display_free(void);
 
 void gfx_display_init(void);
 
+/**
+ * gfx_display_flush:
+ *
+ * Sends the quads collected so far to the display driver.
+ * Anything that draws to the screen without going through
+ * the display driver (text, most notably) has to call this
+ * first, so that it ends up on top of the quads drawn before it.
+ **/
+void gfx_display_flush(gfx_display_t *p_disp);
+
 void gfx_display_draw_cursor(
       gfx_display_t *p_disp,
       void *userdata,
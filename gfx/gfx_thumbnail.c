@@ -24,6 +24,7 @@
 #include <string.h>
 #include <ctype.h>
 
+#include <array/rhmap.h>
 #include <features/features_cpu.h>
 #include <file/file_path.h>
 #include <string/stdstring.h>
@@ -33,19 +34,64 @@
 
 #include "gfx_thumbnail.h"
 
+#include "../configuration.h"
+#include "../msg_hash.h"
 #include "../tasks/tasks_internal.h"
 
 #define DEFAULT_GFX_THUMBNAIL_STREAM_DELAY  83.333333f
 #define DEFAULT_GFX_THUMBNAIL_FADE_DURATION 166.66667f
 
 /* Utility structure, sent as userdata when pushing
- * an image load */
+ * an image load
+ * > 'path' is only set when the image should be
+ *   added to the thumbnail cache */
 typedef struct
 {
    uint64_t list_id;
    gfx_thumbnail_t *thumbnail;
+   char *path;
+   int32_t file_size;
+   unsigned upscale_threshold;
+   unsigned max_width;
+   unsigned max_height;
+   bool supports_rgba;
 } gfx_thumbnail_tag_t;
 
+enum gfx_thumbnail_cache_lru_type
+{
+   GFX_THUMB_CACHE_LRU_CPU = 0,
+   GFX_THUMB_CACHE_LRU_GPU,
+   GFX_THUMB_CACHE_LRU_LAST
+};
+
+/* A decoded thumbnail, identified by file path,
+ * file size and the parameters it was loaded with
+ * (including the box it was shrunk to fit)
+ * > 'image.pixels' is NULL once the image has been
+ *   evicted, 'texture' is 0 when it is not uploaded
+ * > 'refs' counts the thumbnails currently showing
+ *   the texture; it cannot be unloaded until they
+ *   are all reset
+ * > 'next' chains entries with the same path,
+ *   'texture_next' those with the same texture key */
+struct gfx_thumbnail_cache_entry
+{
+   struct texture_image image;
+   uintptr_t texture;
+   struct gfx_thumbnail_cache_entry *next;
+   struct gfx_thumbnail_cache_entry *texture_next;
+   struct gfx_thumbnail_cache_entry *lru_prev[GFX_THUMB_CACHE_LRU_LAST];
+   struct gfx_thumbnail_cache_entry *lru_next[GFX_THUMB_CACHE_LRU_LAST];
+   char *path;
+   uint32_t hash;
+   int32_t file_size;
+   unsigned upscale_threshold;
+   unsigned max_width;
+   unsigned max_height;
+   unsigned refs;
+   bool supports_rgba;
+};
+
 static gfx_thumbnail_state_t gfx_thumb_st = {0}; /* uint64_t alignment */
 
 gfx_thumbnail_state_t *gfx_thumb_get_ptr(void)
@@ -138,6 +184,415 @@ static void gfx_thumbnail_init_fade(
    }
 }
 
+/* Thumbnail cache */
+
+static size_t gfx_thumbnail_cache_cpu_size(
+      const struct gfx_thumbnail_cache_entry *entry)
+{
+   return (size_t)entry->image.width * entry->image.height
+      * sizeof(uint32_t);
+}
+
+/* Textures are loaded with mipmaps, which add
+ * another third */
+static size_t gfx_thumbnail_cache_gpu_size(
+      const struct gfx_thumbnail_cache_entry *entry)
+{
+   return gfx_thumbnail_cache_cpu_size(entry) / 3 * 4;
+}
+
+/* Map keys must be non-zero */
+static uint32_t gfx_thumbnail_cache_hash(const char *path)
+{
+   uint32_t hash = msg_hash_calculate(path);
+   return hash ? hash : 1;
+}
+
+static uint32_t gfx_thumbnail_cache_texture_key(uintptr_t texture)
+{
+   /* Split shift, as uintptr_t may be 32 bits wide */
+   uint32_t key = (uint32_t)(texture ^ (texture >> 16 >> 16));
+   return key ? key : 1;
+}
+
+static gfx_thumbnail_cache_lru_t *gfx_thumbnail_cache_lru(
+      gfx_thumbnail_state_t *p_gfx_thumb,
+      enum gfx_thumbnail_cache_lru_type type)
+{
+   return (type == GFX_THUMB_CACHE_LRU_CPU)
+      ? &p_gfx_thumb->cache_cpu_lru
+      : &p_gfx_thumb->cache_gpu_lru;
+}
+
+/* Adds an entry to the recently used end of a list */
+static void gfx_thumbnail_cache_lru_push(
+      gfx_thumbnail_state_t *p_gfx_thumb,
+      enum gfx_thumbnail_cache_lru_type type,
+      struct gfx_thumbnail_cache_entry *entry)
+{
+   gfx_thumbnail_cache_lru_t *lru = gfx_thumbnail_cache_lru(
+         p_gfx_thumb, type);
+
+   entry->lru_prev[type] = lru->newest;
+   entry->lru_next[type] = NULL;
+   if (lru->newest)
+      lru->newest->lru_next[type] = entry;
+   else
+      lru->oldest                 = entry;
+   lru->newest                    = entry;
+}
+
+static void gfx_thumbnail_cache_lru_unlink(
+      gfx_thumbnail_state_t *p_gfx_thumb,
+      enum gfx_thumbnail_cache_lru_type type,
+      struct gfx_thumbnail_cache_entry *entry)
+{
+   gfx_thumbnail_cache_lru_t *lru = gfx_thumbnail_cache_lru(
+         p_gfx_thumb, type);
+
+   if (entry->lru_prev[type])
+      entry->lru_prev[type]->lru_next[type] = entry->lru_next[type];
+   else
+      lru->oldest                           = entry->lru_next[type];
+   if (entry->lru_next[type])
+      entry->lru_next[type]->lru_prev[type] = entry->lru_prev[type];
+   else
+      lru->newest                           = entry->lru_prev[type];
+   entry->lru_prev[type] = NULL;
+   entry->lru_next[type] = NULL;
+}
+
+static struct gfx_thumbnail_cache_entry *gfx_thumbnail_cache_find(
+      gfx_thumbnail_state_t *p_gfx_thumb,
+      const char *path, int32_t file_size,
+      unsigned upscale_threshold, unsigned max_width,
+      unsigned max_height, bool supports_rgba)
+{
+   struct gfx_thumbnail_cache_entry *entry = NULL;
+
+   if (!p_gfx_thumb->cache_map)
+      return NULL;
+
+   for (entry = RHMAP_GET_FULL(p_gfx_thumb->cache_map,
+            gfx_thumbnail_cache_hash(path), path);
+         entry; entry = entry->next)
+   {
+      if (     (entry->file_size         == file_size)
+            && (entry->upscale_threshold == upscale_threshold)
+            && (entry->max_width         == max_width)
+            && (entry->max_height        == max_height)
+            && (entry->supports_rgba     == supports_rgba))
+         return entry;
+   }
+
+   return NULL;
+}
+
+/* Removes an entry that holds neither an image
+ * nor a texture */
+static void gfx_thumbnail_cache_remove(
+      gfx_thumbnail_state_t *p_gfx_thumb,
+      struct gfx_thumbnail_cache_entry *entry)
+{
+   struct gfx_thumbnail_cache_entry **link =
+      RHMAP_PTR_FULL(p_gfx_thumb->cache_map, entry->hash, entry->path);
+
+   while (*link != entry)
+      link = &(*link)->next;
+   *link = entry->next;
+
+   if (!RHMAP_GET_FULL(p_gfx_thumb->cache_map, entry->hash, entry->path))
+      (void)RHMAP_DEL_FULL(p_gfx_thumb->cache_map, entry->hash, entry->path);
+
+   p_gfx_thumb->cache_count--;
+   free(entry->path);
+   free(entry);
+}
+
+static void gfx_thumbnail_cache_drop_image(
+      gfx_thumbnail_state_t *p_gfx_thumb,
+      struct gfx_thumbnail_cache_entry *entry)
+{
+   gfx_thumbnail_cache_lru_unlink(p_gfx_thumb,
+         GFX_THUMB_CACHE_LRU_CPU, entry);
+   p_gfx_thumb->cache_cpu_bytes -= gfx_thumbnail_cache_cpu_size(entry);
+   free(entry->image.pixels);
+   entry->image.pixels = NULL;
+}
+
+static void gfx_thumbnail_cache_drop_texture(
+      gfx_thumbnail_state_t *p_gfx_thumb,
+      struct gfx_thumbnail_cache_entry *entry)
+{
+   uint32_t key = gfx_thumbnail_cache_texture_key(entry->texture);
+   struct gfx_thumbnail_cache_entry **link =
+      RHMAP_PTR(p_gfx_thumb->cache_texture_map, key);
+
+   while (*link != entry)
+      link = &(*link)->texture_next;
+   *link = entry->texture_next;
+
+   if (!RHMAP_GET(p_gfx_thumb->cache_texture_map, key))
+      (void)RHMAP_DEL(p_gfx_thumb->cache_texture_map, key);
+
+   if (!entry->refs)
+      gfx_thumbnail_cache_lru_unlink(p_gfx_thumb,
+            GFX_THUMB_CACHE_LRU_GPU, entry);
+
+   p_gfx_thumb->cache_gpu_bytes -= gfx_thumbnail_cache_gpu_size(entry);
+   video_driver_texture_unload(&entry->texture);
+   entry->texture      = 0;
+   entry->texture_next = NULL;
+   entry->refs         = 0;
+}
+
+/* Evicts least recently used images, then least
+ * recently used textures that are not on screen,
+ * until both fit their budgets */
+static void gfx_thumbnail_cache_trim(
+      gfx_thumbnail_state_t *p_gfx_thumb,
+      size_t cpu_budget, size_t gpu_budget)
+{
+   while (     (p_gfx_thumb->cache_cpu_bytes > cpu_budget)
+         && p_gfx_thumb->cache_cpu_lru.oldest)
+   {
+      struct gfx_thumbnail_cache_entry *lru =
+         p_gfx_thumb->cache_cpu_lru.oldest;
+
+      gfx_thumbnail_cache_drop_image(p_gfx_thumb, lru);
+      if (!lru->texture)
+         gfx_thumbnail_cache_remove(p_gfx_thumb, lru);
+   }
+
+   /* Once the list is empty, everything left is on screen */
+   while (     (p_gfx_thumb->cache_gpu_bytes > gpu_budget)
+         && p_gfx_thumb->cache_gpu_lru.oldest)
+   {
+      struct gfx_thumbnail_cache_entry *lru =
+         p_gfx_thumb->cache_gpu_lru.oldest;
+
+      gfx_thumbnail_cache_drop_texture(p_gfx_thumb, lru);
+      if (!lru->image.pixels)
+         gfx_thumbnail_cache_remove(p_gfx_thumb, lru);
+   }
+}
+
+/* Adds a freshly decoded image to the cache, taking
+ * ownership of its pixels */
+static struct gfx_thumbnail_cache_entry *gfx_thumbnail_cache_insert(
+      gfx_thumbnail_state_t *p_gfx_thumb,
+      const gfx_thumbnail_tag_t *thumbnail_tag,
+      struct texture_image *img)
+{
+   struct gfx_thumbnail_cache_entry *entry = NULL;
+   uint32_t hash = gfx_thumbnail_cache_hash(thumbnail_tag->path);
+
+   /* Two requests for the same image may have
+    * been in flight at once */
+   if ((entry = gfx_thumbnail_cache_find(p_gfx_thumb,
+               thumbnail_tag->path, thumbnail_tag->file_size,
+               thumbnail_tag->upscale_threshold,
+               thumbnail_tag->max_width, thumbnail_tag->max_height,
+               thumbnail_tag->supports_rgba)))
+   {
+      if (entry->image.pixels)
+         return entry;
+      if (     (entry->image.width  == img->width)
+            && (entry->image.height == img->height))
+      {
+         entry->image.pixels           = img->pixels;
+         img->pixels                   = NULL;
+         p_gfx_thumb->cache_cpu_bytes += gfx_thumbnail_cache_cpu_size(entry);
+         gfx_thumbnail_cache_lru_push(p_gfx_thumb,
+               GFX_THUMB_CACHE_LRU_CPU, entry);
+      }
+      return entry;
+   }
+
+   if (!RHMAP_TRYFIT(p_gfx_thumb->cache_map,
+            RHMAP_LEN(p_gfx_thumb->cache_map) + 1))
+      return NULL;
+
+   if (!(entry = (struct gfx_thumbnail_cache_entry*)
+            calloc(1, sizeof(*entry))))
+      return NULL;
+
+   if (!(entry->path = strdup(thumbnail_tag->path)))
+   {
+      free(entry);
+      return NULL;
+   }
+
+   entry->image                  = *img;
+   entry->hash                   = hash;
+   entry->file_size              = thumbnail_tag->file_size;
+   entry->upscale_threshold      = thumbnail_tag->upscale_threshold;
+   entry->max_width              = thumbnail_tag->max_width;
+   entry->max_height             = thumbnail_tag->max_height;
+   entry->supports_rgba          = thumbnail_tag->supports_rgba;
+   img->pixels                   = NULL;
+
+   /* Same path with other parameters goes
+    * in the same chain */
+   entry->next                   = RHMAP_GET_FULL(p_gfx_thumb->cache_map,
+         hash, entry->path);
+   RHMAP_SET_FULL(p_gfx_thumb->cache_map, hash, entry->path, entry);
+
+   gfx_thumbnail_cache_lru_push(p_gfx_thumb,
+         GFX_THUMB_CACHE_LRU_CPU, entry);
+   p_gfx_thumb->cache_cpu_bytes += gfx_thumbnail_cache_cpu_size(entry);
+   p_gfx_thumb->cache_count++;
+
+   return entry;
+}
+
+/* Points a thumbnail at the texture of a cache entry,
+ * uploading it if required. Returns false if the
+ * texture could not be uploaded */
+static bool gfx_thumbnail_cache_acquire(
+      gfx_thumbnail_state_t *p_gfx_thumb,
+      struct gfx_thumbnail_cache_entry *entry,
+      gfx_thumbnail_t *thumbnail)
+{
+   if (!entry->texture)
+   {
+      uint32_t key;
+
+      if (     !entry->image.pixels
+            || !RHMAP_TRYFIT(p_gfx_thumb->cache_texture_map,
+               RHMAP_LEN(p_gfx_thumb->cache_texture_map) + 1)
+            || !video_driver_texture_load(&entry->image,
+               TEXTURE_FILTER_MIPMAP_LINEAR, &entry->texture))
+         return false;
+
+      key                 = gfx_thumbnail_cache_texture_key(entry->texture);
+      entry->texture_next = RHMAP_GET(p_gfx_thumb->cache_texture_map, key);
+      RHMAP_SET(p_gfx_thumb->cache_texture_map, key, entry);
+      p_gfx_thumb->cache_gpu_bytes += gfx_thumbnail_cache_gpu_size(entry);
+   }
+   /* Back on screen */
+   else if (!entry->refs)
+      gfx_thumbnail_cache_lru_unlink(p_gfx_thumb,
+            GFX_THUMB_CACHE_LRU_GPU, entry);
+
+   entry->refs++;
+   if (entry->image.pixels)
+   {
+      gfx_thumbnail_cache_lru_unlink(p_gfx_thumb,
+            GFX_THUMB_CACHE_LRU_CPU, entry);
+      gfx_thumbnail_cache_lru_push(p_gfx_thumb,
+            GFX_THUMB_CACHE_LRU_CPU, entry);
+   }
+
+   thumbnail->texture    = entry->texture;
+   thumbnail->width      = entry->image.width;
+   thumbnail->height     = entry->image.height;
+   thumbnail->status     = GFX_THUMBNAIL_STATUS_AVAILABLE;
+   thumbnail->flags     |= GFX_THUMB_FLAG_CACHED;
+   disp_get_ptr()->flags |= GFX_DISP_FLAG_DAMAGED;
+
+   return true;
+}
+
+/* Returns a texture borrowed by gfx_thumbnail_cache_acquire() */
+static void gfx_thumbnail_cache_release(
+      gfx_thumbnail_state_t *p_gfx_thumb, uintptr_t texture)
+{
+   struct gfx_thumbnail_cache_entry *entry = NULL;
+
+   if (!p_gfx_thumb->cache_texture_map)
+      return;
+
+   for (entry = RHMAP_GET(p_gfx_thumb->cache_texture_map,
+            gfx_thumbnail_cache_texture_key(texture));
+         entry; entry = entry->texture_next)
+   {
+      if (entry->texture == texture)
+      {
+         /* Last one off screen, so it can be evicted */
+         if (entry->refs && !--entry->refs)
+            gfx_thumbnail_cache_lru_push(p_gfx_thumb,
+                  GFX_THUMB_CACHE_LRU_GPU, entry);
+         break;
+      }
+   }
+}
+
+/* Returns the cache limits in bytes, from the
+ * MB values in the configuration */
+static void gfx_thumbnail_cache_get_budget(
+      size_t *cpu_budget, size_t *gpu_budget)
+{
+   settings_t *settings = config_get_ptr();
+
+   *cpu_budget = (size_t)settings->uints.gfx_thumbnail_cache_size << 20;
+   *gpu_budget = (size_t)settings->uints.gfx_thumbnail_texture_budget << 20;
+}
+
+void gfx_thumbnail_cache_unload_textures(void)
+{
+   size_t i;
+   gfx_thumbnail_state_t *p_gfx_thumb = &gfx_thumb_st;
+
+   /* Walk the texture map slots, as dropping a
+    * texture unlinks the entry from them */
+   for (i = 0; i < RHMAP_CAP(p_gfx_thumb->cache_texture_map); i++)
+   {
+      while (RHMAP_KEY(p_gfx_thumb->cache_texture_map, i))
+      {
+         struct gfx_thumbnail_cache_entry *entry =
+            p_gfx_thumb->cache_texture_map[i];
+
+         gfx_thumbnail_cache_drop_texture(p_gfx_thumb, entry);
+         if (!entry->image.pixels)
+            gfx_thumbnail_cache_remove(p_gfx_thumb, entry);
+      }
+   }
+}
+
+void gfx_thumbnail_cache_free(void)
+{
+   size_t i;
+   gfx_thumbnail_state_t *p_gfx_thumb = &gfx_thumb_st;
+
+   for (i = 0; i < RHMAP_CAP(p_gfx_thumb->cache_map); i++)
+   {
+      struct gfx_thumbnail_cache_entry *entry = NULL;
+
+      if (!RHMAP_KEY(p_gfx_thumb->cache_map, i))
+         continue;
+
+      entry = p_gfx_thumb->cache_map[i];
+      while (entry)
+      {
+         struct gfx_thumbnail_cache_entry *next = entry->next;
+
+         if (entry->texture)
+            video_driver_texture_unload(&entry->texture);
+         free(entry->image.pixels);
+         free(entry->path);
+         free(entry);
+         entry = next;
+      }
+   }
+
+   RHMAP_FREE(p_gfx_thumb->cache_map);
+   RHMAP_FREE(p_gfx_thumb->cache_texture_map);
+   p_gfx_thumb->cache_cpu_lru.oldest = NULL;
+   p_gfx_thumb->cache_cpu_lru.newest = NULL;
+   p_gfx_thumb->cache_gpu_lru.oldest = NULL;
+   p_gfx_thumb->cache_gpu_lru.newest = NULL;
+   p_gfx_thumb->cache_count          = 0;
+   p_gfx_thumb->cache_cpu_bytes      = 0;
+   p_gfx_thumb->cache_gpu_bytes      = 0;
+
+   /* Next menu driver draws its own boxes */
+   p_gfx_thumb->box_width            = 0;
+   p_gfx_thumb->box_height           = 0;
+   p_gfx_thumb->box_video_width      = 0;
+   p_gfx_thumb->box_video_height     = 0;
+}
+
 /* Used to process thumbnail data following completion
  * of image load task */
 static void gfx_thumbnail_handle_upload(
@@ -146,12 +601,22 @@ static void gfx_thumbnail_handle_upload(
    gfx_thumbnail_state_t *p_gfx_thumb = &gfx_thumb_st;
    struct texture_image *img          = (struct texture_image*)task_data;
    gfx_thumbnail_tag_t *thumbnail_tag = (gfx_thumbnail_tag_t*)user_data;
+   struct gfx_thumbnail_cache_entry *entry = NULL;
    bool fade_enabled                  = false;
 
    /* Sanity check */
    if (!thumbnail_tag)
       goto end;
 
+   /* Hand the image over to the cache, even if the
+    * thumbnail that requested it has gone away */
+   if (     thumbnail_tag->path
+         && img
+         && img->pixels
+         && (img->width  > 0)
+         && (img->height > 0))
+      entry = gfx_thumbnail_cache_insert(p_gfx_thumb, thumbnail_tag, img);
+
    /* Ensure that we are operating on the correct
     * thumbnail... */
    if (thumbnail_tag->list_id != p_gfx_thumb->list_id)
@@ -181,18 +646,28 @@ static void gfx_thumbnail_handle_upload(
    if (!img || (img->width < 1) || (img->height < 1))
       goto end;
 
-   /* Upload texture to GPU */
-   if (!video_driver_texture_load(
-            img, TEXTURE_FILTER_MIPMAP_LINEAR,
-            &thumbnail_tag->thumbnail->texture))
-      goto end;
-
-   /* Cache dimensions */
-   thumbnail_tag->thumbnail->width  = img->width;
-   thumbnail_tag->thumbnail->height = img->height;
-
-   /* Update thumbnail status */
-   thumbnail_tag->thumbnail->status = GFX_THUMBNAIL_STATUS_AVAILABLE;
+   /* Use the cached texture, or upload our own */
+   if (entry)
+   {
+      if (!gfx_thumbnail_cache_acquire(p_gfx_thumb, entry,
+               thumbnail_tag->thumbnail))
+         goto end;
+   }
+   else
+   {
+      if (!video_driver_texture_load(
+               img, TEXTURE_FILTER_MIPMAP_LINEAR,
+               &thumbnail_tag->thumbnail->texture))
+         goto end;
+
+      /* Cache dimensions */
+      thumbnail_tag->thumbnail->width  = img->width;
+      thumbnail_tag->thumbnail->height = img->height;
+
+      /* Update thumbnail status */
+      thumbnail_tag->thumbnail->status = GFX_THUMBNAIL_STATUS_AVAILABLE;
+      disp_get_ptr()->flags           |= GFX_DISP_FLAG_DAMAGED;
+   }
 
 end:
    /* Clean up */
@@ -209,6 +684,14 @@ end:
          gfx_thumbnail_init_fade(p_gfx_thumb,
                thumbnail_tag->thumbnail);
 
+      if (thumbnail_tag->path)
+      {
+         size_t cpu_budget, gpu_budget;
+         gfx_thumbnail_cache_get_budget(&cpu_budget, &gpu_budget);
+         gfx_thumbnail_cache_trim(p_gfx_thumb, cpu_budget, gpu_budget);
+         free(thumbnail_tag->path);
+      }
+
       free(thumbnail_tag);
    }
 }
@@ -226,6 +709,10 @@ void gfx_thumbnail_cancel_pending_requests(void)
    gfx_thumbnail_state_t *p_gfx_thumb = &gfx_thumb_st;
 
    p_gfx_thumb->list_id++;
+
+   /* Nothing pending can be used any more, so stop
+    * spending time on it */
+   task_image_cancel_thumbnail_loads();
 }
 
 /* Fetches the current thumbnail file path of the
@@ -269,6 +756,69 @@ static bool gfx_thumbnail_get_path(
 }
 
 
+/* Builds the path of the shrunk copy of a thumbnail
+ * in the disk cache
+ * > Copies are made at the largest box the menu driver
+ *   draws thumbnails into, which is part of the file
+ *   name, so a new layout or screen size makes new ones
+ * > Source file size is part of the file name, so a
+ *   thumbnail replaced on disk is shrunk again
+ * > Whenever the box changes, the disk cache is trimmed
+ *   to its size limit on the task thread, dropping
+ *   copies made for other boxes first
+ * Returns false if the disk cache is disabled, or no
+ * thumbnail has been drawn yet */
+static bool gfx_thumbnail_get_cache_path(
+      gfx_thumbnail_state_t *p_gfx_thumb,
+      gfx_thumbnail_path_data_t *path_data,
+      const char *thumbnail_path, int32_t file_size,
+      char *s, size_t len)
+{
+#ifdef HAVE_RPNG
+   char name[64];
+   char suffix[32];
+   size_t _len;
+   settings_t *settings  = config_get_ptr();
+   const char *dir_cache = settings->paths.directory_cache;
+
+   if (     !settings->bools.gfx_thumbnail_disk_cache
+         || string_is_empty(dir_cache)
+         || !p_gfx_thumb->box_width
+         || !p_gfx_thumb->box_height)
+      return false;
+
+   snprintf(suffix, sizeof(suffix), "_%ux%u.png",
+         p_gfx_thumb->box_width, p_gfx_thumb->box_height);
+
+   _len = fill_pathname_join_special(s, dir_cache, "thumbnails", len);
+
+   if (     (p_gfx_thumb->disk_cache_box_width  != p_gfx_thumb->box_width)
+         || (p_gfx_thumb->disk_cache_box_height != p_gfx_thumb->box_height))
+   {
+      p_gfx_thumb->disk_cache_box_width  = p_gfx_thumb->box_width;
+      p_gfx_thumb->disk_cache_box_height = p_gfx_thumb->box_height;
+      task_push_thumbnail_cache_trim(s, suffix,
+            (uint64_t)settings->uints.gfx_thumbnail_disk_cache_size << 20);
+   }
+
+   if (!string_is_empty(path_data->system))
+   {
+      _len += strlcpy(s + _len, PATH_DEFAULT_SLASH(), len - _len);
+      _len += strlcpy(s + _len, path_data->system, len - _len);
+   }
+
+   snprintf(name, sizeof(name), "%08x_%d%s",
+         (unsigned)msg_hash_calculate(thumbnail_path),
+         (int)file_size, suffix);
+   fill_pathname_join_special(s + _len, PATH_DEFAULT_SLASH(), name,
+         len - _len);
+
+   return true;
+#else
+   return false;
+#endif
+}
+
 /* Requests loading of the specified thumbnail
  * - If operation fails, 'thumbnail->status' will be set to
  *   GFX_THUMBNAIL_STATUS_MISSING
@@ -305,26 +855,90 @@ void gfx_thumbnail_request(
          const char *thumbnail_path = NULL;
          if (gfx_thumbnail_get_path(path_data, thumbnail_id, &thumbnail_path))
          {
-            /* Load thumbnail, if required */
-            if (path_is_valid(thumbnail_path))
+            /* Load thumbnail, if required
+             * > The file size is part of the cache key,
+             *   so that a thumbnail replaced on disk (e.g.
+             *   by an on-demand download) is reloaded */
+            int32_t file_size = path_get_size(thumbnail_path);
+
+            if (file_size >= 0)
             {
-               gfx_thumbnail_tag_t *thumbnail_tag =
-                  (gfx_thumbnail_tag_t*)malloc(sizeof(gfx_thumbnail_tag_t));
+               size_t cpu_budget, gpu_budget;
+               char cache_path[PATH_MAX_LENGTH];
+               unsigned max_width                 = p_gfx_thumb->box_width;
+               unsigned max_height                = p_gfx_thumb->box_height;
+               bool use_cache_path                = false;
+               gfx_thumbnail_tag_t *thumbnail_tag = NULL;
+               bool supports_rgba                 = video_driver_supports_rgba();
+
+               gfx_thumbnail_cache_get_budget(&cpu_budget, &gpu_budget);
+
+               /* Check whether image has already been decoded */
+               if (cpu_budget)
+               {
+                  struct gfx_thumbnail_cache_entry *entry =
+                     gfx_thumbnail_cache_find(p_gfx_thumb,
+                           thumbnail_path,
+                           file_size, gfx_thumbnail_upscale_threshold,
+                           max_width, max_height, supports_rgba);
+
+                  if (     entry
+                        && gfx_thumbnail_cache_acquire(p_gfx_thumb,
+                           entry, thumbnail))
+                  {
+                     gfx_thumbnail_cache_trim(p_gfx_thumb,
+                           cpu_budget, gpu_budget);
+                     goto end;
+                  }
+               }
 
-               if (!thumbnail_tag)
+               if (!(thumbnail_tag =
+                     (gfx_thumbnail_tag_t*)malloc(sizeof(gfx_thumbnail_tag_t))))
                   goto end;
 
                /* Configure user data */
-               thumbnail_tag->thumbnail = thumbnail;
-               thumbnail_tag->list_id   = p_gfx_thumb->list_id;
+               thumbnail_tag->thumbnail         = thumbnail;
+               thumbnail_tag->list_id           = p_gfx_thumb->list_id;
+               thumbnail_tag->path              = cpu_budget
+                  ? strdup(thumbnail_path) : NULL;
+               thumbnail_tag->file_size         = file_size;
+               thumbnail_tag->upscale_threshold = gfx_thumbnail_upscale_threshold;
+               thumbnail_tag->max_width         = max_width;
+               thumbnail_tag->max_height        = max_height;
+               thumbnail_tag->supports_rgba     = supports_rgba;
+
+               /* Load the shrunk copy of the image if there
+                * is one, otherwise have the load task make it
+                * (if the image turns out to be larger than
+                * the box) */
+               if (gfx_thumbnail_get_cache_path(p_gfx_thumb, path_data,
+                        thumbnail_path, file_size,
+                        cache_path, sizeof(cache_path)))
+                  use_cache_path = path_is_valid(cache_path);
+               else
+                  *cache_path    = '\0';
 
                /* Would like to cancel any existing image load tasks
                 * here, but can't see how to do it... */
-               if (task_push_image_load(
-                        thumbnail_path, video_driver_supports_rgba(),
+               if (use_cache_path
+                     ? task_push_thumbnail_load(
+                        cache_path, NULL, supports_rgba,
                         gfx_thumbnail_upscale_threshold,
+                        max_width, max_height,
+                        gfx_thumbnail_handle_upload, thumbnail_tag)
+                     : task_push_thumbnail_load(
+                        thumbnail_path,
+                        string_is_empty(cache_path) ? NULL : cache_path,
+                        supports_rgba, gfx_thumbnail_upscale_threshold,
+                        max_width, max_height,
                         gfx_thumbnail_handle_upload, thumbnail_tag))
                   thumbnail->status = GFX_THUMBNAIL_STATUS_PENDING;
+               else
+               {
+                  if (thumbnail_tag->path)
+                     free(thumbnail_tag->path);
+                  free(thumbnail_tag);
+               }
             }
 #ifdef HAVE_NETWORKING
             /* Handle on demand thumbnail downloads */
@@ -419,15 +1033,19 @@ void gfx_thumbnail_request_file(
    if (!(thumbnail_tag = (gfx_thumbnail_tag_t*)malloc(sizeof(gfx_thumbnail_tag_t))))
       return;
 
-   /* Configure user data */
+   /* Configure user data
+    * > Savestate images change under the same path,
+    *   so they bypass the cache */
    thumbnail_tag->thumbnail = thumbnail;
    thumbnail_tag->list_id   = p_gfx_thumb->list_id;
+   thumbnail_tag->path      = NULL;
 
    /* Would like to cancel any existing image load tasks
     * here, but can't see how to do it... */
-   if (task_push_image_load(
-         file_path, video_driver_supports_rgba(),
+   if (task_push_thumbnail_load(
+         file_path, NULL, video_driver_supports_rgba(),
          gfx_thumbnail_upscale_threshold,
+         p_gfx_thumb->box_width, p_gfx_thumb->box_height,
          gfx_thumbnail_handle_upload, thumbnail_tag))
       thumbnail->status = GFX_THUMBNAIL_STATUS_PENDING;
 }
@@ -439,9 +1057,14 @@ void gfx_thumbnail_reset(gfx_thumbnail_t *thumbnail)
    if (!thumbnail)
       return;
 
-   /* Unload texture */
+   /* Unload texture, or hand it back to the cache */
    if (thumbnail->texture)
-      video_driver_texture_unload(&thumbnail->texture);
+   {
+      if (thumbnail->flags & GFX_THUMB_FLAG_CACHED)
+         gfx_thumbnail_cache_release(&gfx_thumb_st, thumbnail->texture);
+      else
+         video_driver_texture_unload(&thumbnail->texture);
+   }
 
    /* Ensure any 'fade in' animation is killed */
    if (thumbnail->flags & GFX_THUMB_FLAG_FADE_ACTIVE)
@@ -458,7 +1081,8 @@ void gfx_thumbnail_reset(gfx_thumbnail_t *thumbnail)
    thumbnail->alpha       = 0.0f;
    thumbnail->delay_timer = 0.0f;
    thumbnail->flags      &= ~(GFX_THUMB_FLAG_FADE_ACTIVE
-                            | GFX_THUMB_FLAG_CORE_ASPECT);
+                            | GFX_THUMB_FLAG_CORE_ASPECT
+                            | GFX_THUMB_FLAG_CACHED);
 }
 
 /* Stream processing */
@@ -894,6 +1518,34 @@ void gfx_thumbnail_get_draw_dimensions(
    *draw_height *= scale_factor;
 }
 
+/* Records the box a thumbnail is drawn into, so that
+ * images can be shrunk to the largest one in use
+ * > Rounded up, so that boxes differing by a few pixels
+ *   between layouts share the same images
+ * > Starts over when the screen size changes */
+static void gfx_thumbnail_update_box(
+      gfx_thumbnail_state_t *p_gfx_thumb,
+      unsigned video_width, unsigned video_height,
+      unsigned width, unsigned height)
+{
+   if (     (video_width  != p_gfx_thumb->box_video_width)
+         || (video_height != p_gfx_thumb->box_video_height))
+   {
+      p_gfx_thumb->box_video_width  = video_width;
+      p_gfx_thumb->box_video_height = video_height;
+      p_gfx_thumb->box_width        = 0;
+      p_gfx_thumb->box_height       = 0;
+   }
+
+   width  = (width  + 63) & ~63U;
+   height = (height + 63) & ~63U;
+
+   if (width  > p_gfx_thumb->box_width)
+      p_gfx_thumb->box_width  = width;
+   if (height > p_gfx_thumb->box_height)
+      p_gfx_thumb->box_height = height;
+}
+
 /* Draws specified thumbnail with specified alignment
  * (and aspect correct scaling) within a rectangle of
  * (width x height).
@@ -927,6 +1579,9 @@ void gfx_thumbnail_draw(
       )
       return;
 
+   gfx_thumbnail_update_box(&gfx_thumb_st,
+         video_width, video_height, width, height);
+
    /* Only draw thumbnail if it is available... */
    if (thumbnail->status == GFX_THUMBNAIL_STATUS_AVAILABLE)
    {
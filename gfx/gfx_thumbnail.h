@@ -66,7 +66,9 @@ enum gfx_thumbnail_shadow_type
 enum gfx_thumbnail_flags
 {
    GFX_THUMB_FLAG_FADE_ACTIVE = (1 << 0),
-   GFX_THUMB_FLAG_CORE_ASPECT = (1 << 1)
+   GFX_THUMB_FLAG_CORE_ASPECT = (1 << 1),
+   /* Texture is borrowed from the thumbnail cache */
+   GFX_THUMB_FLAG_CACHED      = (1 << 2)
 };
 
 /* Holds all runtime parameters associated with
@@ -99,6 +101,16 @@ typedef struct
    enum gfx_thumbnail_shadow_type type;
 } gfx_thumbnail_shadow_t;
 
+struct gfx_thumbnail_cache_entry;
+
+/* Entries of the thumbnail cache, least recently
+ * used first */
+typedef struct
+{
+   struct gfx_thumbnail_cache_entry *oldest;
+   struct gfx_thumbnail_cache_entry *newest;
+} gfx_thumbnail_cache_lru_t;
+
 /* Structure containing all gfx_thumbnail
  * variables */
 struct gfx_thumbnail_state
@@ -115,6 +127,41 @@ struct gfx_thumbnail_state
     * at the time when the load completes */
    uint64_t list_id;
 
+   /* Decoded thumbnails, shared by every menu entry
+    * that shows the same image. Images are kept in
+    * memory up to a limit, and their textures are
+    * kept uploaded (even after the entries using them
+    * go off-screen) up to a separate budget, so that
+    * scrolling back through a list does not decode or
+    * upload them again. Both limits evict the least
+    * recently used entries first
+    * > 'cache_map' finds entries by path hash,
+    *   'cache_texture_map' by texture handle; each
+    *   maps to a chain of entries
+    * > 'cache_cpu_lru' holds entries with an image,
+    *   'cache_gpu_lru' those with a texture that is
+    *   not on screen */
+   struct gfx_thumbnail_cache_entry **cache_map;
+   struct gfx_thumbnail_cache_entry **cache_texture_map;
+   gfx_thumbnail_cache_lru_t cache_cpu_lru;
+   gfx_thumbnail_cache_lru_t cache_gpu_lru;
+   size_t cache_count;
+   size_t cache_cpu_bytes;
+   size_t cache_gpu_bytes;
+
+   /* Largest box (rounded up) that thumbnails have been
+    * drawn into at the current screen size. Images larger
+    * than this are shrunk to fit when they are loaded, and
+    * the shrunk copies kept in the disk cache are made at
+    * this size. 0 until the first thumbnail is drawn */
+   unsigned box_width;
+   unsigned box_height;
+   unsigned box_video_width;
+   unsigned box_video_height;
+   /* Box size the disk cache was last trimmed for */
+   unsigned disk_cache_box_width;
+   unsigned disk_cache_box_height;
+
    /* When streaming thumbnails, to minimise the processing
     * of unnecessary images (i.e. when scrolling rapidly through
     * playlists), we delay loading until an entry has been on screen
@@ -195,6 +242,16 @@ void gfx_thumbnail_request_file(
  * specified thumbnail */
 void gfx_thumbnail_reset(gfx_thumbnail_t *thumbnail);
 
+/* Unloads every texture held by the thumbnail cache,
+ * keeping the decoded images
+ * > Must be called when the menu driver's video
+ *   context is destroyed, after the menu driver has
+ *   reset its own thumbnails */
+void gfx_thumbnail_cache_unload_textures(void);
+
+/* Frees the thumbnail cache */
+void gfx_thumbnail_cache_free(void);
+
 /* Stream processing */
 
 /* Requests loading of the specified thumbnail via
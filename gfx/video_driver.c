@@ -21,6 +21,9 @@
 #include <string/stdstring.h>
 #include <retro_math.h>
 #include <retro_timers.h>
+#include <compat/strl.h>
+#include <file/config_file.h>
+#include <file/file_path.h>
 
 #ifdef HAVE_CONFIG_H
 #include "../config.h"
@@ -1664,6 +1667,18 @@ void video_driver_free_internal(void)
          (struct rarch_dir_shader_list*)&video_st->dir_shader_list,
          config_get_ptr()->bools.video_shader_remember_last_dir);
 #endif
+
+   if (video_st->frame_dirty.frames)
+      RARCH_LOG("[Video]: Row diffing: %" PRIu64 " of %" PRIu64
+            " frames were dupes, uploaded %" PRIu64 " of %" PRIu64 " KB.\n",
+            video_st->frame_dirty.dupes,
+            video_st->frame_dirty.frames,
+            video_st->frame_dirty.bytes_upload >> 10,
+            video_st->frame_dirty.bytes_in     >> 10);
+   if (video_st->frame_dirty.shadow)
+      free(video_st->frame_dirty.shadow);
+   memset(&video_st->frame_dirty, 0, sizeof(video_st->frame_dirty));
+
 #ifdef HAVE_THREADS
    if (is_threaded)
       return;
@@ -2857,6 +2872,8 @@ void video_driver_build_info(video_frame_info_t *video_info)
    video_info->core_status_msg_show        = runloop_st->core_status_msg.set;
    video_info->aspect_ratio_idx            = settings->uints.video_aspect_ratio_idx;
    video_info->post_filter_record          = settings->bools.video_post_filter_record;
+   video_info->frame_diff                  = settings->bools.video_frame_diff;
+   video_info->frame_dirty                 = NULL;
    video_info->input_menu_swap_ok_cancel_buttons
                                            = settings->bools.input_menu_swap_ok_cancel_buttons;
    video_info->max_swapchain_images        = settings->uints.video_max_swapchain_images;
@@ -3632,6 +3649,177 @@ bool video_driver_init_internal(bool *video_is_threaded, bool verbosity_enabled)
    return true;
 }
 
+/**
+ * video_frame_dirty_update:
+ *
+ * Diffs @data against the previous frame and records the span
+ * between the first and last changed row. Identical frames
+ * record nothing and are only counted as dupes.
+ **/
+static void video_frame_dirty_update(video_frame_dirty_t *dirty,
+      const void *data, unsigned width, unsigned height,
+      size_t pitch, unsigned bpp)
+{
+   unsigned y0, y1, y;
+   size_t row_size       = width * bpp;
+   const uint8_t *src    = (const uint8_t*)data;
+   uint8_t *shadow       = dirty->shadow;
+
+   dirty->frames++;
+   dirty->bytes_in      += row_size * height;
+
+   if (     shadow
+         && width  == dirty->width
+         && height == dirty->height
+         && bpp    == dirty->bpp)
+   {
+      /* Most frames differ in a few rows or not at all, so stop
+       * comparing at the first and last changed row. memcmp is
+       * vectorised by the C library and bails out early. */
+      for (y0 = 0; y0 < height; y0++)
+         if (memcmp(shadow + y0 * row_size, src + y0 * pitch, row_size))
+            break;
+
+      if (y0 == height)
+      {
+         dirty->dupes++;
+         return;
+      }
+
+      for (y1 = height; y1 > y0 + 1; y1--)
+         if (memcmp(shadow + (y1 - 1) * row_size,
+                  src + (y1 - 1) * pitch, row_size))
+            break;
+   }
+   else
+   {
+      size_t size = row_size * height;
+
+      if (size > dirty->shadow_size)
+      {
+         if (shadow)
+            free(shadow);
+         shadow              = (uint8_t*)malloc(size);
+         dirty->shadow       = shadow;
+         dirty->shadow_size  = shadow ? size : 0;
+      }
+
+      dirty->width           = shadow ? width  : 0;
+      dirty->height          = shadow ? height : 0;
+      dirty->bpp             = bpp;
+      y0                     = 0;
+      y1                     = height;
+   }
+
+   if (shadow)
+      for (y = y0; y < y1; y++)
+         memcpy(shadow + y * row_size, src + y * pitch, row_size);
+
+   dirty->serial++;
+   dirty->history[dirty->serial & (VIDEO_FRAME_DIRTY_HISTORY - 1)].y
+                             = y0;
+   dirty->history[dirty->serial & (VIDEO_FRAME_DIRTY_HISTORY - 1)].height
+                             = y1 - y0;
+   dirty->bytes_upload      += (y1 - y0) * row_size;
+}
+
+bool video_frame_dirty_rows(const video_frame_info_t *video_info,
+      uint64_t *stamp, unsigned *y, unsigned *height)
+{
+   uint64_t s;
+   unsigned y0, y1;
+   uint64_t last                    = *stamp;
+   const video_frame_dirty_t *dirty = video_info->frame_dirty;
+
+   if (!dirty)
+   {
+      *stamp = 0;
+      return false;
+   }
+
+   *stamp = dirty->serial;
+
+   /* Texture was never filled, or is older than the history */
+   if (     !last
+         || last > dirty->serial
+         || dirty->serial - last > VIDEO_FRAME_DIRTY_HISTORY)
+      return false;
+
+   y0 = dirty->height;
+   y1 = 0;
+   for (s = last + 1; s <= dirty->serial; s++)
+   {
+      unsigned i = (unsigned)(s & (VIDEO_FRAME_DIRTY_HISTORY - 1));
+      if (!dirty->history[i].height)
+         continue;
+      if (dirty->history[i].y < y0)
+         y0 = dirty->history[i].y;
+      if (dirty->history[i].y + dirty->history[i].height > y1)
+         y1 = dirty->history[i].y + dirty->history[i].height;
+   }
+
+   /* Spans from before a size change may reach past the frame */
+   if (y1 > dirty->height)
+      y1 = dirty->height;
+
+   if (y1 > y0)
+   {
+      *y      = y0;
+      *height = y1 - y0;
+   }
+   else
+   {
+      *y      = 0;
+      *height = 0;
+   }
+   return true;
+}
+
+const video_frame_dirty_t *video_frame_dirty_get_stats(void)
+{
+   video_driver_state_t *video_st = &video_driver_st;
+   if (!video_st->frame_dirty.frames)
+      return NULL;
+   return &video_st->frame_dirty;
+}
+
+bool video_readback_queue_push(video_readback_queue_t *queue,
+      video_viewport_read_cb_t cb, void *userdata)
+{
+   video_readback_request_t *req;
+
+   if (queue->count >= VIDEO_READBACK_QUEUE_SIZE)
+      return false;
+
+   req           = &queue->req[(queue->head + queue->count)
+      % VIDEO_READBACK_QUEUE_SIZE];
+   req->cb       = cb;
+   req->userdata = userdata;
+   req->width    = 0;
+   req->height   = 0;
+   queue->count++;
+   return true;
+}
+
+bool video_readback_queue_pop(video_readback_queue_t *queue,
+      video_readback_request_t *req)
+{
+   if (!queue->count)
+      return false;
+
+   *req         = queue->req[queue->head];
+   queue->head  = (queue->head + 1) % VIDEO_READBACK_QUEUE_SIZE;
+   queue->count--;
+   return true;
+}
+
+void video_readback_queue_flush(video_readback_queue_t *queue)
+{
+   video_readback_request_t req;
+   while (video_readback_queue_pop(queue, &req))
+      req.cb(req.userdata, NULL, 0, 0);
+}
+
 void video_driver_frame(const void *data, unsigned width,
       unsigned height, size_t pitch)
 {
@@ -4211,6 +4399,22 @@ void video_driver_frame(const void *data, unsigned width,
                   " Run-Ahead:   %2u frames\n"
                   " - Preemptive Frames\n",
                   video_info.runahead_frames);
+
+         /* Menu and widget draws of the last frame that had any */
+         {
+            gfx_display_t *p_disp = disp_get_ptr();
+            if (     p_disp->stats.draw_calls
+                  && p_disp->stats_frame + 1 >= video_st->frame_count
+                  && __len < sizeof(video_info.stat_text))
+               __len += snprintf(video_info.stat_text + __len, sizeof(video_info.stat_text) - __len,
+                     "DISPLAY\n"
+                     " Draw Calls:  %5u\n"
+                     " - Batched:   %5u quads\n"
+                     " Vertices:    %5u\n",
+                     p_disp->stats.draw_calls,
+                     p_disp->stats.batched_quads,
+                     p_disp->stats.vertices);
+         }
       }
    }
 
@@ -4218,6 +4422,25 @@ void video_driver_frame(const void *data, unsigned width,
          && video_st->current_video
          && video_st->current_video->frame)
    {
+      /* Let the driver upload only the rows that changed. Frames
+       * identical to the last one are still passed on, since
+       * drivers may rotate them into their frame history; their
+       * dirty span is simply empty. */
+      if (     video_info.frame_diff
+            && data
+            && data != RETRO_HW_FRAME_BUFFER_VALID)
+      {
+         unsigned bpp = (video_driver_pix_fmt == RETRO_PIXEL_FORMAT_XRGB8888)
+               ? 4 : 2;
+#ifdef HAVE_VIDEO_FILTER
+         if (video_st->state_filter)
+            bpp       = video_st->state_out_bpp;
+#endif
+         video_frame_dirty_update(&video_st->frame_dirty,
+               data, width, height, pitch, bpp);
+         video_info.frame_dirty = &video_st->frame_dirty;
+      }
+
       video_info.current_subframe = 0;
       if (video_st->current_video->frame(
                video_st->data, data, width, height,
@@ -4346,6 +4569,75 @@ void video_driver_reinit(int flags)
    video_st->window_title_prev[0]          = '\0';
 }
 
+/* Samples needed before the model replaces the reactive logic */
+#define FRAME_DELAY_MODEL_MIN_SAMPLES  240
+/* Histogram is halved once it holds this many samples (~5 min) */
+#define FRAME_DELAY_MODEL_WINDOW       18000
+/* Leftover kept after the core for sleep jitter and presentation */
+#define FRAME_DELAY_MODEL_MARGIN       2000
+
+static void video_frame_delay_model_record(video_frame_delay_model_t *model,
+      retro_time_t core_run_time, uint8_t delay,
+      retro_time_t frame_time_target)
+{
+   unsigned bucket = core_run_time / FRAME_DELAY_MODEL_BUCKET_USEC;
+
+   if (bucket >= FRAME_DELAY_MODEL_BUCKETS)
+      bucket = FRAME_DELAY_MODEL_BUCKETS - 1;
+
+   model->histogram[bucket]++;
+   model->samples++;
+   model->frames++;
+
+   if (delay * 1000 + core_run_time > frame_time_target)
+      model->misses++;
+
+   /* Let old sessions and old scenes fade out */
+   if (model->samples >= FRAME_DELAY_MODEL_WINDOW)
+   {
+      int i;
+      model->samples = 0;
+      for (i = 0; i < FRAME_DELAY_MODEL_BUCKETS; i++)
+      {
+         model->histogram[i] >>= 1;
+         model->samples       += model->histogram[i];
+      }
+   }
+}
+
+/* Core run time (usec) that at most permille / 1000 of the
+ * recorded frames exceed. */
+static unsigned video_frame_delay_model_quantile(
+      const video_frame_delay_model_t *model, unsigned permille)
+{
+   int i;
+   uint32_t tail    = 0;
+   uint32_t allowed = (uint64_t)model->samples * permille / 1000;
+
+   for (i = FRAME_DELAY_MODEL_BUCKETS - 1; i >= 0; i--)
+   {
+      tail += model->histogram[i];
+      if (tail > allowed)
+         break;
+   }
+
+   return (i + 1) * FRAME_DELAY_MODEL_BUCKET_USEC;
+}
+
+static uint8_t video_frame_delay_model_pick(
+      const video_frame_delay_model_t *model,
+      retro_time_t frame_time_target, unsigned miss_target)
+{
+   retro_time_t leftover = frame_time_target - FRAME_DELAY_MODEL_MARGIN
+         - video_frame_delay_model_quantile(model, miss_target);
+
+   if (leftover < 1000)
+      return 0;
+   if (leftover > 255 * 1000)
+      return 255;
+   return leftover / 1000;
+}
+
 static void video_frame_delay_leftover(video_driver_state_t *video_st,
       runloop_state_t *runloop_st,
       float refresh_rate,
@@ -4555,6 +4847,7 @@ void video_frame_delay(video_driver_state_t *video_st,
    uint8_t video_swap_interval         = runloop_get_video_swap_interval(settings->uints.video_swap_interval);
    uint8_t video_bfi                   = settings->uints.video_black_frame_insertion;
    uint8_t shader_subframes            = settings->uints.video_shader_subframes;
+   unsigned miss_target                = settings->uints.video_frame_delay_auto_miss_target;
    bool skip_delay                     = video_st->frame_count < 4
          || (runloop_st->flags & RUNLOOP_FLAG_SLOWMOTION)
          || (runloop_st->flags & RUNLOOP_FLAG_FASTMOTION);
@@ -4573,6 +4866,8 @@ void video_frame_delay(video_driver_state_t *video_st,
    {
       static uint8_t skip_update  = 0;
       uint8_t frame_time_interval = 8;
+      video_frame_delay_model_t *model = &video_st->frame_delay_model;
+      retro_time_t frame_time_target   = 1000000.0f / refresh_rate;
       static bool skip_delay_prev = false;
       bool frame_time_update      =
             /* Skip some initial frames for stabilization */
@@ -4610,38 +4905,71 @@ void video_frame_delay(video_driver_state_t *video_st,
          RARCH_DBG("[Video]: Frame delay target reset to %d ms.\n", video_frame_delay);
       }
 
-      /* Immediate reaction based on core time */
-      if (video_st->frame_count >= 4 && !skip_delay)
+      /* Core run time of the previous frame, measured with the
+       * delay that was applied to it */
+      if (     miss_target
+            && !skip_delay
+            && !skip_update
+            && runloop_st->core_run_time)
+         video_frame_delay_model_record(model, runloop_st->core_run_time,
+               video_st->frame_delay_effective, frame_time_target);
+
+      /* Statistical pick once enough frames have been seen:
+       * decrease at once, increase one step per interval */
+      if (     miss_target
+            && model->samples >= FRAME_DELAY_MODEL_MIN_SAMPLES)
       {
-         if (video_st->frame_count < frame_time_interval * 8)
-            skip_update = 0;
-
-         video_frame_delay_leftover(video_st, runloop_st,
-               refresh_rate, frame_time_interval,
-               &skip_update, &video_frame_delay_maybe);
+         if (!skip_delay)
+         {
+            uint8_t delay_pick = video_frame_delay_model_pick(model,
+                  frame_time_target, miss_target);
+
+            if (delay_pick > video_frame_delay)
+               delay_pick = video_frame_delay;
+            model->delay = delay_pick;
+
+            if (delay_pick < video_frame_delay_effective)
+               video_frame_delay_effective = delay_pick;
+            else if (delay_pick > video_frame_delay_effective
+                  && video_st->frame_count % frame_time_interval == 0)
+               video_frame_delay_effective++;
+         }
+      }
+      else
+      {
+         /* Immediate reaction based on core time */
+         if (video_st->frame_count >= 4 && !skip_delay)
+         {
+            if (video_st->frame_count < frame_time_interval * 8)
+               skip_update = 0;
 
-         if (video_frame_delay_maybe > video_frame_delay)
-            video_frame_delay_maybe = video_frame_delay;
+            video_frame_delay_leftover(video_st, runloop_st,
+                  refresh_rate, frame_time_interval,
+                  &skip_update, &video_frame_delay_maybe);
 
-         if (video_frame_delay_effective != video_frame_delay_maybe)
-            video_frame_delay_effective = video_frame_delay_maybe;
-      }
+            if (video_frame_delay_maybe > video_frame_delay)
+               video_frame_delay_maybe = video_frame_delay;
 
-      if (skip_update)
-         frame_time_update = false;
+            if (video_frame_delay_effective != video_frame_delay_maybe)
+               video_frame_delay_effective = video_frame_delay_maybe;
+         }
 
-      /* Average calculations */
-      if (video_frame_delay_effective > 0 && frame_time_update)
-      {
-         video_frame_delay_auto_t vfda = {0};
-         vfda.frame_time_interval      = frame_time_interval;
-         vfda.refresh_rate             = refresh_rate;
+         if (skip_update)
+            frame_time_update = false;
 
-         video_frame_delay_auto(video_st, &vfda);
-         if (vfda.delay_decrease > 0)
+         /* Average calculations */
+         if (video_frame_delay_effective > 0 && frame_time_update)
          {
-            video_st->frame_time_reserve += vfda.delay_decrease * 1000;
-            skip_update = frame_time_interval;
+            video_frame_delay_auto_t vfda = {0};
+            vfda.frame_time_interval      = frame_time_interval;
+            vfda.refresh_rate             = refresh_rate;
+
+            video_frame_delay_auto(video_st, &vfda);
+            if (vfda.delay_decrease > 0)
+            {
+               video_st->frame_time_reserve += vfda.delay_decrease * 1000;
+               skip_update = frame_time_interval;
+            }
          }
       }
    }
@@ -4792,3 +5120,110 @@ void video_frame_delay_auto(video_driver_state_t *video_st, video_frame_delay_au
       );
 #endif
 }
+
+void video_frame_delay_model_load(const char *savefile, const char *core)
+{
+   char buf[FRAME_DELAY_MODEL_BUCKETS * 11];
+   char model_core[NAME_MAX_LENGTH];
+   video_frame_delay_model_t *model = &video_driver_st.frame_delay_model;
+   config_file_t *conf              = NULL;
+
+   memset(model, 0, sizeof(*model));
+
+   if (string_is_empty(savefile) || string_is_empty(core))
+      return;
+
+   fill_pathname(model->path, savefile, ".fdm", sizeof(model->path));
+   strlcpy(model->core, core, sizeof(model->core));
+
+   if (!path_is_valid(model->path))
+      return;
+   if (!(conf = config_file_new_from_path_to_string(model->path)))
+      return;
+
+   model_core[0] = '\0';
+   config_get_array(conf, "frame_delay_model_core",
+         model_core, sizeof(model_core));
+
+   /* Only trust timings recorded with the same core */
+   if (     string_is_equal(model_core, core)
+         && config_get_array(conf, "frame_delay_model_histogram",
+            buf, sizeof(buf)))
+   {
+      int i;
+      char *tok = buf;
+
+      for (i = 0; i < FRAME_DELAY_MODEL_BUCKETS && *tok; i++)
+      {
+         char *end            = NULL;
+         model->histogram[i]  = (uint32_t)strtoul(tok, &end, 10);
+         model->samples      += model->histogram[i];
+         if (end == tok)
+            break;
+         tok                  = end;
+      }
+
+      RARCH_LOG("[Video]: Loaded frame delay model with %u samples from \"%s\".\n",
+            model->samples, model->path);
+   }
+
+   config_file_free(conf);
+}
+
+void video_frame_delay_model_save(void)
+{
+   int i;
+   size_t _len                      = 0;
+   char buf[FRAME_DELAY_MODEL_BUCKETS * 11];
+   video_frame_delay_model_t *model = &video_driver_st.frame_delay_model;
+   config_file_t *conf              = NULL;
+
+   /* Nothing new to keep */
+   if (string_is_empty(model->path) || !model->frames)
+      goto end;
+
+   if (!(conf = config_file_new_alloc()))
+      goto end;
+
+   for (i = 0; i < FRAME_DELAY_MODEL_BUCKETS && _len < sizeof(buf); i++)
+      _len += snprintf(buf + _len, sizeof(buf) - _len,
+            (i == 0) ? "%u" : " %u", (unsigned)model->histogram[i]);
+
+   config_set_string(conf, "frame_delay_model_core", model->core);
+   config_set_string(conf, "frame_delay_model_histogram", buf);
+
+   if (config_file_write(conf, model->path, false))
+      RARCH_LOG("[Video]: Frame delay model: %u frames, %u over frame time.\n",
+            model->frames, model->misses);
+   else
+      RARCH_ERR("[Video]: Failed to save frame delay model to \"%s\".\n",
+            model->path);
+
+   config_file_free(conf);
+
+end:
+   memset(model, 0, sizeof(*model));
+}
+
+bool video_frame_delay_model_get_stats(video_frame_delay_stats_t *stats)
+{
+   settings_t *settings                   = config_get_ptr();
+   video_driver_state_t *video_st         = &video_driver_st;
+   const video_frame_delay_model_t *model = &video_st->frame_delay_model;
+
+   stats->miss_target  = settings->uints.video_frame_delay_auto_miss_target;
+   stats->run_time_p50 = video_frame_delay_model_quantile(model, 500);
+   stats->run_time_p90 = video_frame_delay_model_quantile(model, 100);
+   stats->run_time_p99 = video_frame_delay_model_quantile(model, 10);
+   stats->samples      = model->samples;
+   stats->frames       = model->frames;
+   stats->misses       = model->misses;
+   stats->delay        = video_st->frame_delay_effective;
+   stats->pick         = model->delay;
+   stats->target       = video_st->frame_delay_target;
+   stats->active       = settings->bools.video_frame_delay_auto
+         && stats->miss_target
+         && model->samples >= FRAME_DELAY_MODEL_MIN_SAMPLES;
+
+   return stats->active;
+}
@@ -51,6 +51,14 @@
 
 #define MEASURE_FRAME_TIME_SAMPLES_COUNT (2 * 1024)
 
+/* Core run time histogram used by automatic frame delay */
+#define FRAME_DELAY_MODEL_BUCKETS      128
+#define FRAME_DELAY_MODEL_BUCKET_USEC  250
+
+/* Changed row spans remembered for drivers with texture rings.
+ * Must be a power of two. */
+#define VIDEO_FRAME_DIRTY_HISTORY      8
+
 #define VIDEO_SHADER_STOCK_BLEND   (GFX_MAX_SHADERS - 1)
 #define VIDEO_SHADER_MENU          (GFX_MAX_SHADERS - 2)
 #define VIDEO_SHADER_MENU_2        (GFX_MAX_SHADERS - 3)
@@ -385,11 +393,36 @@ typedef struct video_info
    bool font_enable;
 } video_info_t;
 
+/* Tracks which rows of the software frame changed, so drivers
+ * only upload the rows that differ from what their texture
+ * already holds. Identical frames are counted as dupes. */
+typedef struct video_frame_dirty
+{
+   uint8_t *shadow;             /* Last frame, rows packed tightly */
+   size_t shadow_size;
+   uint64_t serial;             /* Stamp of the newest changed frame */
+   uint64_t frames;
+   uint64_t dupes;
+   uint64_t bytes_in;           /* Bytes submitted for upload */
+   uint64_t bytes_upload;       /* Bytes in the changed rows */
+   struct
+   {
+      unsigned y;
+      unsigned height;
+   } history[VIDEO_FRAME_DIRTY_HISTORY];
+   unsigned width;
+   unsigned height;
+   unsigned bpp;
+} video_frame_dirty_t;
+
 typedef struct video_frame_info
 {
    void *userdata;
    void *widgets_userdata;
    void *disp_userdata;
+   /* Set when the frame went through row diffing,
+    * see video_frame_dirty_rows() */
+   const video_frame_dirty_t *frame_dirty;
 
    int custom_vp_x;
    int custom_vp_y;
@@ -478,6 +511,7 @@ typedef struct video_frame_info
    bool framecount_show;
    bool core_status_msg_show;
    bool post_filter_record;
+   bool frame_diff;
    bool windowed_fullscreen;
    bool fullscreen;
    bool font_enable;
@@ -631,6 +665,30 @@ typedef struct gfx_ctx_ident
    const char *ident;
 } gfx_ctx_ident_t;
 
+/* Receives a viewport captured by read_viewport_async, in the same
+ * bottom-up BGR24 layout read_viewport writes. @buffer is malloc'ed
+ * and owned by the callback, NULL if the capture was dropped. */
+typedef void (*video_viewport_read_cb_t)(void *userdata,
+      uint8_t *buffer, unsigned width, unsigned height);
+
+#define VIDEO_READBACK_QUEUE_SIZE 32
+
+typedef struct video_readback_request
+{
+   video_viewport_read_cb_t cb;
+   void *userdata;
+   unsigned width;
+   unsigned height;
+} video_readback_request_t;
+
+/* Captures waiting for the driver to render a frame */
+typedef struct video_readback_queue
+{
+   video_readback_request_t req[VIDEO_READBACK_QUEUE_SIZE];
+   unsigned head;
+   unsigned count;
+} video_readback_queue_t;
+
 /* Optionally implemented interface to poke more
  * deeply into video driver. */
 
@@ -681,6 +739,12 @@ typedef struct video_poke_interface
    void (*set_hdr_paper_white_nits)(void *data, float paper_white_nits);
    void (*set_hdr_contrast)(void *data, float contrast);
    void (*set_hdr_expand_gamut)(void *data, bool expand_gamut);
+
+   /* Queues a capture of the next rendered viewport without waiting
+    * for the GPU; @cb is called from a later frame once the pixels
+    * have arrived. Every call captures one more frame. */
+   bool (*read_viewport_async)(void *data,
+         video_viewport_read_cb_t cb, void *userdata);
 } video_poke_interface_t;
 
 /* msg is for showing a message on the screen
@@ -773,6 +837,36 @@ typedef struct video_driver
 #endif
 } video_driver_t;
 
+/* Distribution of core run times for the running core and
+ * content, persisted across sessions. Automatic frame delay picks
+ * the largest delay the distribution says will still fit. */
+typedef struct video_frame_delay_model
+{
+   uint32_t histogram[FRAME_DELAY_MODEL_BUCKETS];
+   uint32_t samples;     /* Sum of histogram; decays over time */
+   uint32_t frames;      /* Frames recorded this session */
+   uint32_t misses;      /* Frames where delay + run time overran */
+   uint8_t delay;        /* Last delay picked by the model, which
+                          * the effective delay steps towards */
+   char path[PATH_MAX_LENGTH];
+   char core[NAME_MAX_LENGTH];
+} video_frame_delay_model_t;
+
+typedef struct video_frame_delay_stats
+{
+   unsigned run_time_p50; /* usec */
+   unsigned run_time_p90;
+   unsigned run_time_p99;
+   unsigned samples;
+   unsigned frames;
+   unsigned misses;
+   unsigned miss_target;  /* Late frames per 1000 */
+   uint8_t delay;
+   uint8_t pick;          /* Last delay picked by the model */
+   uint8_t target;
+   bool active;           /* Model is driving the delay */
+} video_frame_delay_stats_t;
+
 typedef struct
 {
 #ifdef HAVE_CRTSWITCHRES
@@ -869,6 +963,9 @@ typedef struct
    char title_buf[64];
    char cached_driver_id[32];
 
+   video_frame_delay_model_t frame_delay_model;
+   video_frame_dirty_t frame_dirty;
+
    uint16_t frame_drop_count;
    uint16_t frame_time_reserve;
    uint8_t frame_delay_target;
@@ -1138,6 +1235,72 @@ void video_frame_delay(video_driver_state_t *video_st,
 void video_frame_delay_auto(video_driver_state_t *video_st,
       video_frame_delay_auto_t *vfda);
 
+/**
+ * video_frame_delay_model_load:
+ * @savefile     : save file path of the content; the model is
+ *                 stored next to it with a .fdm extension.
+ * @core         : library name of the running core. A model
+ *                 recorded with another core is discarded.
+ *
+ * Loads the frame delay model for newly started content.
+ **/
+void video_frame_delay_model_load(const char *savefile, const char *core);
+
+/**
+ * video_frame_delay_model_save:
+ *
+ * Writes the frame delay model back for the content being closed,
+ * and clears it.
+ **/
+void video_frame_delay_model_save(void);
+
+/**
+ * video_frame_delay_model_get_stats:
+ * @stats        : filled with the current model state.
+ *
+ * Returns: true if automatic frame delay is using the model.
+ **/
+bool video_frame_delay_model_get_stats(video_frame_delay_stats_t *stats);
+
+/**
+ * video_frame_dirty_rows:
+ * @video_info   : info passed to the driver's frame callback.
+ * @stamp        : per-texture stamp kept by the driver, 0 when the
+ *                 texture holds nothing yet. Updated to the new frame.
+ * @y            : first row to upload.
+ * @height       : number of rows to upload, 0 if the texture is
+ *                 already up to date.
+ *
+ * Works out which rows of the current frame differ from the
+ * frame the texture was last filled with.
+ *
+ * Returns: true if only @y/@height need uploading, false if
+ * the whole frame has to be uploaded.
+ **/
+bool video_frame_dirty_rows(const video_frame_info_t *video_info,
+      uint64_t *stamp, unsigned *y, unsigned *height);
+
+/**
+ * video_frame_dirty_get_stats:
+ *
+ * Returns: the row diffing counters, NULL if no frame was diffed yet.
+ **/
+const video_frame_dirty_t *video_frame_dirty_get_stats(void);
+
+bool video_readback_queue_push(video_readback_queue_t *queue,
+      video_viewport_read_cb_t cb, void *userdata);
+
+bool video_readback_queue_pop(video_readback_queue_t *queue,
+      video_readback_request_t *req);
+
+/**
+ * video_readback_queue_flush:
+ *
+ * Drops every queued capture, telling each callback
+ * with a NULL buffer.
+ **/
+void video_readback_queue_flush(video_readback_queue_t *queue);
+
 /**
  * video_context_driver_init:
  * @core_set_shared_context : Boolean value that tells us whether shared context
@@ -44,6 +44,14 @@ struct rarch_soft_plug
    const struct softfilter_implementation *impl;
 };
 
+/* With automatic threading, frames are cut into packets of roughly
+ * this many input bytes so each one's working set stays in L2. */
+#define SOFTFILTER_PACKET_BYTES (64 * 1024)
+#define SOFTFILTER_MAX_PACKETS  64
+/* Times an idle worker polls for more work, without taking the
+ * lock, before it goes to sleep on the condition variable. */
+#define SOFTFILTER_SPIN_COUNT   256
+
 struct rarch_softfilter
 {
    config_file_t *conf;
@@ -58,51 +66,184 @@ struct rarch_softfilter
    enum retro_pixel_format pix_fmt, out_pix_fmt;
 
    struct softfilter_work_packet *packets;
-   unsigned threads;
+   unsigned num_packets;
 
 #ifdef HAVE_THREADS
-   struct filter_thread_data *thread_data;
+   struct filter_thread_pool *pool;
 #endif
 };
 
 #ifdef HAVE_THREADS
 #include <rthreads/rthreads.h>
 
-struct filter_thread_data
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOFTFILTER_CPU_PAUSE() _mm_pause()
+#elif defined(__GNUC__) && (defined(__aarch64__) || (defined(__ARM_ARCH) && __ARM_ARCH >= 7))
+#define SOFTFILTER_CPU_PAUSE() __asm__ __volatile__("yield")
+#else
+#define SOFTFILTER_CPU_PAUSE() ((void)0)
+#endif
+
+/* Workers persist for the lifetime of the filter and pull packets
+ * off a shared counter, so a frame costs one broadcast rather than
+ * a signal/wait pair per thread. The calling thread works too. */
+struct filter_thread_pool
 {
-   sthread_t *thread;
-   const struct softfilter_work_packet *packet;
-   scond_t *cond;
+   sthread_t **threads;
    slock_t *lock;
+   scond_t *cond_work;
+   scond_t *cond_done;
+   const struct softfilter_work_packet *packets;
    void *userdata;
+   unsigned num_threads;
+   unsigned num_packets;
+   unsigned next;
+   unsigned pending;
    bool die;
-   bool done;
 };
 
+/* Runs packets until none are left. Called with the lock held,
+ * returns with it held. */
+static void filter_thread_pool_drain(struct filter_thread_pool *pool)
+{
+   while (pool->next < pool->num_packets)
+   {
+      const struct softfilter_work_packet *packet =
+         &pool->packets[pool->next++];
+
+      slock_unlock(pool->lock);
+      if (packet->work)
+         packet->work(pool->userdata, packet->thread_data);
+      slock_lock(pool->lock);
+
+      if (--pool->pending == 0)
+         scond_signal(pool->cond_done);
+   }
+}
+
+/* Polls for a new frame without holding the lock, so idle workers
+ * do not fight the calling thread for it. The reads may race with
+ * filter_thread_pool_run(); they only decide when to take the lock,
+ * and the state is checked again under it. */
+static void filter_thread_pool_spin(struct filter_thread_pool *pool)
+{
+   const volatile unsigned *next        = &pool->next;
+   const volatile unsigned *num_packets = &pool->num_packets;
+   const volatile bool *die             = &pool->die;
+   unsigned spins;
+
+   for (spins = 0; spins < SOFTFILTER_SPIN_COUNT; spins++)
+   {
+      if (*die || *next < *num_packets)
+         return;
+      SOFTFILTER_CPU_PAUSE();
+   }
+}
+
 static void filter_thread_loop(void *data)
 {
-   struct filter_thread_data *thr = (struct filter_thread_data*)data;
+   struct filter_thread_pool *pool = (struct filter_thread_pool*)data;
+
+   slock_lock(pool->lock);
 
    for (;;)
    {
-      bool die;
-      slock_lock(thr->lock);
-      while (thr->done && !thr->die)
-         scond_wait(thr->cond, thr->lock);
-      die = thr->die;
-      slock_unlock(thr->lock);
-
-      if (die)
+      if (!pool->die && pool->next >= pool->num_packets)
+      {
+         slock_unlock(pool->lock);
+         filter_thread_pool_spin(pool);
+         slock_lock(pool->lock);
+
+         while (!pool->die && pool->next >= pool->num_packets)
+            scond_wait(pool->cond_work, pool->lock);
+      }
+
+      if (pool->die)
          break;
 
-      if (thr->packet && thr->packet->work)
-         thr->packet->work(thr->userdata, thr->packet->thread_data);
+      filter_thread_pool_drain(pool);
+   }
+
+   slock_unlock(pool->lock);
+}
+
+static void filter_thread_pool_free(struct filter_thread_pool *pool)
+{
+   unsigned i;
+
+   if (!pool)
+      return;
 
-      slock_lock(thr->lock);
-      thr->done = true;
-      scond_signal(thr->cond);
-      slock_unlock(thr->lock);
+   if (pool->lock)
+   {
+      slock_lock(pool->lock);
+      pool->die = true;
+      if (pool->cond_work)
+         scond_broadcast(pool->cond_work);
+      slock_unlock(pool->lock);
    }
+
+   for (i = 0; i < pool->num_threads; i++)
+      sthread_join(pool->threads[i]);
+
+   if (pool->cond_work)
+      scond_free(pool->cond_work);
+   if (pool->cond_done)
+      scond_free(pool->cond_done);
+   if (pool->lock)
+      slock_free(pool->lock);
+   free(pool->threads);
+   free(pool);
+}
+
+static struct filter_thread_pool *filter_thread_pool_new(
+      unsigned num_threads, void *userdata)
+{
+   struct filter_thread_pool *pool = (struct filter_thread_pool*)
+      calloc(1, sizeof(*pool));
+
+   if (!pool)
+      return NULL;
+
+   pool->userdata = userdata;
+
+   if (   !(pool->threads   = (sthread_t**)
+            calloc(num_threads, sizeof(*pool->threads)))
+       || !(pool->lock      = slock_new())
+       || !(pool->cond_work = scond_new())
+       || !(pool->cond_done = scond_new()))
+      goto error;
+
+   for (; pool->num_threads < num_threads; pool->num_threads++)
+   {
+      if (!(pool->threads[pool->num_threads] = sthread_create(
+            filter_thread_loop, pool)))
+         goto error;
+   }
+
+   return pool;
+
+error:
+   filter_thread_pool_free(pool);
+   return NULL;
+}
+
+static void filter_thread_pool_run(struct filter_thread_pool *pool,
+      const struct softfilter_work_packet *packets, unsigned num_packets)
+{
+   slock_lock(pool->lock);
+   pool->packets     = packets;
+   pool->num_packets = num_packets;
+   pool->next        = 0;
+   pool->pending     = num_packets;
+   scond_broadcast(pool->cond_work);
+
+   filter_thread_pool_drain(pool);
+
+   while (pool->pending)
+      scond_wait(pool->cond_done, pool->lock);
+   slock_unlock(pool->lock);
 }
 #endif
 
@@ -136,7 +277,7 @@ static bool create_softfilter_graph(rarch_softfilter_t *filt,
       softfilter_simd_mask_t cpu_features,
       unsigned threads)
 {
-   unsigned input_fmts, input_fmt, output_fmts;
+   unsigned input_fmts, input_fmt, output_fmts, cores;
    struct config_file_userdata userdata;
    char key[64], name[64];
    name[0] = '\0';
@@ -204,11 +345,28 @@ static bool create_softfilter_graph(rarch_softfilter_t *filt,
    filt->max_width = max_width;
    filt->max_height = max_height;
 
+   /* Ask the filter for as many packets as it takes to keep each
+    * one cache-sized; tiny frames end up with a single packet and
+    * never touch the thread pool. */
+   cores = cpu_features_get_core_amount();
+   if (threads == RARCH_SOFTFILTER_THREADS_AUTO)
+   {
+      size_t frame_bytes = (size_t)max_width * max_height *
+         (input_fmt == SOFTFILTER_FMT_XRGB8888
+          ? sizeof(uint32_t) : sizeof(uint16_t));
+
+      threads = (unsigned)((frame_bytes + SOFTFILTER_PACKET_BYTES - 1)
+            / SOFTFILTER_PACKET_BYTES);
+      threads = MIN(MAX(threads, 1), SOFTFILTER_MAX_PACKETS);
+      if (cores <= 1)
+         threads = 1;
+   }
+   else
+      cores   = threads;
+
    filt->impl_data = filt->impl->create(
          &softfilter_config, input_fmt, input_fmt, max_width, max_height,
-         threads != RARCH_SOFTFILTER_THREADS_AUTO ? threads :
-         cpu_features_get_core_amount(), cpu_features,
-         &userdata);
+         threads, cpu_features, &userdata);
    if (!filt->impl_data)
    {
       RARCH_ERR("Failed to create softfilter state.\n");
@@ -222,8 +380,7 @@ static bool create_softfilter_graph(rarch_softfilter_t *filt,
       return false;
    }
 
-   filt->threads = threads;
-   RARCH_LOG("Using %u threads for softfilter.\n", threads);
+   filt->num_packets = threads;
 
    filt->packets = (struct softfilter_work_packet*)
       calloc(threads, sizeof(*filt->packets));
@@ -234,32 +391,20 @@ static bool create_softfilter_graph(rarch_softfilter_t *filt,
    }
 
 #ifdef HAVE_THREADS
-   if (filt->threads > 1)
+   /* The calling thread takes packets as well */
+   threads = MIN(threads, cores) - 1;
+   if (threads > 0)
    {
-      unsigned i;
-      if (!(filt->thread_data = (struct filter_thread_data*)
-         calloc(threads, sizeof(*filt->thread_data))))
+      if (!(filt->pool = filter_thread_pool_new(threads, filt->impl_data)))
          return false;
-
-      for (i = 0; i < threads; i++)
-      {
-         filt->thread_data[i].userdata = filt->impl_data;
-         filt->thread_data[i].done     = true;
-
-         filt->thread_data[i].lock     = slock_new();
-         if (!filt->thread_data[i].lock)
-            return false;
-         filt->thread_data[i].cond     = scond_new();
-         if (!filt->thread_data[i].cond)
-            return false;
-         filt->thread_data[i].thread   = sthread_create(
-               filter_thread_loop, &filt->thread_data[i]);
-         if (!filt->thread_data[i].thread)
-            return false;
-      }
    }
+#else
+   threads = 0;
 #endif
 
+   RARCH_LOG("[SoftFilter]: Using %u work packets on %u threads.\n",
+         filt->num_packets, threads + 1);
+
    return true;
 }
 
@@ -483,6 +628,11 @@ void rarch_softfilter_free(rarch_softfilter_t *filt)
    if (!filt)
       return;
 
+#ifdef HAVE_THREADS
+   /* Workers must be gone before the filter state they run on */
+   filter_thread_pool_free(filt->pool);
+#endif
+
    free(filt->packets);
    if (filt->impl && filt->impl_data)
       filt->impl->destroy(filt->impl_data);
@@ -496,25 +646,6 @@ void rarch_softfilter_free(rarch_softfilter_t *filt)
    free(filt->plugs);
 #endif
 
-#ifdef HAVE_THREADS
-   if (filt->threads > 1)
-   {
-      for (i = 0; i < filt->threads; i++)
-      {
-         if (!filt->thread_data[i].thread)
-            continue;
-         slock_lock(filt->thread_data[i].lock);
-         filt->thread_data[i].die = true;
-         scond_signal(filt->thread_data[i].cond);
-         slock_unlock(filt->thread_data[i].lock);
-         sthread_join(filt->thread_data[i].thread);
-         slock_free(filt->thread_data[i].lock);
-         scond_free(filt->thread_data[i].cond);
-      }
-      free(filt->thread_data);
-   }
-#endif
-
    if (filt->conf)
       config_file_free(filt->conf);
 
@@ -558,36 +689,13 @@ void rarch_softfilter_process(rarch_softfilter_t *filt,
             output, output_stride, input, width, height, input_stride);
 
 #ifdef HAVE_THREADS
-   if (filt->threads > 1)
+   if (filt->pool)
    {
-      /* Fire off workers */
-      for (i = 0; i < filt->threads; i++)
-      {
-#if 0
-         RARCH_LOG("Firing off filter thread %u ...\n", i);
-#endif
-         filt->thread_data[i].packet = &filt->packets[i];
-         slock_lock(filt->thread_data[i].lock);
-         filt->thread_data[i].done = false;
-         scond_signal(filt->thread_data[i].cond);
-         slock_unlock(filt->thread_data[i].lock);
-      }
-
-      /* Wait for workers */
-      for (i = 0; i < filt->threads; i++)
-      {
-#if 0
-         RARCH_LOG("Waiting for filter thread %u ...\n", i);
-#endif
-         slock_lock(filt->thread_data[i].lock);
-         while (!filt->thread_data[i].done)
-            scond_wait(filt->thread_data[i].cond, filt->thread_data[i].lock);
-         slock_unlock(filt->thread_data[i].lock);
-      }
+      filter_thread_pool_run(filt->pool, filt->packets, filt->num_packets);
       return;
    }
 #endif
 
-   for (i = 0; i < filt->threads; i++)
+   for (i = 0; i < filt->num_packets; i++)
       filt->packets[i].work(filt->impl_data, filt->packets[i].thread_data);
 }
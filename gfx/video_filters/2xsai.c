@@ -18,6 +18,25 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+/* Built regardless of compiler flags, used when the SIMD mask has it */
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(__clang__) || (defined(__GNUC__) \
+      && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define TWOXSAI_HAVE_AVX2
+#define TWOXSAI_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && _MSC_VER >= 1900
+#define TWOXSAI_HAVE_AVX2
+#define TWOXSAI_AVX2_TARGET
+#endif
+#endif
+#endif
+
+#ifdef TWOXSAI_HAVE_AVX2
+#include <immintrin.h>
+#endif
+
 #ifdef RARCH_INTERNAL
 #define softfilter_get_implementation twoxsai_get_implementation
 #define softfilter_thread_data twoxsai_softfilter_thread_data
@@ -39,13 +58,280 @@ struct softfilter_thread_data
    int last;
 };
 
+/* Expands pixels [0, n) of a line, returns n */
+typedef unsigned (*twoxsai_simd_rgb565_t)(const uint16_t *in,
+      uint16_t *out, unsigned nextline, unsigned dst_stride,
+      unsigned width);
+typedef unsigned (*twoxsai_simd_xrgb8888_t)(const uint32_t *in,
+      uint32_t *out, unsigned nextline, unsigned dst_stride,
+      unsigned width);
+
 struct filter_data
 {
    unsigned threads;
    struct softfilter_thread_data *workers;
    unsigned in_fmt;
+   twoxsai_simd_rgb565_t simd_rgb565;
+   twoxsai_simd_xrgb8888_t simd_xrgb8888;
 };
 
+/* Vector version of twoxsai_function(). Every branch is evaluated
+ * for every lane and the results picked with masks, in the same
+ * order of precedence as the scalar code, so output is identical.
+ *
+ * A lane reads exactly the pixels the scalar code reads for the same
+ * position, so any run of pixels can go through here.
+ *
+ * twoxsai_result() is (A != C || A != D) - (B != C || B != D); with
+ * all-ones compare masks that is (A == C && A == D) - (B == C && B == D)
+ * after both sides are negated, which is what r adds up. */
+#define TWOXSAI_INTERPOLATE(V, A, B) V##_ADD(V##_ADD( \
+         V##_SRL(V##_AND(A, V##_SET1(V##_MASK1)), 1), \
+         V##_SRL(V##_AND(B, V##_SET1(V##_MASK1)), 1)), \
+      V##_AND(V##_AND(A, B), V##_SET1(V##_LOW1)))
+
+#define TWOXSAI_INTERPOLATE2(V, A, B, C, D) V##_ADD(V##_ADD(V##_ADD( \
+         V##_SRL(V##_AND(A, V##_SET1(V##_MASK2)), 2), \
+         V##_SRL(V##_AND(B, V##_SET1(V##_MASK2)), 2)), V##_ADD( \
+         V##_SRL(V##_AND(C, V##_SET1(V##_MASK2)), 2), \
+         V##_SRL(V##_AND(D, V##_SET1(V##_MASK2)), 2))), \
+      V##_AND(V##_SRL(V##_ADD(V##_ADD( \
+         V##_AND(A, V##_SET1(V##_LOW2)), V##_AND(B, V##_SET1(V##_LOW2))), V##_ADD( \
+         V##_AND(C, V##_SET1(V##_LOW2)), V##_AND(D, V##_SET1(V##_LOW2)))), 2), \
+         V##_SET1(V##_LOW2)))
+
+#define TWOXSAI_EQ2(V, A, B, C) V##_AND(V##_EQ(A, B), V##_EQ(A, C))
+
+#define TWOXSAI_SIMD_ROW(V, n) \
+   for (; x + n <= width; x += n) \
+   { \
+      V##_T colorI     = V##_LOAD(in + x - nextline - 1); \
+      V##_T colorE     = V##_LOAD(in + x - nextline + 0); \
+      V##_T colorF     = V##_LOAD(in + x - nextline + 1); \
+      V##_T colorJ     = V##_LOAD(in + x - nextline + 2); \
+      V##_T colorG     = V##_LOAD(in + x - 1); \
+      V##_T colorA     = V##_LOAD(in + x + 0); \
+      V##_T colorB     = V##_LOAD(in + x + 1); \
+      V##_T colorK     = V##_LOAD(in + x + 2); \
+      V##_T colorH     = V##_LOAD(in + x + nextline - 1); \
+      V##_T colorC     = V##_LOAD(in + x + nextline + 0); \
+      V##_T colorD     = V##_LOAD(in + x + nextline + 1); \
+      V##_T colorL     = V##_LOAD(in + x + nextline + 2); \
+      V##_T colorM     = V##_LOAD(in + x + nextline + nextline - 1); \
+      V##_T colorN     = V##_LOAD(in + x + nextline + nextline + 0); \
+      V##_T colorO     = V##_LOAD(in + x + nextline + nextline + 1); \
+      V##_T zero       = V##_ZERO(); \
+      V##_T ones       = V##_EQ(zero, zero); \
+      V##_T eq_ad      = V##_EQ(colorA, colorD); \
+      V##_T eq_bc      = V##_EQ(colorB, colorC); \
+      V##_T eq_ab      = V##_EQ(colorA, colorB); \
+      /* The four top level cases */ \
+      V##_T c1         = V##_BIC(eq_ad, eq_bc); \
+      V##_T c2         = V##_BIC(eq_bc, eq_ad); \
+      V##_T c3         = V##_AND(eq_ad, eq_bc); \
+      V##_T c4         = V##_BIC(ones, V##_OR(eq_ad, eq_bc)); \
+      /* Patterns the branches test */ \
+      V##_T pa         = V##_AND(TWOXSAI_EQ2(V, colorA, colorC, colorF), \
+            V##_BIC(V##_EQ(colorB, colorJ), V##_EQ(colorB, colorE))); \
+      V##_T pb         = V##_AND(TWOXSAI_EQ2(V, colorB, colorE, colorD), \
+            V##_BIC(V##_EQ(colorA, colorI), V##_EQ(colorA, colorF))); \
+      V##_T p1a        = V##_AND(TWOXSAI_EQ2(V, colorA, colorB, colorH), \
+            V##_BIC(V##_EQ(colorC, colorM), V##_EQ(colorG, colorC))); \
+      V##_T p1c        = V##_AND(TWOXSAI_EQ2(V, colorC, colorG, colorD), \
+            V##_BIC(V##_EQ(colorA, colorI), V##_EQ(colorA, colorH))); \
+      V##_T r          = V##_SUB( \
+            V##_ADD(V##_ADD(TWOXSAI_EQ2(V, colorA, colorG, colorE), \
+                  TWOXSAI_EQ2(V, colorB, colorK, colorF)), \
+               V##_ADD(TWOXSAI_EQ2(V, colorB, colorH, colorN), \
+                  TWOXSAI_EQ2(V, colorA, colorL, colorO))), \
+            V##_ADD(V##_ADD(TWOXSAI_EQ2(V, colorB, colorG, colorE), \
+                  TWOXSAI_EQ2(V, colorA, colorK, colorF)), \
+               V##_ADD(TWOXSAI_EQ2(V, colorA, colorH, colorN), \
+                  TWOXSAI_EQ2(V, colorB, colorL, colorO)))); \
+      /* Where each product takes a source pixel instead of a blend */ \
+      V##_T sel_a      = V##_OR(V##_OR( \
+            V##_AND(c1, V##_OR(V##_AND(V##_EQ(colorA, colorE), \
+                     V##_EQ(colorB, colorL)), pa)), \
+            V##_AND(c3, eq_ab)), V##_AND(c4, pa)); \
+      V##_T sel_b      = V##_OR( \
+            V##_AND(c2, V##_OR(V##_AND(V##_EQ(colorB, colorF), \
+                     V##_EQ(colorA, colorH)), pb)), \
+            V##_AND(c4, V##_BIC(pb, pa))); \
+      V##_T sel1_a     = V##_OR(V##_OR( \
+            V##_AND(c1, V##_OR(V##_AND(V##_EQ(colorA, colorG), \
+                     V##_EQ(colorC, colorO)), p1a)), \
+            V##_AND(c3, eq_ab)), V##_AND(c4, p1a)); \
+      V##_T sel1_c     = V##_OR( \
+            V##_AND(c2, V##_OR(V##_AND(V##_EQ(colorC, colorH), \
+                     V##_EQ(colorA, colorF)), p1c)), \
+            V##_AND(c4, V##_BIC(p1c, p1a))); \
+      V##_T sel2_a     = V##_OR(c1, V##_AND(c3, \
+               V##_OR(eq_ab, V##_GT(r, zero)))); \
+      V##_T sel2_b     = V##_OR(c2, V##_AND(c3, \
+               V##_BIC(V##_GT(zero, r), eq_ab))); \
+      V##_T product    = V##_SEL(sel_a, colorA, V##_SEL(sel_b, colorB, \
+               TWOXSAI_INTERPOLATE(V, colorA, colorB))); \
+      V##_T product1   = V##_SEL(sel1_a, colorA, V##_SEL(sel1_c, colorC, \
+               TWOXSAI_INTERPOLATE(V, colorA, colorC))); \
+      V##_T product2   = V##_SEL(sel2_a, colorA, V##_SEL(sel2_b, colorB, \
+               TWOXSAI_INTERPOLATE2(V, colorA, colorB, colorC, colorD))); \
+      V##_STORE_ZIP(out + (x << 1), colorA, product); \
+      V##_STORE_ZIP(out + dst_stride + (x << 1), product1, product2); \
+   }
+
+#if defined(__SSE2__)
+#define TWOXSAI_SSE2_T            __m128i
+#define TWOXSAI_SSE2_LOAD(p)      _mm_loadu_si128((const __m128i*)(p))
+#define TWOXSAI_SSE2_ZERO()       _mm_setzero_si128()
+#define TWOXSAI_SSE2_AND(a, b)    _mm_and_si128(a, b)
+#define TWOXSAI_SSE2_OR(a, b)     _mm_or_si128(a, b)
+#define TWOXSAI_SSE2_BIC(a, m)    _mm_andnot_si128(m, a)
+#define TWOXSAI_SSE2_SEL(m, a, b) _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b))
+
+#define TWOXSAI_SSE2_16_T         TWOXSAI_SSE2_T
+#define TWOXSAI_SSE2_16_LOAD      TWOXSAI_SSE2_LOAD
+#define TWOXSAI_SSE2_16_ZERO      TWOXSAI_SSE2_ZERO
+#define TWOXSAI_SSE2_16_AND       TWOXSAI_SSE2_AND
+#define TWOXSAI_SSE2_16_OR        TWOXSAI_SSE2_OR
+#define TWOXSAI_SSE2_16_BIC       TWOXSAI_SSE2_BIC
+#define TWOXSAI_SSE2_16_SEL       TWOXSAI_SSE2_SEL
+#define TWOXSAI_SSE2_16_EQ(a, b)  _mm_cmpeq_epi16(a, b)
+#define TWOXSAI_SSE2_16_GT(a, b)  _mm_cmpgt_epi16(a, b)
+#define TWOXSAI_SSE2_16_ADD(a, b) _mm_add_epi16(a, b)
+#define TWOXSAI_SSE2_16_SUB(a, b) _mm_sub_epi16(a, b)
+#define TWOXSAI_SSE2_16_SRL(a, n) _mm_srli_epi16(a, n)
+#define TWOXSAI_SSE2_16_SET1(c)   _mm_set1_epi16((short)(c))
+#define TWOXSAI_SSE2_16_STORE_ZIP(p, a, b) \
+   _mm_storeu_si128((__m128i*)(p),     _mm_unpacklo_epi16(a, b)); \
+   _mm_storeu_si128((__m128i*)(p) + 1, _mm_unpackhi_epi16(a, b))
+
+#define TWOXSAI_SSE2_32_T         TWOXSAI_SSE2_T
+#define TWOXSAI_SSE2_32_LOAD      TWOXSAI_SSE2_LOAD
+#define TWOXSAI_SSE2_32_ZERO      TWOXSAI_SSE2_ZERO
+#define TWOXSAI_SSE2_32_AND       TWOXSAI_SSE2_AND
+#define TWOXSAI_SSE2_32_OR        TWOXSAI_SSE2_OR
+#define TWOXSAI_SSE2_32_BIC       TWOXSAI_SSE2_BIC
+#define TWOXSAI_SSE2_32_SEL       TWOXSAI_SSE2_SEL
+#define TWOXSAI_SSE2_32_EQ(a, b)  _mm_cmpeq_epi32(a, b)
+#define TWOXSAI_SSE2_32_GT(a, b)  _mm_cmpgt_epi32(a, b)
+#define TWOXSAI_SSE2_32_ADD(a, b) _mm_add_epi32(a, b)
+#define TWOXSAI_SSE2_32_SUB(a, b) _mm_sub_epi32(a, b)
+#define TWOXSAI_SSE2_32_SRL(a, n) _mm_srli_epi32(a, n)
+#define TWOXSAI_SSE2_32_SET1(c)   _mm_set1_epi32((int)(c))
+#define TWOXSAI_SSE2_32_STORE_ZIP(p, a, b) \
+   _mm_storeu_si128((__m128i*)(p),     _mm_unpacklo_epi32(a, b)); \
+   _mm_storeu_si128((__m128i*)(p) + 1, _mm_unpackhi_epi32(a, b))
+#endif
+
+#ifdef TWOXSAI_HAVE_AVX2
+#define TWOXSAI_AVX2_T            __m256i
+#define TWOXSAI_AVX2_LOAD(p)      _mm256_loadu_si256((const __m256i*)(p))
+#define TWOXSAI_AVX2_ZERO()       _mm256_setzero_si256()
+#define TWOXSAI_AVX2_AND(a, b)    _mm256_and_si256(a, b)
+#define TWOXSAI_AVX2_OR(a, b)     _mm256_or_si256(a, b)
+#define TWOXSAI_AVX2_BIC(a, m)    _mm256_andnot_si256(m, a)
+#define TWOXSAI_AVX2_SEL(m, a, b) _mm256_blendv_epi8(b, a, m)
+/* unpacklo/hi work within 128-bit halves, so put the halves back
+ * in order before storing */
+#define TWOXSAI_AVX2_STORE(p, lo, hi) \
+   _mm256_storeu_si256((__m256i*)(p),     _mm256_permute2x128_si256(lo, hi, 0x20)); \
+   _mm256_storeu_si256((__m256i*)(p) + 1, _mm256_permute2x128_si256(lo, hi, 0x31))
+
+#define TWOXSAI_AVX2_16_T         TWOXSAI_AVX2_T
+#define TWOXSAI_AVX2_16_LOAD      TWOXSAI_AVX2_LOAD
+#define TWOXSAI_AVX2_16_ZERO      TWOXSAI_AVX2_ZERO
+#define TWOXSAI_AVX2_16_AND       TWOXSAI_AVX2_AND
+#define TWOXSAI_AVX2_16_OR        TWOXSAI_AVX2_OR
+#define TWOXSAI_AVX2_16_BIC       TWOXSAI_AVX2_BIC
+#define TWOXSAI_AVX2_16_SEL       TWOXSAI_AVX2_SEL
+#define TWOXSAI_AVX2_16_EQ(a, b)  _mm256_cmpeq_epi16(a, b)
+#define TWOXSAI_AVX2_16_GT(a, b)  _mm256_cmpgt_epi16(a, b)
+#define TWOXSAI_AVX2_16_ADD(a, b) _mm256_add_epi16(a, b)
+#define TWOXSAI_AVX2_16_SUB(a, b) _mm256_sub_epi16(a, b)
+#define TWOXSAI_AVX2_16_SRL(a, n) _mm256_srli_epi16(a, n)
+#define TWOXSAI_AVX2_16_SET1(c)   _mm256_set1_epi16((short)(c))
+#define TWOXSAI_AVX2_16_STORE_ZIP(p, a, b) \
+   TWOXSAI_AVX2_STORE(p, _mm256_unpacklo_epi16(a, b), _mm256_unpackhi_epi16(a, b))
+
+#define TWOXSAI_AVX2_32_T         TWOXSAI_AVX2_T
+#define TWOXSAI_AVX2_32_LOAD      TWOXSAI_AVX2_LOAD
+#define TWOXSAI_AVX2_32_ZERO      TWOXSAI_AVX2_ZERO
+#define TWOXSAI_AVX2_32_AND       TWOXSAI_AVX2_AND
+#define TWOXSAI_AVX2_32_OR        TWOXSAI_AVX2_OR
+#define TWOXSAI_AVX2_32_BIC       TWOXSAI_AVX2_BIC
+#define TWOXSAI_AVX2_32_SEL       TWOXSAI_AVX2_SEL
+#define TWOXSAI_AVX2_32_EQ(a, b)  _mm256_cmpeq_epi32(a, b)
+#define TWOXSAI_AVX2_32_GT(a, b)  _mm256_cmpgt_epi32(a, b)
+#define TWOXSAI_AVX2_32_ADD(a, b) _mm256_add_epi32(a, b)
+#define TWOXSAI_AVX2_32_SUB(a, b) _mm256_sub_epi32(a, b)
+#define TWOXSAI_AVX2_32_SRL(a, n) _mm256_srli_epi32(a, n)
+#define TWOXSAI_AVX2_32_SET1(c)   _mm256_set1_epi32((int)(c))
+#define TWOXSAI_AVX2_32_STORE_ZIP(p, a, b) \
+   TWOXSAI_AVX2_STORE(p, _mm256_unpacklo_epi32(a, b), _mm256_unpackhi_epi32(a, b))
+#endif
+
+/* Same masks as the scalar interpolate callbacks */
+#define TWOXSAI_SSE2_16_MASK1     0xF7DE
+#define TWOXSAI_SSE2_16_LOW1      0x0821
+#define TWOXSAI_SSE2_16_MASK2     0xE79C
+#define TWOXSAI_SSE2_16_LOW2      0x1863
+#define TWOXSAI_SSE2_32_MASK1     0xFEFEFEFE
+#define TWOXSAI_SSE2_32_LOW1      0x01010101
+#define TWOXSAI_SSE2_32_MASK2     0xFCFCFCFC
+#define TWOXSAI_SSE2_32_LOW2      0x03030303
+#define TWOXSAI_AVX2_16_MASK1     TWOXSAI_SSE2_16_MASK1
+#define TWOXSAI_AVX2_16_LOW1      TWOXSAI_SSE2_16_LOW1
+#define TWOXSAI_AVX2_16_MASK2     TWOXSAI_SSE2_16_MASK2
+#define TWOXSAI_AVX2_16_LOW2      TWOXSAI_SSE2_16_LOW2
+#define TWOXSAI_AVX2_32_MASK1     TWOXSAI_SSE2_32_MASK1
+#define TWOXSAI_AVX2_32_LOW1      TWOXSAI_SSE2_32_LOW1
+#define TWOXSAI_AVX2_32_MASK2     TWOXSAI_SSE2_32_MASK2
+#define TWOXSAI_AVX2_32_LOW2      TWOXSAI_SSE2_32_LOW2
+
+#if defined(__SSE2__)
+static unsigned twoxsai_simd_rgb565_sse2(const uint16_t *in,
+      uint16_t *out, unsigned nextline, unsigned dst_stride,
+      unsigned width)
+{
+   unsigned x = 0;
+   TWOXSAI_SIMD_ROW(TWOXSAI_SSE2_16, 8)
+   return x;
+}
+
+static unsigned twoxsai_simd_xrgb8888_sse2(const uint32_t *in,
+      uint32_t *out, unsigned nextline, unsigned dst_stride,
+      unsigned width)
+{
+   unsigned x = 0;
+   TWOXSAI_SIMD_ROW(TWOXSAI_SSE2_32, 4)
+   return x;
+}
+#endif
+
+#ifdef TWOXSAI_HAVE_AVX2
+TWOXSAI_AVX2_TARGET
+static unsigned twoxsai_simd_rgb565_avx2(const uint16_t *in,
+      uint16_t *out, unsigned nextline, unsigned dst_stride,
+      unsigned width)
+{
+   unsigned x = 0;
+   TWOXSAI_SIMD_ROW(TWOXSAI_AVX2_16, 16)
+   return x + twoxsai_simd_rgb565_sse2(in + x, out + (x << 1),
+         nextline, dst_stride, width - x);
+}
+
+TWOXSAI_AVX2_TARGET
+static unsigned twoxsai_simd_xrgb8888_avx2(const uint32_t *in,
+      uint32_t *out, unsigned nextline, unsigned dst_stride,
+      unsigned width)
+{
+   unsigned x = 0;
+   TWOXSAI_SIMD_ROW(TWOXSAI_AVX2_32, 8)
+   return x + twoxsai_simd_xrgb8888_sse2(in + x, out + (x << 1),
+         nextline, dst_stride, width - x);
+}
+#endif
+
 static unsigned twoxsai_generic_input_fmts(void)
 {
    return SOFTFILTER_FMT_RGB565 | SOFTFILTER_FMT_XRGB8888;
@@ -80,6 +366,20 @@ static void *twoxsai_generic_create(const struct softfilter_config *config,
     * so force single threaded operation... */
    filt->threads = 1;
    filt->in_fmt  = in_fmt;
+#if defined(__SSE2__)
+   if (simd & SOFTFILTER_SIMD_SSE2)
+   {
+      filt->simd_rgb565   = twoxsai_simd_rgb565_sse2;
+      filt->simd_xrgb8888 = twoxsai_simd_xrgb8888_sse2;
+   }
+#endif
+#ifdef TWOXSAI_HAVE_AVX2
+   if (simd & SOFTFILTER_SIMD_AVX2)
+   {
+      filt->simd_rgb565   = twoxsai_simd_rgb565_avx2;
+      filt->simd_xrgb8888 = twoxsai_simd_xrgb8888_avx2;
+   }
+#endif
    return filt;
 }
 
@@ -209,7 +509,8 @@ static void twoxsai_generic_destroy(void *data)
 
 static void twoxsai_generic_xrgb8888(unsigned width, unsigned height,
       int first, int last, uint32_t *src,
-      unsigned src_stride, uint32_t *dst, unsigned dst_stride)
+      unsigned src_stride, uint32_t *dst, unsigned dst_stride,
+      twoxsai_simd_xrgb8888_t simd_row)
 {
    unsigned finish;
    unsigned nextline = (last) ? 0 : src_stride;
@@ -219,7 +520,17 @@ static void twoxsai_generic_xrgb8888(unsigned width, unsigned height,
       uint32_t *in  = (uint32_t*)src;
       uint32_t *out = (uint32_t*)dst;
 
-      for (finish = width; finish; finish -= 1)
+      finish        = width;
+
+      if (simd_row)
+      {
+         unsigned done = simd_row(in, out, nextline, dst_stride, width);
+         in           += done;
+         out          += done << 1;
+         finish       -= done;
+      }
+
+      for (; finish; finish -= 1)
       {
          twoxsai_declare_variables(uint32_t, in, nextline);
 
@@ -241,7 +552,8 @@ static void twoxsai_generic_xrgb8888(unsigned width, unsigned height,
 
 static void twoxsai_generic_rgb565(unsigned width, unsigned height,
       int first, int last, uint16_t *src,
-      unsigned src_stride, uint16_t *dst, unsigned dst_stride)
+      unsigned src_stride, uint16_t *dst, unsigned dst_stride,
+      twoxsai_simd_rgb565_t simd_row)
 {
    unsigned finish;
    unsigned nextline = (last) ? 0 : src_stride;
@@ -251,7 +563,17 @@ static void twoxsai_generic_rgb565(unsigned width, unsigned height,
       uint16_t *in  = (uint16_t*)src;
       uint16_t *out = (uint16_t*)dst;
 
-      for (finish = width; finish; finish -= 1)
+      finish        = width;
+
+      if (simd_row)
+      {
+         unsigned done = simd_row(in, out, nextline, dst_stride, width);
+         in           += done;
+         out          += done << 1;
+         finish       -= done;
+      }
+
+      for (; finish; finish -= 1)
       {
          twoxsai_declare_variables(uint16_t, in, nextline);
 
@@ -273,6 +595,7 @@ static void twoxsai_generic_rgb565(unsigned width, unsigned height,
 
 static void twoxsai_work_cb_rgb565(void *data, void *thread_data)
 {
+   struct filter_data *filt           = (struct filter_data*)data;
    struct softfilter_thread_data *thr =
       (struct softfilter_thread_data*)thread_data;
    uint16_t *input                    = (uint16_t*)thr->in_data;
@@ -283,11 +606,13 @@ static void twoxsai_work_cb_rgb565(void *data, void *thread_data)
          thr->first, thr->last, input,
          (unsigned)(thr->in_pitch / SOFTFILTER_BPP_RGB565),
          output,
-         (unsigned)(thr->out_pitch / SOFTFILTER_BPP_RGB565));
+         (unsigned)(thr->out_pitch / SOFTFILTER_BPP_RGB565),
+         filt->simd_rgb565);
 }
 
 static void twoxsai_work_cb_xrgb8888(void *data, void *thread_data)
 {
+   struct filter_data *filt           = (struct filter_data*)data;
    struct softfilter_thread_data *thr =
       (struct softfilter_thread_data*)thread_data;
    uint32_t *input                    = (uint32_t*)thr->in_data;
@@ -298,7 +623,8 @@ static void twoxsai_work_cb_xrgb8888(void *data, void *thread_data)
          thr->first, thr->last, input,
          (unsigned)(thr->in_pitch / SOFTFILTER_BPP_XRGB8888),
          output,
-         (unsigned)(thr->out_pitch / SOFTFILTER_BPP_XRGB8888));
+         (unsigned)(thr->out_pitch / SOFTFILTER_BPP_XRGB8888),
+         filt->simd_xrgb8888);
 }
 
 static void twoxsai_generic_packets(void *data,
@@ -20,6 +20,25 @@
 
 #include <retro_endianness.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+/* Built regardless of compiler flags, used when the SIMD mask has it */
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(__clang__) || (defined(__GNUC__) \
+      && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define EPX_HAVE_AVX2
+#define EPX_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && _MSC_VER >= 1900
+#define EPX_HAVE_AVX2
+#define EPX_AVX2_TARGET
+#endif
+#endif
+#endif
+
+#ifdef EPX_HAVE_AVX2
+#include <immintrin.h>
+#endif
+
 #ifdef RARCH_INTERNAL
 #define softfilter_get_implementation epx_get_implementation
 #define softfilter_thread_data epx_softfilter_thread_data
@@ -41,13 +60,88 @@ struct softfilter_thread_data
    int last;
 };
 
+/* Expands the middle pixels of a line starting at x, returns the
+ * first pixel left for the scalar loop */
+typedef unsigned (*epx_simd_row_t)(uint16_t *out0, uint16_t *out1,
+      const uint16_t *up, const uint16_t *cur, const uint16_t *down,
+      unsigned x, unsigned width);
+
 struct filter_data
 {
    unsigned threads;
    struct softfilter_thread_data *workers;
    unsigned in_fmt;
+   epx_simd_row_t simd_row;
 };
 
+/* Vector version of the middle loop below. Each lane does exactly
+ * what the scalar code does for one pixel, so output is identical.
+ * Output pixels are stored in memory order, which is what the
+ * MSB_FIRST/LSB_FIRST word packing below amounts to. */
+#define EPX_SIMD_ROW(V, n) \
+   for (; x + n < width; x += n) \
+   { \
+      V##_T A    = V##_LOAD(cur + x - 1); \
+      V##_T X    = V##_LOAD(cur + x); \
+      V##_T C    = V##_LOAD(cur + x + 1); \
+      V##_T B    = V##_LOAD(down + x); \
+      V##_T D    = V##_LOAD(up + x); \
+      V##_T keep = V##_OR(V##_EQ(A, C), V##_EQ(B, D)); \
+      V##_T e00  = V##_SEL(V##_BIC(V##_EQ(D, A), keep), D, X); \
+      V##_T e01  = V##_SEL(V##_BIC(V##_EQ(C, D), keep), C, X); \
+      V##_T e10  = V##_SEL(V##_BIC(V##_EQ(A, B), keep), A, X); \
+      V##_T e11  = V##_SEL(V##_BIC(V##_EQ(B, C), keep), B, X); \
+      V##_STORE_ZIP(out0 + (x << 1), e00, e01); \
+      V##_STORE_ZIP(out1 + (x << 1), e10, e11); \
+   }
+
+#if defined(__SSE2__)
+#define EPX_SSE2_T                __m128i
+#define EPX_SSE2_LOAD(p)          _mm_loadu_si128((const __m128i*)(p))
+#define EPX_SSE2_EQ(a, b)         _mm_cmpeq_epi16(a, b)
+#define EPX_SSE2_OR(a, b)         _mm_or_si128(a, b)
+#define EPX_SSE2_BIC(a, m)        _mm_andnot_si128(m, a)
+#define EPX_SSE2_SEL(m, a, b)     _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b))
+#define EPX_SSE2_STORE_ZIP(p, a, b) \
+   _mm_storeu_si128((__m128i*)(p),     _mm_unpacklo_epi16(a, b)); \
+   _mm_storeu_si128((__m128i*)(p) + 1, _mm_unpackhi_epi16(a, b))
+
+static unsigned epx_simd_row_sse2(uint16_t *out0, uint16_t *out1,
+      const uint16_t *up, const uint16_t *cur, const uint16_t *down,
+      unsigned x, unsigned width)
+{
+   EPX_SIMD_ROW(EPX_SSE2, 8)
+   return x;
+}
+#endif
+
+#ifdef EPX_HAVE_AVX2
+/* unpacklo/hi work within 128-bit halves, so put the halves back
+ * in order before storing */
+#define EPX_AVX2_T                __m256i
+#define EPX_AVX2_LOAD(p)          _mm256_loadu_si256((const __m256i*)(p))
+#define EPX_AVX2_EQ(a, b)         _mm256_cmpeq_epi16(a, b)
+#define EPX_AVX2_OR(a, b)         _mm256_or_si256(a, b)
+#define EPX_AVX2_BIC(a, m)        _mm256_andnot_si256(m, a)
+#define EPX_AVX2_SEL(m, a, b)     _mm256_blendv_epi8(b, a, m)
+#define EPX_AVX2_STORE_ZIP(p, a, b) \
+   { \
+      __m256i lo = _mm256_unpacklo_epi16(a, b); \
+      __m256i hi = _mm256_unpackhi_epi16(a, b); \
+      _mm256_storeu_si256((__m256i*)(p),     _mm256_permute2x128_si256(lo, hi, 0x20)); \
+      _mm256_storeu_si256((__m256i*)(p) + 1, _mm256_permute2x128_si256(lo, hi, 0x31)); \
+   }
+
+EPX_AVX2_TARGET
+static unsigned epx_simd_row_avx2(uint16_t *out0, uint16_t *out1,
+      const uint16_t *up, const uint16_t *cur, const uint16_t *down,
+      unsigned x, unsigned width)
+{
+   EPX_SIMD_ROW(EPX_AVX2, 16)
+   return epx_simd_row_sse2(out0, out1, up, cur, down, x, width);
+}
+#endif
+
 static unsigned epx_generic_input_fmts(void)
 {
    return SOFTFILTER_FMT_RGB565;
@@ -81,6 +175,14 @@ static void *epx_generic_create(const struct softfilter_config *config,
    }
    filt->threads            = 1;
    filt->in_fmt             = in_fmt;
+#if defined(__SSE2__)
+   if (simd & SOFTFILTER_SIMD_SSE2)
+      filt->simd_row        = epx_simd_row_sse2;
+#endif
+#ifdef EPX_HAVE_AVX2
+   if (simd & SOFTFILTER_SIMD_AVX2)
+      filt->simd_row        = epx_simd_row_avx2;
+#endif
    return filt;
 }
 
@@ -105,7 +207,8 @@ static void epx_generic_destroy(void *data)
 
 static void epx_generic_rgb565 (unsigned width, unsigned height,
       int first, int lsat, uint16_t *src,
-      unsigned src_stride, uint16_t *dst, unsigned dst_stride)
+      unsigned src_stride, uint16_t *dst, unsigned dst_stride,
+      epx_simd_row_t simd_row)
 {
    uint16_t colorA;
    int w;
@@ -140,7 +243,28 @@ static void epx_generic_rgb565 (unsigned width, unsigned height,
       dP1++;
       dP2++;
 
-      for (w = width - 2; w; w--)
+      w = width - 2;
+
+      if (simd_row)
+      {
+         unsigned x = simd_row((uint16_t*)dst, (uint16_t*)(dst + dst_stride),
+               src - src_stride, src, src + src_stride, 1, width);
+
+         /* Pick the scalar loop up at pixel x */
+         if (x > 1)
+         {
+            w      -= x - 1;
+            dP1    += x - 1;
+            dP2    += x - 1;
+            sP      = src + x;
+            lP      = src + src_stride + x;
+            uP      = src - src_stride + x;
+            colorX  = src[x - 1];
+            colorC  = src[x];
+         }
+      }
+
+      for (; w; w--)
       {
          colorA = colorX;
          colorX = colorC;
@@ -191,6 +315,7 @@ static void epx_generic_rgb565 (unsigned width, unsigned height,
 
 static void epx_work_cb_rgb565(void *data, void *thread_data)
 {
+   struct filter_data *filt           = (struct filter_data*)data;
    struct softfilter_thread_data *thr =
       (struct softfilter_thread_data*)thread_data;
    uint16_t *input  = (uint16_t*)thr->in_data;
@@ -202,7 +327,8 @@ static void epx_work_cb_rgb565(void *data, void *thread_data)
          thr->first, thr->last, input,
          (unsigned)(thr->in_pitch / SOFTFILTER_BPP_RGB565),
          output,
-         (unsigned)(thr->out_pitch / SOFTFILTER_BPP_RGB565));
+         (unsigned)(thr->out_pitch / SOFTFILTER_BPP_RGB565),
+         filt->simd_row);
 }
 
 static void epx_generic_packets(void *data,
@@ -17,6 +17,25 @@
 #include "softfilter.h"
 #include <stdlib.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+/* Built regardless of compiler flags, used when the SIMD mask has it */
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(__clang__) || (defined(__GNUC__) \
+      && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define LQ2X_HAVE_AVX2
+#define LQ2X_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && _MSC_VER >= 1900
+#define LQ2X_HAVE_AVX2
+#define LQ2X_AVX2_TARGET
+#endif
+#endif
+#endif
+
+#ifdef LQ2X_HAVE_AVX2
+#include <immintrin.h>
+#endif
+
 #ifdef RARCH_INTERNAL
 #define softfilter_get_implementation lq2x_get_implementation
 #define softfilter_thread_data lq2x_softfilter_thread_data
@@ -38,13 +57,174 @@ struct softfilter_thread_data
    int last;
 };
 
+/* Expands the middle pixels of a line starting at x, returns the
+ * first pixel left for the scalar loop */
+typedef unsigned (*lq2x_simd_rgb565_t)(uint16_t *out0, uint16_t *out1,
+      const uint16_t *prev, const uint16_t *cur, const uint16_t *next,
+      unsigned x, unsigned width);
+typedef unsigned (*lq2x_simd_xrgb8888_t)(uint32_t *out0, uint32_t *out1,
+      const uint32_t *prev, const uint32_t *cur, const uint32_t *next,
+      unsigned x, unsigned width);
+
 struct filter_data
 {
    unsigned threads;
    struct softfilter_thread_data *workers;
    unsigned in_fmt;
+   lq2x_simd_rgb565_t simd_rgb565;
+   lq2x_simd_xrgb8888_t simd_xrgb8888;
 };
 
+/* Vector versions of the expansion below. Each lane does exactly
+ * what the scalar code does for one pixel, so output is identical.
+ *
+ * The RGB565 blend is done in int in C and can carry into bit 16
+ * before the shift. (C + A - ((C ^ A) & 0x0821)) >> 1 is the same
+ * as (C & A) + (((C ^ A) & 0xF7DE) >> 1), which cannot. XRGB8888
+ * wraps in C just like it does in a lane. */
+#define LQ2X_BLEND16(V, C, A) V##_ADD(V##_AND(C, A), \
+      V##_SRL1(V##_AND(V##_XOR(C, A), V##_SET1(0xF7DE))))
+#define LQ2X_BLEND32(V, C, A) V##_SRL1(V##_SUB(V##_ADD(C, A), \
+      V##_AND(V##_XOR(C, A), V##_SET1(0x0421))))
+
+#define LQ2X_SIMD_ROW(V, n, BLEND) \
+   for (; x + n < width; x += n) \
+   { \
+      V##_T A    = V##_LOAD(prev + x); \
+      V##_T B    = V##_LOAD(cur + x - 1); \
+      V##_T C    = V##_LOAD(cur + x); \
+      V##_T D    = V##_LOAD(cur + x + 1); \
+      V##_T E    = V##_LOAD(next + x); \
+      V##_T keep = V##_OR(V##_EQ(A, E), V##_EQ(B, D)); \
+      V##_T ca   = BLEND(V, C, A); \
+      V##_T ce   = BLEND(V, C, E); \
+      V##_T e00  = V##_SEL(V##_BIC(V##_EQ(A, B), keep), ca, C); \
+      V##_T e01  = V##_SEL(V##_BIC(V##_EQ(A, D), keep), ca, C); \
+      V##_T e10  = V##_SEL(V##_BIC(V##_EQ(E, B), keep), ce, C); \
+      V##_T e11  = V##_SEL(V##_BIC(V##_EQ(E, D), keep), ce, C); \
+      V##_STORE_ZIP(out0 + (x << 1), e00, e01); \
+      V##_STORE_ZIP(out1 + (x << 1), e10, e11); \
+   }
+
+#if defined(__SSE2__)
+#define LQ2X_SSE2_T               __m128i
+#define LQ2X_SSE2_LOAD(p)         _mm_loadu_si128((const __m128i*)(p))
+#define LQ2X_SSE2_OR(a, b)        _mm_or_si128(a, b)
+#define LQ2X_SSE2_AND(a, b)       _mm_and_si128(a, b)
+#define LQ2X_SSE2_XOR(a, b)       _mm_xor_si128(a, b)
+#define LQ2X_SSE2_BIC(a, m)       _mm_andnot_si128(m, a)
+#define LQ2X_SSE2_SEL(m, a, b)    _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b))
+
+#define LQ2X_SSE2_16_T            LQ2X_SSE2_T
+#define LQ2X_SSE2_16_LOAD         LQ2X_SSE2_LOAD
+#define LQ2X_SSE2_16_OR           LQ2X_SSE2_OR
+#define LQ2X_SSE2_16_AND          LQ2X_SSE2_AND
+#define LQ2X_SSE2_16_XOR          LQ2X_SSE2_XOR
+#define LQ2X_SSE2_16_BIC          LQ2X_SSE2_BIC
+#define LQ2X_SSE2_16_SEL          LQ2X_SSE2_SEL
+#define LQ2X_SSE2_16_EQ(a, b)     _mm_cmpeq_epi16(a, b)
+#define LQ2X_SSE2_16_ADD(a, b)    _mm_add_epi16(a, b)
+#define LQ2X_SSE2_16_SRL1(a)      _mm_srli_epi16(a, 1)
+#define LQ2X_SSE2_16_SET1(c)      _mm_set1_epi16((short)(c))
+#define LQ2X_SSE2_16_STORE_ZIP(p, a, b) \
+   _mm_storeu_si128((__m128i*)(p),     _mm_unpacklo_epi16(a, b)); \
+   _mm_storeu_si128((__m128i*)(p) + 1, _mm_unpackhi_epi16(a, b))
+
+#define LQ2X_SSE2_32_T            LQ2X_SSE2_T
+#define LQ2X_SSE2_32_LOAD         LQ2X_SSE2_LOAD
+#define LQ2X_SSE2_32_OR           LQ2X_SSE2_OR
+#define LQ2X_SSE2_32_AND          LQ2X_SSE2_AND
+#define LQ2X_SSE2_32_XOR          LQ2X_SSE2_XOR
+#define LQ2X_SSE2_32_BIC          LQ2X_SSE2_BIC
+#define LQ2X_SSE2_32_SEL          LQ2X_SSE2_SEL
+#define LQ2X_SSE2_32_EQ(a, b)     _mm_cmpeq_epi32(a, b)
+#define LQ2X_SSE2_32_ADD(a, b)    _mm_add_epi32(a, b)
+#define LQ2X_SSE2_32_SUB(a, b)    _mm_sub_epi32(a, b)
+#define LQ2X_SSE2_32_SRL1(a)      _mm_srli_epi32(a, 1)
+#define LQ2X_SSE2_32_SET1(c)      _mm_set1_epi32(c)
+#define LQ2X_SSE2_32_STORE_ZIP(p, a, b) \
+   _mm_storeu_si128((__m128i*)(p),     _mm_unpacklo_epi32(a, b)); \
+   _mm_storeu_si128((__m128i*)(p) + 1, _mm_unpackhi_epi32(a, b))
+
+static unsigned lq2x_simd_rgb565_sse2(uint16_t *out0, uint16_t *out1,
+      const uint16_t *prev, const uint16_t *cur, const uint16_t *next,
+      unsigned x, unsigned width)
+{
+   LQ2X_SIMD_ROW(LQ2X_SSE2_16, 8, LQ2X_BLEND16)
+   return x;
+}
+
+static unsigned lq2x_simd_xrgb8888_sse2(uint32_t *out0, uint32_t *out1,
+      const uint32_t *prev, const uint32_t *cur, const uint32_t *next,
+      unsigned x, unsigned width)
+{
+   LQ2X_SIMD_ROW(LQ2X_SSE2_32, 4, LQ2X_BLEND32)
+   return x;
+}
+#endif
+
+#ifdef LQ2X_HAVE_AVX2
+#define LQ2X_AVX2_T               __m256i
+#define LQ2X_AVX2_LOAD(p)         _mm256_loadu_si256((const __m256i*)(p))
+#define LQ2X_AVX2_OR(a, b)        _mm256_or_si256(a, b)
+#define LQ2X_AVX2_AND(a, b)       _mm256_and_si256(a, b)
+#define LQ2X_AVX2_XOR(a, b)       _mm256_xor_si256(a, b)
+#define LQ2X_AVX2_BIC(a, m)       _mm256_andnot_si256(m, a)
+#define LQ2X_AVX2_SEL(m, a, b)    _mm256_blendv_epi8(b, a, m)
+/* unpacklo/hi work within 128-bit halves, so put the halves back
+ * in order before storing */
+#define LQ2X_AVX2_STORE(p, lo, hi) \
+   _mm256_storeu_si256((__m256i*)(p),     _mm256_permute2x128_si256(lo, hi, 0x20)); \
+   _mm256_storeu_si256((__m256i*)(p) + 1, _mm256_permute2x128_si256(lo, hi, 0x31))
+
+#define LQ2X_AVX2_16_T            LQ2X_AVX2_T
+#define LQ2X_AVX2_16_LOAD         LQ2X_AVX2_LOAD
+#define LQ2X_AVX2_16_OR           LQ2X_AVX2_OR
+#define LQ2X_AVX2_16_AND          LQ2X_AVX2_AND
+#define LQ2X_AVX2_16_XOR          LQ2X_AVX2_XOR
+#define LQ2X_AVX2_16_BIC          LQ2X_AVX2_BIC
+#define LQ2X_AVX2_16_SEL          LQ2X_AVX2_SEL
+#define LQ2X_AVX2_16_EQ(a, b)     _mm256_cmpeq_epi16(a, b)
+#define LQ2X_AVX2_16_ADD(a, b)    _mm256_add_epi16(a, b)
+#define LQ2X_AVX2_16_SRL1(a)      _mm256_srli_epi16(a, 1)
+#define LQ2X_AVX2_16_SET1(c)      _mm256_set1_epi16((short)(c))
+#define LQ2X_AVX2_16_STORE_ZIP(p, a, b) \
+   LQ2X_AVX2_STORE(p, _mm256_unpacklo_epi16(a, b), _mm256_unpackhi_epi16(a, b))
+
+#define LQ2X_AVX2_32_T            LQ2X_AVX2_T
+#define LQ2X_AVX2_32_LOAD         LQ2X_AVX2_LOAD
+#define LQ2X_AVX2_32_OR           LQ2X_AVX2_OR
+#define LQ2X_AVX2_32_AND          LQ2X_AVX2_AND
+#define LQ2X_AVX2_32_XOR          LQ2X_AVX2_XOR
+#define LQ2X_AVX2_32_BIC          LQ2X_AVX2_BIC
+#define LQ2X_AVX2_32_SEL          LQ2X_AVX2_SEL
+#define LQ2X_AVX2_32_EQ(a, b)     _mm256_cmpeq_epi32(a, b)
+#define LQ2X_AVX2_32_ADD(a, b)    _mm256_add_epi32(a, b)
+#define LQ2X_AVX2_32_SUB(a, b)    _mm256_sub_epi32(a, b)
+#define LQ2X_AVX2_32_SRL1(a)      _mm256_srli_epi32(a, 1)
+#define LQ2X_AVX2_32_SET1(c)      _mm256_set1_epi32(c)
+#define LQ2X_AVX2_32_STORE_ZIP(p, a, b) \
+   LQ2X_AVX2_STORE(p, _mm256_unpacklo_epi32(a, b), _mm256_unpackhi_epi32(a, b))
+
+LQ2X_AVX2_TARGET
+static unsigned lq2x_simd_rgb565_avx2(uint16_t *out0, uint16_t *out1,
+      const uint16_t *prev, const uint16_t *cur, const uint16_t *next,
+      unsigned x, unsigned width)
+{
+   LQ2X_SIMD_ROW(LQ2X_AVX2_16, 16, LQ2X_BLEND16)
+   return lq2x_simd_rgb565_sse2(out0, out1, prev, cur, next, x, width);
+}
+
+LQ2X_AVX2_TARGET
+static unsigned lq2x_simd_xrgb8888_avx2(uint32_t *out0, uint32_t *out1,
+      const uint32_t *prev, const uint32_t *cur, const uint32_t *next,
+      unsigned x, unsigned width)
+{
+   LQ2X_SIMD_ROW(LQ2X_AVX2_32, 8, LQ2X_BLEND32)
+   return lq2x_simd_xrgb8888_sse2(out0, out1, prev, cur, next, x, width);
+}
+#endif
+
 static unsigned lq2x_generic_input_fmts(void)
 {
    return SOFTFILTER_FMT_RGB565 | SOFTFILTER_FMT_XRGB8888;
@@ -79,6 +259,20 @@ static void *lq2x_generic_create(const struct softfilter_config *config,
     * so force single threaded operation... */
    filt->threads = 1;
    filt->in_fmt  = in_fmt;
+#if defined(__SSE2__)
+   if (simd & SOFTFILTER_SIMD_SSE2)
+   {
+      filt->simd_rgb565   = lq2x_simd_rgb565_sse2;
+      filt->simd_xrgb8888 = lq2x_simd_xrgb8888_sse2;
+   }
+#endif
+#ifdef LQ2X_HAVE_AVX2
+   if (simd & SOFTFILTER_SIMD_AVX2)
+   {
+      filt->simd_rgb565   = lq2x_simd_rgb565_avx2;
+      filt->simd_xrgb8888 = lq2x_simd_xrgb8888_avx2;
+   }
+#endif
    return filt;
 }
 
@@ -103,7 +297,8 @@ static void lq2x_generic_destroy(void *data)
 
 static void lq2x_generic_rgb565(unsigned width, unsigned height,
       int first, int last, uint16_t *src,
-      unsigned src_stride, uint16_t *dst, unsigned dst_stride)
+      unsigned src_stride, uint16_t *dst, unsigned dst_stride,
+      lq2x_simd_rgb565_t simd_row)
 {
    unsigned x, y;
    uint16_t *out0 = (uint16_t*)dst;
@@ -137,6 +332,18 @@ static void lq2x_generic_rgb565(unsigned width, unsigned height,
             *out1++ = c;
             *out1++ = c;
          }
+
+         /* First pixel needs the edge clamp, the middle of the
+          * line goes to the vector code */
+         if (x == 0 && simd_row)
+         {
+            unsigned done = simd_row(out0 - 2, out1 - 2, src - 1 - prevline,
+                  src - 1, src - 1 + nextline, 1, width) - 1;
+            src          += done;
+            out0         += done << 1;
+            out1         += done << 1;
+            x            += done;
+         }
       }
 
       src  += src_stride - width;
@@ -147,7 +354,8 @@ static void lq2x_generic_rgb565(unsigned width, unsigned height,
 
 static void lq2x_generic_xrgb8888(unsigned width, unsigned height,
       int first, int last, uint32_t *src,
-      unsigned src_stride, uint32_t *dst, unsigned dst_stride)
+      unsigned src_stride, uint32_t *dst, unsigned dst_stride,
+      lq2x_simd_xrgb8888_t simd_row)
 {
    unsigned x, y;
    uint32_t *out0 = (uint32_t*)dst;
@@ -181,6 +389,18 @@ static void lq2x_generic_xrgb8888(unsigned width, unsigned height,
             *out1++ = c;
             *out1++ = c;
          }
+
+         /* First pixel needs the edge clamp, the middle of the
+          * line goes to the vector code */
+         if (x == 0 && simd_row)
+         {
+            unsigned done = simd_row(out0 - 2, out1 - 2, src - 1 - prevline,
+                  src - 1, src - 1 + nextline, 1, width) - 1;
+            src          += done;
+            out0         += done << 1;
+            out1         += done << 1;
+            x            += done;
+         }
       }
 
       src += src_stride - width;
@@ -191,6 +411,7 @@ static void lq2x_generic_xrgb8888(unsigned width, unsigned height,
 
 static void lq2x_work_cb_rgb565(void *data, void *thread_data)
 {
+   struct filter_data *filt           = (struct filter_data*)data;
    struct softfilter_thread_data *thr =
       (struct softfilter_thread_data*)thread_data;
    uint16_t *input                    = (uint16_t*)thr->in_data;
@@ -201,11 +422,13 @@ static void lq2x_work_cb_rgb565(void *data, void *thread_data)
          thr->first, thr->last, input,
          (unsigned)(thr->in_pitch / SOFTFILTER_BPP_RGB565),
          output,
-         (unsigned)(thr->out_pitch / SOFTFILTER_BPP_RGB565));
+         (unsigned)(thr->out_pitch / SOFTFILTER_BPP_RGB565),
+         filt->simd_rgb565);
 }
 
 static void lq2x_work_cb_xrgb8888(void *data, void *thread_data)
 {
+   struct filter_data *filt           = (struct filter_data*)data;
    struct softfilter_thread_data *thr =
       (struct softfilter_thread_data*)thread_data;
    uint32_t *input                    = (uint32_t*)thr->in_data;
@@ -216,7 +439,8 @@ static void lq2x_work_cb_xrgb8888(void *data, void *thread_data)
          thr->first, thr->last, input,
          (unsigned)(thr->in_pitch / SOFTFILTER_BPP_XRGB8888),
          output,
-         (unsigned)(thr->out_pitch / SOFTFILTER_BPP_XRGB8888));
+         (unsigned)(thr->out_pitch / SOFTFILTER_BPP_XRGB8888),
+         filt->simd_xrgb8888);
 }
 
 static void lq2x_generic_packets(void *data,
@@ -19,6 +19,15 @@
 #include "softfilter.h"
 #include <stdlib.h>
 #include <string.h>
+#include <retro_inline.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
 
 #ifdef RARCH_INTERNAL
 #define softfilter_get_implementation scale2x_get_implementation
@@ -44,8 +53,83 @@ struct filter_data
    unsigned threads;
    struct softfilter_thread_data *workers;
    unsigned in_fmt;
+   int simd;
 };
 
+/* Vector versions of the expansion below. Each lane does exactly
+ * what the scalar code does for one pixel, so output is identical. */
+#if defined(__SSE2__)
+#define SCALE2X_SIMD
+typedef __m128i scale2x_v32_t;
+typedef __m128i scale2x_v16_t;
+#define SCALE2X_LOAD32(p)         _mm_loadu_si128((const __m128i*)(p))
+#define SCALE2X_LOAD16(p)         _mm_loadu_si128((const __m128i*)(p))
+#define SCALE2X_EQ32(a, b)        _mm_cmpeq_epi32(a, b)
+#define SCALE2X_EQ16(a, b)        _mm_cmpeq_epi16(a, b)
+#define SCALE2X_OR32(a, b)        _mm_or_si128(a, b)
+#define SCALE2X_OR16(a, b)        _mm_or_si128(a, b)
+#define SCALE2X_BIC32(a, m)       _mm_andnot_si128(m, a)
+#define SCALE2X_BIC16(a, m)       _mm_andnot_si128(m, a)
+#define SCALE2X_SEL32(m, a, b)    _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b))
+#define SCALE2X_SEL16(m, a, b)    _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b))
+#define SCALE2X_STORE_ZIP32(p, a, b) \
+   _mm_storeu_si128((__m128i*)(p),     _mm_unpacklo_epi32(a, b)); \
+   _mm_storeu_si128((__m128i*)(p) + 1, _mm_unpackhi_epi32(a, b))
+#define SCALE2X_STORE_ZIP16(p, a, b) \
+   _mm_storeu_si128((__m128i*)(p),     _mm_unpacklo_epi16(a, b)); \
+   _mm_storeu_si128((__m128i*)(p) + 1, _mm_unpackhi_epi16(a, b))
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define SCALE2X_SIMD
+typedef uint32x4_t scale2x_v32_t;
+typedef uint16x8_t scale2x_v16_t;
+#define SCALE2X_LOAD32(p)         vld1q_u32(p)
+#define SCALE2X_LOAD16(p)         vld1q_u16(p)
+#define SCALE2X_EQ32(a, b)        vceqq_u32(a, b)
+#define SCALE2X_EQ16(a, b)        vceqq_u16(a, b)
+#define SCALE2X_OR32(a, b)        vorrq_u32(a, b)
+#define SCALE2X_OR16(a, b)        vorrq_u16(a, b)
+#define SCALE2X_BIC32(a, m)       vbicq_u32(a, m)
+#define SCALE2X_BIC16(a, m)       vbicq_u16(a, m)
+#define SCALE2X_SEL32(m, a, b)    vbslq_u32(m, a, b)
+#define SCALE2X_SEL16(m, a, b)    vbslq_u16(m, a, b)
+#define SCALE2X_STORE_ZIP32(p, a, b) vst2q_u32(p, scale2x_zip32(a, b))
+#define SCALE2X_STORE_ZIP16(p, a, b) vst2q_u16(p, scale2x_zip16(a, b))
+static INLINE uint32x4x2_t scale2x_zip32(uint32x4_t a, uint32x4_t b)
+{
+   uint32x4x2_t v;
+   v.val[0] = a;
+   v.val[1] = b;
+   return v;
+}
+static INLINE uint16x8x2_t scale2x_zip16(uint16x8_t a, uint16x8_t b)
+{
+   uint16x8x2_t v;
+   v.val[0] = a;
+   v.val[1] = b;
+   return v;
+}
+#elif defined(__wasm_simd128__)
+#define SCALE2X_SIMD
+typedef v128_t scale2x_v32_t;
+typedef v128_t scale2x_v16_t;
+#define SCALE2X_LOAD32(p)         wasm_v128_load(p)
+#define SCALE2X_LOAD16(p)         wasm_v128_load(p)
+#define SCALE2X_EQ32(a, b)        wasm_i32x4_eq(a, b)
+#define SCALE2X_EQ16(a, b)        wasm_i16x8_eq(a, b)
+#define SCALE2X_OR32(a, b)        wasm_v128_or(a, b)
+#define SCALE2X_OR16(a, b)        wasm_v128_or(a, b)
+#define SCALE2X_BIC32(a, m)       wasm_v128_andnot(a, m)
+#define SCALE2X_BIC16(a, m)       wasm_v128_andnot(a, m)
+#define SCALE2X_SEL32(m, a, b)    wasm_v128_bitselect(a, b, m)
+#define SCALE2X_SEL16(m, a, b)    wasm_v128_bitselect(a, b, m)
+#define SCALE2X_STORE_ZIP32(p, a, b) \
+   wasm_v128_store((p),     wasm_i32x4_shuffle(a, b, 0, 4, 1, 5)); \
+   wasm_v128_store((p) + 4, wasm_i32x4_shuffle(a, b, 2, 6, 3, 7))
+#define SCALE2X_STORE_ZIP16(p, a, b) \
+   wasm_v128_store((p),     wasm_i16x8_shuffle(a, b, 0, 8, 1, 9, 2, 10, 3, 11)); \
+   wasm_v128_store((p) + 8, wasm_i16x8_shuffle(a, b, 4, 12, 5, 13, 6, 14, 7, 15))
+#endif
+
 static unsigned scale2x_generic_input_fmts(void)
 {
    return SOFTFILTER_FMT_XRGB8888 | SOFTFILTER_FMT_RGB565;
@@ -79,6 +163,14 @@ static void *scale2x_generic_create(const struct softfilter_config *config,
     * so force single threaded operation... */
    filt->threads = 1;
    filt->in_fmt  = in_fmt;
+#if defined(__SSE2__)
+   filt->simd    = (simd & SOFTFILTER_SIMD_SSE2) ? 1 : 0;
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+   filt->simd    = (simd & SOFTFILTER_SIMD_NEON) ? 1 : 0;
+#elif defined(__wasm_simd128__)
+   /* No runtime bit for it; building with -msimd128 is the opt-in */
+   filt->simd    = 1;
+#endif
    return filt;
 }
 
@@ -99,99 +191,198 @@ static void scale2x_generic_destroy(void *data)
    free(filt);
 }
 
+#ifdef SCALE2X_SIMD
+/* Handles pixels [x, width - 1) four (XRGB8888) or eight (RGB565)
+ * at a time, as long as the right-hand neighbour load stays inside
+ * the line. Returns the first pixel left for the scalar loop. */
+static unsigned scale2x_simd_xrgb8888(uint32_t *out0, uint32_t *out1,
+      const uint32_t *prev, const uint32_t *cur, const uint32_t *next,
+      unsigned x, unsigned width)
+{
+   for (; x + 4 < width; x += 4)
+   {
+      scale2x_v32_t A    = SCALE2X_LOAD32(prev + x);
+      scale2x_v32_t B    = SCALE2X_LOAD32(cur + x - 1);
+      scale2x_v32_t C    = SCALE2X_LOAD32(cur + x);
+      scale2x_v32_t D    = SCALE2X_LOAD32(cur + x + 1);
+      scale2x_v32_t E    = SCALE2X_LOAD32(next + x);
+      scale2x_v32_t keep = SCALE2X_OR32(SCALE2X_EQ32(A, E), SCALE2X_EQ32(B, D));
+      scale2x_v32_t e00  = SCALE2X_SEL32(SCALE2X_BIC32(SCALE2X_EQ32(A, B), keep), A, C);
+      scale2x_v32_t e01  = SCALE2X_SEL32(SCALE2X_BIC32(SCALE2X_EQ32(A, D), keep), A, C);
+      scale2x_v32_t e10  = SCALE2X_SEL32(SCALE2X_BIC32(SCALE2X_EQ32(E, B), keep), E, C);
+      scale2x_v32_t e11  = SCALE2X_SEL32(SCALE2X_BIC32(SCALE2X_EQ32(E, D), keep), E, C);
+
+      SCALE2X_STORE_ZIP32(out0 + (x << 1), e00, e01);
+      SCALE2X_STORE_ZIP32(out1 + (x << 1), e10, e11);
+   }
+
+   return x;
+}
+
+static unsigned scale2x_simd_rgb565(uint16_t *out0, uint16_t *out1,
+      const uint16_t *prev, const uint16_t *cur, const uint16_t *next,
+      unsigned x, unsigned width)
+{
+   for (; x + 8 < width; x += 8)
+   {
+      scale2x_v16_t A    = SCALE2X_LOAD16(prev + x);
+      scale2x_v16_t B    = SCALE2X_LOAD16(cur + x - 1);
+      scale2x_v16_t C    = SCALE2X_LOAD16(cur + x);
+      scale2x_v16_t D    = SCALE2X_LOAD16(cur + x + 1);
+      scale2x_v16_t E    = SCALE2X_LOAD16(next + x);
+      scale2x_v16_t keep = SCALE2X_OR16(SCALE2X_EQ16(A, E), SCALE2X_EQ16(B, D));
+      scale2x_v16_t e00  = SCALE2X_SEL16(SCALE2X_BIC16(SCALE2X_EQ16(A, B), keep), A, C);
+      scale2x_v16_t e01  = SCALE2X_SEL16(SCALE2X_BIC16(SCALE2X_EQ16(A, D), keep), A, C);
+      scale2x_v16_t e10  = SCALE2X_SEL16(SCALE2X_BIC16(SCALE2X_EQ16(E, B), keep), E, C);
+      scale2x_v16_t e11  = SCALE2X_SEL16(SCALE2X_BIC16(SCALE2X_EQ16(E, D), keep), E, C);
+
+      SCALE2X_STORE_ZIP16(out0 + (x << 1), e00, e01);
+      SCALE2X_STORE_ZIP16(out1 + (x << 1), e10, e11);
+   }
+
+   return x;
+}
+#endif
+
 static void scale2x_work_cb_xrgb8888(void *data, void *thread_data)
 {
+   struct filter_data *filt           = (struct filter_data*)data;
    struct softfilter_thread_data *thr = (struct softfilter_thread_data*)thread_data;
    uint32_t in_stride                 = (uint32_t)(thr->in_pitch >> 2);
    uint32_t out_stride                = (uint32_t)(thr->out_pitch >> 2);
    const uint32_t *input              = (const uint32_t*)thr->in_data;
    uint32_t *output0                  = (uint32_t*)thr->out_data;
    uint32_t *output1                  = (uint32_t*)thr->out_data + out_stride;
-   uint16_t x, y;
+   unsigned x, y;
 
    for (y = 0; y < thr->height; y++)
    {
-      /* Determine offsets of previous/next source lines */
-      uint32_t line_prev = (y == 0)               ? 0 : in_stride;
-      uint32_t line_next = (y == thr->height - 1) ? 0 : in_stride;
+      /* Determine previous/next source lines */
+      const uint32_t *prev = (y == 0)               ? input : input - in_stride;
+      const uint32_t *next = (y == thr->height - 1) ? input : input + in_stride;
 
-      for (x = 0; x < thr->width; x++)
+      x = 0;
+#ifdef SCALE2X_SIMD
+      if (filt->simd && thr->width > 1)
+      {
+         /* First pixel needs the edge clamp, so it goes scalar */
+         uint32_t C = input[0];
+         uint32_t D = input[1];
+         if (prev[0] != next[0] && C != D)
+         {
+            output0[0] = C;
+            output0[1] = (prev[0] == D ? prev[0] : C);
+            output1[0] = C;
+            output1[1] = (next[0] == D ? next[0] : C);
+         }
+         else
+            output0[0] = output0[1] = output1[0] = output1[1] = C;
+
+         x = scale2x_simd_xrgb8888(output0, output1,
+               prev, input, next, 1, thr->width);
+      }
+#endif
+
+      for (; x < thr->width; x++)
       {
          /* Get sample points */
-         uint32_t A = *(input - line_prev);
-         uint32_t B = (x > 0) ? *(input - 1) : *input;
-         uint32_t C = *input;
-         uint32_t D = (x < thr->width - 1) ? *(input + 1) : *input;
-         uint32_t E = *(input++ + line_next);
+         uint32_t A = prev[x];
+         uint32_t B = (x > 0) ? input[x - 1] : input[x];
+         uint32_t C = input[x];
+         uint32_t D = (x < thr->width - 1) ? input[x + 1] : input[x];
+         uint32_t E = next[x];
 
          /* Apply pixel expansion algorithm */
          if (A != E && B != D)
          {
-            *output0++ = (A == B ? A : C);
-            *output0++ = (A == D ? A : C);
-            *output1++ = (E == B ? E : C);
-            *output1++ = (E == D ? E : C);
+            output0[(x << 1)    ] = (A == B ? A : C);
+            output0[(x << 1) + 1] = (A == D ? A : C);
+            output1[(x << 1)    ] = (E == B ? E : C);
+            output1[(x << 1) + 1] = (E == D ? E : C);
          }
          else
          {
-            *output0++ = C;
-            *output0++ = C;
-            *output1++ = C;
-            *output1++ = C;
+            output0[(x << 1)    ] = C;
+            output0[(x << 1) + 1] = C;
+            output1[(x << 1)    ] = C;
+            output1[(x << 1) + 1] = C;
          }
       }
 
-      input   += in_stride - thr->width;
-      output0 += (out_stride << 1) - (thr->width << 1);
-      output1 += (out_stride << 1) - (thr->width << 1);
+      input   += in_stride;
+      output0 += out_stride << 1;
+      output1 += out_stride << 1;
    }
 }
 
 static void scale2x_work_cb_rgb565(void *data, void *thread_data)
 {
+   struct filter_data *filt           = (struct filter_data*)data;
    struct softfilter_thread_data *thr = (struct softfilter_thread_data*)thread_data;
    uint32_t in_stride                 = (uint32_t)(thr->in_pitch >> 1);
    uint32_t out_stride                = (uint32_t)(thr->out_pitch >> 1);
    const uint16_t *input              = (const uint16_t*)thr->in_data;
    uint16_t *output0                  = (uint16_t*)thr->out_data;
    uint16_t *output1                  = (uint16_t*)thr->out_data + out_stride;
-   uint16_t x, y;
+   unsigned x, y;
 
    for (y = 0; y < thr->height; y++)
    {
-      /* Determine offsets of previous/next source lines */
-      uint32_t line_prev = (y == 0)               ? 0 : in_stride;
-      uint32_t line_next = (y == thr->height - 1) ? 0 : in_stride;
+      /* Determine previous/next source lines */
+      const uint16_t *prev = (y == 0)               ? input : input - in_stride;
+      const uint16_t *next = (y == thr->height - 1) ? input : input + in_stride;
+
+      x = 0;
+#ifdef SCALE2X_SIMD
+      if (filt->simd && thr->width > 1)
+      {
+         /* First pixel needs the edge clamp, so it goes scalar */
+         uint16_t C = input[0];
+         uint16_t D = input[1];
+         if (prev[0] != next[0] && C != D)
+         {
+            output0[0] = C;
+            output0[1] = (prev[0] == D ? prev[0] : C);
+            output1[0] = C;
+            output1[1] = (next[0] == D ? next[0] : C);
+         }
+         else
+            output0[0] = output0[1] = output1[0] = output1[1] = C;
+
+         x = scale2x_simd_rgb565(output0, output1,
+               prev, input, next, 1, thr->width);
+      }
+#endif
 
-      for (x = 0; x < thr->width; x++)
+      for (; x < thr->width; x++)
       {
          /* Get sample points */
-         uint16_t A = *(input - line_prev);
-         uint16_t B = (x > 0) ? *(input - 1) : *input;
-         uint16_t C = *input;
-         uint16_t D = (x < thr->width - 1) ? *(input + 1) : *input;
-         uint16_t E = *(input++ + line_next);
+         uint16_t A = prev[x];
+         uint16_t B = (x > 0) ? input[x - 1] : input[x];
+         uint16_t C = input[x];
+         uint16_t D = (x < thr->width - 1) ? input[x + 1] : input[x];
+         uint16_t E = next[x];
 
          /* Apply pixel expansion algorithm */
          if (A != E && B != D)
          {
-            *output0++ = (A == B ? A : C);
-            *output0++ = (A == D ? A : C);
-            *output1++ = (E == B ? E : C);
-            *output1++ = (E == D ? E : C);
+            output0[(x << 1)    ] = (A == B ? A : C);
+            output0[(x << 1) + 1] = (A == D ? A : C);
+            output1[(x << 1)    ] = (E == B ? E : C);
+            output1[(x << 1) + 1] = (E == D ? E : C);
          }
          else
          {
-            *output0++ = C;
-            *output0++ = C;
-            *output1++ = C;
-            *output1++ = C;
+            output0[(x << 1)    ] = C;
+            output0[(x << 1) + 1] = C;
+            output1[(x << 1)    ] = C;
+            output1[(x << 1) + 1] = C;
          }
       }
 
-      input   += in_stride - thr->width;
-      output0 += (out_stride << 1) - (thr->width << 1);
-      output1 += (out_stride << 1) - (thr->width << 1);
+      input   += in_stride;
+      output0 += out_stride << 1;
+      output1 += out_stride << 1;
    }
 }
 
@@ -20,6 +20,14 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
 #ifdef RARCH_INTERNAL
 #define softfilter_get_implementation scanline2x_get_implementation
 #define softfilter_thread_data scanline2x_softfilter_thread_data
@@ -44,8 +52,67 @@ struct filter_data
    unsigned threads;
    struct softfilter_thread_data *workers;
    unsigned in_fmt;
+   int simd;
 };
 
+/* Vector versions of the scanline mix below. XRGB8888 wraps at
+ * 32 bits exactly like the scalar code; RGB565 is computed in int
+ * by the scalar code, so the vector code uses a halving add that
+ * cannot overflow. Output is identical either way. */
+#if defined(__SSE2__)
+#define SCANLINE2X_SIMD
+typedef __m128i scanline2x_v_t;
+#define SCANLINE2X_LOAD(p)        _mm_loadu_si128((const __m128i*)(p))
+#define SCANLINE2X_SET32(x)       _mm_set1_epi32(x)
+#define SCANLINE2X_SET16(x)       _mm_set1_epi16(x)
+#define SCANLINE2X_AND(a, b)      _mm_and_si128(a, b)
+#define SCANLINE2X_XOR(a, b)      _mm_xor_si128(a, b)
+#define SCANLINE2X_ADD32(a, b)    _mm_add_epi32(a, b)
+#define SCANLINE2X_ADD16(a, b)    _mm_add_epi16(a, b)
+#define SCANLINE2X_SHR32(a)       _mm_srli_epi32(a, 1)
+#define SCANLINE2X_HADD16(a, b)   _mm_add_epi16(_mm_and_si128(a, b), _mm_srli_epi16(_mm_xor_si128(a, b), 1))
+#define SCANLINE2X_STORE_DUP32(p, a) \
+   _mm_storeu_si128((__m128i*)(p),     _mm_unpacklo_epi32(a, a)); \
+   _mm_storeu_si128((__m128i*)(p) + 1, _mm_unpackhi_epi32(a, a))
+#define SCANLINE2X_STORE_DUP16(p, a) \
+   _mm_storeu_si128((__m128i*)(p),     _mm_unpacklo_epi16(a, a)); \
+   _mm_storeu_si128((__m128i*)(p) + 1, _mm_unpackhi_epi16(a, a))
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define SCANLINE2X_SIMD
+typedef uint32x4_t scanline2x_v_t;
+#define SCANLINE2X_LOAD(p)        vreinterpretq_u32_u8(vld1q_u8((const uint8_t*)(p)))
+#define SCANLINE2X_SET32(x)       vdupq_n_u32(x)
+#define SCANLINE2X_SET16(x)       vreinterpretq_u32_u16(vdupq_n_u16(x))
+#define SCANLINE2X_AND(a, b)      vandq_u32(a, b)
+#define SCANLINE2X_XOR(a, b)      veorq_u32(a, b)
+#define SCANLINE2X_ADD32(a, b)    vaddq_u32(a, b)
+#define SCANLINE2X_ADD16(a, b)    vreinterpretq_u32_u16(vaddq_u16(vreinterpretq_u16_u32(a), vreinterpretq_u16_u32(b)))
+#define SCANLINE2X_SHR32(a)       vshrq_n_u32(a, 1)
+#define SCANLINE2X_HADD16(a, b)   vreinterpretq_u32_u16(vhaddq_u16(vreinterpretq_u16_u32(a), vreinterpretq_u16_u32(b)))
+#define SCANLINE2X_STORE_DUP32(p, a) \
+   do { uint32x4x2_t v_; v_.val[0] = v_.val[1] = (a); vst2q_u32(p, v_); } while (0)
+#define SCANLINE2X_STORE_DUP16(p, a) \
+   do { uint16x8x2_t v_; v_.val[0] = v_.val[1] = vreinterpretq_u16_u32(a); vst2q_u16(p, v_); } while (0)
+#elif defined(__wasm_simd128__)
+#define SCANLINE2X_SIMD
+typedef v128_t scanline2x_v_t;
+#define SCANLINE2X_LOAD(p)        wasm_v128_load(p)
+#define SCANLINE2X_SET32(x)       wasm_i32x4_splat(x)
+#define SCANLINE2X_SET16(x)       wasm_i16x8_splat(x)
+#define SCANLINE2X_AND(a, b)      wasm_v128_and(a, b)
+#define SCANLINE2X_XOR(a, b)      wasm_v128_xor(a, b)
+#define SCANLINE2X_ADD32(a, b)    wasm_i32x4_add(a, b)
+#define SCANLINE2X_ADD16(a, b)    wasm_i16x8_add(a, b)
+#define SCANLINE2X_SHR32(a)       wasm_u32x4_shr(a, 1)
+#define SCANLINE2X_HADD16(a, b)   wasm_i16x8_add(wasm_v128_and(a, b), wasm_u16x8_shr(wasm_v128_xor(a, b), 1))
+#define SCANLINE2X_STORE_DUP32(p, a) \
+   wasm_v128_store((p),     wasm_i32x4_shuffle(a, a, 0, 0, 1, 1)); \
+   wasm_v128_store((p) + 4, wasm_i32x4_shuffle(a, a, 2, 2, 3, 3))
+#define SCANLINE2X_STORE_DUP16(p, a) \
+   wasm_v128_store((p),     wasm_i16x8_shuffle(a, a, 0, 0, 1, 1, 2, 2, 3, 3)); \
+   wasm_v128_store((p) + 8, wasm_i16x8_shuffle(a, a, 4, 4, 5, 5, 6, 6, 7, 7))
+#endif
+
 static unsigned scanline2x_generic_input_fmts(void)
 {
    return SOFTFILTER_FMT_XRGB8888 | SOFTFILTER_FMT_RGB565;
@@ -79,6 +146,14 @@ static void *scanline2x_generic_create(const struct softfilter_config *config,
     * so force single threaded operation... */
    filt->threads = 1;
    filt->in_fmt  = in_fmt;
+#if defined(__SSE2__)
+   filt->simd    = (simd & SOFTFILTER_SIMD_SSE2) ? 1 : 0;
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+   filt->simd    = (simd & SOFTFILTER_SIMD_NEON) ? 1 : 0;
+#elif defined(__wasm_simd128__)
+   /* No runtime bit for it; building with -msimd128 is the opt-in */
+   filt->simd    = 1;
+#endif
    return filt;
 }
 
@@ -99,8 +174,56 @@ static void scanline2x_generic_destroy(void *data)
    free(filt);
 }
 
+#ifdef SCANLINE2X_SIMD
+/* Returns the first pixel left for the scalar loop */
+static unsigned scanline2x_simd_xrgb8888(uint32_t *out0, uint32_t *out1,
+      const uint32_t *input, unsigned width)
+{
+   unsigned x;
+   scanline2x_v_t mask = SCANLINE2X_SET32(0x1010101);
+
+   for (x = 0; x + 4 <= width; x += 4)
+   {
+      scanline2x_v_t color    = SCANLINE2X_LOAD(input + x);
+      scanline2x_v_t scanline = SCANLINE2X_SHR32(SCANLINE2X_ADD32(color,
+               SCANLINE2X_AND(color, mask)));
+      scanline                = SCANLINE2X_SHR32(SCANLINE2X_ADD32(
+               SCANLINE2X_ADD32(color, scanline),
+               SCANLINE2X_AND(SCANLINE2X_XOR(color, scanline), mask)));
+
+      SCANLINE2X_STORE_DUP32(out0 + (x << 1), color);
+      SCANLINE2X_STORE_DUP32(out1 + (x << 1), scanline);
+   }
+
+   return x;
+}
+
+static unsigned scanline2x_simd_rgb565(uint16_t *out0, uint16_t *out1,
+      const uint16_t *input, unsigned width)
+{
+   unsigned x;
+   scanline2x_v_t mask = SCANLINE2X_SET16(0x821);
+
+   for (x = 0; x + 8 <= width; x += 8)
+   {
+      scanline2x_v_t color    = SCANLINE2X_LOAD(input + x);
+      scanline2x_v_t scanline = SCANLINE2X_HADD16(color,
+            SCANLINE2X_AND(color, mask));
+      scanline                = SCANLINE2X_HADD16(color,
+            SCANLINE2X_ADD16(scanline,
+               SCANLINE2X_AND(SCANLINE2X_XOR(color, scanline), mask)));
+
+      SCANLINE2X_STORE_DUP16(out0 + (x << 1), color);
+      SCANLINE2X_STORE_DUP16(out1 + (x << 1), scanline);
+   }
+
+   return x;
+}
+#endif
+
 static void scanline2x_work_cb_xrgb8888(void *data, void *thread_data)
 {
+   struct filter_data *filt           = (struct filter_data*)data;
    struct softfilter_thread_data *thr = (struct softfilter_thread_data*)thread_data;
    const uint32_t *input              = (const uint32_t*)thr->in_data;
    uint32_t *output                   = (uint32_t*)thr->out_data;
@@ -110,8 +233,17 @@ static void scanline2x_work_cb_xrgb8888(void *data, void *thread_data)
 
    for (y = 0; y < thr->height; ++y)
    {
-      uint32_t *out_ptr = output;
-      for (x = 0; x < thr->width; ++x)
+      uint32_t *out_ptr;
+
+      x = 0;
+#ifdef SCANLINE2X_SIMD
+      if (filt->simd)
+         x = scanline2x_simd_xrgb8888(output, output + out_stride,
+               input, thr->width);
+#endif
+      out_ptr = output + (x << 1);
+
+      for (; x < thr->width; ++x)
       {
          uint32_t *out_line_ptr  = out_ptr;
          uint32_t color          = *(input + x);
@@ -145,6 +277,7 @@ static void scanline2x_work_cb_xrgb8888(void *data, void *thread_data)
 
 static void scanline2x_work_cb_rgb565(void *data, void *thread_data)
 {
+   struct filter_data *filt           = (struct filter_data*)data;
    struct softfilter_thread_data *thr = (struct softfilter_thread_data*)thread_data;
    const uint16_t *input              = (const uint16_t*)thr->in_data;
    uint16_t *output                   = (uint16_t*)thr->out_data;
@@ -154,8 +287,17 @@ static void scanline2x_work_cb_rgb565(void *data, void *thread_data)
 
    for (y = 0; y < thr->height; ++y)
    {
-      uint16_t *out_ptr = output;
-      for (x = 0; x < thr->width; ++x)
+      uint16_t *out_ptr;
+
+      x = 0;
+#ifdef SCANLINE2X_SIMD
+      if (filt->simd)
+         x = scanline2x_simd_rgb565(output, output + out_stride,
+               input, thr->width);
+#endif
+      out_ptr = output + (x << 1);
+
+      for (; x < thr->width; ++x)
       {
          uint16_t *out_line_ptr  = out_ptr;
          uint16_t color          = *(input + x);
@@ -412,7 +412,7 @@ static bool video_thread_handle_packet(
 static void video_thread_loop(void *data)
 {
    thread_packet_t pkt;
-   bool updated;
+   bool updated, dupe;
    thread_video_t *thr = (thread_video_t*)data;
 
    for (;;)
@@ -422,6 +422,29 @@ static void video_thread_loop(void *data)
          scond_wait(thr->cond_thread, thr->lock);
 
       updated = thr->frame.updated;
+      dupe    = thr->frame.dupe;
+
+      if (updated)
+      {
+         /* Take the newest frame; the runloop can
+          * immediately start on the next one */
+         if (!thr->frame.dupe)
+         {
+            unsigned read      = thr->frame.read;
+            thr->frame.read    = thr->frame.ready;
+            thr->frame.ready   = read;
+         }
+         else
+         {
+            thread_video_frame_t *fr = &thr->frame.slots[thr->frame.read];
+            fr->count          = thr->frame.dupe_count;
+            strlcpy(fr->msg, thr->frame.dupe_msg, sizeof(fr->msg));
+         }
+         thr->frame.dupe       = false;
+         thr->frame.updated    = false;
+         thr->frame.busy       = true;
+         scond_signal(thr->cond_cmd);
+      }
 
       /* To avoid race condition where send_cmd is updated
        * right after the switch is checked. */
@@ -438,6 +461,7 @@ static void video_thread_loop(void *data)
          bool               alive = false;
          bool               focus = false;
          bool        has_windowed = false;
+         thread_video_frame_t *fr = &thr->frame.slots[thr->frame.read];
 
          vp.x                     = 0;
          vp.y                     = 0;
@@ -462,15 +486,27 @@ static void video_thread_loop(void *data)
                video_driver_build_info(&video_info);
 
                ret = thr->driver->frame(thr->driver_data,
-                  thr->frame.buffer, thr->frame.width, thr->frame.height,
-                  thr->frame.count, thr->frame.pitch,
-                  *thr->frame.msg ? thr->frame.msg : NULL,
+                  fr->buffer, fr->width, fr->height,
+                  fr->count, fr->pitch,
+                  *fr->msg ? fr->msg : NULL,
                   &video_info);
 
                slock_unlock(thr->frame.lock);
 
                if (ret)
                {
+                  /* Time from the core handing us the frame
+                   * until it went to the screen */
+                  if (!dupe)
+                  {
+                     retro_time_t latency = cpu_features_get_time_usec()
+                        - fr->stamp;
+                     thr->frame.latency_total += latency;
+                     thr->frame.latency_frames++;
+                     if (latency > thr->frame.latency_max)
+                        thr->frame.latency_max = latency;
+                  }
+
                   if (thr->driver->alive)
                      alive = thr->driver->alive(thr->driver_data);
                   if (thr->driver->focus)
@@ -493,7 +529,7 @@ static void video_thread_loop(void *data)
          thr->focus         = focus;
          thr->has_windowed  = has_windowed;
          thr->vp            = vp;
-         thr->frame.updated = false;
+         thr->frame.busy    = false;
          scond_signal(thr->cond_cmd);
          slock_unlock(thr->lock);
       }
@@ -595,6 +631,41 @@ static bool video_thread_frame(void *data, const void *frame_,
       return false;
    }
 
+   /* Fill our own buffer first, without holding any lock;
+    * the video thread may be drawing the previous frame meanwhile.
+    * If the core rendered straight into it (see
+    * thread_get_current_software_framebuffer), there's nothing to copy. */
+   if (frame_)
+   {
+      thread_video_frame_t *fr = &thr->frame.slots[thr->frame.write];
+      unsigned copy_stride     = width *
+         (thr->info.rgb32 ? sizeof(uint32_t) : sizeof(uint16_t));
+
+      if ((const uint8_t*)frame_ != fr->buffer)
+      {
+         unsigned i;
+         const uint8_t *src    = (const uint8_t*)frame_;
+         uint8_t       *dst    = fr->buffer;
+
+         if (pitch == copy_stride)
+            memcpy(dst, src, copy_stride * height);
+         else
+            for (i = 0; i < height; i++, src += pitch, dst += copy_stride)
+               memcpy(dst, src, copy_stride);
+      }
+
+      fr->width             = width;
+      fr->height            = height;
+      fr->count             = frame_count;
+      fr->pitch             = copy_stride;
+      fr->stamp             = cpu_features_get_time_usec();
+
+      if (msg)
+         strlcpy(fr->msg, msg, sizeof(fr->msg));
+      else
+         *fr->msg = '\0';
+   }
+
    slock_lock(thr->lock);
 
    if (!thr->nonblock)
@@ -617,48 +688,55 @@ static bool video_thread_frame(void *data, const void *frame_,
       }
    }
 
-   /* Drop frame if updated flag is still set, as thread is
-    * still working on last frame. */
-   if (!thr->frame.updated)
+   if (frame_)
    {
-      const uint8_t *src   = (const uint8_t*)frame_;
-      uint8_t       *dst   = thr->frame.buffer;
-      unsigned copy_stride = width *
-         (thr->info.rgb32 ? sizeof(uint32_t) : sizeof(uint16_t));
+      /* Publish the new frame. If the thread hasn't picked up
+       * the previous one yet, it gets replaced by this newer one. */
+      unsigned write     = thr->frame.write;
 
-      if (src)
-      {
-         int i; /* TODO/FIXME - increment counter never meaningfully used */
-         for (i = 0; i < (int)height; i++, src += pitch, dst += copy_stride)
-            memcpy(dst, src, copy_stride);
-      }
+      if (thr->frame.updated && !thr->frame.dupe)
+         thr->miss_count++;
 
+      thr->frame.write   = thr->frame.ready;
+      thr->frame.ready   = write;
+      thr->frame.dupe    = false;
       thr->frame.updated = true;
-      thr->frame.width   = width;
-      thr->frame.height  = height;
-      thr->frame.count   = frame_count;
-      thr->frame.pitch   = copy_stride;
+      thr->hit_count++;
+   }
+   else if (thr->frame.updated && !thr->frame.dupe)
+   {
+      /* Dupe while a new frame is still waiting; only
+       * the OSD message and frame count move on */
+      thread_video_frame_t *fr = &thr->frame.slots[thr->frame.ready];
 
+      fr->count          = frame_count;
+      if (msg)
+         strlcpy(fr->msg, msg, sizeof(fr->msg));
+      else
+         *fr->msg = '\0';
+   }
+   else
+   {
+      /* Dupe; have the thread draw its current frame again,
+       * with the new OSD message and frame count */
+      thr->frame.dupe_count = frame_count;
       if (msg)
-         strlcpy(thr->frame.msg, msg, sizeof(thr->frame.msg));
+         strlcpy(thr->frame.dupe_msg, msg, sizeof(thr->frame.dupe_msg));
       else
-         *thr->frame.msg = '\0';
+         *thr->frame.dupe_msg = '\0';
+      thr->frame.dupe    = true;
+      thr->frame.updated = true;
+   }
 
-      scond_signal(thr->cond_thread);
+   scond_signal(thr->cond_thread);
 
 #ifdef HAVE_MENU
-      if (thr->texture.enable)
-      {
-         do
-         {
-            scond_wait(thr->cond_cmd, thr->lock);
-         } while (thr->frame.updated);
-      }
-#endif
-      thr->hit_count++;
+   if (thr->texture.enable)
+   {
+      while (thr->frame.updated || thr->frame.busy)
+         scond_wait(thr->cond_cmd, thr->lock);
    }
-   else
-      thr->miss_count++;
+#endif
 
    slock_unlock(thr->lock);
 
@@ -695,20 +773,29 @@ static bool video_thread_init(thread_video_t *thr,
       return false;
 
    {
+      unsigned i;
       size_t max_size        = info.input_scale * RARCH_SCALE_BASE;
       max_size              *= max_size;
       max_size              *= info.rgb32 ?
          sizeof(uint32_t) : sizeof(uint16_t);
 
+      for (i = 0; i < VIDEO_THREAD_FRAME_BUFFERS; i++)
+      {
 #ifdef _3DS
-      thr->frame.buffer      = linearMemAlign(max_size, 0x80);
+         thr->frame.slots[i].buffer = (uint8_t*)linearMemAlign(max_size, 0x80);
 #else
-      thr->frame.buffer      = (uint8_t*)malloc(max_size);
+         thr->frame.slots[i].buffer = (uint8_t*)malloc(max_size);
 #endif
-      if (!thr->frame.buffer)
-         return false;
+         if (!thr->frame.slots[i].buffer)
+            return false;
 
-      memset(thr->frame.buffer, 0x80, max_size);
+         memset(thr->frame.slots[i].buffer, 0x80, max_size);
+      }
+
+      thr->frame.buffer_size = max_size;
+      thr->frame.write       = 0;
+      thr->frame.ready       = 1;
+      thr->frame.read        = 2;
    }
 
    thr->input                = input;
@@ -818,6 +905,7 @@ static bool video_thread_read_viewport(void *data,
 
 static void video_thread_free(void *data)
 {
+   unsigned i;
    thread_video_t *thr = (thread_video_t*)data;
 
    if (thr)
@@ -840,11 +928,14 @@ static void video_thread_free(void *data)
       }
 
       free(thr->texture.frame);
+      for (i = 0; i < VIDEO_THREAD_FRAME_BUFFERS; i++)
+      {
 #ifdef _3DS
-      linearFree(thr->frame.buffer);
+         linearFree(thr->frame.slots[i].buffer);
 #else
-      free(thr->frame.buffer);
+         free(thr->frame.slots[i].buffer);
 #endif
+      }
       free(thr->alpha_mod);
 
       slock_free(thr->frame.lock);
@@ -856,6 +947,12 @@ static void video_thread_free(void *data)
       RARCH_LOG(
          "Threaded video stats: Frames pushed: %u, Frames dropped: %u.\n",
          thr->hit_count, thr->miss_count);
+      if (thr->frame.latency_frames)
+         RARCH_LOG(
+            "Threaded video stats: Frame to present latency: %.2f ms average, %.2f ms max.\n",
+            (double)thr->frame.latency_total
+            / thr->frame.latency_frames / 1000.0,
+            (double)thr->frame.latency_max / 1000.0);
 
       free(thr);
    }
@@ -1248,6 +1345,45 @@ static struct video_shader *thread_get_current_shader(void *data)
    return NULL;
 }
 
+/* Hands the core the buffer the next frame will be published from,
+ * so video_thread_frame can skip its copy. Only the runloop touches
+ * the write slot, so this is safe without taking any lock. */
+static bool thread_get_current_software_framebuffer(void *data,
+      struct retro_framebuffer *framebuffer)
+{
+   thread_video_t *thr            = (thread_video_t*)data;
+   video_driver_state_t *video_st = video_state_get_ptr();
+   unsigned bpp;
+   enum retro_pixel_format fmt;
+
+   if (!thr || !framebuffer)
+      return false;
+
+   if (thr->info.rgb32)
+   {
+      bpp = sizeof(uint32_t);
+      fmt = RETRO_PIXEL_FORMAT_XRGB8888;
+   }
+   else
+   {
+      bpp = sizeof(uint16_t);
+      fmt = RETRO_PIXEL_FORMAT_RGB565;
+   }
+
+   if (     video_st->pix_fmt != fmt
+         || framebuffer->width > thr->info.input_scale * RARCH_SCALE_BASE
+         || (size_t)framebuffer->width * bpp * framebuffer->height
+            > thr->frame.buffer_size)
+      return false;
+
+   framebuffer->data         = thr->frame.slots[thr->frame.write].buffer;
+   framebuffer->pitch        = framebuffer->width * bpp;
+   framebuffer->format       = fmt;
+   framebuffer->memory_flags = RETRO_MEMORY_TYPE_CACHED;
+
+   return true;
+}
+
 static uint32_t thread_get_flags(void *data)
 {
    thread_video_t *thr = (thread_video_t*)data;
@@ -1278,7 +1414,7 @@ static const video_poke_interface_t thread_poke = {
    thread_show_mouse,
    thread_grab_mouse_toggle,
    thread_get_current_shader,
-   NULL, /* get_current_software_framebuffer */
+   thread_get_current_software_framebuffer,
    NULL, /* get_hw_render_interface */
    thread_set_hdr_max_nits,
    thread_set_hdr_paper_white_nits,
@@ -66,6 +66,11 @@ enum thread_cmd
    CMD_DUMMY = INT_MAX
 };
 
+/* Number of frame buffers exchanged between the runloop
+ * and the video thread: one being written by the runloop,
+ * one ready for display and one being displayed. */
+#define VIDEO_THREAD_FRAME_BUFFERS 3
+
 typedef int (*custom_command_method_t)(void*);
 
 typedef bool (*custom_font_command_method_t)(const void **font_driver,
@@ -166,6 +171,18 @@ typedef struct thread_packet
    enum thread_cmd type;
 } thread_packet_t;
 
+typedef struct thread_video_frame
+{
+   uint8_t *buffer;
+   /* Time the frame was handed over by the runloop */
+   retro_time_t stamp;
+   uint64_t count;
+   unsigned width;
+   unsigned height;
+   unsigned pitch;
+   char msg[NAME_MAX_LENGTH];
+} thread_video_frame_t;
+
 typedef struct thread_video
 {
    retro_time_t last_time;
@@ -218,16 +235,32 @@ typedef struct thread_video
 
    bool alpha_update;
 
+   /* Frames are passed through a mailbox of three buffers.
+    * The runloop owns slots[write] and the video thread owns
+    * slots[read]; slots[ready] holds the most recent complete
+    * frame and is swapped in by either side under thr->lock,
+    * so neither side ever waits for the other's copy or draw. */
    struct
    {
-      uint64_t count;
+      thread_video_frame_t slots[VIDEO_THREAD_FRAME_BUFFERS];
+      /* Runloop to present latency, in microseconds */
+      retro_time_t latency_total;
+      retro_time_t latency_max;
+      uint64_t latency_frames;
+      /* Frame count and message that came with the pending dupe */
+      uint64_t dupe_count;
+      char dupe_msg[NAME_MAX_LENGTH];
       slock_t *lock;
-      uint8_t *buffer;
-      unsigned width;
-      unsigned height;
-      unsigned pitch;
-      char msg[NAME_MAX_LENGTH];
+      size_t buffer_size;
+      unsigned write;
+      unsigned ready;
+      unsigned read;
+      /* slots[ready] holds a frame the thread hasn't picked up yet */
       bool updated;
+      /* The pending update is a dupe; redraw slots[read] */
+      bool dupe;
+      /* The thread is drawing slots[read] */
+      bool busy;
       bool within_thread;
    } frame;
 
@@ -31,12 +31,21 @@
 #include <formats/rwav.h>
 #endif
 #include <memalign.h>
+#include <retro_miscellaneous.h>
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
 #ifdef HAVE_STB_VORBIS
 #define STB_VORBIS_NO_PUSHDATA_API
 #define STB_VORBIS_NO_STDIO
@@ -70,9 +79,16 @@
 #define AUDIO_MIXER_UNLOCK(voice) do {} while(0)
 #endif
 
-#define AUDIO_MIXER_MAX_VOICES      8
+#ifndef AUDIO_MIXER_MAX_VOICES
+#define AUDIO_MIXER_MAX_VOICES      32
+#endif
 #define AUDIO_MIXER_TEMP_BUFFER 8192
 
+/* Number of frames over which a volume change is ramped
+ * when mixing a voice; avoids zipper noise and clicks
+ * when the volume is changed while a sound is playing. */
+#define AUDIO_MIXER_RAMP_FRAMES    64
+
 struct audio_mixer_sound
 {
    enum audio_mixer_type type;
@@ -191,6 +207,7 @@ struct audio_mixer_voice
    audio_mixer_stop_cb_t stop_cb;
    unsigned type;
    float    volume;
+   float    gain; /* Gain applied at the end of the last mix */
    bool     repeat;
 #ifdef HAVE_THREADS
    slock_t *lock;
@@ -917,6 +934,7 @@ audio_mixer_voice_t* audio_mixer_play(audio_mixer_sound_t* sound,
    {
       voice->repeat   = repeat;
       voice->volume   = volume;
+      voice->gain     = volume;
       voice->sound    = sound;
       voice->stop_cb  = stop_cb;
       AUDIO_MIXER_UNLOCK(voice);
@@ -990,11 +1008,119 @@ void audio_mixer_stop(audio_mixer_voice_t* voice)
    }
 }
 
+/**
+ * audio_mixer_accumulate:
+ * @out                : interleaved stereo output buffer.
+ * @in                 : interleaved stereo input samples.
+ * @samples            : number of samples (not frames) to mix.
+ * @voice              : voice being mixed (its gain gets updated).
+ * @volume             : target volume for this voice.
+ *
+ * Adds @in scaled by the voice gain to @out. If the gain
+ * differs from @volume, it is ramped per-frame towards it
+ * first; the remainder is then mixed at constant gain with
+ * a SIMD loop where available. Saturation is not done here,
+ * but once for all voices at the end of audio_mixer_mix().
+ **/
+static void audio_mixer_accumulate(float *out, const float *in,
+      size_t samples, audio_mixer_voice_t *voice, float volume)
+{
+   size_t i   = 0;
+   float gain = voice->gain;
+
+   if (gain != volume)
+   {
+      const float step = 1.0f / AUDIO_MIXER_RAMP_FRAMES;
+
+      for (; i + 2 <= samples && gain != volume; i += 2)
+      {
+         if (gain < volume)
+            gain = (gain + step > volume) ? volume : gain + step;
+         else
+            gain = (gain - step < volume) ? volume : gain - step;
+
+         out[i + 0] += in[i + 0] * gain;
+         out[i + 1] += in[i + 1] * gain;
+      }
+
+      voice->gain = gain;
+   }
+
+#if defined(__SSE__)
+   {
+      __m128 vgain = _mm_set1_ps(gain);
+      for (; i + 8 <= samples; i += 8)
+      {
+         __m128 a = _mm_loadu_ps(in + i);
+         __m128 b = _mm_loadu_ps(in + i + 4);
+         _mm_storeu_ps(out + i,
+               _mm_add_ps(_mm_loadu_ps(out + i),     _mm_mul_ps(a, vgain)));
+         _mm_storeu_ps(out + i + 4,
+               _mm_add_ps(_mm_loadu_ps(out + i + 4), _mm_mul_ps(b, vgain)));
+      }
+   }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+   for (; i + 8 <= samples; i += 8)
+   {
+      vst1q_f32(out + i,
+            vmlaq_n_f32(vld1q_f32(out + i),     vld1q_f32(in + i),     gain));
+      vst1q_f32(out + i + 4,
+            vmlaq_n_f32(vld1q_f32(out + i + 4), vld1q_f32(in + i + 4), gain));
+   }
+#elif defined(__wasm_simd128__)
+   {
+      v128_t vgain = wasm_f32x4_splat(gain);
+      for (; i + 8 <= samples; i += 8)
+      {
+         wasm_v128_store(out + i, wasm_f32x4_add(wasm_v128_load(out + i),
+                  wasm_f32x4_mul(wasm_v128_load(in + i), vgain)));
+         wasm_v128_store(out + i + 4, wasm_f32x4_add(wasm_v128_load(out + i + 4),
+                  wasm_f32x4_mul(wasm_v128_load(in + i + 4), vgain)));
+      }
+   }
+#endif
+
+   for (; i < samples; i++)
+      out[i] += in[i] * gain;
+}
+
+/* Clamps the mixed buffer to [-1.0, 1.0] */
+static void audio_mixer_saturate(float *buffer, size_t samples)
+{
+   size_t i = 0;
+#if defined(__SSE__)
+   __m128 vmin = _mm_set1_ps(-1.0f);
+   __m128 vmax = _mm_set1_ps( 1.0f);
+   for (; i + 4 <= samples; i += 4)
+      _mm_storeu_ps(buffer + i, _mm_min_ps(vmax,
+               _mm_max_ps(vmin, _mm_loadu_ps(buffer + i))));
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+   float32x4_t vmin = vdupq_n_f32(-1.0f);
+   float32x4_t vmax = vdupq_n_f32( 1.0f);
+   for (; i + 4 <= samples; i += 4)
+      vst1q_f32(buffer + i, vminq_f32(vmax,
+               vmaxq_f32(vmin, vld1q_f32(buffer + i))));
+#elif defined(__wasm_simd128__)
+   v128_t vmin = wasm_f32x4_splat(-1.0f);
+   v128_t vmax = wasm_f32x4_splat( 1.0f);
+   for (; i + 4 <= samples; i += 4)
+      wasm_v128_store(buffer + i, wasm_f32x4_pmin(vmax,
+               wasm_f32x4_pmax(vmin, wasm_v128_load(buffer + i))));
+#endif
+
+   for (; i < samples; i++)
+   {
+      if (buffer[i] < -1.0f)
+         buffer[i] = -1.0f;
+      else if (buffer[i] > 1.0f)
+         buffer[i] = 1.0f;
+   }
+}
+
 static void audio_mixer_mix_wav(float* buffer, size_t num_frames,
       audio_mixer_voice_t* voice,
       float volume)
 {
-   int i;
    unsigned buf_free                = (unsigned)(num_frames * 2);
    const audio_mixer_sound_t* sound = voice->sound;
    unsigned pcm_available           = sound->types.wav.frames
@@ -1005,8 +1131,8 @@ static void audio_mixer_mix_wav(float* buffer, size_t num_frames,
 again:
    if (pcm_available < buf_free)
    {
-      for (i = pcm_available; i != 0; i--)
-         *buffer++ += *pcm++ * volume;
+      audio_mixer_accumulate(buffer, pcm, pcm_available, voice, volume);
+      buffer += pcm_available;
 
       if (voice->repeat)
       {
@@ -1027,9 +1153,7 @@ again:
    }
    else
    {
-      for (i = buf_free; i != 0; i--)
-         *buffer++ += *pcm++ * volume;
-
+      audio_mixer_accumulate(buffer, pcm, buf_free, voice, volume);
       voice->types.wav.position += buf_free;
    }
 }
@@ -1039,7 +1163,6 @@ static void audio_mixer_mix_ogg(float* buffer, size_t num_frames,
       audio_mixer_voice_t* voice,
       float volume)
 {
-   int i;
    float* temp_buffer = NULL;
    unsigned buf_free                = (unsigned)(num_frames * 2);
    unsigned temp_samples            = 0;
@@ -1100,15 +1223,14 @@ again:
 
    if (voice->types.ogg.samples < buf_free)
    {
-      for (i = voice->types.ogg.samples; i != 0; i--)
-         *buffer++ += *pcm++ * volume;
-
+      audio_mixer_accumulate(buffer, pcm,
+            voice->types.ogg.samples, voice, volume);
+      buffer   += voice->types.ogg.samples;
       buf_free -= voice->types.ogg.samples;
       goto again;
    }
 
-   for (i = buf_free; i != 0; --i )
-      *buffer++ += *pcm++ * volume;
+   audio_mixer_accumulate(buffer, pcm, buf_free, voice, volume);
 
    voice->types.ogg.position += buf_free;
    voice->types.ogg.samples  -= buf_free;
@@ -1124,8 +1246,7 @@ static void audio_mixer_mix_mod(float* buffer, size_t num_frames,
       audio_mixer_voice_t* voice,
       float volume)
 {
-   int i;
-   float samplef                    = 0.0f;
+   float temp_buffer[AUDIO_MIXER_TEMP_BUFFER / 8];
    unsigned temp_samples            = 0;
    unsigned buf_free                = (unsigned)(num_frames * 2);
    int* pcm                         = NULL;
@@ -1159,28 +1280,34 @@ again:
    }
    pcm = voice->types.mod.buffer + voice->types.mod.position;
 
-   if (voice->types.mod.samples < buf_free)
+   /* Convert to float in chunks, so the accumulation
+    * can take the same vectorized path as the other types */
+   for (;;)
    {
-      for (i = voice->types.mod.samples; i != 0; i--)
-      {
-         samplef     = ((float)(*pcm++) + 32768.0f) / 65535.0f;
-         samplef     = samplef * 2.0f - 1.0f;
-         *buffer++  += samplef * volume;
-      }
+      unsigned i;
+      unsigned avail = (voice->types.mod.samples < buf_free)
+         ? voice->types.mod.samples : buf_free;
+      unsigned count = (avail < ARRAY_SIZE(temp_buffer))
+         ? avail : (unsigned)ARRAY_SIZE(temp_buffer);
 
-      buf_free -= voice->types.mod.samples;
-      goto again;
-   }
+      if (count == 0)
+         break;
 
-   for (i = buf_free; i != 0; --i )
-   {
-      samplef     = ((float)(*pcm++) + 32768.0f) / 65535.0f;
-      samplef     = samplef * 2.0f - 1.0f;
-      *buffer++  += samplef * volume;
+      for (i = 0; i < count; i++)
+         temp_buffer[i] = (((float)pcm[i] + 32768.0f) / 65535.0f)
+            * 2.0f - 1.0f;
+
+      audio_mixer_accumulate(buffer, temp_buffer, count, voice, volume);
+
+      buffer                    += count;
+      pcm                       += count;
+      buf_free                  -= count;
+      voice->types.mod.position += count;
+      voice->types.mod.samples  -= count;
    }
 
-   voice->types.mod.position += buf_free;
-   voice->types.mod.samples  -= buf_free;
+   if (buf_free)
+      goto again;
 }
 #endif
 
@@ -1189,7 +1316,6 @@ static void audio_mixer_mix_flac(float* buffer, size_t num_frames,
       audio_mixer_voice_t* voice,
       float volume)
 {
-   int i;
    struct resampler_data info;
    float temp_buffer[AUDIO_MIXER_TEMP_BUFFER] = { 0 };
    unsigned buf_free                = (unsigned)(num_frames * 2);
@@ -1237,15 +1363,14 @@ again:
 
    if (voice->types.flac.samples < buf_free)
    {
-      for (i = voice->types.flac.samples; i != 0; i--)
-         *buffer++ += *pcm++ * volume;
-
+      audio_mixer_accumulate(buffer, pcm,
+            voice->types.flac.samples, voice, volume);
+      buffer   += voice->types.flac.samples;
       buf_free -= voice->types.flac.samples;
       goto again;
    }
 
-   for (i = buf_free; i != 0; --i )
-      *buffer++ += *pcm++ * volume;
+   audio_mixer_accumulate(buffer, pcm, buf_free, voice, volume);
 
    voice->types.flac.position += buf_free;
    voice->types.flac.samples  -= buf_free;
@@ -1257,7 +1382,6 @@ static void audio_mixer_mix_mp3(float* buffer, size_t num_frames,
       audio_mixer_voice_t* voice,
       float volume)
 {
-   int i;
    struct resampler_data info;
    float temp_buffer[AUDIO_MIXER_TEMP_BUFFER] = { 0 };
    unsigned buf_free                = (unsigned)(num_frames * 2);
@@ -1309,27 +1433,24 @@ again:
 
    if (voice->types.mp3.samples < buf_free)
    {
-      for (i = voice->types.mp3.samples; i != 0; i--)
-         *buffer++ += *pcm++ * volume;
-
+      audio_mixer_accumulate(buffer, pcm,
+            voice->types.mp3.samples, voice, volume);
+      buffer   += voice->types.mp3.samples;
       buf_free -= voice->types.mp3.samples;
       goto again;
    }
 
-   for (i = buf_free; i != 0; --i )
-      *buffer++ += *pcm++ * volume;
+   audio_mixer_accumulate(buffer, pcm, buf_free, voice, volume);
 
    voice->types.mp3.position += buf_free;
    voice->types.mp3.samples  -= buf_free;
 }
 #endif
 
-void audio_mixer_mix(float* buffer, size_t num_frames,
+void audio_mixer_mix_unclamped(float* buffer, size_t num_frames,
       float volume_override, bool override)
 {
    unsigned i;
-   size_t j                   = 0;
-   float* sample              = NULL;
    audio_mixer_voice_t* voice = s_voices;
 
    for (i = 0; i < AUDIO_MIXER_MAX_VOICES; i++, voice++)
@@ -1371,14 +1492,13 @@ void audio_mixer_mix(float* buffer, size_t num_frames,
 
       AUDIO_MIXER_UNLOCK(voice);
    }
+}
 
-   for (j = 0, sample = buffer; j < num_frames * 2; j++, sample++)
-   {
-      if (*sample < -1.0f)
-         *sample = -1.0f;
-      else if (*sample > 1.0f)
-         *sample = 1.0f;
-   }
+void audio_mixer_mix(float* buffer, size_t num_frames,
+      float volume_override, bool override)
+{
+   audio_mixer_mix_unclamped(buffer, num_frames, volume_override, override);
+   audio_mixer_saturate(buffer, num_frames * 2);
 }
 
 float audio_mixer_voice_get_volume(audio_mixer_voice_t *voice)
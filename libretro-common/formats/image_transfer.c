@@ -208,6 +208,27 @@ void image_transfer_set_buffer_ptr(
    }
 }
 
+void image_transfer_set_max_size(
+      void *data,
+      enum image_type_enum type,
+      unsigned max_width,
+      unsigned max_height)
+{
+   switch (type)
+   {
+      case IMAGE_TYPE_JPEG:
+#ifdef HAVE_RJPEG
+         rjpeg_set_max_size((rjpeg_t*)data, max_width, max_height);
+#endif
+         break;
+      case IMAGE_TYPE_PNG:
+      case IMAGE_TYPE_TGA:
+      case IMAGE_TYPE_BMP:
+      case IMAGE_TYPE_NONE:
+         break;
+   }
+}
+
 int image_transfer_process(
       void *data,
       enum image_type_enum type,
@@ -67,6 +67,8 @@ typedef struct
 struct rjpeg
 {
    uint8_t *buff_data;
+   unsigned max_width;
+   unsigned max_height;
 };
 
 #ifdef _MSC_VER
@@ -180,6 +182,8 @@ typedef struct
 typedef struct
 {
    rjpeg_context *s;
+   unsigned max_width;
+   unsigned max_height;
    /* kernels */
    void (*idct_block_kernel)(uint8_t *out, int out_stride, short data[64]);
    void (*YCbCr_to_RGB_kernel)(uint8_t *out, const uint8_t *y, const uint8_t *pcb,
@@ -213,6 +217,7 @@ typedef struct
    int            code_bits;     /* number of valid bits */
    int            nomore;        /* flag if we saw a marker so must stop */
    int            progressive;
+   int            scale_shift;   /* blocks are decoded to (8 >> scale_shift) pixels */
    int            spec_start;
    int            spec_end;
    int            succ_high;
@@ -771,7 +776,7 @@ static INLINE uint8_t rjpeg_clamp(int x)
 {
    /* trick to use a single test to catch both cases */
    if ((unsigned int) x > 255)
-      return 255;
+      return x < 0 ? 0 : 255;
    return (uint8_t) x;
 }
 
@@ -890,6 +895,74 @@ static void rjpeg_idct_block(uint8_t *out, int out_stride, short data[64])
    }
 }
 
+/* Reduced size IDCTs, for decoding straight to 1/2, 1/4 or 1/8
+ * scale. Sampling the 8x8 IDCT at the centres of an NxN grid
+ * only takes the top left NxN coefficients, with the cosines of
+ * an N point IDCT: C(u) / 2 * cos((2x + 1) * u * pi / 2N).
+ * Dropping the high frequencies doubles as the low-pass filter. */
+#define RJPEG_IDCT_4_A  RJPEG_F2F(0.353553391f)
+#define RJPEG_IDCT_4_B  RJPEG_F2F(0.461939766f)
+#define RJPEG_IDCT_4_C  RJPEG_F2F(0.191341716f)
+
+static void rjpeg_idct_block_4x4(uint8_t *out, int out_stride, short data[64])
+{
+   int i, val[16];
+   int     *v = val;
+   int16_t *d = data;
+
+   /* columns, keeping 2 extra bits like the full size IDCT */
+   for (i = 0; i < 4; ++i, ++d, ++v)
+   {
+      int e0 = (d[0] + d[16]) * RJPEG_IDCT_4_A + 512;
+      int e1 = (d[0] - d[16]) * RJPEG_IDCT_4_A + 512;
+      int o0 = d[8] * RJPEG_IDCT_4_B + d[24] * RJPEG_IDCT_4_C;
+      int o1 = d[8] * RJPEG_IDCT_4_C - d[24] * RJPEG_IDCT_4_B;
+
+      v[ 0] = (e0 + o0) >> 10;
+      v[12] = (e0 - o0) >> 10;
+      v[ 4] = (e1 + o1) >> 10;
+      v[ 8] = (e1 - o1) >> 10;
+   }
+
+   /* rows; 1<<12 from the constants and 1<<2 from the columns,
+    * rounded and biased to 0..255 like the full size IDCT */
+   for (i = 0, v = val; i < 4; ++i, v += 4, out += out_stride)
+   {
+      int e0 = (v[0] + v[2]) * RJPEG_IDCT_4_A + 8192 + (128 << 14);
+      int e1 = (v[0] - v[2]) * RJPEG_IDCT_4_A + 8192 + (128 << 14);
+      int o0 = v[1] * RJPEG_IDCT_4_B + v[3] * RJPEG_IDCT_4_C;
+      int o1 = v[1] * RJPEG_IDCT_4_C - v[3] * RJPEG_IDCT_4_B;
+
+      out[0] = rjpeg_clamp((e0 + o0) >> 14);
+      out[3] = rjpeg_clamp((e0 - o0) >> 14);
+      out[1] = rjpeg_clamp((e1 + o1) >> 14);
+      out[2] = rjpeg_clamp((e1 - o1) >> 14);
+   }
+}
+
+static void rjpeg_idct_block_2x2(uint8_t *out, int out_stride, short data[64])
+{
+   /* C(u) / 2 is 1/(2 sqrt 2) for both frequencies of a 2 point
+    * IDCT, 1/8 for the pair of passes */
+   int a  = data[0] + data[8];
+   int b  = data[0] - data[8];
+   int a0 = a + data[1] + data[9];
+   int a1 = a - data[1] - data[9];
+   int b0 = b + data[1] - data[9];
+   int b1 = b - data[1] + data[9];
+
+   out[0]              = rjpeg_clamp(((a0 + 4) >> 3) + 128);
+   out[1]              = rjpeg_clamp(((a1 + 4) >> 3) + 128);
+   out[out_stride]     = rjpeg_clamp(((b0 + 4) >> 3) + 128);
+   out[out_stride + 1] = rjpeg_clamp(((b1 + 4) >> 3) + 128);
+}
+
+/* 1/8 scale is just the block average */
+static void rjpeg_idct_block_1x1(uint8_t *out, int out_stride, short data[64])
+{
+   out[0] = rjpeg_clamp(((data[0] + 4) >> 3) + 128);
+}
+
 #if defined(__SSE2__)
 /* sse2 integer IDCT. not the fastest possible implementation but it
  * produces bit-identical results to the generic C version so it's
@@ -1378,6 +1451,7 @@ static int rjpeg_parse_entropy_coded_data(rjpeg_jpeg *z)
       else
       {
          RJPEG_SIMD_ALIGN(short, data[64]);
+         int bs = 8 >> z->scale_shift;
 
          for (j = 0; j < h; ++j)
          {
@@ -1388,7 +1462,7 @@ static int rjpeg_parse_entropy_coded_data(rjpeg_jpeg *z)
                         z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq]))
                   return 0;
 
-               z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8,
+               z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*j*bs+i*bs,
                      z->img_comp[n].w2, data);
 
                /* every data block is an MCU, so countdown the restart interval */
@@ -1453,6 +1527,7 @@ static int rjpeg_parse_entropy_coded_data(rjpeg_jpeg *z)
       else
       {
          RJPEG_SIMD_ALIGN(short, data[64]);
+         int bs = 8 >> z->scale_shift;
 
          for (j = 0; j < z->img_mcu_y; ++j)
          {
@@ -1468,8 +1543,8 @@ static int rjpeg_parse_entropy_coded_data(rjpeg_jpeg *z)
                   {
                      for (x = 0; x < z->img_comp[n].h; ++x)
                      {
-                        int x2 = (i*z->img_comp[n].h + x)*8;
-                        int y2 = (j*z->img_comp[n].v + y)*8;
+                        int x2 = (i*z->img_comp[n].h + x)*bs;
+                        int y2 = (j*z->img_comp[n].v + y)*bs;
                         int ha = z->img_comp[n].ha;
 
                         if (!rjpeg_jpeg_decode_block(z, data,
@@ -1512,6 +1587,7 @@ static void rjpeg_jpeg_dequantize(short *data, uint8_t *dequant)
 static void rjpeg_jpeg_finish(rjpeg_jpeg *z)
 {
    int i,j,n;
+   int bs = 8 >> z->scale_shift;
 
    if (!z->progressive)
       return;
@@ -1527,7 +1603,7 @@ static void rjpeg_jpeg_finish(rjpeg_jpeg *z)
          {
             short *data = z->img_comp[n].coeff + 64 * (i + j * z->img_comp[n].coeff_w);
             rjpeg_jpeg_dequantize(data, z->dequant[z->img_comp[n].tq]);
-            z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8,
+            z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*j*bs+i*bs,
                   z->img_comp[n].w2, data);
          }
       }
@@ -1704,7 +1780,7 @@ static int rjpeg_process_scan_header(rjpeg_jpeg *z)
 static int rjpeg_process_frame_header(rjpeg_jpeg *z, int scan)
 {
    rjpeg_context *s = z->s;
-   int Lf,p,i,q, h_max=1,v_max=1,c;
+   int Lf,p,i,q, h_max=1,v_max=1,c,bs;
    Lf = RJPEG_GET16BE(s);
 
    /* JPEG */
@@ -1805,6 +1881,33 @@ static int rjpeg_process_frame_header(rjpeg_jpeg *z, int scan)
    z->img_mcu_x = (s->img_x + z->img_mcu_w-1) / z->img_mcu_w;
    z->img_mcu_y = (s->img_y + z->img_mcu_h-1) / z->img_mcu_h;
 
+   /* If the caller is going to shrink the image anyway, decode
+    * straight to the smallest of 1/2, 1/4 or 1/8 scale that still
+    * covers the size it fits the image into */
+   z->scale_shift = 0;
+   if (z->max_width && z->max_height)
+   {
+      while (     z->scale_shift < 3
+            && (  (z->max_width  << (z->scale_shift + 1)) <= s->img_x
+               || (z->max_height << (z->scale_shift + 1)) <= s->img_y))
+         z->scale_shift++;
+   }
+
+   switch (z->scale_shift)
+   {
+      case 1:
+         z->idct_block_kernel = rjpeg_idct_block_4x4;
+         break;
+      case 2:
+         z->idct_block_kernel = rjpeg_idct_block_2x2;
+         break;
+      case 3:
+         z->idct_block_kernel = rjpeg_idct_block_1x1;
+         break;
+   }
+
+   bs = 8 >> z->scale_shift;
+
    if (z->progressive)
    {
       for (i = 0; i < s->img_n; ++i)
@@ -1817,8 +1920,8 @@ static int rjpeg_process_frame_header(rjpeg_jpeg *z, int scan)
           * the bogus oversized data from using interleaved MCUs and their
           * big blocks (e.g. a 16x16 iMCU on an image of width 33); we won't
           * discard the extra data until colorspace conversion */
-         z->img_comp[i].w2       = z->img_mcu_x * z->img_comp[i].h * 8;
-         z->img_comp[i].h2       = z->img_mcu_y * z->img_comp[i].v * 8;
+         z->img_comp[i].w2       = z->img_mcu_x * z->img_comp[i].h * bs;
+         z->img_comp[i].h2       = z->img_mcu_y * z->img_comp[i].v * bs;
          z->img_comp[i].raw_data = malloc(z->img_comp[i].w2 * z->img_comp[i].h2+15);
 
          /* Out of memory? */
@@ -1836,8 +1939,8 @@ static int rjpeg_process_frame_header(rjpeg_jpeg *z, int scan)
          /* align blocks for IDCT using MMX/SSE */
          z->img_comp[i].data      = (uint8_t*) (((size_t) z->img_comp[i].raw_data + 15) & ~15);
          z->img_comp[i].linebuf   = NULL;
-         z->img_comp[i].coeff_w   = (z->img_comp[i].w2 + 7) >> 3;
-         z->img_comp[i].coeff_h   = (z->img_comp[i].h2 + 7) >> 3;
+         z->img_comp[i].coeff_w   = z->img_mcu_x * z->img_comp[i].h;
+         z->img_comp[i].coeff_h   = z->img_mcu_y * z->img_comp[i].v;
          z->img_comp[i].raw_coeff = malloc(z->img_comp[i].coeff_w *
                                     z->img_comp[i].coeff_h * 64 * sizeof(short) + 15);
          z->img_comp[i].coeff     = (short*) (((size_t) z->img_comp[i].raw_coeff + 15) & ~15);
@@ -1855,8 +1958,8 @@ static int rjpeg_process_frame_header(rjpeg_jpeg *z, int scan)
           * the bogus oversized data from using interleaved MCUs and their
           * big blocks (e.g. a 16x16 iMCU on an image of width 33); we won't
           * discard the extra data until colorspace conversion */
-         z->img_comp[i].w2       = z->img_mcu_x * z->img_comp[i].h * 8;
-         z->img_comp[i].h2       = z->img_mcu_y * z->img_comp[i].v * 8;
+         z->img_comp[i].w2       = z->img_mcu_x * z->img_comp[i].h * bs;
+         z->img_comp[i].h2       = z->img_mcu_y * z->img_comp[i].v * bs;
          z->img_comp[i].raw_data = malloc(z->img_comp[i].w2 * z->img_comp[i].h2+15);
 
          /* Out of memory? */
@@ -1877,6 +1980,11 @@ static int rjpeg_process_frame_header(rjpeg_jpeg *z, int scan)
       }
    }
 
+   /* Component sizes stay in full size blocks, the output
+    * is in scaled pixels */
+   s->img_x = (s->img_x + (1 << z->scale_shift) - 1) >> z->scale_shift;
+   s->img_y = (s->img_y + (1 << z->scale_shift) - 1) >> z->scale_shift;
+
    return 1;
 }
 
@@ -2214,11 +2322,11 @@ static void rjpeg_YCbCr_to_RGB_row(uint8_t *out, const uint8_t *y,
       g >>= 20;
       b >>= 20;
       if ((unsigned) r > 255)
-         r = 255;
+         r = r < 0 ? 0 : 255;
       if ((unsigned) g > 255)
-         g = 255;
+         g = g < 0 ? 0 : 255;
       if ((unsigned) b > 255)
-         b = 255;
+         b = b < 0 ? 0 : 255;
       out[0] = (uint8_t)r;
       out[1] = (uint8_t)g;
       out[2] = (uint8_t)b;
@@ -2358,11 +2466,11 @@ static void rjpeg_YCbCr_to_RGB_simd(uint8_t *out, const uint8_t *y,
       g >>= 20;
       b >>= 20;
       if ((unsigned) r > 255)
-         r = 255;
+         r = r < 0 ? 0 : 255;
       if ((unsigned) g > 255)
-         g = 255;
+         g = g < 0 ? 0 : 255;
       if ((unsigned) b > 255)
-         b = 255;
+         b = b < 0 ? 0 : 255;
       out[0] = (uint8_t)r;
       out[1] = (uint8_t)g;
       out[2] = (uint8_t)b;
@@ -2503,7 +2611,8 @@ static uint8_t *rjpeg_load_jpeg_image(rjpeg_jpeg *z,
          {
             r->ystep = 0;
             r->line0 = r->line1;
-            if (++r->ypos < z->img_comp[k].y)
+            if (++r->ypos < ((z->img_comp[k].y + (1 << z->scale_shift) - 1)
+                     >> z->scale_shift))
                r->line1 += z->img_comp[k].w2;
          }
       }
@@ -2570,6 +2679,9 @@ int rjpeg_process_image(rjpeg_t *rjpeg, void **buf_data,
    s.img_buffer_end      = (uint8_t*)rjpeg->buff_data + (int)size;
 
    j.s                   = &s;
+   j.max_width           = rjpeg->max_width;
+   j.max_height          = rjpeg->max_height;
+   j.scale_shift         = 0;
 
    rjpeg_setup_jpeg(&j);
 
@@ -2615,6 +2727,16 @@ bool rjpeg_set_buf_ptr(rjpeg_t *rjpeg, void *data)
    return true;
 }
 
+void rjpeg_set_max_size(rjpeg_t *rjpeg,
+      unsigned max_width, unsigned max_height)
+{
+   if (!rjpeg)
+      return;
+
+   rjpeg->max_width  = max_width;
+   rjpeg->max_height = max_height;
+}
+
 void rjpeg_free(rjpeg_t *rjpeg)
 {
    if (!rjpeg)
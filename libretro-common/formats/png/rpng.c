@@ -20,7 +20,7 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
-#ifdef DEBUG
+#if defined(DEBUG) || defined(RPNG_TEST)
 #include <stdio.h>
 #endif
 #include <stdint.h>
@@ -76,12 +76,6 @@ struct adam7_pass
    unsigned stride_y;
 };
 
-struct idat_buffer
-{
-   uint8_t *data;
-   size_t size;
-};
-
 enum rpng_process_flags
 {
    RPNG_PROCESS_FLAG_INFLATE_INITIALIZED    = (1 << 0),
@@ -95,9 +89,11 @@ struct rpng_process
    uint32_t *palette;
    void *stream;
    const struct trans_stream_backend *stream_backend;
-   uint8_t *prev_scanline;
-   uint8_t *decoded_scanline;
-   uint8_t *inflate_buf;
+   const uint8_t *idat_next; /* Next IDAT chunk to inflate */
+   const uint8_t *idat_end;
+   uint8_t *prev_scanline;   /* Zeroes, the row above the first */
+   uint8_t *inflate_buf;     /* Advances row by row while unfiltering */
+   uint8_t *inflate_buf_base;
    size_t restore_buf_size;
    size_t adam7_restore_buf_size;
    size_t data_restore_buf_size;
@@ -130,7 +126,9 @@ struct rpng
    struct rpng_process *process;
    uint8_t *buff_data;
    uint8_t *buff_end;
-   struct idat_buffer idat_buf; /* ptr alignment */
+   /* The IDAT chunks, left in the caller's buffer */
+   const uint8_t *idat_begin;
+   const uint8_t *idat_end;
    struct png_ihdr ihdr; /* uint32 alignment */
    uint32_t palette[256];
    uint8_t flags;
@@ -233,11 +231,38 @@ static bool rpng_process_ihdr(struct png_ihdr *ihdr)
 static void rpng_reverse_filter_copy_line_rgb(uint32_t *data,
       const uint8_t *decoded, unsigned width, unsigned bpp)
 {
-   int i;
+   int i = 0;
+
+   if (bpp == 8)
+   {
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+      for (; i + 16 <= (int)width; i += 16, decoded += 48)
+      {
+         uint8x16x3_t rgb = vld3q_u8(decoded);
+         uint8x16x4_t bgra;
+         bgra.val[0]      = rgb.val[2];
+         bgra.val[1]      = rgb.val[1];
+         bgra.val[2]      = rgb.val[0];
+         bgra.val[3]      = vdupq_n_u8(0xff);
+         vst4q_u8((uint8_t*)(data + i), bgra);
+      }
+#elif defined(__wasm_simd128__)
+      const v128_t alpha = wasm_i8x16_splat((int8_t)0xff);
+      /* Reads 16 bytes for 12, stay clear of the end of the row */
+      for (; i + 6 <= (int)width; i += 4, decoded += 12)
+         wasm_v128_store(data + i, wasm_i8x16_shuffle(
+                  wasm_v128_load(decoded), alpha,
+                  2, 1, 0, 16, 5, 4, 3, 16, 8, 7, 6, 16, 11, 10, 9, 16));
+#endif
+      for (; i < (int)width; i++, decoded += 3)
+         data[i] = (0xffu << 24) | ((uint32_t)decoded[0] << 16)
+            | ((uint32_t)decoded[1] << 8) | decoded[2];
+      return;
+   }
 
    bpp /= 8;
 
-   for (i = 0; i < (int)width; i++)
+   for (; i < (int)width; i++)
    {
       uint32_t r, g, b;
 
@@ -254,11 +279,48 @@ static void rpng_reverse_filter_copy_line_rgb(uint32_t *data,
 static void rpng_reverse_filter_copy_line_rgba(uint32_t *data,
       const uint8_t *decoded, unsigned width, unsigned bpp)
 {
-   int i;
+   int i = 0;
+
+   /* 8-bit RGBA only needs R and B swapped */
+   if (bpp == 8)
+   {
+#if defined(__SSE2__)
+      const __m128i ag_mask = _mm_set1_epi32((int)0xff00ff00);
+      for (; i + 4 <= (int)width; i += 4, decoded += 16)
+      {
+         __m128i v  = _mm_loadu_si128((const __m128i*)decoded);
+         __m128i rb = _mm_andnot_si128(ag_mask, v);
+         rb         = _mm_or_si128(_mm_slli_epi32(rb, 16),
+               _mm_srli_epi32(rb, 16));
+         _mm_storeu_si128((__m128i*)(data + i),
+               _mm_or_si128(_mm_and_si128(v, ag_mask), rb));
+      }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+      for (; i + 16 <= (int)width; i += 16, decoded += 64)
+      {
+         uint8x16x4_t px = vld4q_u8(decoded);
+         uint8x16_t r    = px.val[0];
+         px.val[0]       = px.val[2];
+         px.val[2]       = r;
+         vst4q_u8((uint8_t*)(data + i), px);
+      }
+#elif defined(__wasm_simd128__)
+      for (; i + 4 <= (int)width; i += 4, decoded += 16)
+      {
+         v128_t v = wasm_v128_load(decoded);
+         wasm_v128_store(data + i, wasm_i8x16_shuffle(v, v,
+                  2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15));
+      }
+#endif
+      for (; i < (int)width; i++, decoded += 4)
+         data[i] = ((uint32_t)decoded[3] << 24) | ((uint32_t)decoded[0] << 16)
+            | ((uint32_t)decoded[1] << 8) | decoded[2];
+      return;
+   }
 
    bpp /= 8;
 
-   for (i = 0; i < (int)width; i++)
+   for (; i < (int)width; i++)
    {
       uint32_t r, g, b, a;
       r        = *decoded;
@@ -484,9 +546,6 @@ static void rpng_reverse_filter_deinit(struct rpng_process *pngp)
 {
    if (!pngp)
       return;
-   if (pngp->decoded_scanline)
-      free(pngp->decoded_scanline);
-   pngp->decoded_scanline = NULL;
    if (pngp->prev_scanline)
       free(pngp->prev_scanline);
    pngp->prev_scanline    = NULL;
@@ -547,9 +606,8 @@ static int rpng_reverse_filter_init(const struct png_ihdr *ihdr,
    pngp->restore_buf_size      = 0;
    pngp->data_restore_buf_size = 0;
    pngp->prev_scanline         = (uint8_t*)calloc(1, pngp->pitch);
-   pngp->decoded_scanline      = (uint8_t*)calloc(1, pngp->pitch);
 
-   if (!pngp->prev_scanline || !pngp->decoded_scanline)
+   if (!pngp->prev_scanline)
       goto error;
 
    pngp->h                    = 0;
@@ -562,76 +620,270 @@ error:
    return -1;
 }
 
-static int rpng_reverse_filter_copy_line(uint32_t *data,
-      const struct png_ihdr *ihdr,
-      struct rpng_process *pngp, unsigned filter)
+/* Sub, Average and Paeth depend on the pixel to the left, so
+ * vectors only help across the bytes of one pixel. Rows of 3 and
+ * 4 byte pixels (8-bit RGB and RGBA) take that path, and come out
+ * converted to ARGB on the way if @out is set. */
+#if defined(__SSE2__)
+static INLINE __m128i rpng_load_pixel(const uint8_t *p, unsigned bpp)
+{
+   uint32_t v = 0;
+   memcpy(&v, p, bpp);
+   return _mm_cvtsi32_si128((int)v);
+}
+
+static INLINE uint32_t rpng_store_pixel(uint8_t *p, __m128i x, unsigned bpp)
+{
+   uint32_t v = (uint32_t)_mm_cvtsi128_si32(x);
+   memcpy(p, &v, bpp);
+   return v;
+}
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+static INLINE uint8x8_t rpng_load_pixel(const uint8_t *p, unsigned bpp)
+{
+   uint32_t v = 0;
+   memcpy(&v, p, bpp);
+   return vreinterpret_u8_u32(vdup_n_u32(v));
+}
+
+static INLINE uint32_t rpng_store_pixel(uint8_t *p, uint8x8_t x, unsigned bpp)
+{
+   uint32_t v = vget_lane_u32(vreinterpret_u32_u8(x), 0);
+   memcpy(p, &v, bpp);
+   return v;
+}
+
+/* Paeth predictor over the bytes of @a, @b and @c */
+static INLINE uint8x8_t rpng_paeth_neon(uint8x8_t a, uint8x8_t b, uint8x8_t c)
+{
+   uint16x8_t pa = vabdl_u8(b, c);
+   uint16x8_t pb = vabdl_u8(a, c);
+   uint16x8_t pc = vabdq_u16(vaddl_u8(a, b), vaddl_u8(c, c));
+   uint8x8_t use_a = vmovn_u16(vandq_u16(vcleq_u16(pa, pb), vcleq_u16(pa, pc)));
+   uint8x8_t use_b = vmovn_u16(vcleq_u16(pb, pc));
+   return vbsl_u8(use_a, a, vbsl_u8(use_b, b, c));
+}
+#endif
+
+#if defined(__SSE2__) || defined(__ARM_NEON__) || defined(__ARM_NEON)
+/* Little endian R, G, B[, A] in @v to ARGB; 3 byte pixels
+ * load with a zero top byte, which becomes opaque */
+static INLINE uint32_t rpng_pixel_to_argb(uint32_t v, unsigned bpp)
+{
+   uint32_t argb = (v & 0xff00ff00) | ((v >> 16) & 0xff) | ((v & 0xff) << 16);
+   return bpp == 3 ? argb | 0xff000000 : argb;
+}
+
+static INLINE void rpng_unfilter_pixels(uint8_t *row, const uint8_t *prev,
+      unsigned pitch, unsigned bpp, unsigned filter, uint32_t *out)
 {
    unsigned i;
+#if defined(__SSE2__)
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i one  = _mm_set1_epi8(1);
+   __m128i a          = zero;
+   __m128i c          = zero;
 
    switch (filter)
    {
-      case PNG_FILTER_NONE:
-         memcpy(pngp->decoded_scanline, pngp->inflate_buf, pngp->pitch);
-         break;
       case PNG_FILTER_SUB:
-         memcpy(pngp->decoded_scanline, pngp->inflate_buf, pngp->pitch);
-         for (i = pngp->bpp; i < pngp->pitch; i++)
-            pngp->decoded_scanline[i] += pngp->decoded_scanline[i - pngp->bpp];
+         for (i = 0; i < pitch; i += bpp)
+         {
+            uint32_t v;
+            a = _mm_add_epi8(a, rpng_load_pixel(row + i, bpp));
+            v = rpng_store_pixel(row + i, a, bpp);
+            if (out)
+               *out++ = rpng_pixel_to_argb(v, bpp);
+         }
          break;
-      case PNG_FILTER_UP:
-         memcpy(pngp->decoded_scanline, pngp->inflate_buf, pngp->pitch);
-         for (i = 0; i < pngp->pitch; i++)
-            pngp->decoded_scanline[i] += pngp->prev_scanline[i];
+      case PNG_FILTER_AVERAGE:
+         for (i = 0; i < pitch; i += bpp)
+         {
+            uint32_t v;
+            __m128i b = rpng_load_pixel(prev + i, bpp);
+            /* _mm_avg_epu8 rounds up, PNG rounds down */
+            a = _mm_add_epi8(rpng_load_pixel(row + i, bpp),
+                  _mm_sub_epi8(_mm_avg_epu8(a, b),
+                     _mm_and_si128(_mm_xor_si128(a, b), one)));
+            v = rpng_store_pixel(row + i, a, bpp);
+            if (out)
+               *out++ = rpng_pixel_to_argb(v, bpp);
+         }
+         break;
+      case PNG_FILTER_PAETH:
+         /* a and c are kept as 16-bit lanes */
+         for (i = 0; i < pitch; i += bpp)
+         {
+            uint32_t v;
+            __m128i b = _mm_unpacklo_epi8(rpng_load_pixel(prev + i, bpp), zero);
+            __m128i p = rpng_paeth_sse2(a, b, c);
+            __m128i x = _mm_add_epi8(rpng_load_pixel(row + i, bpp),
+                  _mm_packus_epi16(p, p));
+            v         = rpng_store_pixel(row + i, x, bpp);
+            if (out)
+               *out++ = rpng_pixel_to_argb(v, bpp);
+            a         = _mm_unpacklo_epi8(x, zero);
+            c         = b;
+         }
+         break;
+   }
+#else
+   uint8x8_t a = vdup_n_u8(0);
+   uint8x8_t c = vdup_n_u8(0);
+
+   switch (filter)
+   {
+      case PNG_FILTER_SUB:
+         for (i = 0; i < pitch; i += bpp)
+         {
+            uint32_t v;
+            a = vadd_u8(a, rpng_load_pixel(row + i, bpp));
+            v = rpng_store_pixel(row + i, a, bpp);
+            if (out)
+               *out++ = rpng_pixel_to_argb(v, bpp);
+         }
          break;
       case PNG_FILTER_AVERAGE:
-         memcpy(pngp->decoded_scanline, pngp->inflate_buf, pngp->pitch);
-         for (i = 0; i < pngp->bpp; i++)
+         for (i = 0; i < pitch; i += bpp)
          {
-            uint8_t avg = pngp->prev_scanline[i] >> 1;
-            pngp->decoded_scanline[i] += avg;
+            uint32_t v;
+            a = vadd_u8(rpng_load_pixel(row + i, bpp),
+                  vhadd_u8(a, rpng_load_pixel(prev + i, bpp)));
+            v = rpng_store_pixel(row + i, a, bpp);
+            if (out)
+               *out++ = rpng_pixel_to_argb(v, bpp);
          }
-         for (i = pngp->bpp; i < pngp->pitch; i++)
+         break;
+      case PNG_FILTER_PAETH:
+         for (i = 0; i < pitch; i += bpp)
          {
-            uint8_t avg = (pngp->decoded_scanline[i - pngp->bpp] + pngp->prev_scanline[i]) >> 1;
-            pngp->decoded_scanline[i] += avg;
+            uint32_t v;
+            uint8x8_t b = rpng_load_pixel(prev + i, bpp);
+            a           = vadd_u8(rpng_load_pixel(row + i, bpp),
+                  rpng_paeth_neon(a, b, c));
+            v           = rpng_store_pixel(row + i, a, bpp);
+            if (out)
+               *out++ = rpng_pixel_to_argb(v, bpp);
+            c           = b;
          }
          break;
+   }
+#endif
+}
+#endif
+
+/* Undoes @filter on @row in place. @prev is the row above,
+ * already unfiltered, or zeroes for the first row.
+ * Returns true if @out got the row as ARGB too. */
+static bool rpng_unfilter_line(uint8_t *row, const uint8_t *prev,
+      unsigned pitch, unsigned bpp, unsigned filter, uint32_t *out)
+{
+   unsigned i = 0;
+
+   switch (filter)
+   {
+      case PNG_FILTER_UP:
+#if defined(__SSE2__)
+         for (; i + 16 <= pitch; i += 16)
+            _mm_storeu_si128((__m128i*)(row + i), _mm_add_epi8(
+                     _mm_loadu_si128((const __m128i*)(row + i)),
+                     _mm_loadu_si128((const __m128i*)(prev + i))));
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+         for (; i + 16 <= pitch; i += 16)
+            vst1q_u8(row + i, vaddq_u8(vld1q_u8(row + i), vld1q_u8(prev + i)));
+#elif defined(__wasm_simd128__)
+         for (; i + 16 <= pitch; i += 16)
+            wasm_v128_store(row + i, wasm_i8x16_add(
+                     wasm_v128_load(row + i), wasm_v128_load(prev + i)));
+#endif
+         for (; i < pitch; i++)
+            row[i] += prev[i];
+         return false;
+      case PNG_FILTER_SUB:
+      case PNG_FILTER_AVERAGE:
       case PNG_FILTER_PAETH:
-         memcpy(pngp->decoded_scanline, pngp->inflate_buf, pngp->pitch);
-         for (i = 0; i < pngp->bpp; i++)
-            pngp->decoded_scanline[i] += pngp->prev_scanline[i];
-         for (i = pngp->bpp; i < pngp->pitch; i++)
-            pngp->decoded_scanline[i] += paeth(pngp->decoded_scanline[i - pngp->bpp],
-                  pngp->prev_scanline[i], pngp->prev_scanline[i - pngp->bpp]);
+#if defined(__SSE2__) || defined(__ARM_NEON__) || defined(__ARM_NEON)
+         /* Constant bpp, so the pixel loads and stores inline */
+         if (bpp == 4)
+         {
+            rpng_unfilter_pixels(row, prev, pitch, 4, filter, out);
+            return out != NULL;
+         }
+         if (bpp == 3)
+         {
+            rpng_unfilter_pixels(row, prev, pitch, 3, filter, out);
+            return out != NULL;
+         }
+#endif
          break;
       default:
-         return IMAGE_PROCESS_ERROR_END;
+         return false;
+   }
+
+   switch (filter)
+   {
+      case PNG_FILTER_SUB:
+         for (i = bpp; i < pitch; i++)
+            row[i] += row[i - bpp];
+         break;
+      case PNG_FILTER_AVERAGE:
+         for (i = 0; i < bpp; i++)
+            row[i] += prev[i] >> 1;
+         for (i = bpp; i < pitch; i++)
+            row[i] += (row[i - bpp] + prev[i]) >> 1;
+         break;
+      case PNG_FILTER_PAETH:
+         for (i = 0; i < bpp; i++)
+            row[i] += prev[i];
+         for (i = bpp; i < pitch; i++)
+            row[i] += paeth(row[i - bpp], prev[i], prev[i - bpp]);
+         break;
    }
 
+   return false;
+}
+
+static int rpng_reverse_filter_copy_line(uint32_t *data,
+      const struct png_ihdr *ihdr,
+      struct rpng_process *pngp, unsigned filter)
+{
+   /* Rows are unfiltered in place in the inflate buffer,
+    * so the row above is right there */
+   uint8_t *row        = pngp->inflate_buf;
+   const uint8_t *prev = pngp->h ? row - pngp->pitch - 1 : pngp->prev_scanline;
+   /* 8-bit RGB and RGBA rows can be converted while unfiltering */
+   uint32_t *out       = (ihdr->depth == 8
+         && (     ihdr->color_type == PNG_IHDR_COLOR_RGB
+               || ihdr->color_type == PNG_IHDR_COLOR_RGBA)) ? data : NULL;
+
+   if (filter > PNG_FILTER_PAETH)
+      return IMAGE_PROCESS_ERROR_END;
+
+   if (rpng_unfilter_line(row, prev, pngp->pitch, pngp->bpp, filter, out))
+      return IMAGE_PROCESS_NEXT;
+
    switch (ihdr->color_type)
    {
       case PNG_IHDR_COLOR_GRAY:
-         rpng_reverse_filter_copy_line_bw(data, pngp->decoded_scanline, ihdr->width, ihdr->depth);
+         rpng_reverse_filter_copy_line_bw(data, row, ihdr->width, ihdr->depth);
          break;
       case PNG_IHDR_COLOR_RGB:
-         rpng_reverse_filter_copy_line_rgb(data, pngp->decoded_scanline, ihdr->width, ihdr->depth);
+         rpng_reverse_filter_copy_line_rgb(data, row, ihdr->width, ihdr->depth);
          break;
       case PNG_IHDR_COLOR_PLT:
          rpng_reverse_filter_copy_line_plt(
-               data, pngp->decoded_scanline, ihdr->width,
+               data, row, ihdr->width,
                ihdr->depth, pngp->palette);
          break;
       case PNG_IHDR_COLOR_GRAY_ALPHA:
-         rpng_reverse_filter_copy_line_gray_alpha(data, pngp->decoded_scanline, ihdr->width,
+         rpng_reverse_filter_copy_line_gray_alpha(data, row, ihdr->width,
                ihdr->depth);
          break;
       case PNG_IHDR_COLOR_RGBA:
-         rpng_reverse_filter_copy_line_rgba(data, pngp->decoded_scanline, ihdr->width, ihdr->depth);
+         rpng_reverse_filter_copy_line_rgba(data, row, ihdr->width, ihdr->depth);
          break;
    }
 
-   memcpy(pngp->prev_scanline, pngp->decoded_scanline, pngp->pitch);
-
    return IMAGE_PROCESS_NEXT;
 }
 
@@ -756,7 +1008,21 @@ static int rpng_load_image_argb_process_inflate_init(
    enum trans_stream_error terror;
    uint32_t rd, wn;
    struct rpng_process *process = (struct rpng_process*)rpng->process;
-   bool to_continue        = (process->avail_in > 0
+   bool to_continue;
+
+   /* Inflate straight out of the chunks, one at a time */
+   while (!process->avail_in && process->idat_next < process->idat_end)
+   {
+      const uint8_t *chunk = process->idat_next;
+      uint32_t chunk_size  = rpng_dword_be(chunk);
+
+      process->idat_next  += chunk_size + 12;
+      process->avail_in    = chunk_size;
+      process->stream_backend->set_in(process->stream,
+            chunk + 8, chunk_size);
+   }
+
+   to_continue             = (process->avail_in > 0
          && process->avail_out > 0);
 
    if (!to_continue)
@@ -806,17 +1072,6 @@ false_end:
    return -1;
 }
 
-static bool rpng_realloc_idat(struct idat_buffer *buf, uint32_t chunk_size)
-{
-   uint8_t *new_buffer = (uint8_t*)realloc(buf->data, buf->size + chunk_size);
-
-   if (!new_buffer)
-      return false;
-
-   buf->data  = new_buffer;
-   return true;
-}
-
 static struct rpng_process *rpng_process_init(rpng_t *rpng)
 {
    uint8_t *inflate_buf            = NULL;
@@ -826,9 +1081,11 @@ static struct rpng_process *rpng_process_init(rpng_t *rpng)
       return NULL;
 
    process->flags                  = 0;
+   process->idat_next              = rpng->idat_begin;
+   process->idat_end               = rpng->idat_end;
    process->prev_scanline          = NULL;
-   process->decoded_scanline       = NULL;
    process->inflate_buf            = NULL;
+   process->inflate_buf_base       = NULL;
 
    process->ihdr.width             = 0;
    process->ihdr.height            = 0;
@@ -874,14 +1131,11 @@ static struct rpng_process *rpng_process_init(rpng_t *rpng)
    if (!inflate_buf)
       goto error;
 
-   process->inflate_buf = inflate_buf;
-   process->avail_in    = rpng->idat_buf.size;
+   process->inflate_buf      = inflate_buf;
+   process->inflate_buf_base = inflate_buf;
+   process->avail_in         = 0;
    process->avail_out   = process->inflate_buf_size;
 
-   process->stream_backend->set_in(
-         process->stream,
-         rpng->idat_buf.data,
-         (uint32_t)rpng->idat_buf.size);
    process->stream_backend->set_out(
          process->stream,
          process->inflate_buf,
@@ -969,7 +1223,6 @@ static enum png_chunk_type rpng_read_chunk_header(
 
 bool rpng_iterate_image(rpng_t *rpng)
 {
-   unsigned i;
    uint8_t *buf             = (uint8_t*)rpng->buff_data;
    uint32_t chunk_size      = 0;
 
@@ -1098,16 +1351,14 @@ bool rpng_iterate_image(rpng_t *rpng)
                   !(rpng->flags & RPNG_FLAG_HAS_PLTE)))
             return false;
 
-         if (!rpng_realloc_idat(&rpng->idat_buf, chunk_size))
+         /* Only remember where they are, they get inflated
+          * in place later. The spec has them back to back. */
+         if (!(rpng->flags & RPNG_FLAG_HAS_IDAT))
+            rpng->idat_begin  = buf;
+         else if (buf != rpng->idat_end)
             return false;
 
-         buf += 8;
-
-         for (i = 0; i < chunk_size; i++)
-            rpng->idat_buf.data[i + rpng->idat_buf.size] = buf[i];
-
-         rpng->idat_buf.size += chunk_size;
-
+         rpng->idat_end       = buf + chunk_size + 12;
          rpng->flags         |= RPNG_FLAG_HAS_IDAT;
          break;
 
@@ -1128,6 +1379,30 @@ bool rpng_iterate_image(rpng_t *rpng)
    return true;
 }
 
+/* Also copes with a decode abandoned half-way, when the
+ * row pointers still point into the middle of their buffers */
+static void rpng_process_free(struct rpng_process *process)
+{
+   if (!process)
+      return;
+
+   if (process->inflate_buf_base)
+      free(process->inflate_buf_base);
+   if (process->prev_scanline)
+      free(process->prev_scanline);
+   /* Adam7 pass buffer */
+   if (process->data)
+      free(process->data - process->data_restore_buf_size);
+   if (process->stream)
+   {
+      if (process->stream_backend && process->stream_backend->stream_free)
+         process->stream_backend->stream_free(process->stream);
+      else
+         free(process->stream);
+   }
+   free(process);
+}
+
 int rpng_process_image(rpng_t *rpng,
       void **_data, size_t size, unsigned *width, unsigned *height)
 {
@@ -1159,15 +1434,8 @@ int rpng_process_image(rpng_t *rpng,
    return rpng_reverse_filter_regular_iterate(data, &rpng->ihdr, rpng->process);
 
 error:
-   if (rpng->process)
-   {
-      if (rpng->process->inflate_buf)
-         free(rpng->process->inflate_buf);
-      if (rpng->process->stream)
-         rpng->process->stream_backend->stream_free(rpng->process->stream);
-      free(rpng->process);
-      rpng->process = NULL;
-   }
+   rpng_process_free(rpng->process);
+   rpng->process = NULL;
    return IMAGE_PROCESS_ERROR;
 }
 
@@ -1176,22 +1444,7 @@ void rpng_free(rpng_t *rpng)
    if (!rpng)
       return;
 
-   if (rpng->idat_buf.data)
-      free(rpng->idat_buf.data);
-   if (rpng->process)
-   {
-      if (rpng->process->inflate_buf)
-         free(rpng->process->inflate_buf);
-      if (rpng->process->stream)
-      {
-         if (rpng->process->stream_backend && rpng->process->stream_backend->stream_free)
-            rpng->process->stream_backend->stream_free(rpng->process->stream);
-         else
-            free(rpng->process->stream);
-      }
-      free(rpng->process);
-   }
-
+   rpng_process_free(rpng->process);
    free(rpng);
 }
 
@@ -25,9 +25,14 @@
 #include <string.h>
 
 #include <libretro.h>
+#include <retro_inline.h>
 #include <encodings/crc32.h>
 #include <streams/interface_stream.h>
 #include <streams/trans_stream.h>
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#include <features/features_cpu.h>
+#endif
 
 #include "rpng_internal.h"
 
@@ -94,14 +99,6 @@ static bool png_write_ihdr_string(intfstream_t *intf_s, const struct png_ihdr *i
          sizeof(ihdr_raw) - sizeof(uint32_t));
 }
 
-static bool png_write_idat_string(intfstream_t* intf_s, const uint8_t *data, size_t size)
-{
-   if (intfstream_write(intf_s, data, size) != (ssize_t)size)
-      return false;
-
-   return png_write_crc_string(intf_s, data + sizeof(uint32_t), size - sizeof(uint32_t));
-}
-
 static bool png_write_iend_string(intfstream_t* intf_s)
 {
    const uint8_t data[] = {
@@ -140,24 +137,63 @@ static void copy_bgr24_line(uint8_t *dst, const uint8_t *src, unsigned width)
    }
 }
 
+#if defined(__SSE2__)
+/* Adds the sum of |v| over v's bytes taken as signed to @acc;
+ * |v| of a signed byte is min(v, -v) taken unsigned */
+static INLINE __m128i rpng_sad_sse2(__m128i acc, __m128i v)
+{
+   const __m128i zero = _mm_setzero_si128();
+   return _mm_add_epi64(acc,
+         _mm_sad_epu8(_mm_min_epu8(v, _mm_sub_epi8(zero, v)), zero));
+}
+
+static INLINE unsigned rpng_sad_sum_sse2(__m128i acc)
+{
+   return (unsigned)(_mm_cvtsi128_si32(acc)
+         + _mm_cvtsi128_si32(_mm_srli_si128(acc, 8)));
+}
+#endif
+
+/* Sum of the bytes taken as signed, the usual guess
+ * at how well a filtered row will compress */
 static unsigned count_sad(const uint8_t *data, size_t size)
 {
-   size_t i;
+   size_t i     = 0;
    unsigned cnt = 0;
-   for (i = 0; i < size; i++)
+#if defined(__SSE2__)
+   __m128i acc  = _mm_setzero_si128();
+   for (; i + 16 <= size; i += 16)
+      acc = rpng_sad_sse2(acc, _mm_loadu_si128((const __m128i*)(data + i)));
+   cnt  = rpng_sad_sum_sse2(acc);
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+   uint32x4_t acc = vdupq_n_u32(0);
+   for (; i + 16 <= size; i += 16)
    {
-      if (data[i])
-         cnt += abs((int8_t)data[i]);
+      /* vabsq_s8(-128) stays 0x80, which is 128 taken unsigned */
+      uint8x16_t v = vreinterpretq_u8_s8(
+            vabsq_s8(vld1q_s8((const int8_t*)data + i)));
+      acc          = vpadalq_u16(acc, vpaddlq_u8(v));
    }
+   cnt  = vgetq_lane_u32(acc, 0) + vgetq_lane_u32(acc, 1)
+        + vgetq_lane_u32(acc, 2) + vgetq_lane_u32(acc, 3);
+#endif
+   for (; i < size; i++)
+      cnt += abs((int8_t)data[i]);
    return cnt;
 }
 
 static unsigned filter_up(uint8_t *target, const uint8_t *line,
       const uint8_t *prev, unsigned width, unsigned bpp)
 {
-   unsigned i;
+   unsigned i = 0;
    width *= bpp;
-   for (i = 0; i < width; i++)
+#if defined(__SSE2__)
+   for (; i + 16 <= width; i += 16)
+      _mm_storeu_si128((__m128i*)(target + i), _mm_sub_epi8(
+               _mm_loadu_si128((const __m128i*)(line + i)),
+               _mm_loadu_si128((const __m128i*)(prev + i))));
+#endif
+   for (; i < width; i++)
       target[i] = line[i] - prev[i];
 
    return count_sad(target, width);
@@ -170,201 +206,496 @@ static unsigned filter_sub(uint8_t *target, const uint8_t *line,
    width *= bpp;
    for (i = 0; i < bpp; i++)
       target[i] = line[i];
-   for (i = bpp; i < width; i++)
+#if defined(__SSE2__)
+   for (; i + 16 <= width; i += 16)
+      _mm_storeu_si128((__m128i*)(target + i), _mm_sub_epi8(
+               _mm_loadu_si128((const __m128i*)(line + i)),
+               _mm_loadu_si128((const __m128i*)(line + i - bpp))));
+#endif
+   for (; i < width; i++)
       target[i] = line[i] - line[i - bpp];
 
    return count_sad(target, width);
 }
 
+/* Avg and Paeth are the costly filters; they stop early with a
+ * score above @limit once the row can no longer beat the best
+ * filter found so far, checking every RPNG_FILTER_BLOCK bytes. */
+#define RPNG_FILTER_BLOCK 256
+
 static unsigned filter_avg(uint8_t *target, const uint8_t *line,
-      const uint8_t *prev, unsigned width, unsigned bpp)
+      const uint8_t *prev, unsigned width, unsigned bpp, unsigned limit)
 {
-   unsigned i;
-   width *= bpp;
+   unsigned i, end;
+   unsigned cnt = 0;
+   width       *= bpp;
    for (i = 0; i < bpp; i++)
       target[i] = line[i] - (prev[i] >> 1);
-   for (i = bpp; i < width; i++)
-      target[i] = line[i] - ((line[i - bpp] + prev[i]) >> 1);
+   cnt          = count_sad(target, bpp);
 
-   return count_sad(target, width);
+   for (; i < width; i = end)
+   {
+      end = (i + RPNG_FILTER_BLOCK < width) ? i + RPNG_FILTER_BLOCK : width;
+      {
+         unsigned j = i;
+#if defined(__SSE2__)
+         const __m128i one = _mm_set1_epi8(1);
+         for (; j + 16 <= end; j += 16)
+         {
+            __m128i a = _mm_loadu_si128((const __m128i*)(line + j - bpp));
+            __m128i b = _mm_loadu_si128((const __m128i*)(prev + j));
+            /* _mm_avg_epu8 rounds up, PNG rounds down */
+            __m128i p = _mm_sub_epi8(_mm_avg_epu8(a, b),
+                  _mm_and_si128(_mm_xor_si128(a, b), one));
+            _mm_storeu_si128((__m128i*)(target + j), _mm_sub_epi8(
+                     _mm_loadu_si128((const __m128i*)(line + j)), p));
+         }
+#endif
+         for (; j < end; j++)
+            target[j] = line[j] - ((line[j - bpp] + prev[j]) >> 1);
+      }
+      cnt += count_sad(target + i, end - i);
+      if (cnt > limit)
+         break;
+   }
+
+   return cnt;
 }
 
 static unsigned filter_paeth(uint8_t *target,
       const uint8_t *line, const uint8_t *prev,
-      unsigned width, unsigned bpp)
+      unsigned width, unsigned bpp, unsigned limit)
 {
-   unsigned i;
-   width *= bpp;
+   unsigned i, end;
+   unsigned cnt = 0;
+   width       *= bpp;
    for (i = 0; i < bpp; i++)
       target[i] = line[i] - paeth(0, prev[i], 0);
-   for (i = bpp; i < width; i++)
-      target[i] = line[i] - paeth(line[i - bpp], prev[i], prev[i - bpp]);
+   cnt          = count_sad(target, bpp);
 
-   return count_sad(target, width);
+   for (; i < width; i = end)
+   {
+      end = (i + RPNG_FILTER_BLOCK < width) ? i + RPNG_FILTER_BLOCK : width;
+      {
+         unsigned j = i;
+#if defined(__SSE2__)
+         const __m128i zero = _mm_setzero_si128();
+         for (; j + 16 <= end; j += 16)
+         {
+            __m128i a  = _mm_loadu_si128((const __m128i*)(line + j - bpp));
+            __m128i b  = _mm_loadu_si128((const __m128i*)(prev + j));
+            __m128i c  = _mm_loadu_si128((const __m128i*)(prev + j - bpp));
+            __m128i lo = rpng_paeth_sse2(_mm_unpacklo_epi8(a, zero),
+                  _mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(c, zero));
+            __m128i hi = rpng_paeth_sse2(_mm_unpackhi_epi8(a, zero),
+                  _mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi8(c, zero));
+            _mm_storeu_si128((__m128i*)(target + j), _mm_sub_epi8(
+                     _mm_loadu_si128((const __m128i*)(line + j)),
+                     _mm_packus_epi16(lo, hi)));
+         }
+#endif
+         for (; j < end; j++)
+            target[j] = line[j] - paeth(line[j - bpp], prev[j], prev[j - bpp]);
+      }
+      cnt += count_sad(target + i, end - i);
+      if (cnt > limit)
+         break;
+   }
+
+   return cnt;
 }
 
-bool rpng_save_image_stream(const uint8_t *data, intfstream_t* intf_s,
-      unsigned width, unsigned height, signed pitch, unsigned bpp)
-{
-   unsigned h;
-   struct png_ihdr ihdr = {0};
-   bool ret = true;
-   const struct trans_stream_backend *stream_backend = NULL;
-   size_t encode_buf_size  = 0;
-   uint8_t *encode_buf     = NULL;
-   uint8_t *deflate_buf    = NULL;
-   uint8_t *rgba_line      = NULL;
-   uint8_t *up_filtered    = NULL;
-   uint8_t *sub_filtered   = NULL;
-   uint8_t *avg_filtered   = NULL;
-   uint8_t *paeth_filtered = NULL;
-   uint8_t *prev_encoded   = NULL;
-   uint8_t *encode_target  = NULL;
-   void *stream            = NULL;
-   uint32_t total_in       = 0;
-   uint32_t total_out      = 0;
-   
-   if (!intf_s)
-      GOTO_END_ERROR();
+#define RPNG_ADLER_BASE 65521
+/* Most bytes the 32-bit Adler sums take before they can overflow */
+#define RPNG_ADLER_NMAX 5552
 
-   stream_backend = trans_stream_get_zlib_deflate_backend();
+static uint32_t rpng_adler32(uint32_t adler, const uint8_t *data, size_t len)
+{
+   uint32_t a = adler & 0xFFFF;
+   uint32_t b = adler >> 16;
 
-   if (intfstream_write(intf_s, png_magic, sizeof(png_magic)) != sizeof(png_magic))
-      GOTO_END_ERROR();
+   while (len)
+   {
+      size_t n = (len < RPNG_ADLER_NMAX) ? len : RPNG_ADLER_NMAX;
+      len     -= n;
+      while (n--)
+      {
+         a += *data++;
+         b += a;
+      }
+      a %= RPNG_ADLER_BASE;
+      b %= RPNG_ADLER_BASE;
+   }
 
-   ihdr.width = width;
-   ihdr.height = height;
-   ihdr.depth = 8;
-   ihdr.color_type = bpp == sizeof(uint32_t) ? 6 : 2; /* RGBA or RGB */
-   if (!png_write_ihdr_string(intf_s, &ihdr))
-      GOTO_END_ERROR();
+   return a | (b << 16);
+}
 
-   encode_buf_size = (width * bpp + 1) * height;
-   encode_buf      = (uint8_t*)malloc(encode_buf_size);
-   if (!encode_buf)
-      GOTO_END_ERROR();
+/* Adler-32 of two buffers back to back, from the checksum
+ * of each and the length of the second, as zlib does it */
+static uint32_t rpng_adler32_combine(uint32_t adler1, uint32_t adler2,
+      size_t len2)
+{
+   uint32_t rem  = (uint32_t)(len2 % RPNG_ADLER_BASE);
+   uint32_t sum1 = adler1 & 0xFFFF;
+   uint32_t sum2 = (rem * sum1) % RPNG_ADLER_BASE;
+
+   sum1 += (adler2 & 0xFFFF) + RPNG_ADLER_BASE - 1;
+   sum2 += (adler1 >> 16) + (adler2 >> 16) + RPNG_ADLER_BASE - rem;
+   if (sum1 >= RPNG_ADLER_BASE)
+      sum1 -= RPNG_ADLER_BASE;
+   if (sum1 >= RPNG_ADLER_BASE)
+      sum1 -= RPNG_ADLER_BASE;
+   if (sum2 >= (RPNG_ADLER_BASE << 1))
+      sum2 -= (RPNG_ADLER_BASE << 1);
+   if (sum2 >= RPNG_ADLER_BASE)
+      sum2 -= RPNG_ADLER_BASE;
+   return sum1 | (sum2 << 16);
+}
 
-   prev_encoded = (uint8_t*)calloc(1, width * bpp);
-   if (!prev_encoded)
-      GOTO_END_ERROR();
+/* Filtered bytes a deflate group gets at least. Every group
+ * starts with an empty window, so smaller ones cost ratio. */
+#define RPNG_ENCODE_GROUP_MIN   (256 * 1024)
+#define RPNG_ENCODE_MAX_THREADS 8
 
-   rgba_line      = (uint8_t*)malloc(width * bpp);
-   up_filtered    = (uint8_t*)malloc(width * bpp);
-   sub_filtered   = (uint8_t*)malloc(width * bpp);
-   avg_filtered   = (uint8_t*)malloc(width * bpp);
-   paeth_filtered = (uint8_t*)malloc(width * bpp);
-   if (!rgba_line || !up_filtered || !sub_filtered || !avg_filtered || !paeth_filtered)
-      GOTO_END_ERROR();
+/* A run of rows filtered and deflated on its own, pigz style.
+ * All but the last group end on a sync flush, so the raw deflate
+ * streams concatenate into one zlib stream. */
+typedef struct rpng_encode_group
+{
+   const uint8_t *data;      /* First source row */
+   const uint8_t *above;     /* Source row above it, NULL at the top */
+   uint8_t *filtered;        /* Filter byte + filtered row, per row */
+   uint8_t *out;             /* Raw deflate data */
+   size_t filtered_size;
+   size_t out_size;
+   size_t out_len;
+   int level;
+   signed pitch;
+   unsigned width;
+   unsigned rows;
+   unsigned bpp;
+   unsigned flags;
+   uint32_t adler;
+   bool last;
+   bool ok;
+} rpng_encode_group_t;
+
+static void rpng_copy_line(uint8_t *dst, const uint8_t *src,
+      unsigned width, unsigned bpp)
+{
+   if (bpp == sizeof(uint32_t))
+      copy_argb_line(dst, (const uint32_t*)src, width);
+   else
+      copy_bgr24_line(dst, src, width);
+}
 
-   encode_target = encode_buf;
-   for (h = 0; h < height;
-         h++, encode_target += width * bpp, data += pitch)
+static bool rpng_encode_group_filter(rpng_encode_group_t *group)
+{
+   unsigned h;
+   size_t line_size        = group->width * group->bpp;
+   unsigned width          = group->width;
+   unsigned bpp            = group->bpp;
+   const uint8_t *data     = group->data;
+   uint8_t *encode_target  = group->filtered;
+   uint8_t *rgba_line      = (uint8_t*)malloc(line_size);
+   uint8_t *prev_encoded   = (uint8_t*)calloc(1, line_size);
+   uint8_t *up_filtered    = (uint8_t*)malloc(line_size);
+   uint8_t *sub_filtered   = (uint8_t*)malloc(line_size);
+   uint8_t *avg_filtered   = (uint8_t*)malloc(line_size);
+   uint8_t *paeth_filtered = (uint8_t*)malloc(line_size);
+   bool ret                = rgba_line && prev_encoded && up_filtered
+      && sub_filtered && avg_filtered && paeth_filtered;
+
+   if (ret && group->above)
+      rpng_copy_line(prev_encoded, group->above, width, bpp);
+
+   for (h = 0; ret && h < group->rows;
+         h++, encode_target += line_size, data += group->pitch)
    {
-      if (bpp == sizeof(uint32_t))
-         copy_argb_line(rgba_line, (const uint32_t*)data, width);
-      else
-         copy_bgr24_line(rgba_line, data, width);
-
-      /* Try every filtering method, and choose the method
-       * which has most entries as zero.
-       *
-       * This is probably not very optimal, but it's very
-       * simple to implement.
-       */
+      uint8_t filter;
+      unsigned min_sad;
+      const uint8_t *chosen_filtered;
+
+      rpng_copy_line(rgba_line, data, width, bpp);
+
+      /* Up and Sub are cheap and catch most of what screen
+       * content has to offer. Fast mode stops there, otherwise
+       * the rest only get tried while the row still has any
+       * cost left, and give up once they cannot beat it. */
+      filter          = 2;
+      chosen_filtered = up_filtered;
+      min_sad         = filter_up(up_filtered, rgba_line, prev_encoded,
+            width, bpp);
+
+      if (min_sad)
       {
-         unsigned none_score  = count_sad(rgba_line, width * bpp);
-         unsigned up_score    = filter_up(up_filtered, rgba_line, prev_encoded, width, bpp);
-         unsigned sub_score   = filter_sub(sub_filtered, rgba_line, width, bpp);
-         unsigned avg_score   = filter_avg(avg_filtered, rgba_line, prev_encoded, width, bpp);
-         unsigned paeth_score = filter_paeth(paeth_filtered, rgba_line, prev_encoded, width, bpp);
-
-         uint8_t filter       = 0;
-         unsigned min_sad     = none_score;
-         const uint8_t *chosen_filtered = rgba_line;
-
+         unsigned sub_score = filter_sub(sub_filtered, rgba_line,
+               width, bpp);
          if (sub_score < min_sad)
          {
-            filter = 1;
+            filter          = 1;
             chosen_filtered = sub_filtered;
-            min_sad = sub_score;
+            min_sad         = sub_score;
          }
+      }
 
-         if (up_score < min_sad)
+      if (min_sad && !(group->flags & RPNG_ENCODE_FAST_FILTER))
+      {
+         unsigned avg_score = filter_avg(avg_filtered, rgba_line,
+               prev_encoded, width, bpp, min_sad);
+         if (avg_score < min_sad)
          {
-            filter = 2;
-            chosen_filtered = up_filtered;
-            min_sad = up_score;
+            filter          = 3;
+            chosen_filtered = avg_filtered;
+            min_sad         = avg_score;
          }
 
-         if (avg_score < min_sad)
+         if (min_sad)
          {
-            filter = 3;
-            chosen_filtered = avg_filtered;
-            min_sad = avg_score;
+            unsigned paeth_score = filter_paeth(paeth_filtered, rgba_line,
+                  prev_encoded, width, bpp, min_sad);
+            if (paeth_score < min_sad)
+            {
+               filter          = 4;
+               chosen_filtered = paeth_filtered;
+               min_sad         = paeth_score;
+            }
          }
 
-         if (paeth_score < min_sad)
+         if (min_sad && count_sad(rgba_line, line_size) < min_sad)
          {
-            filter = 4;
-            chosen_filtered = paeth_filtered;
+            filter          = 0;
+            chosen_filtered = rgba_line;
          }
+      }
 
-         *encode_target++ = filter;
-         memcpy(encode_target, chosen_filtered, width * bpp);
+      *encode_target++ = filter;
+      memcpy(encode_target, chosen_filtered, line_size);
 
-         memcpy(prev_encoded, rgba_line, width * bpp);
-      }
+      memcpy(prev_encoded, rgba_line, line_size);
    }
 
-   deflate_buf = (uint8_t*)malloc(encode_buf_size * 2); /* Just to be sure. */
-   if (!deflate_buf)
-      GOTO_END_ERROR();
+   free(rgba_line);
+   free(prev_encoded);
+   free(up_filtered);
+   free(sub_filtered);
+   free(avg_filtered);
+   free(paeth_filtered);
+   return ret;
+}
 
-   stream = stream_backend->stream_new();
+static bool rpng_encode_group_deflate(rpng_encode_group_t *group)
+{
+   uint32_t rd, wn;
+   bool ret                                     = false;
+   const struct trans_stream_backend *backend   =
+      trans_stream_get_zlib_deflate_backend();
+   void *stream                                 = backend->stream_new();
 
    if (!stream)
+      return false;
+
+   /* Raw deflate, the zlib header and checksum
+    * are written once for all groups */
+   backend->define(stream, "window_bits", (uint32_t)-15);
+   if (group->level >= 0)
+      backend->define(stream, "level", (uint32_t)group->level);
+   if (!group->last)
+      backend->define(stream, "sync_flush", 1);
+
+   backend->set_in(stream, group->filtered, (uint32_t)group->filtered_size);
+   backend->set_out(stream, group->out, (uint32_t)group->out_size);
+
+   /* A sync flush only completes if it did not run out of room */
+   if (     backend->trans(stream, true, &rd, &wn, NULL)
+         && rd == group->filtered_size
+         && wn  < group->out_size)
+   {
+      group->out_len = wn;
+      ret            = true;
+   }
+
+   backend->stream_free(stream);
+   return ret;
+}
+
+static void rpng_encode_group(void *data)
+{
+   rpng_encode_group_t *group = (rpng_encode_group_t*)data;
+
+   group->ok    = rpng_encode_group_filter(group);
+   if (!group->ok)
+      return;
+   group->adler = rpng_adler32(1, group->filtered, group->filtered_size);
+   group->ok    = rpng_encode_group_deflate(group);
+}
+
+/* Writes a single IDAT holding the zlib stream the groups make up */
+static bool rpng_write_idat_groups(intfstream_t *intf_s,
+      const rpng_encode_group_t *groups, unsigned num_groups, int level)
+{
+   unsigned i;
+   uint32_t crc;
+   uint8_t head[10];
+   uint8_t tail[8];
+   unsigned flevel = (level < 0 || level == 6) ? 2
+      : (level <= 1) ? 0 : (level <= 5) ? 1 : 3;
+   uint32_t adler  = groups[0].adler;
+   size_t len      = 2 + 4;
+
+   for (i = 0; i < num_groups; i++)
+      len += groups[i].out_len;
+   for (i = 1; i < num_groups; i++)
+      adler = rpng_adler32_combine(adler, groups[i].adler,
+            groups[i].filtered_size);
+
+   dword_write_be(head, (uint32_t)len);
+   memcpy(head + 4, "IDAT", 4);
+   /* Deflate with a 32K window; FLEVEL is informational */
+   head[8] = 0x78;
+   head[9] = flevel << 6;
+   head[9] += 31 - ((head[8] << 8) + head[9]) % 31;
+
+   crc     = encoding_crc32(0, head + 4, sizeof(head) - 4);
+   if (intfstream_write(intf_s, head, sizeof(head)) != sizeof(head))
+      return false;
+
+   for (i = 0; i < num_groups; i++)
+   {
+      crc = encoding_crc32(crc, groups[i].out, groups[i].out_len);
+      if (intfstream_write(intf_s, groups[i].out, groups[i].out_len)
+            != (int64_t)groups[i].out_len)
+         return false;
+   }
+
+   dword_write_be(tail, adler);
+   crc = encoding_crc32(crc, tail, 4);
+   dword_write_be(tail + 4, crc);
+   return intfstream_write(intf_s, tail, sizeof(tail)) == sizeof(tail);
+}
+
+static bool rpng_save_image_stream_ex(const uint8_t *data,
+      intfstream_t* intf_s, unsigned width, unsigned height,
+      signed pitch, unsigned bpp, int level, unsigned flags)
+{
+   unsigned g, num_groups, group_rows;
+   struct png_ihdr ihdr            = {0};
+   bool ret                        = true;
+   size_t row_size                 = width * bpp + 1;
+   size_t encode_buf_size          = row_size * height;
+   uint8_t *encode_buf             = NULL;
+   rpng_encode_group_t *groups     = NULL;
+#ifdef HAVE_THREADS
+   sthread_t *threads[RPNG_ENCODE_MAX_THREADS];
+#endif
+
+   /* PNG forbids empty images, and the rows
+    * could not be split into groups anyway */
+   if (!intf_s || !width || !height)
       GOTO_END_ERROR();
 
-   stream_backend->set_in(
-         stream,
-         encode_buf,
-         (unsigned)encode_buf_size);
-   stream_backend->set_out(
-         stream,
-         deflate_buf + 8,
-         (unsigned)(encode_buf_size * 2));
+   if (intfstream_write(intf_s, png_magic, sizeof(png_magic)) != sizeof(png_magic))
+      GOTO_END_ERROR();
 
-   if (!stream_backend->trans(stream, true, &total_in, &total_out, NULL))
+   ihdr.width = width;
+   ihdr.height = height;
+   ihdr.depth = 8;
+   ihdr.color_type = bpp == sizeof(uint32_t) ? 6 : 2; /* RGBA or RGB */
+   if (!png_write_ihdr_string(intf_s, &ihdr))
       GOTO_END_ERROR();
 
-   memcpy(deflate_buf + 4, "IDAT", 4);
-   dword_write_be(deflate_buf + 0,        ((uint32_t)total_out));
-   if (!png_write_idat_string(intf_s, deflate_buf, ((size_t)total_out + 8)))
+   encode_buf = (uint8_t*)malloc(encode_buf_size);
+   if (!encode_buf)
+      GOTO_END_ERROR();
+
+   /* Split the rows into groups worth a thread each */
+   num_groups = 1;
+#ifdef HAVE_THREADS
+   {
+      unsigned cores = cpu_features_get_core_amount();
+      if (cores > RPNG_ENCODE_MAX_THREADS)
+         cores       = RPNG_ENCODE_MAX_THREADS;
+      num_groups     = (unsigned)(encode_buf_size / RPNG_ENCODE_GROUP_MIN);
+      if (num_groups > cores)
+         num_groups  = cores;
+      if (num_groups < 1)
+         num_groups  = 1;
+   }
+#endif
+   group_rows = (height + num_groups - 1) / num_groups;
+   num_groups = (height + group_rows - 1) / group_rows;
+
+   groups     = (rpng_encode_group_t*)calloc(num_groups, sizeof(*groups));
+   if (!groups)
+      GOTO_END_ERROR();
+
+   for (g = 0; g < num_groups; g++)
+   {
+      rpng_encode_group_t *group = &groups[g];
+      unsigned first_row         = g * group_rows;
+
+      group->rows          = (height - first_row < group_rows)
+         ? height - first_row : group_rows;
+      group->data          = data + (ptrdiff_t)first_row * pitch;
+      group->above         = first_row ? group->data - pitch : NULL;
+      group->filtered      = encode_buf + first_row * row_size;
+      group->filtered_size = group->rows * row_size;
+      /* Stored blocks and the sync flush are the worst case */
+      group->out_size      = group->filtered_size
+         + (group->filtered_size >> 3) + 64;
+      group->out           = (uint8_t*)malloc(group->out_size);
+      group->level         = level;
+      group->pitch         = pitch;
+      group->width         = width;
+      group->bpp           = bpp;
+      group->flags         = flags;
+      group->last          = (g == num_groups - 1);
+      if (!group->out)
+         GOTO_END_ERROR();
+   }
+
+#ifdef HAVE_THREADS
+   for (g = 1; g < num_groups; g++)
+      threads[g] = sthread_create(rpng_encode_group, &groups[g]);
+   rpng_encode_group(&groups[0]);
+   for (g = 1; g < num_groups; g++)
+   {
+      if (threads[g])
+         sthread_join(threads[g]);
+      else
+         rpng_encode_group(&groups[g]);
+   }
+#else
+   rpng_encode_group(&groups[0]);
+#endif
+
+   for (g = 0; g < num_groups; g++)
+      if (!groups[g].ok)
+         GOTO_END_ERROR();
+
+   if (!rpng_write_idat_groups(intf_s, groups, num_groups, level))
       GOTO_END_ERROR();
 
    if (!png_write_iend_string(intf_s))
       GOTO_END_ERROR();
 end:
-   free(encode_buf);
-   free(deflate_buf);
-   free(rgba_line);
-   free(prev_encoded);
-   free(up_filtered);
-   free(sub_filtered);
-   free(avg_filtered);
-   free(paeth_filtered);
-
-   if (stream_backend)
+   if (groups)
    {
-      if (stream)
-      {
-         if (stream_backend->stream_free)
-            stream_backend->stream_free(stream);
-      }
+      for (g = 0; g < num_groups; g++)
+         free(groups[g].out);
+      free(groups);
    }
+   free(encode_buf);
    return ret;
 }
 
+bool rpng_save_image_stream(const uint8_t *data, intfstream_t* intf_s,
+      unsigned width, unsigned height, signed pitch, unsigned bpp)
+{
+   return rpng_save_image_stream_ex(data, intf_s, width, height,
+         pitch, bpp, -1, 0);
+}
+
 bool rpng_save_image_argb(const char *path, const uint32_t *data,
       unsigned width, unsigned height, unsigned pitch)
 {
@@ -399,6 +730,21 @@ bool rpng_save_image_bgr24(const char *path, const uint8_t *data,
    return ret;
 }
 
+bool rpng_save_image_bgr24_ex(const char *path, const uint8_t *data,
+      unsigned width, unsigned height, signed pitch,
+      int level, unsigned flags)
+{
+   bool ret                      = false;
+   intfstream_t* intf_s          = intfstream_open_file(path,
+         RETRO_VFS_FILE_ACCESS_WRITE,
+         RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+   ret = rpng_save_image_stream_ex(data, intf_s, width, height,
+         pitch, 3, level, flags);
+   intfstream_close(intf_s);
+   free(intf_s);
+   return ret;
+}
 
 uint8_t* rpng_save_image_bgr24_string(const uint8_t *data,
       unsigned width, unsigned height, signed pitch, uint64_t* bytes)
@@ -24,9 +24,18 @@
 #define _RPNG_COMMON_H
 
 #include <stdint.h>
+#include <retro_inline.h>
 #include <filters.h>
 #include <formats/rpng.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
 #ifndef ARRAY_SIZE
 #define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
 #endif
@@ -46,4 +55,25 @@ struct png_ihdr
    uint8_t interlace;
 };
 
+#if defined(__SSE2__)
+/* Paeth predictor over eight 16-bit lanes */
+static INLINE __m128i rpng_paeth_sse2(__m128i a, __m128i b, __m128i c)
+{
+   const __m128i zero = _mm_setzero_si128();
+   __m128i pa         = _mm_sub_epi16(b, c);
+   __m128i pb         = _mm_sub_epi16(a, c);
+   __m128i pc         = _mm_add_epi16(pa, pb);
+   __m128i not_a, not_b;
+
+   pa    = _mm_max_epi16(pa, _mm_sub_epi16(zero, pa));
+   pb    = _mm_max_epi16(pb, _mm_sub_epi16(zero, pb));
+   pc    = _mm_max_epi16(pc, _mm_sub_epi16(zero, pc));
+
+   not_a = _mm_or_si128(_mm_cmpgt_epi16(pa, pb), _mm_cmpgt_epi16(pa, pc));
+   not_b = _mm_cmpgt_epi16(pb, pc);
+   b     = _mm_or_si128(_mm_and_si128(not_b, c), _mm_andnot_si128(not_b, b));
+   return  _mm_or_si128(_mm_and_si128(not_a, b), _mm_andnot_si128(not_a, a));
+}
+#endif
+
 #endif
@@ -72,7 +72,9 @@ static void rtga_skip(rtga_context *s, int n)
 
 static int rtga_get16le(rtga_context *s)
 {
-   return rtga_get8(s) + (rtga_get8(s) << 8);
+   /* Operands of '+' may be evaluated in either order */
+   int lo = rtga_get8(s);
+   return lo + (rtga_get8(s) << 8);
 }
 
 static unsigned char *rtga_convert_format(
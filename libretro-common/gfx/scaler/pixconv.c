@@ -26,6 +26,7 @@
 #include <string.h>
 
 #include <retro_inline.h>
+#include <features/features_cpu.h>
 
 #include <gfx/scaler/pixconv.h>
 
@@ -43,8 +44,50 @@
 #include <mmintrin.h>
 #elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
 #include <arm_neon.h>
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
 #endif
 
+/* AVX2 kernels are built regardless of compiler flags and only
+ * picked by pixconv_get() when the CPU reports AVX2. */
+#if !defined(SCALER_NO_SIMD)
+#if defined(__clang__) || (defined(__GNUC__) \
+      && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#if defined(__x86_64__) || defined(__i386__)
+#define PIXCONV_HAVE_AVX2
+#define PIXCONV_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#elif defined(_MSC_VER) && _MSC_VER >= 1900 && defined(_M_X64)
+#define PIXCONV_HAVE_AVX2
+#define PIXCONV_AVX2_TARGET
+#endif
+#endif
+
+#ifdef PIXCONV_HAVE_AVX2
+#include <immintrin.h>
+#endif
+
+static void conv_rgb565_0rgb1555_c(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h, w;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint16_t *output      = (uint16_t*)output_;
+
+   for (h = 0; h < height;
+         h++, output += out_stride >> 1, input += in_stride >> 1)
+   {
+      for (w = 0; w < width; w++)
+      {
+         uint16_t col = input[w];
+         uint16_t hi  = (col >> 1) & 0x7fe0;
+         uint16_t lo  = col & 0x1f;
+         output[w]    = hi | lo;
+      }
+   }
+}
+
 void conv_rgb565_0rgb1555(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -57,6 +100,14 @@ void conv_rgb565_0rgb1555(void *output_, const void *input_,
    int max_width           = width - 7;
    const __m128i hi_mask   = _mm_set1_epi16(0x7fe0);
    const __m128i lo_mask   = _mm_set1_epi16(0x1f);
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   int max_width           = width - 7;
+   const uint16x8_t hi_mask = vdupq_n_u16(0x7fe0);
+   const uint16x8_t lo_mask = vdupq_n_u16(0x1f);
+#elif defined(__wasm_simd128__)
+   int max_width           = width - 7;
+   const v128_t hi_mask    = wasm_i16x8_splat(0x7fe0);
+   const v128_t lo_mask    = wasm_i16x8_splat(0x1f);
 #endif
 
    for (h = 0; h < height;
@@ -67,18 +118,50 @@ void conv_rgb565_0rgb1555(void *output_, const void *input_,
       for (; w < max_width; w += 8)
       {
          const __m128i in = _mm_loadu_si128((const __m128i*)(input + w));
-         __m128i hi = _mm_and_si128(_mm_slli_epi16(in, 1), hi_mask);
+         __m128i hi = _mm_and_si128(_mm_srli_epi16(in, 1), hi_mask);
          __m128i lo = _mm_and_si128(in, lo_mask);
          _mm_storeu_si128((__m128i*)(output + w), _mm_or_si128(hi, lo));
       }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 8)
+      {
+         uint16x8_t in = vld1q_u16(input + w);
+         uint16x8_t hi = vandq_u16(vshrq_n_u16(in, 1), hi_mask);
+         uint16x8_t lo = vandq_u16(in, lo_mask);
+         vst1q_u16(output + w, vorrq_u16(hi, lo));
+      }
+#elif defined(__wasm_simd128__)
+      for (; w < max_width; w += 8)
+      {
+         v128_t in = wasm_v128_load(input + w);
+         v128_t hi = wasm_v128_and(wasm_u16x8_shr(in, 1), hi_mask);
+         v128_t lo = wasm_v128_and(in, lo_mask);
+         wasm_v128_store(output + w, wasm_v128_or(hi, lo));
+      }
 #endif
 
-      for (; w < width; w++)
+      conv_rgb565_0rgb1555_c(output + w, input + w, width - w, 1, 0, 0);
+   }
+}
+
+static void conv_0rgb1555_rgb565_c(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h, w;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint16_t *output      = (uint16_t*)output_;
+
+   for (h = 0; h < height;
+         h++, output += out_stride >> 1, input += in_stride >> 1)
+   {
+      for (w = 0; w < width; w++)
       {
-         uint16_t col = input[w];
-         uint16_t hi  = (col >> 1) & 0x7fe0;
-         uint16_t lo  = col & 0x1f;
-         output[w]    = hi | lo;
+         uint16_t col  = input[w];
+         uint16_t rg   = (col << 1) & ((0x1f << 11) | (0x1f << 6));
+         uint16_t b    = col & 0x1f;
+         uint16_t glow = (col >> 4) & (1 << 5);
+         output[w]     = rg | b | glow;
       }
    }
 }
@@ -98,6 +181,17 @@ void conv_0rgb1555_rgb565(void *output_, const void *input_,
          (int16_t)((0x1f << 11) | (0x1f << 6)));
    const __m128i lo_mask   = _mm_set1_epi16(0x1f);
    const __m128i glow_mask = _mm_set1_epi16(1 << 5);
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   int max_width             = width - 7;
+   const uint16x8_t hi_mask   = vdupq_n_u16((0x1f << 11) | (0x1f << 6));
+   const uint16x8_t lo_mask   = vdupq_n_u16(0x1f);
+   const uint16x8_t glow_mask = vdupq_n_u16(1 << 5);
+#elif defined(__wasm_simd128__)
+   int max_width           = width - 7;
+   const v128_t hi_mask    = wasm_i16x8_splat(
+         (int16_t)((0x1f << 11) | (0x1f << 6)));
+   const v128_t lo_mask    = wasm_i16x8_splat(0x1f);
+   const v128_t glow_mask  = wasm_i16x8_splat(1 << 5);
 #endif
 
    for (h = 0; h < height;
@@ -114,15 +208,52 @@ void conv_0rgb1555_rgb565(void *output_, const void *input_,
          _mm_storeu_si128((__m128i*)(output + w),
                _mm_or_si128(rg, _mm_or_si128(b, glow)));
       }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 8)
+      {
+         uint16x8_t in   = vld1q_u16(input + w);
+         uint16x8_t rg   = vandq_u16(vshlq_n_u16(in, 1), hi_mask);
+         uint16x8_t b    = vandq_u16(in, lo_mask);
+         uint16x8_t glow = vandq_u16(vshrq_n_u16(in, 4), glow_mask);
+         vst1q_u16(output + w, vorrq_u16(rg, vorrq_u16(b, glow)));
+      }
+#elif defined(__wasm_simd128__)
+      for (; w < max_width; w += 8)
+      {
+         v128_t in   = wasm_v128_load(input + w);
+         v128_t rg   = wasm_v128_and(wasm_i16x8_shl(in, 1), hi_mask);
+         v128_t b    = wasm_v128_and(in, lo_mask);
+         v128_t glow = wasm_v128_and(wasm_u16x8_shr(in, 4), glow_mask);
+         wasm_v128_store(output + w, wasm_v128_or(rg, wasm_v128_or(b, glow)));
+      }
 #endif
 
-      for (; w < width; w++)
+      conv_0rgb1555_rgb565_c(output + w, input + w, width - w, 1, 0, 0);
+   }
+}
+
+static void conv_0rgb1555_argb8888_c(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h, w;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint32_t *output      = (uint32_t*)output_;
+
+   for (h = 0; h < height;
+         h++, output += out_stride >> 2, input += in_stride >> 1)
+   {
+      for (w = 0; w < width; w++)
       {
-         uint16_t col  = input[w];
-         uint16_t rg   = (col << 1) & ((0x1f << 11) | (0x1f << 6));
-         uint16_t b    = col & 0x1f;
-         uint16_t glow = (col >> 4) & (1 << 5);
-         output[w]     = rg | b | glow;
+         uint32_t col = input[w];
+         uint32_t r   = (col >> 10) & 0x1f;
+         uint32_t g   = (col >>  5) & 0x1f;
+         uint32_t b   = (col >>  0) & 0x1f;
+         r            = (r << 3) | (r >> 2);
+         g            = (g << 3) | (g >> 2);
+         b            = (b << 3) | (b >> 2);
+
+         output[w]    = (0xffu << 24) | (r << 16) | (g << 8) | (b << 0);
       }
    }
 }
@@ -179,14 +310,29 @@ void conv_0rgb1555_argb8888(void *output_, const void *input_,
       }
 #endif
 
-      for (; w < width; w++)
+      conv_0rgb1555_argb8888_c(output + w, input + w, width - w, 1, 0, 0);
+   }
+}
+
+static void conv_rgb565_argb8888_c(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h, w;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint32_t *output      = (uint32_t*)output_;
+
+   for (h = 0; h < height;
+         h++, output += out_stride >> 2, input += in_stride >> 1)
+   {
+      for (w = 0; w < width; w++)
       {
          uint32_t col = input[w];
-         uint32_t r   = (col >> 10) & 0x1f;
-         uint32_t g   = (col >>  5) & 0x1f;
+         uint32_t r   = (col >> 11) & 0x1f;
+         uint32_t g   = (col >>  5) & 0x3f;
          uint32_t b   = (col >>  0) & 0x1f;
          r            = (r << 3) | (r >> 2);
-         g            = (g << 3) | (g >> 2);
+         g            = (g << 2) | (g >> 4);
          b            = (b << 3) | (b >> 2);
 
          output[w]    = (0xffu << 24) | (r << 16) | (g << 8) | (b << 0);
@@ -305,17 +451,31 @@ void conv_rgb565_argb8888(void *output_, const void *input_,
       }
 #endif
 
-      for (; w < width; w++)
-      {
-         uint32_t col = input[w];
-         uint32_t r   = (col >> 11) & 0x1f;
-         uint32_t g   = (col >>  5) & 0x3f;
-         uint32_t b   = (col >>  0) & 0x1f;
-         r            = (r << 3) | (r >> 2);
-         g            = (g << 2) | (g >> 4);
-         b            = (b << 3) | (b >> 2);
+      conv_rgb565_argb8888_c(output + w, input + w, width - w, 1, 0, 0);
+   }
+}
 
-         output[w]    = (0xffu << 24) | (r << 16) | (g << 8) | (b << 0);
+static void conv_rgb565_abgr8888_c(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h, w;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint32_t *output      = (uint32_t*)output_;
+
+   for (h = 0; h < height;
+         h++, output += out_stride >> 2, input += in_stride >> 1)
+   {
+      for (w = 0; w < width; w++)
+      {
+        uint32_t col = input[w];
+        uint32_t r   = (col >> 11) & 0x1f;
+        uint32_t g   = (col >>  5) & 0x3f;
+        uint32_t b   = (col >>  0) & 0x1f;
+        r            = (r << 3) | (r >> 2);
+        g            = (g << 2) | (g >> 4);
+        b            = (b << 3) | (b >> 2);
+        output[w]    = (0xffu << 24) | (b << 16) | (g << 8) | (r << 0);
       }
    }
 }
@@ -355,10 +515,11 @@ void conv_rgb565_abgr8888(void *output_, const void *input_,
          r                = _mm_mulhi_epi16(r, mul16_r);
          g                = _mm_mulhi_epi16(g, mul16_g);
          b                = _mm_mulhi_epi16(b, mul16_b);
-         res_lo_bg        = _mm_unpacklo_epi8(b, g);
-         res_hi_bg        = _mm_unpackhi_epi8(b, g);
-         res_lo_ra        = _mm_unpacklo_epi8(r, a);
-         res_hi_ra        = _mm_unpackhi_epi8(r, a);
+         /* Same as ARGB8888, with red and blue trading places */
+         res_lo_bg        = _mm_unpacklo_epi8(r, g);
+         res_hi_bg        = _mm_unpackhi_epi8(r, g);
+         res_lo_ra        = _mm_unpacklo_epi8(b, a);
+         res_hi_ra        = _mm_unpackhi_epi8(b, a);
          res_lo           = _mm_or_si128(res_lo_bg,
                _mm_slli_si128(res_lo_ra, 2));
          res_hi           = _mm_or_si128(res_hi_bg,
@@ -384,17 +545,7 @@ void conv_rgb565_abgr8888(void *output_, const void *input_,
          vst4_u8((uint8_t*)(output + w), res);
       }
 #endif
-       for (; w < width; w++)
-      {
-         uint32_t col = input[w];
-         uint32_t r   = (col >> 11) & 0x1f;
-         uint32_t g   = (col >>  5) & 0x3f;
-         uint32_t b   = (col >>  0) & 0x1f;
-         r            = (r << 3) | (r >> 2);
-         g            = (g << 2) | (g >> 4);
-         b            = (b << 3) | (b >> 2);
-         output[w]    = (0xffu << 24) | (b << 16) | (g << 8) | (r << 0);
-      }
+       conv_rgb565_abgr8888_c(output + w, input + w, width - w, 1, 0, 0);
    }
 }
 
@@ -426,62 +577,18 @@ void conv_argb8888_rgba4444(void *output_, const void *input_,
    }
 }
 
-void conv_rgba4444_argb8888(void *output_, const void *input_,
+static void conv_rgba4444_argb8888_c(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h;
+   int h, w;
    const uint16_t *input = (const uint16_t*)input_;
    uint32_t *output      = (uint32_t*)output_;
 
-#if defined(__MMX__)
-   const __m64 pix_mask_r = _mm_set1_pi16(0xf << 10);
-   const __m64 pix_mask_g = _mm_set1_pi16(0xf << 8);
-   const __m64 pix_mask_b = _mm_set1_pi16(0xf << 8);
-   const __m64 mul16_r    = _mm_set1_pi16(0x0440);
-   const __m64 mul16_g    = _mm_set1_pi16(0x1100);
-   const __m64 mul16_b    = _mm_set1_pi16(0x1100);
-   const __m64 a          = _mm_set1_pi16(0x00ff);
-
-   int max_width            = width - 3;
-#endif
-
    for (h = 0; h < height;
          h++, output += out_stride >> 2, input += in_stride >> 1)
    {
-      int w = 0;
-#if defined(__MMX__)
-      for (; w < max_width; w += 4)
-      {
-         __m64 res_lo, res_hi;
-         __m64 res_lo_bg, res_hi_bg, res_lo_ra, res_hi_ra;
-         const __m64 in = *((__m64*)(input + w));
-         __m64          r = _mm_and_si64(_mm_srli_pi16(in, 2), pix_mask_r);
-         __m64          g = _mm_and_si64(in, pix_mask_g);
-         __m64          b = _mm_and_si64(_mm_slli_pi16(in, 4), pix_mask_b);
-
-         r                = _mm_mulhi_pi16(r, mul16_r);
-         g                = _mm_mulhi_pi16(g, mul16_g);
-         b                = _mm_mulhi_pi16(b, mul16_b);
-
-         res_lo_bg        = _mm_unpacklo_pi8(b, g);
-         res_hi_bg        = _mm_unpackhi_pi8(b, g);
-         res_lo_ra        = _mm_unpacklo_pi8(r, a);
-         res_hi_ra        = _mm_unpackhi_pi8(r, a);
-
-         res_lo           = _mm_or_si64(res_lo_bg,
-               _mm_slli_si64(res_lo_ra, 16));
-         res_hi           = _mm_or_si64(res_hi_bg,
-               _mm_slli_si64(res_hi_ra, 16));
-
-         *((__m64*)(output + w + 0)) = res_lo;
-         *((__m64*)(output + w + 2)) = res_hi;
-      }
-
-      _mm_empty();
-#endif
-
-      for (; w < width; w++)
+      for (w = 0; w < width; w++)
       {
          uint32_t col = input[w];
          uint32_t r   = (col >> 12) & 0xf;
@@ -498,6 +605,54 @@ void conv_rgba4444_argb8888(void *output_, const void *input_,
    }
 }
 
+void conv_rgba4444_argb8888(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint32_t *output      = (uint32_t*)output_;
+
+#if defined(__SSE2__)
+   const __m128i nib_mask = _mm_set1_epi16(0x0f0f);
+   const __m128i lo_mask  = _mm_set1_epi16(0x00ff);
+   const __m128i hi_mask  = _mm_set1_epi16((int16_t)0xff00);
+   int max_width          = width - 7;
+#endif
+
+   for (h = 0; h < height;
+         h++, output += out_stride >> 2, input += in_stride >> 1)
+   {
+      int w = 0;
+#if defined(__SSE2__)
+      for (; w < max_width; w += 8)
+      {
+         const __m128i in = _mm_loadu_si128((const __m128i*)(input + w));
+         /* Bytes of each 16-bit lane: (b, r) and (a, g) nibbles,
+          * widened to 8 bits by replicating them. */
+         __m128i br       = _mm_and_si128(_mm_srli_epi16(in, 4), nib_mask);
+         __m128i ag       = _mm_and_si128(in, nib_mask);
+         __m128i bg, ra;
+
+         br               = _mm_or_si128(br, _mm_slli_epi16(br, 4));
+         ag               = _mm_or_si128(ag, _mm_slli_epi16(ag, 4));
+
+         bg               = _mm_or_si128(_mm_and_si128(br, lo_mask),
+               _mm_and_si128(ag, hi_mask));
+         ra               = _mm_or_si128(_mm_srli_epi16(br, 8),
+               _mm_slli_epi16(ag, 8));
+
+         _mm_storeu_si128((__m128i*)(output + w + 0),
+               _mm_unpacklo_epi16(bg, ra));
+         _mm_storeu_si128((__m128i*)(output + w + 4),
+               _mm_unpackhi_epi16(bg, ra));
+      }
+#endif
+
+      conv_rgba4444_argb8888_c(output + w, input + w, width - w, 1, 0, 0);
+   }
+}
+
 void conv_rgba4444_rgb565(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -568,6 +723,35 @@ static INLINE void store_bgr24_sse2(void *output, __m128i a,
 }
 #endif
 
+static void conv_0rgb1555_bgr24_c(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h, w;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint8_t *output      = (uint8_t*)output_;
+
+   for (h = 0; h < height;
+         h++, output += out_stride, input += in_stride >> 1)
+   {
+      uint8_t *out = output;
+      for (w = 0; w < width; w++)
+      {
+         uint32_t col = input[w];
+         uint32_t b   = (col >>  0) & 0x1f;
+         uint32_t g   = (col >>  5) & 0x1f;
+         uint32_t r   = (col >> 10) & 0x1f;
+         b            = (b << 3) | (b >> 2);
+         g            = (g << 3) | (g >> 2);
+         r            = (r << 3) | (r >> 2);
+
+         *out++       = b;
+         *out++       = g;
+         *out++       = r;
+      }
+   }
+}
+
 void conv_0rgb1555_bgr24(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -637,19 +821,35 @@ void conv_0rgb1555_bgr24(void *output_, const void *input_,
       }
 #endif
 
-      for (; w < width; w++)
-      {
-         uint32_t col = input[w];
-         uint32_t b   = (col >>  0) & 0x1f;
-         uint32_t g   = (col >>  5) & 0x1f;
-         uint32_t r   = (col >> 10) & 0x1f;
-         b            = (b << 3) | (b >> 2);
-         g            = (g << 3) | (g >> 2);
-         r            = (r << 3) | (r >> 2);
+      conv_0rgb1555_bgr24_c(out, input + w, width - w, 1, 0, 0);
+   }
+}
 
-         *out++       = b;
-         *out++       = g;
-         *out++       = r;
+static void conv_rgb565_bgr24_c(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h, w;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint8_t *output      = (uint8_t*)output_;
+
+   for (h = 0; h < height;
+         h++, output += out_stride, input += in_stride >> 1)
+   {
+      uint8_t *out = output;
+      for (w = 0; w < width; w++)
+      {
+         uint32_t col = input[w];
+         uint32_t r   = (col >> 11) & 0x1f;
+         uint32_t g   = (col >>  5) & 0x3f;
+         uint32_t b   = (col >>  0) & 0x1f;
+         r = (r << 3) | (r >> 2);
+         g = (g << 2) | (g >> 4);
+         b = (b << 3) | (b >> 2);
+
+         *out++ = b;
+         *out++ = g;
+         *out++ = r;
       }
    }
 }
@@ -722,20 +922,7 @@ void conv_rgb565_bgr24(void *output_, const void *input_,
       }
 #endif
 
-      for (; w < width; w++)
-      {
-         uint32_t col = input[w];
-         uint32_t r   = (col >> 11) & 0x1f;
-         uint32_t g   = (col >>  5) & 0x3f;
-         uint32_t b   = (col >>  0) & 0x1f;
-         r = (r << 3) | (r >> 2);
-         g = (g << 2) | (g >> 4);
-         b = (b << 3) | (b >> 2);
-
-         *out++ = b;
-         *out++ = g;
-         *out++ = r;
-      }
+      conv_rgb565_bgr24_c(out, input + w, width - w, 1, 0, 0);
    }
 }
 
@@ -805,6 +992,28 @@ void conv_argb8888_0rgb1555(void *output_, const void *input_,
    }
 }
 
+static void conv_argb8888_bgr24_c(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h, w;
+   const uint32_t *input = (const uint32_t*)input_;
+   uint8_t *output      = (uint8_t*)output_;
+
+   for (h = 0; h < height;
+         h++, output += out_stride, input += in_stride >> 2)
+   {
+      uint8_t *out = output;
+      for (w = 0; w < width; w++)
+      {
+         uint32_t col = input[w];
+         *out++       = (uint8_t)(col >>  0);
+         *out++       = (uint8_t)(col >>  8);
+         *out++       = (uint8_t)(col >> 16);
+      }
+   }
+}
+
 void conv_argb8888_bgr24(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -813,7 +1022,7 @@ void conv_argb8888_bgr24(void *output_, const void *input_,
    const uint32_t *input = (const uint32_t*)input_;
    uint8_t *output       = (uint8_t*)output_;
 
-#if defined(__SSE2__)
+#if defined(__SSE2__) || (defined(__ARM_NEON__) || defined(__ARM_NEON))
    int max_width = width - 15;
 #endif
 
@@ -831,15 +1040,19 @@ void conv_argb8888_bgr24(void *output_, const void *input_,
          __m128i l3 = _mm_loadu_si128((const __m128i*)(input + w + 12));
          store_bgr24_sse2(out, l0, l1, l2, l3);
       }
-#endif
-
-      for (; w < width; w++)
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 16, out += 48)
       {
-         uint32_t col = input[w];
-         *out++       = (uint8_t)(col >>  0);
-         *out++       = (uint8_t)(col >>  8);
-         *out++       = (uint8_t)(col >> 16);
+         uint8x16x4_t in = vld4q_u8((const uint8_t*)(input + w));
+         uint8x16x3_t res;
+         res.val[0]      = in.val[0];
+         res.val[1]      = in.val[1];
+         res.val[2]      = in.val[2];
+         vst3q_u8(out, res);
       }
+#endif
+
+      conv_argb8888_bgr24_c(out, input + w, width - w, 1, 0, 0);
    }
 }
 
@@ -858,6 +1071,28 @@ static INLINE __m128i conv_shuffle_rb_epi32(__m128i c)
 }
 #endif
 
+static void conv_abgr8888_bgr24_c(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h, w;
+   const uint32_t *input = (const uint32_t*)input_;
+   uint8_t *output      = (uint8_t*)output_;
+
+   for (h = 0; h < height;
+         h++, output += out_stride, input += in_stride >> 2)
+   {
+      uint8_t *out = output;
+      for (w = 0; w < width; w++)
+      {
+         uint32_t col = input[w];
+         *out++       = (uint8_t)(col >> 16);
+         *out++       = (uint8_t)(col >>  8);
+         *out++       = (uint8_t)(col >>  0);
+      }
+   }
+}
+
 void conv_abgr8888_bgr24(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -890,17 +1125,11 @@ void conv_abgr8888_bgr24(void *output_, const void *input_,
       }
 #endif
 
-      for (; w < width; w++)
-      {
-         uint32_t col = input[w];
-         *out++       = (uint8_t)(col >> 16);
-         *out++       = (uint8_t)(col >>  8);
-         *out++       = (uint8_t)(col >>  0);
-      }
+      conv_abgr8888_bgr24_c(out, input + w, width - w, 1, 0, 0);
    }
 }
 
-void conv_argb8888_abgr8888(void *output_, const void *input_,
+static void conv_argb8888_abgr8888_c(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
@@ -920,6 +1149,61 @@ void conv_argb8888_abgr8888(void *output_, const void *input_,
    }
 }
 
+void conv_argb8888_abgr8888(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h;
+   const uint32_t *input = (const uint32_t*)input_;
+   uint32_t *output      = (uint32_t*)output_;
+
+#if defined(__SSE2__)
+   const __m128i ag_mask = _mm_set1_epi32(0xff00ff00);
+   const __m128i b_mask  = _mm_set1_epi32(0x000000ff);
+   const __m128i r_mask  = _mm_set1_epi32(0x00ff0000);
+   int max_width         = width - 3;
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   int max_width         = width - 15;
+#elif defined(__wasm_simd128__)
+   int max_width         = width - 3;
+#endif
+
+   for (h = 0; h < height;
+         h++, output += out_stride >> 2, input += in_stride >> 2)
+   {
+      int w = 0;
+#if defined(__SSE2__)
+      for (; w < max_width; w += 4)
+      {
+         __m128i c  = _mm_loadu_si128((const __m128i*)(input + w));
+         __m128i ag = _mm_and_si128(c, ag_mask);
+         __m128i r  = _mm_and_si128(_mm_slli_epi32(c, 16), r_mask);
+         __m128i b  = _mm_and_si128(_mm_srli_epi32(c, 16), b_mask);
+         _mm_storeu_si128((__m128i*)(output + w),
+               _mm_or_si128(ag, _mm_or_si128(r, b)));
+      }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+      for (; w < max_width; w += 16)
+      {
+         uint8x16x4_t c = vld4q_u8((const uint8_t*)(input + w));
+         uint8x16_t tmp = c.val[0];
+         c.val[0]       = c.val[2];
+         c.val[2]       = tmp;
+         vst4q_u8((uint8_t*)(output + w), c);
+      }
+#elif defined(__wasm_simd128__)
+      for (; w < max_width; w += 4)
+      {
+         v128_t c = wasm_v128_load(input + w);
+         wasm_v128_store(output + w, wasm_i8x16_shuffle(c, c,
+                  2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15));
+      }
+#endif
+
+      conv_argb8888_abgr8888_c(output + w, input + w, width - w, 1, 0, 0);
+   }
+}
+
 #define YUV_SHIFT 6
 #define YUV_OFFSET (1 << (YUV_SHIFT - 1))
 #define YUV_MAT_Y (1 << 6)
@@ -928,6 +1212,40 @@ void conv_argb8888_abgr8888(void *output_, const void *input_,
 #define YUV_MAT_V_R (90)
 #define YUV_MAT_V_G (-46)
 
+static void conv_yuyv_argb8888_c(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h, w;
+   const uint8_t *input = (const uint8_t*)input_;
+   uint32_t *output      = (uint32_t*)output_;
+
+   for (h = 0; h < height;
+         h++, output += out_stride >> 2, input += in_stride)
+   {
+      const uint8_t *src = input;
+      uint32_t      *dst = output;
+      for (w = 0; w < width; w += 2, src += 4, dst += 2)
+      {
+         int _y0    = src[0];
+         int  u     = src[1] - 128;
+         int _y1    = src[2];
+         int  v     = src[3] - 128;
+
+         uint8_t r0 = clamp_8bit((YUV_MAT_Y * _y0 +                   YUV_MAT_V_R * v + YUV_OFFSET) >> YUV_SHIFT);
+         uint8_t g0 = clamp_8bit((YUV_MAT_Y * _y0 + YUV_MAT_U_G * u + YUV_MAT_V_G * v + YUV_OFFSET) >> YUV_SHIFT);
+         uint8_t b0 = clamp_8bit((YUV_MAT_Y * _y0 + YUV_MAT_U_B * u                   + YUV_OFFSET) >> YUV_SHIFT);
+
+         uint8_t r1 = clamp_8bit((YUV_MAT_Y * _y1 +                   YUV_MAT_V_R * v + YUV_OFFSET) >> YUV_SHIFT);
+         uint8_t g1 = clamp_8bit((YUV_MAT_Y * _y1 + YUV_MAT_U_G * u + YUV_MAT_V_G * v + YUV_OFFSET) >> YUV_SHIFT);
+         uint8_t b1 = clamp_8bit((YUV_MAT_Y * _y1 + YUV_MAT_U_B * u                   + YUV_OFFSET) >> YUV_SHIFT);
+
+         dst[0]     = 0xff000000u | (r0 << 16) | (g0 << 8) | (b0 << 0);
+         dst[1]     = 0xff000000u | (r1 << 16) | (g1 << 8) | (b1 << 0);
+      }
+   }
+}
+
 void conv_yuyv_argb8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -1044,24 +1362,7 @@ void conv_yuyv_argb8888(void *output_, const void *input_,
 #endif
 
       /* Finish off the rest (if any) in C. */
-      for (; w < width; w += 2, src += 4, dst += 2)
-      {
-         int _y0    = src[0];
-         int  u     = src[1] - 128;
-         int _y1    = src[2];
-         int  v     = src[3] - 128;
-
-         uint8_t r0 = clamp_8bit((YUV_MAT_Y * _y0 +                   YUV_MAT_V_R * v + YUV_OFFSET) >> YUV_SHIFT);
-         uint8_t g0 = clamp_8bit((YUV_MAT_Y * _y0 + YUV_MAT_U_G * u + YUV_MAT_V_G * v + YUV_OFFSET) >> YUV_SHIFT);
-         uint8_t b0 = clamp_8bit((YUV_MAT_Y * _y0 + YUV_MAT_U_B * u                   + YUV_OFFSET) >> YUV_SHIFT);
-
-         uint8_t r1 = clamp_8bit((YUV_MAT_Y * _y1 +                   YUV_MAT_V_R * v + YUV_OFFSET) >> YUV_SHIFT);
-         uint8_t g1 = clamp_8bit((YUV_MAT_Y * _y1 + YUV_MAT_U_G * u + YUV_MAT_V_G * v + YUV_OFFSET) >> YUV_SHIFT);
-         uint8_t b1 = clamp_8bit((YUV_MAT_Y * _y1 + YUV_MAT_U_B * u                   + YUV_OFFSET) >> YUV_SHIFT);
-
-         dst[0]     = 0xff000000u | (r0 << 16) | (g0 << 8) | (b0 << 0);
-         dst[1]     = 0xff000000u | (r1 << 16) | (g1 << 8) | (b1 << 0);
-      }
+      conv_yuyv_argb8888_c(dst, src, width - w, 1, 0, 0);
    }
 }
 
@@ -1081,3 +1382,372 @@ void conv_copy(void *output_, const void *input_,
          h++, output += out_stride, input += in_stride)
       memcpy(output, input, copy_len);
 }
+
+#ifdef PIXCONV_HAVE_AVX2
+/* 256-bit unpacks work per 128-bit lane, so the two result
+ * vectors hold pixels 0-3/8-11 and 4-7/12-15; permute them back
+ * into order before storing. */
+PIXCONV_AVX2_TARGET
+static void conv_rgb565_argb8888_avx2(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h;
+   const uint16_t *input    = (const uint16_t*)input_;
+   uint32_t *output         = (uint32_t*)output_;
+   const __m256i pix_mask_r = _mm256_set1_epi16(0x1f << 10);
+   const __m256i pix_mask_g = _mm256_set1_epi16(0x3f <<  5);
+   const __m256i pix_mask_b = _mm256_set1_epi16(0x1f <<  5);
+   const __m256i mul16_r    = _mm256_set1_epi16(0x0210);
+   const __m256i mul16_g    = _mm256_set1_epi16(0x2080);
+   const __m256i mul16_b    = _mm256_set1_epi16(0x4200);
+   const __m256i a          = _mm256_set1_epi16(0x00ff);
+   int max_width            = width - 15;
+
+   for (h = 0; h < height;
+         h++, output += out_stride >> 2, input += in_stride >> 1)
+   {
+      int w = 0;
+      for (; w < max_width; w += 16)
+      {
+         __m256i res_lo, res_hi;
+         const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+         __m256i        r = _mm256_and_si256(_mm256_srli_epi16(in, 1), pix_mask_r);
+         __m256i        g = _mm256_and_si256(in, pix_mask_g);
+         __m256i        b = _mm256_and_si256(_mm256_slli_epi16(in, 5), pix_mask_b);
+
+         r                = _mm256_mulhi_epi16(r, mul16_r);
+         g                = _mm256_mulhi_epi16(g, mul16_g);
+         b                = _mm256_mulhi_epi16(b, mul16_b);
+
+         res_lo           = _mm256_or_si256(_mm256_unpacklo_epi8(b, g),
+               _mm256_slli_si256(_mm256_unpacklo_epi8(r, a), 2));
+         res_hi           = _mm256_or_si256(_mm256_unpackhi_epi8(b, g),
+               _mm256_slli_si256(_mm256_unpackhi_epi8(r, a), 2));
+
+         _mm256_storeu_si256((__m256i*)(output + w + 0),
+               _mm256_permute2x128_si256(res_lo, res_hi, 0x20));
+         _mm256_storeu_si256((__m256i*)(output + w + 8),
+               _mm256_permute2x128_si256(res_lo, res_hi, 0x31));
+      }
+
+      conv_rgb565_argb8888_c(output + w, input + w, width - w, 1, 0, 0);
+   }
+}
+
+PIXCONV_AVX2_TARGET
+static void conv_0rgb1555_argb8888_avx2(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h;
+   const uint16_t *input     = (const uint16_t*)input_;
+   uint32_t *output          = (uint32_t*)output_;
+   const __m256i pix_mask_r  = _mm256_set1_epi16(0x1f << 10);
+   const __m256i pix_mask_gb = _mm256_set1_epi16(0x1f <<  5);
+   const __m256i mul15_mid   = _mm256_set1_epi16(0x4200);
+   const __m256i mul15_hi    = _mm256_set1_epi16(0x0210);
+   const __m256i a           = _mm256_set1_epi16(0x00ff);
+   int max_width             = width - 15;
+
+   for (h = 0; h < height;
+         h++, output += out_stride >> 2, input += in_stride >> 1)
+   {
+      int w = 0;
+      for (; w < max_width; w += 16)
+      {
+         __m256i res_lo, res_hi;
+         const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+         __m256i r = _mm256_and_si256(in, pix_mask_r);
+         __m256i g = _mm256_and_si256(in, pix_mask_gb);
+         __m256i b = _mm256_and_si256(_mm256_slli_epi16(in, 5), pix_mask_gb);
+
+         r         = _mm256_mulhi_epi16(r, mul15_hi);
+         g         = _mm256_mulhi_epi16(g, mul15_mid);
+         b         = _mm256_mulhi_epi16(b, mul15_mid);
+
+         res_lo    = _mm256_or_si256(_mm256_unpacklo_epi8(b, g),
+               _mm256_slli_si256(_mm256_unpacklo_epi8(r, a), 2));
+         res_hi    = _mm256_or_si256(_mm256_unpackhi_epi8(b, g),
+               _mm256_slli_si256(_mm256_unpackhi_epi8(r, a), 2));
+
+         _mm256_storeu_si256((__m256i*)(output + w + 0),
+               _mm256_permute2x128_si256(res_lo, res_hi, 0x20));
+         _mm256_storeu_si256((__m256i*)(output + w + 8),
+               _mm256_permute2x128_si256(res_lo, res_hi, 0x31));
+      }
+
+      conv_0rgb1555_argb8888_c(output + w, input + w, width - w, 1, 0, 0);
+   }
+}
+
+PIXCONV_AVX2_TARGET
+static void conv_0rgb1555_rgb565_avx2(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h;
+   const uint16_t *input   = (const uint16_t*)input_;
+   uint16_t *output        = (uint16_t*)output_;
+   const __m256i hi_mask   = _mm256_set1_epi16(
+         (int16_t)((0x1f << 11) | (0x1f << 6)));
+   const __m256i lo_mask   = _mm256_set1_epi16(0x1f);
+   const __m256i glow_mask = _mm256_set1_epi16(1 << 5);
+   int max_width           = width - 15;
+
+   for (h = 0; h < height;
+         h++, output += out_stride >> 1, input += in_stride >> 1)
+   {
+      int w = 0;
+      for (; w < max_width; w += 16)
+      {
+         const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+         __m256i rg   = _mm256_and_si256(_mm256_slli_epi16(in, 1), hi_mask);
+         __m256i b    = _mm256_and_si256(in, lo_mask);
+         __m256i glow = _mm256_and_si256(_mm256_srli_epi16(in, 4), glow_mask);
+         _mm256_storeu_si256((__m256i*)(output + w),
+               _mm256_or_si256(rg, _mm256_or_si256(b, glow)));
+      }
+
+      conv_0rgb1555_rgb565_c(output + w, input + w, width - w, 1, 0, 0);
+   }
+}
+
+PIXCONV_AVX2_TARGET
+static void conv_rgb565_0rgb1555_avx2(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h;
+   const uint16_t *input = (const uint16_t*)input_;
+   uint16_t *output      = (uint16_t*)output_;
+   const __m256i hi_mask = _mm256_set1_epi16(0x7fe0);
+   const __m256i lo_mask = _mm256_set1_epi16(0x1f);
+   int max_width         = width - 15;
+
+   for (h = 0; h < height;
+         h++, output += out_stride >> 1, input += in_stride >> 1)
+   {
+      int w = 0;
+      for (; w < max_width; w += 16)
+      {
+         const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+         __m256i hi = _mm256_and_si256(_mm256_srli_epi16(in, 1), hi_mask);
+         __m256i lo = _mm256_and_si256(in, lo_mask);
+         _mm256_storeu_si256((__m256i*)(output + w), _mm256_or_si256(hi, lo));
+      }
+
+      conv_rgb565_0rgb1555_c(output + w, input + w, width - w, 1, 0, 0);
+   }
+}
+
+PIXCONV_AVX2_TARGET
+static void conv_argb8888_abgr8888_avx2(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h;
+   const uint32_t *input = (const uint32_t*)input_;
+   uint32_t *output      = (uint32_t*)output_;
+   const __m256i shuf    = _mm256_setr_epi8(
+          2,  1,  0,  3,  6,  5,  4,  7, 10,  9,  8, 11, 14, 13, 12, 15,
+          2,  1,  0,  3,  6,  5,  4,  7, 10,  9,  8, 11, 14, 13, 12, 15);
+   int max_width         = width - 7;
+
+   for (h = 0; h < height;
+         h++, output += out_stride >> 2, input += in_stride >> 2)
+   {
+      int w = 0;
+      for (; w < max_width; w += 8)
+      {
+         const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+         _mm256_storeu_si256((__m256i*)(output + w),
+               _mm256_shuffle_epi8(in, shuf));
+      }
+
+      conv_argb8888_abgr8888_c(output + w, input + w, width - w, 1, 0, 0);
+   }
+}
+#endif
+
+#ifdef PIXCONV_HAVE_AVX2
+#define PIXCONV_AVX2(fn) fn##_avx2
+#else
+#define PIXCONV_AVX2(fn) NULL
+#endif
+
+/* The exported conv_* functions carry whichever 128-bit path the
+ * compiler targets, so they fill the matching ISA slot. */
+#if defined(__SSE2__)
+#define PIXCONV_SSE2(fn) fn
+#else
+#define PIXCONV_SSE2(fn) NULL
+#endif
+
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define PIXCONV_NEON(fn) fn
+#else
+#define PIXCONV_NEON(fn) NULL
+#endif
+
+#if defined(__wasm_simd128__)
+#define PIXCONV_WASM(fn) fn
+#else
+#define PIXCONV_WASM(fn) NULL
+#endif
+
+struct pixconv_kernel
+{
+   enum scaler_pix_fmt in_fmt;
+   enum scaler_pix_fmt out_fmt;
+   pixconv_fn_t isa[PIXCONV_ISA_LAST];
+};
+
+static const struct pixconv_kernel pixconv_kernels[] = {
+   { SCALER_FMT_0RGB1555, SCALER_FMT_ARGB8888, {
+      conv_0rgb1555_argb8888_c,
+      PIXCONV_SSE2(conv_0rgb1555_argb8888),
+      PIXCONV_AVX2(conv_0rgb1555_argb8888),
+      NULL,
+      NULL } },
+   { SCALER_FMT_0RGB1555, SCALER_FMT_RGB565, {
+      conv_0rgb1555_rgb565_c,
+      PIXCONV_SSE2(conv_0rgb1555_rgb565),
+      PIXCONV_AVX2(conv_0rgb1555_rgb565),
+      PIXCONV_NEON(conv_0rgb1555_rgb565),
+      PIXCONV_WASM(conv_0rgb1555_rgb565) } },
+   { SCALER_FMT_0RGB1555, SCALER_FMT_BGR24, {
+      conv_0rgb1555_bgr24_c,
+      PIXCONV_SSE2(conv_0rgb1555_bgr24),
+      NULL,
+      NULL,
+      NULL } },
+   { SCALER_FMT_RGB565, SCALER_FMT_ARGB8888, {
+      conv_rgb565_argb8888_c,
+      PIXCONV_SSE2(conv_rgb565_argb8888),
+      PIXCONV_AVX2(conv_rgb565_argb8888),
+      PIXCONV_NEON(conv_rgb565_argb8888),
+      NULL } },
+   { SCALER_FMT_RGB565, SCALER_FMT_ABGR8888, {
+      conv_rgb565_abgr8888_c,
+      PIXCONV_SSE2(conv_rgb565_abgr8888),
+      NULL,
+      PIXCONV_NEON(conv_rgb565_abgr8888),
+      NULL } },
+   { SCALER_FMT_RGB565, SCALER_FMT_BGR24, {
+      conv_rgb565_bgr24_c,
+      PIXCONV_SSE2(conv_rgb565_bgr24),
+      NULL,
+      NULL,
+      NULL } },
+   { SCALER_FMT_RGB565, SCALER_FMT_0RGB1555, {
+      conv_rgb565_0rgb1555_c,
+      PIXCONV_SSE2(conv_rgb565_0rgb1555),
+      PIXCONV_AVX2(conv_rgb565_0rgb1555),
+      PIXCONV_NEON(conv_rgb565_0rgb1555),
+      PIXCONV_WASM(conv_rgb565_0rgb1555) } },
+   { SCALER_FMT_BGR24, SCALER_FMT_ARGB8888, {
+      conv_bgr24_argb8888, NULL, NULL, NULL, NULL } },
+   { SCALER_FMT_BGR24, SCALER_FMT_RGB565, {
+      conv_bgr24_rgb565, NULL, NULL, NULL, NULL } },
+   { SCALER_FMT_ARGB8888, SCALER_FMT_0RGB1555, {
+      conv_argb8888_0rgb1555, NULL, NULL, NULL, NULL } },
+   { SCALER_FMT_ARGB8888, SCALER_FMT_BGR24, {
+      conv_argb8888_bgr24_c,
+      PIXCONV_SSE2(conv_argb8888_bgr24),
+      NULL,
+      PIXCONV_NEON(conv_argb8888_bgr24),
+      NULL } },
+   { SCALER_FMT_ARGB8888, SCALER_FMT_ABGR8888, {
+      conv_argb8888_abgr8888_c,
+      PIXCONV_SSE2(conv_argb8888_abgr8888),
+      PIXCONV_AVX2(conv_argb8888_abgr8888),
+      PIXCONV_NEON(conv_argb8888_abgr8888),
+      PIXCONV_WASM(conv_argb8888_abgr8888) } },
+   { SCALER_FMT_ARGB8888, SCALER_FMT_RGBA4444, {
+      conv_argb8888_rgba4444, NULL, NULL, NULL, NULL } },
+   { SCALER_FMT_ABGR8888, SCALER_FMT_BGR24, {
+      conv_abgr8888_bgr24_c,
+      PIXCONV_SSE2(conv_abgr8888_bgr24),
+      NULL,
+      NULL,
+      NULL } },
+   { SCALER_FMT_YUYV, SCALER_FMT_ARGB8888, {
+      conv_yuyv_argb8888_c,
+      PIXCONV_SSE2(conv_yuyv_argb8888),
+      NULL,
+      NULL,
+      NULL } },
+   { SCALER_FMT_RGBA4444, SCALER_FMT_ARGB8888, {
+      conv_rgba4444_argb8888_c,
+      PIXCONV_SSE2(conv_rgba4444_argb8888),
+      NULL,
+      NULL,
+      NULL } },
+   { SCALER_FMT_RGBA4444, SCALER_FMT_RGB565, {
+      conv_rgba4444_rgb565, NULL, NULL, NULL, NULL } },
+};
+
+pixconv_fn_t pixconv_get_kernel(enum scaler_pix_fmt in_fmt,
+      enum scaler_pix_fmt out_fmt, enum pixconv_isa isa)
+{
+   size_t i;
+
+   if ((unsigned)isa >= PIXCONV_ISA_LAST)
+      return NULL;
+
+   for (i = 0; i < sizeof(pixconv_kernels) / sizeof(pixconv_kernels[0]); i++)
+   {
+      if (     pixconv_kernels[i].in_fmt  == in_fmt
+            && pixconv_kernels[i].out_fmt == out_fmt)
+         return pixconv_kernels[i].isa[isa];
+   }
+
+   return NULL;
+}
+
+pixconv_fn_t pixconv_get(enum scaler_pix_fmt in_fmt,
+      enum scaler_pix_fmt out_fmt)
+{
+   pixconv_fn_t fn   = NULL;
+#ifdef PIXCONV_HAVE_AVX2
+   uint64_t features = cpu_features_get();
+
+   if (features & RETRO_SIMD_AVX2)
+      fn = pixconv_get_kernel(in_fmt, out_fmt, PIXCONV_ISA_AVX2);
+#endif
+
+   /* The 128-bit paths are compiled in unconditionally when the
+    * target has them, so they need no runtime check. */
+   if (!fn)
+      fn = pixconv_get_kernel(in_fmt, out_fmt, PIXCONV_ISA_SSE2);
+   if (!fn)
+      fn = pixconv_get_kernel(in_fmt, out_fmt, PIXCONV_ISA_NEON);
+   if (!fn)
+      fn = pixconv_get_kernel(in_fmt, out_fmt, PIXCONV_ISA_WASM_SIMD);
+   if (!fn)
+      fn = pixconv_get_kernel(in_fmt, out_fmt, PIXCONV_ISA_C);
+
+   return fn;
+}
+
+const char *pixconv_isa_name(enum pixconv_isa isa)
+{
+   switch (isa)
+   {
+      case PIXCONV_ISA_C:
+         return "C";
+      case PIXCONV_ISA_SSE2:
+         return "SSE2";
+      case PIXCONV_ISA_AVX2:
+         return "AVX2";
+      case PIXCONV_ISA_NEON:
+         return "NEON";
+      case PIXCONV_ISA_WASM_SIMD:
+         return "WASM SIMD";
+      default:
+         break;
+   }
+
+   return "unknown";
+}
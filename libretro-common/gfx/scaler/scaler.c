@@ -29,13 +29,17 @@
 #include <gfx/scaler/scaler_int.h>
 #include <gfx/scaler/filter.h>
 #include <gfx/scaler/pixconv.h>
+#include <features/features_cpu.h>
 
-static bool allocate_frames(struct scaler_ctx *ctx)
+/* The horizontal pass only keeps the vert.filter_len rows the
+ * vertical pass is reading, each stored twice so that they are
+ * contiguous (see scaler_argb8888_sep_special). */
+static bool allocate_scaled_ring(struct scaler_ctx *ctx)
 {
    uint64_t *scaled_frame = NULL;
    ctx->scaled.stride     = ((ctx->out_width + 7) & ~7) * sizeof(uint64_t);
    ctx->scaled.width      = ctx->out_width;
-   ctx->scaled.height     = ctx->in_height;
+   ctx->scaled.height     = ctx->vert.filter_len * 2;
    scaled_frame           = (uint64_t*)calloc(sizeof(uint64_t),
             (ctx->scaled.stride * ctx->scaled.height) >> 3);
 
@@ -43,7 +47,11 @@ static bool allocate_frames(struct scaler_ctx *ctx)
       return false;
 
    ctx->scaled.frame      = scaled_frame;
+   return true;
+}
 
+static bool allocate_frames(struct scaler_ctx *ctx)
+{
    if (ctx->in_fmt != SCALER_FMT_ARGB8888)
    {
       uint32_t *input_frame = NULL;
@@ -93,110 +101,9 @@ bool scaler_ctx_gen_filter(struct scaler_ctx *ctx)
          ctx->direct_pixconv = conv_copy;
       else
       {
-         /* Bind a pixel converter callback function to the
+         /* Bind the fastest pixel converter the CPU supports to the
           * 'direct_pixconv' function pointer of the scaler context object. */
-         switch (ctx->in_fmt)
-         {
-            case SCALER_FMT_0RGB1555:
-               switch (ctx->out_fmt)
-               {
-                  case SCALER_FMT_ARGB8888:
-                     ctx->direct_pixconv = conv_0rgb1555_argb8888;
-                     break;
-                  case SCALER_FMT_RGB565:
-                     ctx->direct_pixconv = conv_0rgb1555_rgb565;
-                     break;
-                  case SCALER_FMT_BGR24:
-                     ctx->direct_pixconv = conv_0rgb1555_bgr24;
-                     break;
-                  default:
-                     break;
-               }
-               break;
-            case SCALER_FMT_RGB565:
-               switch (ctx->out_fmt)
-               {
-                  case SCALER_FMT_ARGB8888:
-                     ctx->direct_pixconv = conv_rgb565_argb8888;
-                     break;
-                  case SCALER_FMT_ABGR8888:
-                     ctx->direct_pixconv = conv_rgb565_abgr8888;
-                     break;
-                  case SCALER_FMT_BGR24:
-                     ctx->direct_pixconv = conv_rgb565_bgr24;
-                     break;
-                  case SCALER_FMT_0RGB1555:
-                     ctx->direct_pixconv = conv_rgb565_0rgb1555;
-                     break;
-                  default:
-                     break;
-               }
-               break;
-            case SCALER_FMT_BGR24:
-               switch (ctx->out_fmt)
-               {
-                  case SCALER_FMT_ARGB8888:
-                     ctx->direct_pixconv = conv_bgr24_argb8888;
-                     break;
-                  case SCALER_FMT_RGB565:
-                     ctx->direct_pixconv = conv_bgr24_rgb565;
-                  default:
-                     break;
-               }
-               break;
-            case SCALER_FMT_ARGB8888:
-               switch (ctx->out_fmt)
-               {
-                  case SCALER_FMT_0RGB1555:
-                     ctx->direct_pixconv = conv_argb8888_0rgb1555;
-                     break;
-                  case SCALER_FMT_BGR24:
-                     ctx->direct_pixconv = conv_argb8888_bgr24;
-                     break;
-                  case SCALER_FMT_ABGR8888:
-                     ctx->direct_pixconv = conv_argb8888_abgr8888;
-                     break;
-                  case SCALER_FMT_RGBA4444:
-                     ctx->direct_pixconv = conv_argb8888_rgba4444;
-                     break;
-                  default:
-                     break;
-               }
-               break;
-            case SCALER_FMT_YUYV:
-               switch (ctx->out_fmt)
-               {
-                  case SCALER_FMT_ARGB8888:
-                     ctx->direct_pixconv = conv_yuyv_argb8888;
-                     break;
-                  default:
-                     break;
-               }
-               break;
-            case SCALER_FMT_RGBA4444:
-               switch (ctx->out_fmt)
-               {
-                  case SCALER_FMT_ARGB8888:
-                     ctx->direct_pixconv = conv_rgba4444_argb8888;
-                     break;
-                  case SCALER_FMT_RGB565:
-                     ctx->direct_pixconv = conv_rgba4444_rgb565;
-                     break;
-                  default:
-                     break;
-               }
-               break;
-            case SCALER_FMT_ABGR8888:
-               switch (ctx->out_fmt)
-               {
-                  case SCALER_FMT_BGR24:
-                     ctx->direct_pixconv = conv_abgr8888_bgr24;
-                     break;
-                  default:
-                     break;
-               }
-               break;
-         }
+         ctx->direct_pixconv = pixconv_get(ctx->in_fmt, ctx->out_fmt);
 
          if (!ctx->direct_pixconv)
             return false;
@@ -204,63 +111,35 @@ bool scaler_ctx_gen_filter(struct scaler_ctx *ctx)
    }
    else
    {
-      ctx->scaler_horiz = scaler_argb8888_horiz;
-      ctx->scaler_vert  = scaler_argb8888_vert;
-
-      switch (ctx->in_fmt)
+      /* ARGB8888 needs no conversion on either side :D */
+      if (ctx->in_fmt != SCALER_FMT_ARGB8888)
       {
-         case SCALER_FMT_ARGB8888:
-            /* No need to convert :D */
-            break;
-
-         case SCALER_FMT_0RGB1555:
-            ctx->in_pixconv = conv_0rgb1555_argb8888;
-            break;
-
-         case SCALER_FMT_RGB565:
-            ctx->in_pixconv = conv_rgb565_argb8888;
-            break;
-
-         case SCALER_FMT_BGR24:
-            ctx->in_pixconv = conv_bgr24_argb8888;
-            break;
-
-         case SCALER_FMT_RGBA4444:
-            ctx->in_pixconv = conv_rgba4444_argb8888;
-            break;
-
-         default:
+         if (!(ctx->in_pixconv = pixconv_get(
+                     ctx->in_fmt, SCALER_FMT_ARGB8888)))
             return false;
       }
 
-      switch (ctx->out_fmt)
+      if (ctx->out_fmt != SCALER_FMT_ARGB8888)
       {
-         case SCALER_FMT_ARGB8888:
-            /* No need to convert :D */
-            break;
-
-         case SCALER_FMT_RGBA4444:
-            ctx->out_pixconv = conv_argb8888_rgba4444;
-            break;
-
-         case SCALER_FMT_0RGB1555:
-            ctx->out_pixconv = conv_argb8888_0rgb1555;
-            break;
-
-         case SCALER_FMT_BGR24:
-            ctx->out_pixconv = conv_argb8888_bgr24;
-            break;
-
-         case SCALER_FMT_ABGR8888:
-            ctx->out_pixconv = conv_argb8888_abgr8888;
-            break;
-
-         default:
+         if (!(ctx->out_pixconv = pixconv_get(
+                     SCALER_FMT_ARGB8888, ctx->out_fmt)))
             return false;
       }
 
       if (!scaler_gen_filter(ctx))
          return false;
+
+      /* Point sampling already picked its own path. */
+      if (!ctx->scaler_special)
+      {
+         if (!allocate_scaled_ring(ctx))
+            return false;
+
+         if (cpu_features_get() & RETRO_SIMD_AVX2)
+            ctx->scaler_special = scaler_argb8888_sep_avx2_special;
+         else
+            ctx->scaler_special = scaler_argb8888_sep_special;
+      }
    }
 
    return true;
@@ -337,20 +216,14 @@ void scaler_ctx_scale(struct scaler_ctx *ctx,
       output_stride = ctx->output.stride;
    }
 
-   /* Take some special, and (hopefully) more optimized path. */
+   /* Point sampling, or the fused separable filter picked
+    * by scaler_ctx_gen_filter(). Unscaled contexts have
+    * neither and go through scaler_ctx_scale_direct(). */
    if (ctx->scaler_special)
       ctx->scaler_special(ctx, output_frame, input_frame,
             ctx->out_width, ctx->out_height,
             ctx->in_width, ctx->in_height,
             output_stride, input_stride);
-   else
-   {
-      /* Take generic filter path. */
-      if (ctx->scaler_horiz)
-         ctx->scaler_horiz(ctx, input_frame, input_stride);
-      if (ctx->scaler_vert)
-         ctx->scaler_vert (ctx, output, output_stride);
-   }
 
    if (ctx->out_fmt != SCALER_FMT_ARGB8888)
       ctx->out_pixconv(output, ctx->output.frame,
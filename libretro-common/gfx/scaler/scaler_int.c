@@ -20,6 +20,8 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <string.h>
+
 #include <gfx/scaler/scaler_int.h>
 
 #include <retro_inline.h>
@@ -33,6 +35,25 @@
 #ifdef _WIN32
 #include <intrin.h>
 #endif
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#include <arm_neon.h>
+#endif
+
+/* AVX2 row kernels are built regardless of compiler flags, and only
+ * used through scaler_argb8888_sep_avx2_special(). */
+#if defined(__SSE2__) && (defined(__x86_64__) || defined(_M_X64))
+#if defined(__clang__) || (defined(__GNUC__) \
+      && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define SCALER_HAVE_AVX2
+#define SCALER_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && _MSC_VER >= 1900
+#define SCALER_HAVE_AVX2
+#define SCALER_AVX2_TARGET
+#endif
+#endif
+
+#ifdef SCALER_HAVE_AVX2
+#include <immintrin.h>
 #endif
 
 /* ARGB8888 scaler is split in two:
@@ -62,175 +83,444 @@
  * SIMD code for testing purposes.
  */
 
-void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int stride)
+/* Replicates a tap into all four 16-bit lanes of a 64-bit word. The
+ * tap is zero-extended first so negative sinc taps don't borrow into
+ * the upper lanes. */
+#define SCALER_COEFF64(c) \
+   ((long long)((uint64_t)(uint16_t)(c) * 0x0001000100010001ull))
+
+typedef void (*scaler_horiz_row_t)(const struct scaler_ctx *ctx,
+      const uint32_t *input, uint64_t *output);
+typedef void (*scaler_vert_row_t)(const struct scaler_ctx *ctx,
+      const uint64_t *input, int stride,
+      const int16_t *filter_vert, uint32_t *output);
+
+#if defined(__SSE2__)
+/* Pixels are processed two at a time, but the taps are summed into
+ * separate even and odd accumulators and only combined at the end,
+ * in the same order as the single pixel loop below. Saturating adds
+ * do not associate, so this keeps the result bit-identical. */
+static INLINE __m128i scaler_argb8888_vert_sse2(const uint64_t *input,
+      int stride, const int16_t *filter_vert, int filter_len)
 {
-   int h, w, y;
-   const uint64_t      *input = ctx->scaled.frame;
-   uint32_t           *output = (uint32_t*)output_;
+   int y;
+   __m128i res_even = _mm_setzero_si128();
+   __m128i res_odd  = _mm_setzero_si128();
 
-   const int16_t *filter_vert = ctx->vert.filter;
+   for (y = 0; (y + 1) < filter_len; y += 2, input += stride << 1)
+   {
+      __m128i col0  = _mm_loadu_si128((const __m128i*)input);
+      __m128i col1  = _mm_loadu_si128((const __m128i*)(input + stride));
 
-   for (h = 0; h < ctx->out_height; h++,
-         filter_vert += ctx->vert.filter_stride, output += stride >> 2)
+      res_even      = _mm_adds_epi16(_mm_mulhi_epi16(col0,
+               _mm_set1_epi16(filter_vert[y + 0])), res_even);
+      res_odd       = _mm_adds_epi16(_mm_mulhi_epi16(col1,
+               _mm_set1_epi16(filter_vert[y + 1])), res_odd);
+   }
+
+   if (y < filter_len)
    {
-      const uint64_t *input_base = input + ctx->vert.filter_pos[h]
-         * (ctx->scaled.stride >> 3);
+      __m128i col   = _mm_loadu_si128((const __m128i*)input);
+      res_even      = _mm_adds_epi16(_mm_mulhi_epi16(col,
+               _mm_set1_epi16(filter_vert[y])), res_even);
+   }
 
-      for (w = 0; w < ctx->out_width; w++)
+   return _mm_srai_epi16(_mm_adds_epi16(res_odd, res_even), (7 - 2 - 2));
+}
+#endif
+
+static void scaler_argb8888_vert_row(const struct scaler_ctx *ctx,
+      const uint64_t *input, int stride,
+      const int16_t *filter_vert, uint32_t *output)
+{
+   int w;
+   int width = ctx->out_width;
+#if defined(__SSE2__)
+   for (w = 0; (w + 1) < width; w += 2)
+   {
+      __m128i res = scaler_argb8888_vert_sse2(input + w, stride,
+            filter_vert, ctx->vert.filter_len);
+      _mm_storel_epi64((__m128i*)(output + w), _mm_packus_epi16(res, res));
+   }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+   for (w = 0; (w + 1) < width; w += 2)
+   {
+      /* vqdmulh is a saturating (a * b * 2) >> 16; halving it again
+       * gives the same result as an SSE2 mulhi for these inputs. */
+      int y;
+      int16x8_t res_even          = vdupq_n_s16(0);
+      int16x8_t res_odd           = vdupq_n_s16(0);
+      const uint64_t *input_base_y = input + w;
+
+      for (y = 0; (y + 1) < ctx->vert.filter_len; y += 2,
+            input_base_y += stride << 1)
       {
-         const uint64_t *input_base_y = input_base + w;
+         int16x8_t col0 = vreinterpretq_s16_u64(vld1q_u64(input_base_y));
+         int16x8_t col1 = vreinterpretq_s16_u64(vld1q_u64(input_base_y + stride));
+
+         res_even       = vqaddq_s16(vshrq_n_s16(vqdmulhq_n_s16(col0,
+                     filter_vert[y + 0]), 1), res_even);
+         res_odd        = vqaddq_s16(vshrq_n_s16(vqdmulhq_n_s16(col1,
+                     filter_vert[y + 1]), 1), res_odd);
+      }
+
+      if (y < ctx->vert.filter_len)
+      {
+         int16x8_t col  = vreinterpretq_s16_u64(vld1q_u64(input_base_y));
+         res_even       = vqaddq_s16(vshrq_n_s16(vqdmulhq_n_s16(col,
+                     filter_vert[y]), 1), res_even);
+      }
+
+      res_even = vshrq_n_s16(vqaddq_s16(res_odd, res_even), (7 - 2 - 2));
+      vst1_u8((uint8_t*)(output + w), vqmovun_s16(res_even));
+   }
+#else
+   w = 0;
+#endif
+
+   for (; w < width; w++)
+   {
+      const uint64_t *input_base_y = input + w;
 #if defined(__SSE2__)
-         __m128i final;
-         __m128i res = _mm_setzero_si128();
+      __m128i res = scaler_argb8888_vert_sse2(input_base_y, stride,
+            filter_vert, ctx->vert.filter_len);
+      /* Only the low pixel is wanted; the high one may be past
+       * the end of the row, but the row stride is padded. */
+      output[w]   = _mm_cvtsi128_si32(_mm_packus_epi16(res, res));
+#else
+      int y;
+      int16_t res_a = 0;
+      int16_t res_r = 0;
+      int16_t res_g = 0;
+      int16_t res_b = 0;
+
+      for (y = 0; y < ctx->vert.filter_len; y++,
+            input_base_y += stride)
+      {
+         uint64_t col   = *input_base_y;
 
-         for (y = 0; (y + 1) < ctx->vert.filter_len; y += 2,
-               input_base_y += (ctx->scaled.stride >> 2))
-         {
-            __m128i coeff = _mm_set_epi64x(filter_vert[y + 1] * 0x0001000100010001ll, filter_vert[y + 0] * 0x0001000100010001ll);
-            __m128i col   = _mm_set_epi64x(input_base_y[ctx->scaled.stride >> 3], input_base_y[0]);
+         int16_t a      = (col >> 48) & 0xffff;
+         int16_t r      = (col >> 32) & 0xffff;
+         int16_t g      = (col >> 16) & 0xffff;
+         int16_t b      = (col >>  0) & 0xffff;
 
-            res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
-         }
+         int16_t coeff  = filter_vert[y];
 
-         for (; y < ctx->vert.filter_len; y++, input_base_y += (ctx->scaled.stride >> 3))
-         {
-            __m128i coeff = _mm_set_epi64x(0, filter_vert[y] * 0x0001000100010001ll);
-            __m128i col   = _mm_set_epi64x(0, input_base_y[0]);
+         res_a         += (a * coeff) >> 16;
+         res_r         += (r * coeff) >> 16;
+         res_g         += (g * coeff) >> 16;
+         res_b         += (b * coeff) >> 16;
+      }
 
-            res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
-         }
+      res_a           >>= (7 - 2 - 2);
+      res_r           >>= (7 - 2 - 2);
+      res_g           >>= (7 - 2 - 2);
+      res_b           >>= (7 - 2 - 2);
 
-         res       = _mm_adds_epi16(_mm_srli_si128(res, 8), res);
-         res       = _mm_srai_epi16(res, (7 - 2 - 2));
+      output[w]         =
+         (clamp_8bit(res_a) << 24) |
+         (clamp_8bit(res_r) << 16) |
+         (clamp_8bit(res_g) << 8)  |
+         (clamp_8bit(res_b) << 0);
+#endif
+   }
+}
 
-         final     = _mm_packus_epi16(res, res);
 
-         output[w] = _mm_cvtsi128_si32(final);
-#else
-         int16_t res_a = 0;
-         int16_t res_r = 0;
-         int16_t res_g = 0;
-         int16_t res_b = 0;
+#if defined(__SSE2__)
+static INLINE __m128i scaler_argb8888_horiz_sse2(
+      const uint32_t *input_base_x, const int16_t *filter_horiz,
+      int filter_len)
+{
+   int x;
+   __m128i res = _mm_setzero_si128();
 
-         for (y = 0; y < ctx->vert.filter_len; y++,
-               input_base_y += (ctx->scaled.stride >> 3))
-         {
-            uint64_t col   = *input_base_y;
+   for (x = 0; (x + 1) < filter_len; x += 2)
+   {
+      __m128i coeff = _mm_set_epi64x(SCALER_COEFF64(filter_horiz[x + 1]), SCALER_COEFF64(filter_horiz[x + 0]));
 
-            int16_t a      = (col >> 48) & 0xffff;
-            int16_t r      = (col >> 32) & 0xffff;
-            int16_t g      = (col >> 16) & 0xffff;
-            int16_t b      = (col >>  0) & 0xffff;
+      __m128i col   = _mm_unpacklo_epi8(_mm_set_epi64x(0,
+               ((uint64_t)input_base_x[x + 1] << 32) | input_base_x[x + 0]), _mm_setzero_si128());
 
-            int16_t coeff  = filter_vert[y];
+      col           = _mm_slli_epi16(col, 7);
+      res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
+   }
 
-            res_a         += (a * coeff) >> 16;
-            res_r         += (r * coeff) >> 16;
-            res_g         += (g * coeff) >> 16;
-            res_b         += (b * coeff) >> 16;
-         }
+   for (; x < filter_len; x++)
+   {
+      __m128i coeff = _mm_set_epi64x(0, SCALER_COEFF64(filter_horiz[x]));
+      __m128i col   = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, 0, input_base_x[x]), _mm_setzero_si128());
 
-         res_a           >>= (7 - 2 - 2);
-         res_r           >>= (7 - 2 - 2);
-         res_g           >>= (7 - 2 - 2);
-         res_b           >>= (7 - 2 - 2);
+      col           = _mm_slli_epi16(col, 7);
+      res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
+   }
+
+   return _mm_adds_epi16(_mm_srli_si128(res, 8), res);
+}
 
-         output[w]         =
-            (clamp_8bit(res_a) << 24) |
-            (clamp_8bit(res_r) << 16) |
-            (clamp_8bit(res_g) << 8)  |
-            (clamp_8bit(res_b) << 0);
+static INLINE void scaler_argb8888_horiz_store_sse2(uint64_t *output,
+      __m128i res)
+{
+#ifdef __x86_64__
+   *output  = _mm_cvtsi128_si64(res);
+#else /* 32-bit doesn't have si64. Do it in two steps. */
+   union
+   {
+      uint32_t *u32;
+      uint64_t *u64;
+   } u;
+   u.u64    = output;
+   u.u32[0] = _mm_cvtsi128_si32(res);
+   u.u32[1] = _mm_cvtsi128_si32(_mm_srli_si128(res, 4));
 #endif
-      }
-   }
 }
+#endif
 
-void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int stride)
+static void scaler_argb8888_horiz_row(const struct scaler_ctx *ctx,
+      const uint32_t *input, uint64_t *output)
 {
-   int h, w, x;
-   const uint32_t *input = (uint32_t*)input_;
-   uint64_t *output      = ctx->scaled.frame;
+   int w;
+   const int16_t *filter_horiz = ctx->horiz.filter;
 
-   for (h = 0; h < ctx->scaled.height; h++, input += stride >> 2,
-         output += ctx->scaled.stride >> 3)
+#if defined(__SSE2__)
+   /* Bilinear: both taps fit in one register, no loop needed. */
+   if (ctx->horiz.filter_len == 2)
    {
-      const int16_t *filter_horiz = ctx->horiz.filter;
-
       for (w = 0; w < ctx->scaled.width; w++,
             filter_horiz += ctx->horiz.filter_stride)
       {
-         const uint32_t *input_base_x = input + ctx->horiz.filter_pos[w];
-#if defined(__SSE2__)
-         __m128i res = _mm_setzero_si128();
-#ifndef __x86_64__
-         union
-         {
-            uint32_t *u32;
-            uint64_t *u64;
-         } u;
+         __m128i coeff = _mm_unpacklo_epi64(
+               _mm_set1_epi16(filter_horiz[0]),
+               _mm_set1_epi16(filter_horiz[1]));
+         __m128i col   = _mm_unpacklo_epi8(_mm_loadl_epi64(
+                  (const __m128i*)(input + ctx->horiz.filter_pos[w])),
+               _mm_setzero_si128());
+         __m128i res   = _mm_mulhi_epi16(_mm_slli_epi16(col, 7), coeff);
+
+         scaler_argb8888_horiz_store_sse2(output + w,
+               _mm_adds_epi16(_mm_srli_si128(res, 8), res));
+      }
+      return;
+   }
 #endif
-         for (x = 0; (x + 1) < ctx->horiz.filter_len; x += 2)
-         {
-            __m128i coeff = _mm_set_epi64x(filter_horiz[x + 1] * 0x0001000100010001ll, filter_horiz[x + 0] * 0x0001000100010001ll);
 
-            __m128i col   = _mm_unpacklo_epi8(_mm_set_epi64x(0,
-                     ((uint64_t)input_base_x[x + 1] << 32) | input_base_x[x + 0]), _mm_setzero_si128());
+   for (w = 0; w < ctx->scaled.width; w++,
+         filter_horiz += ctx->horiz.filter_stride)
+   {
+      const uint32_t *input_base_x = input + ctx->horiz.filter_pos[w];
+#if defined(__SSE2__)
+      scaler_argb8888_horiz_store_sse2(output + w,
+            scaler_argb8888_horiz_sse2(input_base_x, filter_horiz,
+               ctx->horiz.filter_len));
+#else
+      int x;
+      int16_t res_a = 0;
+      int16_t res_r = 0;
+      int16_t res_g = 0;
+      int16_t res_b = 0;
 
-            col           = _mm_slli_epi16(col, 7);
-            res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
-         }
+      for (x = 0; x < ctx->horiz.filter_len; x++)
+      {
+         uint32_t col   = input_base_x[x];
 
-         for (; x < ctx->horiz.filter_len; x++)
-         {
-            __m128i coeff = _mm_set_epi64x(0, filter_horiz[x] * 0x0001000100010001ll);
-            __m128i col   = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, 0, input_base_x[x]), _mm_setzero_si128());
+         int16_t a      = (col >> (24 - 7)) & (0xff << 7);
+         int16_t r      = (col >> (16 - 7)) & (0xff << 7);
+         int16_t g      = (col >> ( 8 - 7)) & (0xff << 7);
+         int16_t b      = (col << ( 0 + 7)) & (0xff << 7);
 
-            col           = _mm_slli_epi16(col, 7);
-            res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
-         }
+         int16_t coeff  = filter_horiz[x];
 
-         res              = _mm_adds_epi16(_mm_srli_si128(res, 8), res);
+         res_a         += (a * coeff) >> 16;
+         res_r         += (r * coeff) >> 16;
+         res_g         += (g * coeff) >> 16;
+         res_b         += (b * coeff) >> 16;
+      }
 
-#ifdef __x86_64__
-         output[w]        = _mm_cvtsi128_si64(res);
-#else /* 32-bit doesn't have si64. Do it in two steps. */
-         u.u64    = output + w;
-         u.u32[0] = _mm_cvtsi128_si32(res);
-         u.u32[1] = _mm_cvtsi128_si32(_mm_srli_si128(res, 4));
+      output[w]         = (
+            (uint64_t)res_a  << 48)  |
+            ((uint64_t)res_r << 32)  |
+            ((uint64_t)res_g << 16)  |
+            ((uint64_t)res_b << 0);
 #endif
-#else
-         int16_t res_a = 0;
-         int16_t res_r = 0;
-         int16_t res_g = 0;
-         int16_t res_b = 0;
+   }
+}
 
-         for (x = 0; x < ctx->horiz.filter_len; x++)
-         {
-            uint32_t col   = input_base_x[x];
+#ifdef SCALER_HAVE_AVX2
+/* Same arithmetic as the SSE2 rows, with one 128-bit lane per
+ * output pixel (horizontal) or four pixels per register (vertical). */
+SCALER_AVX2_TARGET
+static void scaler_argb8888_horiz_row_avx2(const struct scaler_ctx *ctx,
+      const uint32_t *input, uint64_t *output)
+{
+   int w, x;
+   const int16_t *filter_horiz = ctx->horiz.filter;
+   int filter_stride           = ctx->horiz.filter_stride;
 
-            int16_t a      = (col >> (24 - 7)) & (0xff << 7);
-            int16_t r      = (col >> (16 - 7)) & (0xff << 7);
-            int16_t g      = (col >> ( 8 - 7)) & (0xff << 7);
-            int16_t b      = (col << ( 0 + 7)) & (0xff << 7);
+   for (w = 0; (w + 1) < ctx->scaled.width; w += 2,
+         filter_horiz += filter_stride << 1)
+   {
+      const uint32_t *input_base0 = input + ctx->horiz.filter_pos[w + 0];
+      const uint32_t *input_base1 = input + ctx->horiz.filter_pos[w + 1];
+      const int16_t *filter1      = filter_horiz + filter_stride;
+      __m256i res                 = _mm256_setzero_si256();
+      __m128i res_lo, res_hi;
 
-            int16_t coeff  = filter_horiz[x];
+      for (x = 0; (x + 1) < ctx->horiz.filter_len; x += 2)
+      {
+         __m256i coeff = _mm256_set_epi64x(
+               SCALER_COEFF64(filter1[x + 1]),
+               SCALER_COEFF64(filter1[x + 0]),
+               SCALER_COEFF64(filter_horiz[x + 1]),
+               SCALER_COEFF64(filter_horiz[x + 0]));
+         __m256i col   = _mm256_cvtepu8_epi16(_mm_set_epi64x(
+                  ((uint64_t)input_base1[x + 1] << 32) | input_base1[x + 0],
+                  ((uint64_t)input_base0[x + 1] << 32) | input_base0[x + 0]));
+
+         col           = _mm256_slli_epi16(col, 7);
+         res           = _mm256_adds_epi16(_mm256_mulhi_epi16(col, coeff), res);
+      }
 
-            res_a         += (a * coeff) >> 16;
-            res_r         += (r * coeff) >> 16;
-            res_g         += (g * coeff) >> 16;
-            res_b         += (b * coeff) >> 16;
-         }
+      for (; x < ctx->horiz.filter_len; x++)
+      {
+         __m256i coeff = _mm256_set_epi64x(0,
+               SCALER_COEFF64(filter1[x]), 0,
+               SCALER_COEFF64(filter_horiz[x]));
+         __m256i col   = _mm256_cvtepu8_epi16(_mm_set_epi64x(
+                  input_base1[x], input_base0[x]));
+
+         col           = _mm256_slli_epi16(col, 7);
+         res           = _mm256_adds_epi16(_mm256_mulhi_epi16(col, coeff), res);
+      }
+
+      res    = _mm256_adds_epi16(_mm256_srli_si256(res, 8), res);
+      res_lo = _mm256_castsi256_si128(res);
+      res_hi = _mm256_extracti128_si256(res, 1);
+      _mm_storel_epi64((__m128i*)(output + w + 0), res_lo);
+      _mm_storel_epi64((__m128i*)(output + w + 1), res_hi);
+   }
 
-         output[w]         = (
-               (uint64_t)res_a  << 48)  |
-               ((uint64_t)res_r << 32)  |
-               ((uint64_t)res_g << 16)  |
-               ((uint64_t)res_b << 0);
+   for (; w < ctx->scaled.width; w++, filter_horiz += filter_stride)
+      _mm_storel_epi64((__m128i*)(output + w), scaler_argb8888_horiz_sse2(
+               input + ctx->horiz.filter_pos[w], filter_horiz,
+               ctx->horiz.filter_len));
+}
+
+SCALER_AVX2_TARGET
+static void scaler_argb8888_vert_row_avx2(const struct scaler_ctx *ctx,
+      const uint64_t *input, int stride,
+      const int16_t *filter_vert, uint32_t *output)
+{
+   int w, y;
+   int width = ctx->out_width;
+
+   for (w = 0; (w + 3) < width; w += 4)
+   {
+      const uint64_t *input_base_y = input + w;
+      __m256i res_even             = _mm256_setzero_si256();
+      __m256i res_odd              = _mm256_setzero_si256();
+      __m256i res;
+
+      for (y = 0; (y + 1) < ctx->vert.filter_len; y += 2,
+            input_base_y += stride << 1)
+      {
+         __m256i col0 = _mm256_loadu_si256((const __m256i*)input_base_y);
+         __m256i col1 = _mm256_loadu_si256((const __m256i*)(input_base_y + stride));
+
+         res_even     = _mm256_adds_epi16(_mm256_mulhi_epi16(col0,
+                  _mm256_set1_epi16(filter_vert[y + 0])), res_even);
+         res_odd      = _mm256_adds_epi16(_mm256_mulhi_epi16(col1,
+                  _mm256_set1_epi16(filter_vert[y + 1])), res_odd);
+      }
+
+      if (y < ctx->vert.filter_len)
+      {
+         __m256i col  = _mm256_loadu_si256((const __m256i*)input_base_y);
+         res_even     = _mm256_adds_epi16(_mm256_mulhi_epi16(col,
+                  _mm256_set1_epi16(filter_vert[y])), res_even);
+      }
+
+      res = _mm256_srai_epi16(_mm256_adds_epi16(res_odd, res_even), (7 - 2 - 2));
+      /* Packing works per lane; gather the low half of each lane. */
+      res = _mm256_permute4x64_epi64(_mm256_packus_epi16(res, res), 0x08);
+      _mm_storeu_si128((__m128i*)(output + w), _mm256_castsi256_si128(res));
+   }
+
+   for (; w < width; w++)
+   {
+      __m128i res = scaler_argb8888_vert_sse2(input + w, stride,
+            filter_vert, ctx->vert.filter_len);
+      output[w]   = _mm_cvtsi128_si32(_mm_packus_epi16(res, res));
+   }
+}
 #endif
+
+/* Runs the horizontal pass on demand into a ring of filter_len rows
+ * instead of a whole intermediate frame, so the rows the vertical
+ * pass reads are still in cache. Every row is stored twice, filter_len
+ * rows apart, so the window for any output row is contiguous. */
+static INLINE void scaler_argb8888_sep(const struct scaler_ctx *ctx,
+      uint32_t *output, const uint32_t *input,
+      int out_stride, int in_stride,
+      scaler_horiz_row_t horiz_row, scaler_vert_row_t vert_row)
+{
+   int h;
+   int next_row               = 0;
+   int filter_len             = ctx->vert.filter_len;
+   int ring_stride            = ctx->scaled.stride >> 3;
+   uint64_t *ring             = ctx->scaled.frame;
+   const int16_t *filter_vert = ctx->vert.filter;
+
+   for (h = 0; h < ctx->out_height; h++,
+         filter_vert += ctx->vert.filter_stride, output += out_stride >> 2)
+   {
+      int pos = ctx->vert.filter_pos[h];
+
+      /* Rows older than the ring have been overwritten. */
+      if (pos < next_row - filter_len || pos > next_row)
+         next_row = pos;
+
+      for (; next_row < pos + filter_len; next_row++)
+      {
+         uint64_t *slot = ring + (next_row % filter_len) * ring_stride;
+
+         horiz_row(ctx, input + next_row * (in_stride >> 2), slot);
+         memcpy(slot + filter_len * ring_stride, slot,
+               ctx->scaled.width * sizeof(uint64_t));
       }
+
+      vert_row(ctx, ring + (pos % filter_len) * ring_stride, ring_stride,
+            filter_vert, output);
    }
 }
 
+void scaler_argb8888_sep_special(const struct scaler_ctx *ctx,
+      void *output, const void *input,
+      int out_width, int out_height,
+      int in_width, int in_height,
+      int out_stride, int in_stride)
+{
+   scaler_argb8888_sep(ctx, (uint32_t*)output, (const uint32_t*)input,
+         out_stride, in_stride,
+         scaler_argb8888_horiz_row, scaler_argb8888_vert_row);
+}
+
+void scaler_argb8888_sep_avx2_special(const struct scaler_ctx *ctx,
+      void *output, const void *input,
+      int out_width, int out_height,
+      int in_width, int in_height,
+      int out_stride, int in_stride)
+{
+#ifdef SCALER_HAVE_AVX2
+   scaler_argb8888_sep(ctx, (uint32_t*)output, (const uint32_t*)input,
+         out_stride, in_stride,
+         scaler_argb8888_horiz_row_avx2, scaler_argb8888_vert_row_avx2);
+#else
+   scaler_argb8888_sep(ctx, (uint32_t*)output, (const uint32_t*)input,
+         out_stride, in_stride,
+         scaler_argb8888_horiz_row, scaler_argb8888_vert_row);
+#endif
+}
+
 void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
       void *output_, const void *input_,
       int out_width, int out_height,
@@ -242,6 +532,8 @@ void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
    int x_step            = (1 << 16) * in_width / out_width;
    int y_pos             = (1 << 15) * in_height / out_height - (1 << 15);
    int y_step            = (1 << 16) * in_height / out_height;
+   int x_ratio           = 0;
+   int prev_y            = -1;
    const uint32_t *input = (const uint32_t*)input_;
    uint32_t *output      = (uint32_t*)output_;
 
@@ -250,12 +542,48 @@ void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
    if (y_pos < 0)
       y_pos = 0;
 
+   /* Integer upscale where the stepping below lands exactly on
+    * every source pixel; replicate runs instead of stepping. */
+   if (     x_pos == 0
+         && out_width % in_width == 0
+         && x_step * (out_width / in_width) == (1 << 16))
+      x_ratio = out_width / in_width;
+
    for (h = 0; h < out_height; h++, y_pos += y_step, output += out_stride >> 2)
    {
-      int               x = x_pos;
-      const uint32_t *inp = input + (y_pos >> 16) * (in_stride >> 2);
+      const uint32_t *inp;
+
+      /* Upscaled rows repeat; copy the previous output row. */
+      if ((y_pos >> 16) == prev_y)
+      {
+         memcpy(output, output - (out_stride >> 2),
+               out_width * sizeof(uint32_t));
+         continue;
+      }
 
-      for (w = 0; w < out_width; w++, x += x_step)
-         output[w] = inp[x >> 16];
+      prev_y = y_pos >> 16;
+      inp    = input + prev_y * (in_stride >> 2);
+
+      if (x_ratio == 2)
+      {
+         for (w = 0; w < out_width; w += 2, inp++)
+            output[w] = output[w + 1] = *inp;
+      }
+      else if (x_ratio)
+      {
+         for (w = 0; w < out_width; inp++)
+         {
+            int i;
+            uint32_t col = *inp;
+            for (i = 0; i < x_ratio; i++)
+               output[w++] = col;
+         }
+      }
+      else
+      {
+         int x = x_pos;
+         for (w = 0; w < out_width; w++, x += x_step)
+            output[w] = inp[x >> 16];
+      }
    }
 }
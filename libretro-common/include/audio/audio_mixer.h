@@ -85,6 +85,11 @@ void audio_mixer_voice_set_volume(audio_mixer_voice_t *voice, float val);
 
 void audio_mixer_mix(float* buffer, size_t num_frames, float volume_override, bool override);
 
+/* Same as audio_mixer_mix(), but leaves the result unclamped;
+ * for callers that saturate the buffer themselves afterwards,
+ * e.g. while converting it to integer samples. */
+void audio_mixer_mix_unclamped(float* buffer, size_t num_frames, float volume_override, bool override);
+
 RETRO_END_DECLS
 
 #endif
@@ -87,6 +87,14 @@ void image_transfer_set_buffer_ptr(
       void *ptr,
       size_t len);
 
+/* Hint that the image will be shrunk to fit (max_width x max_height),
+ * decoders that can produce a smaller image directly will do so */
+void image_transfer_set_max_size(
+      void *data,
+      enum image_type_enum type,
+      unsigned max_width,
+      unsigned max_height);
+
 int image_transfer_process(
       void *data,
       enum image_type_enum type,
@@ -39,6 +39,20 @@ int rjpeg_process_image(rjpeg_t *rjpeg, void **buf,
 
 bool rjpeg_set_buf_ptr(rjpeg_t *rjpeg, void *data);
 
+/**
+ * rjpeg_set_max_size:
+ * @rjpeg        : decoder handle.
+ * @max_width    : width the caller will shrink the image to fit, or 0.
+ * @max_height   : height the caller will shrink the image to fit, or 0.
+ *
+ * Lets the decoder output the image at 1/2, 1/4 or 1/8 scale,
+ * as long as it still covers what fits in (max_width x max_height).
+ * Only the needed DCT coefficients are transformed, so this is a
+ * lot cheaper than decoding at full size and shrinking after.
+ **/
+void rjpeg_set_max_size(rjpeg_t *rjpeg,
+      unsigned max_width, unsigned max_height);
+
 void rjpeg_free(rjpeg_t *rjpeg);
 
 rjpeg_t *rjpeg_alloc(void);
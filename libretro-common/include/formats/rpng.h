@@ -38,6 +38,8 @@ rpng_t *rpng_init(const char *path);
 
 bool rpng_is_valid(rpng_t *rpng);
 
+/* @data is not copied and must stay around
+ * until rpng_process_image() is done with it */
 bool rpng_set_buf_ptr(rpng_t *rpng, void *data, size_t len);
 
 rpng_t *rpng_alloc(void);
@@ -56,6 +58,20 @@ bool rpng_save_image_argb(const char *path, const uint32_t *data,
 bool rpng_save_image_bgr24(const char *path, const uint8_t *data,
       unsigned width, unsigned height, unsigned pitch);
 
+enum rpng_encode_flags
+{
+   /* Pick each row's filter from Sub and Up only, instead of
+    * trying all five. Much cheaper, slightly larger files. */
+   RPNG_ENCODE_FAST_FILTER = (1 << 0)
+};
+
+/* Like rpng_save_image_bgr24(), with @level the zlib compression
+ * level (0-9, or -1 for the default) and @flags a mask of
+ * enum rpng_encode_flags. A negative @pitch reads bottom-up. */
+bool rpng_save_image_bgr24_ex(const char *path, const uint8_t *data,
+      unsigned width, unsigned height, signed pitch,
+      int level, unsigned flags);
+
 uint8_t* rpng_save_image_bgr24_string(const uint8_t *data,
       unsigned width, unsigned height, signed pitch, uint64_t *bytes);
 
@@ -27,8 +27,24 @@
 
 #include <retro_common_api.h>
 
+#include <gfx/scaler/scaler.h>
+
 RETRO_BEGIN_DECLS
 
+typedef void (*pixconv_fn_t)(void *output, const void *input,
+      int width, int height,
+      int out_stride, int in_stride);
+
+enum pixconv_isa
+{
+   PIXCONV_ISA_C = 0,
+   PIXCONV_ISA_SSE2,
+   PIXCONV_ISA_AVX2,
+   PIXCONV_ISA_NEON,
+   PIXCONV_ISA_WASM_SIMD,
+   PIXCONV_ISA_LAST
+};
+
 void conv_0rgb1555_argb8888(void *output, const void *input,
       int width, int height,
       int out_stride, int in_stride);
@@ -105,6 +121,36 @@ void conv_copy(void *output, const void *input,
       int width, int height,
       int out_stride, int in_stride);
 
+/**
+ * pixconv_get_kernel:
+ * @in_fmt       : input pixel format.
+ * @out_fmt      : output pixel format.
+ * @isa          : instruction set of the requested kernel.
+ *
+ * Looks up the converter for a format pair built for one specific
+ * instruction set, regardless of what the running CPU supports.
+ *
+ * Returns: converter, or NULL if the pair has no kernel for @isa
+ * in this build.
+ **/
+pixconv_fn_t pixconv_get_kernel(enum scaler_pix_fmt in_fmt,
+      enum scaler_pix_fmt out_fmt, enum pixconv_isa isa);
+
+/**
+ * pixconv_get:
+ * @in_fmt       : input pixel format.
+ * @out_fmt      : output pixel format.
+ *
+ * Picks the fastest converter for a format pair that the running
+ * CPU can execute. Resolve this once at setup time, not per frame.
+ *
+ * Returns: converter, or NULL if the pair is not supported.
+ **/
+pixconv_fn_t pixconv_get(enum scaler_pix_fmt in_fmt,
+      enum scaler_pix_fmt out_fmt);
+
+const char *pixconv_isa_name(enum pixconv_isa isa);
+
 RETRO_END_DECLS
 
 #endif
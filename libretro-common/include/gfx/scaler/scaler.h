@@ -61,10 +61,6 @@ struct scaler_filter
 
 struct scaler_ctx
 {
-   void (*scaler_horiz)(const struct scaler_ctx*,
-         const void*, int);
-   void (*scaler_vert)(const struct scaler_ctx*,
-         void*, int);
    void (*scaler_special)(const struct scaler_ctx*,
          void*, const void*, int, int, int, int, int, int);
 
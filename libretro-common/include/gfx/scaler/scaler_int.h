@@ -29,13 +29,24 @@
 
 RETRO_BEGIN_DECLS
 
-void scaler_argb8888_vert(const struct scaler_ctx *ctx,
-      void *output, int stride);
+void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
+      void *output, const void *input,
+      int out_width, int out_height,
+      int in_width, int in_height,
+      int out_stride, int in_stride);
 
-void scaler_argb8888_horiz(const struct scaler_ctx *ctx,
-      const void *input, int stride);
+/* Fused horizontal + vertical pass through a ring buffer of
+ * vert.filter_len rows (see scaler_ctx_gen_filter). Output matches
+ * the old whole-frame horizontal then vertical passes bit for bit,
+ * see samples/gfx/scaler. */
+void scaler_argb8888_sep_special(const struct scaler_ctx *ctx,
+      void *output, const void *input,
+      int out_width, int out_height,
+      int in_width, int in_height,
+      int out_stride, int in_stride);
 
-void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
+/* Same, with AVX2 row kernels. Only call this when the CPU has AVX2. */
+void scaler_argb8888_sep_avx2_special(const struct scaler_ctx *ctx,
       void *output, const void *input,
       int out_width, int out_height,
       int in_width, int in_height,
@@ -0,0 +1,144 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (audio_mixer_bench.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Mixes 1 to AUDIO_MIXER_BENCH_MAX_VOICES looping WAV voices through
+ * audio_mixer_mix() and reports the cost per output frame. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <audio/audio_mixer.h>
+#include <features/features_cpu.h>
+
+#define AUDIO_MIXER_BENCH_RATE       48000
+#define AUDIO_MIXER_BENCH_FRAMES     1024
+#define AUDIO_MIXER_BENCH_ITERATIONS 2000
+#define AUDIO_MIXER_BENCH_MAX_VOICES 32
+
+static void write_le32(uint8_t *p, uint32_t v)
+{
+   p[0] = (uint8_t)(v >>  0);
+   p[1] = (uint8_t)(v >>  8);
+   p[2] = (uint8_t)(v >> 16);
+   p[3] = (uint8_t)(v >> 24);
+}
+
+static void write_le16(uint8_t *p, uint16_t v)
+{
+   p[0] = (uint8_t)(v >> 0);
+   p[1] = (uint8_t)(v >> 8);
+}
+
+/* Builds a 16-bit stereo WAV holding a one second sine tone */
+static uint8_t *make_wav(unsigned freq, size_t *len)
+{
+   size_t i;
+   size_t frames = AUDIO_MIXER_BENCH_RATE;
+   size_t data   = frames * 4;
+   uint8_t *wav  = (uint8_t*)malloc(44 + data);
+
+   if (!wav)
+      return NULL;
+
+   memcpy(wav +  0, "RIFF", 4);
+   write_le32(wav +  4, (uint32_t)(36 + data));
+   memcpy(wav +  8, "WAVEfmt ", 8);
+   write_le32(wav + 16, 16);
+   write_le16(wav + 20, 1);
+   write_le16(wav + 22, 2);
+   write_le32(wav + 24, AUDIO_MIXER_BENCH_RATE);
+   write_le32(wav + 28, AUDIO_MIXER_BENCH_RATE * 4);
+   write_le16(wav + 32, 4);
+   write_le16(wav + 34, 16);
+   memcpy(wav + 36, "data", 4);
+   write_le32(wav + 40, (uint32_t)data);
+
+   for (i = 0; i < frames; i++)
+   {
+      int16_t s = (int16_t)(8192.0 *
+            sin(2.0 * M_PI * freq * i / AUDIO_MIXER_BENCH_RATE));
+      write_le16(wav + 44 + i * 4 + 0, (uint16_t)s);
+      write_le16(wav + 44 + i * 4 + 2, (uint16_t)s);
+   }
+
+   *len = 44 + data;
+   return wav;
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned voices;
+   size_t wav_len                = 0;
+   uint8_t *wav                  = make_wav(440, &wav_len);
+   float *buffer                 = (float*)
+      malloc(AUDIO_MIXER_BENCH_FRAMES * 2 * sizeof(float));
+   audio_mixer_sound_t *sound    = NULL;
+
+   if (!wav || !buffer)
+      return 1;
+
+   audio_mixer_init(AUDIO_MIXER_BENCH_RATE);
+
+   if (!(sound = audio_mixer_load_wav(wav, (int32_t)wav_len,
+         "null", RESAMPLER_QUALITY_DONTCARE)))
+   {
+      fprintf(stderr, "Failed to load WAV.\n");
+      return 1;
+   }
+
+   for (voices = 1; voices <= AUDIO_MIXER_BENCH_MAX_VOICES; voices *= 2)
+   {
+      unsigned i;
+      retro_time_t start, elapsed;
+      audio_mixer_voice_t *handles[AUDIO_MIXER_BENCH_MAX_VOICES];
+
+      for (i = 0; i < voices; i++)
+         handles[i] = audio_mixer_play(sound, true, 0.5f,
+               "null", RESAMPLER_QUALITY_DONTCARE, NULL);
+
+      start = cpu_features_get_time_usec();
+      for (i = 0; i < AUDIO_MIXER_BENCH_ITERATIONS; i++)
+      {
+         /* Change the volume every block to exercise the gain ramps */
+         audio_mixer_voice_set_volume(handles[0], (i & 1) ? 0.25f : 0.5f);
+         memset(buffer, 0, AUDIO_MIXER_BENCH_FRAMES * 2 * sizeof(float));
+         audio_mixer_mix(buffer, AUDIO_MIXER_BENCH_FRAMES, 0.0f, false);
+      }
+      elapsed = cpu_features_get_time_usec() - start;
+
+      printf("voices: %2u, %8.3f ns/frame\n", voices,
+            (elapsed * 1000.0) /
+            ((double)AUDIO_MIXER_BENCH_ITERATIONS * AUDIO_MIXER_BENCH_FRAMES));
+
+      for (i = 0; i < voices; i++)
+         audio_mixer_stop(handles[i]);
+   }
+
+   audio_mixer_destroy(sound);
+   audio_mixer_done();
+   free(buffer);
+   free(wav);
+   return 0;
+}
@@ -0,0 +1,373 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (audio_pipeline_bench.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Headless benchmark of the frontend audio path.
+ *
+ * Synthetic core audio (a 1 kHz sine, delivered in video frame sized
+ * batches as a core would through audio_driver_sample_batch) goes through
+ * the same stages as audio_driver_flush: s16 to float conversion, an
+ * optional DSP filter chain, the resampler, the audio mixer and the final
+ * float to s16 conversion. The output is discarded, as with the null
+ * audio driver.
+ *
+ * Every resampler x DSP preset x mixer voice count combination is timed,
+ * and for the combinations without DSP or mixer voices the output is
+ * compared against an ideal sine to get SNR and THD. Results are written
+ * to stdout as JSON.
+ *
+ * Usage: audio_pipeline_bench [preset.dsp ...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <audio/audio_mixer.h>
+#include <audio/audio_resampler.h>
+#include <audio/dsp_filter.h>
+#include <audio/conversion/s16_to_float.h>
+#include <audio/conversion/float_to_s16.h>
+#include <features/features_cpu.h>
+#include <retro_miscellaneous.h>
+
+#define BENCH_CORE_RATE    32040
+#define BENCH_OUT_RATE     48000
+#define BENCH_FPS          60
+#define BENCH_TONE         1000.0
+#define BENCH_AMPLITUDE    0.5
+#define BENCH_SECONDS      10
+/* Output frames skipped before analysis, to let filters settle */
+#define BENCH_WARMUP       4800
+/* Output frames analysed; a whole number of periods of BENCH_TONE */
+#define BENCH_ANALYSIS     BENCH_OUT_RATE
+#define BENCH_HARMONICS    5
+#define BENCH_BATCH        ((BENCH_CORE_RATE + BENCH_FPS - 1) / BENCH_FPS)
+#define BENCH_MAX_OUT      (BENCH_BATCH * 4)
+
+struct bench_resampler
+{
+   const char *ident;
+   enum resampler_quality quality;
+   const char *quality_name;
+};
+
+static const struct bench_resampler bench_resamplers[] = {
+   { "nearest", RESAMPLER_QUALITY_DONTCARE, "dontcare" },
+   { "sinc",    RESAMPLER_QUALITY_LOWEST,   "lowest"   },
+   { "sinc",    RESAMPLER_QUALITY_NORMAL,   "normal"   },
+   { "sinc",    RESAMPLER_QUALITY_HIGHEST,  "highest"  },
+};
+
+static const unsigned bench_voices[] = { 0, 4, 16 };
+
+struct bench_quality
+{
+   double snr_db;
+   double thd_db;
+};
+
+static void write_le32(uint8_t *p, uint32_t v)
+{
+   p[0] = (uint8_t)(v >>  0);
+   p[1] = (uint8_t)(v >>  8);
+   p[2] = (uint8_t)(v >> 16);
+   p[3] = (uint8_t)(v >> 24);
+}
+
+static void write_le16(uint8_t *p, uint16_t v)
+{
+   p[0] = (uint8_t)(v >> 0);
+   p[1] = (uint8_t)(v >> 8);
+}
+
+/* Builds a quiet 16-bit stereo WAV (one second of noise) for mixer voices */
+static uint8_t *make_wav(size_t *len)
+{
+   size_t i;
+   uint32_t seed = 1;
+   size_t frames = BENCH_OUT_RATE;
+   size_t data   = frames * 4;
+   uint8_t *wav  = (uint8_t*)malloc(44 + data);
+
+   if (!wav)
+      return NULL;
+
+   memcpy(wav +  0, "RIFF", 4);
+   write_le32(wav +  4, (uint32_t)(36 + data));
+   memcpy(wav +  8, "WAVEfmt ", 8);
+   write_le32(wav + 16, 16);
+   write_le16(wav + 20, 1);
+   write_le16(wav + 22, 2);
+   write_le32(wav + 24, BENCH_OUT_RATE);
+   write_le32(wav + 28, BENCH_OUT_RATE * 4);
+   write_le16(wav + 32, 4);
+   write_le16(wav + 34, 16);
+   memcpy(wav + 36, "data", 4);
+   write_le32(wav + 40, (uint32_t)data);
+
+   for (i = 0; i < frames * 2; i++)
+   {
+      seed = seed * 1103515245 + 12345;
+      write_le16(wav + 44 + i * 2, (uint16_t)(int16_t)((seed >> 16) & 0x3ff));
+   }
+
+   *len = 44 + data;
+   return wav;
+}
+
+/* Power of the left channel at freq, on a whole number of periods */
+static double tone_power(const int16_t *s, size_t frames, double freq)
+{
+   size_t i;
+   double re = 0.0, im = 0.0;
+   double w  = 2.0 * M_PI * freq / BENCH_OUT_RATE;
+
+   for (i = 0; i < frames; i++)
+   {
+      re += s[i * 2] * cos(w * i);
+      im -= s[i * 2] * sin(w * i);
+   }
+
+   return 2.0 * (re * re + im * im) / ((double)frames * frames);
+}
+
+static void analyse(const int16_t *s, size_t frames, struct bench_quality *q)
+{
+   unsigned h;
+   size_t i;
+   double total = 0.0, mean = 0.0, harmonics = 0.0, fundamental;
+
+   for (i = 0; i < frames; i++)
+      mean  += s[i * 2];
+   mean     /= frames;
+   for (i = 0; i < frames; i++)
+      total += (s[i * 2] - mean) * (s[i * 2] - mean);
+   total    /= frames;
+
+   fundamental = tone_power(s, frames, BENCH_TONE);
+   for (h = 2; h <= BENCH_HARMONICS; h++)
+      if (BENCH_TONE * h < BENCH_OUT_RATE / 2)
+         harmonics += tone_power(s, frames, BENCH_TONE * h);
+
+   q->snr_db = 10.0 * log10(fundamental / MAX(total - fundamental, 1e-12));
+   q->thd_db = 10.0 * log10(MAX(harmonics, 1e-12) / fundamental);
+}
+
+static bool run(const struct bench_resampler *r, const char *dsp_path,
+      unsigned voices, audio_mixer_sound_t *sound,
+      double *ns_per_frame, struct bench_quality *q)
+{
+   unsigned i, batch;
+   size_t captured                   = 0;
+   size_t out_total                  = 0;
+   uint64_t in_frames                = 0;
+   retro_time_t elapsed              = 0;
+   double phase                      = 0.0;
+   void *re                          = NULL;
+   const retro_resampler_t *backend  = NULL;
+   retro_dsp_filter_t *dsp           = NULL;
+   double ratio                      = (double)BENCH_OUT_RATE / BENCH_CORE_RATE;
+   int16_t *in                       = (int16_t*)malloc(BENCH_BATCH * 2 * sizeof(int16_t));
+   float *in_float                   = (float*)malloc(BENCH_BATCH * 2 * sizeof(float));
+   float *out                        = (float*)malloc(BENCH_MAX_OUT * 2 * sizeof(float));
+   int16_t *out_s16                  = (int16_t*)malloc(BENCH_MAX_OUT * 2 * sizeof(int16_t));
+   int16_t *capture                  = (int16_t*)malloc((BENCH_ANALYSIS + BENCH_MAX_OUT) * 2 * sizeof(int16_t));
+   audio_mixer_voice_t *handles[16];
+
+   if (!in || !in_float || !out || !out_s16 || !capture)
+      goto error;
+
+   if (!retro_resampler_realloc(&re, &backend, r->ident, r->quality, ratio))
+      goto error;
+
+   if (dsp_path && !(dsp = retro_dsp_filter_new(dsp_path, NULL, BENCH_CORE_RATE)))
+   {
+      fprintf(stderr, "Failed to load DSP preset \"%s\".\n", dsp_path);
+      goto error;
+   }
+
+   for (i = 0; i < voices; i++)
+      handles[i] = audio_mixer_play(sound, true, 0.1f,
+            "null", RESAMPLER_QUALITY_DONTCARE, NULL);
+
+   for (batch = 0; batch < BENCH_SECONDS * BENCH_FPS; batch++)
+   {
+      retro_time_t start;
+      struct resampler_data src;
+
+      /* Synthetic core audio for one video frame */
+      for (i = 0; i < BENCH_BATCH; i++)
+      {
+         int16_t v  = (int16_t)(BENCH_AMPLITUDE * 32767.0 * sin(phase));
+         in[i * 2 + 0] = v;
+         in[i * 2 + 1] = v;
+         phase     += 2.0 * M_PI * BENCH_TONE / BENCH_CORE_RATE;
+      }
+      phase = fmod(phase, 2.0 * M_PI);
+
+      start             = cpu_features_get_time_usec();
+
+      convert_s16_to_float(in_float, in, BENCH_BATCH * 2, 1.0f);
+
+      src.data_in       = in_float;
+      src.input_frames  = BENCH_BATCH;
+
+      if (dsp)
+      {
+         struct retro_dsp_data dsp_data;
+
+         dsp_data.input         = in_float;
+         dsp_data.input_frames  = BENCH_BATCH;
+         dsp_data.output        = NULL;
+         dsp_data.output_frames = 0;
+
+         retro_dsp_filter_process(dsp, &dsp_data);
+
+         if (dsp_data.output)
+         {
+            src.data_in      = dsp_data.output;
+            src.input_frames = dsp_data.output_frames;
+         }
+      }
+
+      src.data_out      = out;
+      src.output_frames = 0;
+      src.ratio         = ratio;
+      backend->process(re, &src);
+
+      if (voices)
+         audio_mixer_mix_unclamped(out, src.output_frames, 0.0f, false);
+
+      convert_float_to_s16(out_s16, out, src.output_frames * 2);
+
+      elapsed          += cpu_features_get_time_usec() - start;
+      in_frames        += BENCH_BATCH;
+
+      /* Keep a window of the output for analysis */
+      if (     out_total + src.output_frames > BENCH_WARMUP
+            && captured < BENCH_ANALYSIS)
+      {
+         size_t skip = (out_total < BENCH_WARMUP) ? BENCH_WARMUP - out_total : 0;
+         memcpy(capture + captured * 2, out_s16 + skip * 2,
+               (src.output_frames - skip) * 2 * sizeof(int16_t));
+         captured += src.output_frames - skip;
+      }
+      out_total += src.output_frames;
+   }
+
+   for (i = 0; i < voices; i++)
+      audio_mixer_stop(handles[i]);
+
+   *ns_per_frame = (elapsed * 1000.0) / in_frames;
+   if (captured >= BENCH_ANALYSIS)
+      analyse(capture, BENCH_ANALYSIS, q);
+
+   retro_dsp_filter_free(dsp);
+   backend->free(re);
+   free(in);
+   free(in_float);
+   free(out);
+   free(out_s16);
+   free(capture);
+   return captured >= BENCH_ANALYSIS;
+
+error:
+   if (re && backend)
+      backend->free(re);
+   free(in);
+   free(in_float);
+   free(out);
+   free(out_s16);
+   free(capture);
+   return false;
+}
+
+int main(int argc, char *argv[])
+{
+   int d;
+   unsigned r, v;
+   bool first                 = true;
+   size_t wav_len             = 0;
+   uint8_t *wav               = make_wav(&wav_len);
+   audio_mixer_sound_t *sound = NULL;
+
+   if (!wav)
+      return 1;
+
+   convert_s16_to_float_init_simd();
+   convert_float_to_s16_init_simd();
+   audio_mixer_init(BENCH_OUT_RATE);
+
+   if (!(sound = audio_mixer_load_wav(wav, (int32_t)wav_len,
+         "null", RESAMPLER_QUALITY_DONTCARE)))
+   {
+      fprintf(stderr, "Failed to load WAV.\n");
+      return 1;
+   }
+
+   printf("[\n");
+
+   /* d == 0 is the run without any DSP filter */
+   for (d = 0; d < argc; d++)
+   {
+      const char *dsp_path = d ? argv[d] : NULL;
+
+      for (r = 0; r < ARRAY_SIZE(bench_resamplers); r++)
+      {
+         for (v = 0; v < ARRAY_SIZE(bench_voices); v++)
+         {
+            double ns_per_frame      = 0.0;
+            struct bench_quality q   = { 0.0, 0.0 };
+            bool reference           = !dsp_path && !bench_voices[v];
+
+            if (!run(&bench_resamplers[r], dsp_path, bench_voices[v],
+                     sound, &ns_per_frame, &q))
+               continue;
+
+            printf("%s  {\"resampler\": \"%s\", \"quality\": \"%s\", "
+                  "\"dsp\": \"%s\", \"voices\": %u, \"ns_per_frame\": %.3f",
+                  first ? "" : ",\n",
+                  bench_resamplers[r].ident,
+                  bench_resamplers[r].quality_name,
+                  dsp_path ? dsp_path : "none",
+                  bench_voices[v], ns_per_frame);
+
+            /* Quality is only meaningful against the undistorted signal */
+            if (reference)
+               printf(", \"snr_db\": %.2f, \"thd_db\": %.2f}", q.snr_db, q.thd_db);
+            else
+               printf(", \"snr_db\": null, \"thd_db\": null}");
+
+            first = false;
+         }
+      }
+   }
+
+   printf("\n]\n");
+
+   audio_mixer_destroy(sound);
+   audio_mixer_done();
+   free(wav);
+   return 0;
+}
@@ -0,0 +1,316 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (rpng_bench.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/* Benchmark for rpng.
+ *
+ *    rpng_bench [width height [iterations]]
+ *    rpng_bench -d [-n iterations] <png files...>
+ *
+ * The first form encodes a synthetic screenshot at a few compression
+ * settings, decodes every result again to check it, and prints
+ * throughput and file size. The second decodes a set of PNGs, say a
+ * directory of boxart thumbnails, and prints decode throughput. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <formats/rpng.h>
+#include <formats/image.h>
+#include <streams/file_stream.h>
+#include <features/features_cpu.h>
+
+#define BENCH_PATH "rpng_bench.png"
+
+/* Flat areas, gradients, hard edged sprites and a bit of noise,
+ * which is roughly what game screenshots are made of */
+static void make_image(uint8_t *bgr, unsigned width, unsigned height)
+{
+   unsigned x, y;
+   uint32_t seed = 1;
+
+   for (y = 0; y < height; y++)
+   {
+      for (x = 0; x < width; x++)
+      {
+         uint8_t *p = bgr + ((size_t)y * width + x) * 3;
+
+         if (y < height / 3)
+         {
+            p[0] = (uint8_t)(y * 255 / height);
+            p[1] = (uint8_t)(x * 255 / width);
+            p[2] = 0x40;
+         }
+         else if (((x / 24) + (y / 24)) & 1)
+         {
+            p[0] = 0x20;
+            p[1] = 0x80;
+            p[2] = 0xE0;
+         }
+         else
+         {
+            seed = seed * 1103515245 + 12345;
+            p[0] = p[1] = p[2] = (uint8_t)(0x60 + ((seed >> 16) & 0x0F));
+         }
+      }
+   }
+}
+
+/* Decodes a PNG in memory the way image_transfer does */
+static uint32_t *decode_png(void *buf, size_t len,
+      unsigned *width, unsigned *height)
+{
+   int retval;
+   uint32_t *argb = NULL;
+   rpng_t *rpng   = rpng_alloc();
+
+   if (!rpng)
+      return NULL;
+
+   if (     !rpng_set_buf_ptr(rpng, buf, len)
+         || !rpng_start(rpng))
+      goto end;
+
+   while (rpng_iterate_image(rpng));
+
+   if (!rpng_is_valid(rpng))
+      goto end;
+
+   do
+   {
+      retval = rpng_process_image(rpng, (void**)&argb, len, width, height);
+   } while (retval == IMAGE_PROCESS_NEXT);
+
+   if (     retval == IMAGE_PROCESS_ERROR
+         || retval == IMAGE_PROCESS_ERROR_END)
+   {
+      free(argb);
+      argb = NULL;
+   }
+
+end:
+   rpng_free(rpng);
+   return argb;
+}
+
+static bool check_png(const char *path, const uint8_t *bgr,
+      unsigned width, unsigned height, int64_t *size)
+{
+   unsigned w, h;
+   size_t i;
+   void *buf       = NULL;
+   int64_t len     = 0;
+   uint32_t *argb  = NULL;
+   bool ret        = false;
+
+   if (!filestream_read_file(path, &buf, &len))
+      return false;
+   *size = len;
+
+   if (     !(argb = decode_png(buf, (size_t)len, &w, &h))
+         || w != width || h != height)
+      goto end;
+
+   for (i = 0; i < (size_t)width * height; i++, bgr += 3)
+   {
+      uint32_t col = 0xFF000000
+         | ((uint32_t)bgr[2] << 16) | ((uint32_t)bgr[1] << 8) | bgr[0];
+      if (argb[i] != col)
+         break;
+   }
+   ret = (i == (size_t)width * height);
+
+end:
+   free(argb);
+   free(buf);
+   return ret;
+}
+
+static int decode_bench(int count, char *paths[], unsigned iterations)
+{
+   int f;
+   unsigned i;
+   retro_time_t elapsed = 0;
+   uint64_t pixels      = 0;
+   uint64_t bytes       = 0;
+   unsigned decoded     = 0;
+   int ret              = 0;
+
+   for (f = 0; f < count; f++)
+   {
+      void *buf   = NULL;
+      int64_t len = 0;
+
+      /* Only the decode is timed, not the file read */
+      if (!filestream_read_file(paths[f], &buf, &len))
+      {
+         printf("%s: can't read\n", paths[f]);
+         ret = 1;
+         continue;
+      }
+
+      for (i = 0; i < iterations; i++)
+      {
+         unsigned w, h;
+         uint32_t *argb;
+         retro_time_t start = cpu_features_get_time_usec();
+
+         argb     = decode_png(buf, (size_t)len, &w, &h);
+         elapsed += cpu_features_get_time_usec() - start;
+
+         if (!argb)
+         {
+            printf("%s: decode failed\n", paths[f]);
+            ret = 1;
+            break;
+         }
+
+         pixels  += (uint64_t)w * h;
+         bytes   += (uint64_t)len;
+         decoded++;
+         free(argb);
+      }
+
+      free(buf);
+   }
+
+   if (elapsed > 0)
+      printf("%d files, %u decodes: %.1f images/s, "
+            "%.1f MB/s in, %.1f Mpixels/s out\n",
+            count, decoded,
+            decoded / ((double)elapsed / 1000000.0),
+            bytes / (1024.0 * 1024.0) / ((double)elapsed / 1000000.0),
+            pixels / 1000000.0 / ((double)elapsed / 1000000.0));
+
+   return ret;
+}
+
+int main(int argc, char *argv[])
+{
+   static const struct
+   {
+      const char *name;
+      int level;
+      unsigned flags;
+   } modes[] = {
+      { "default",         -1, 0 },
+      { "level 1",          1, 0 },
+      { "level 1, fast",    1, RPNG_ENCODE_FAST_FILTER },
+      { "level 9",          9, 0 },
+   };
+   unsigned m, i;
+   unsigned width      = 1920;
+   unsigned height     = 1080;
+   unsigned iterations = 5;
+   uint8_t *bgr        = NULL;
+   int ret             = 0;
+
+   if (argc >= 2 && !strcmp(argv[1], "-d"))
+   {
+      int first = 2;
+      if (argc >= 4 && !strcmp(argv[2], "-n"))
+      {
+         iterations = (unsigned)strtoul(argv[3], NULL, 0);
+         first      = 4;
+      }
+      if (first >= argc || !iterations)
+      {
+         fprintf(stderr, "Usage: %s -d [-n iterations] <png files...>\n",
+               argv[0]);
+         return 1;
+      }
+      return decode_bench(argc - first, argv + first, iterations);
+   }
+
+   if (argc >= 3)
+   {
+      width  = (unsigned)strtoul(argv[1], NULL, 0);
+      height = (unsigned)strtoul(argv[2], NULL, 0);
+   }
+   if (argc >= 4)
+      iterations = (unsigned)strtoul(argv[3], NULL, 0);
+   if (!width || !height || !iterations)
+   {
+      fprintf(stderr, "Usage: %s [width height [iterations]]\n", argv[0]);
+      return 1;
+   }
+
+   if (!(bgr = (uint8_t*)malloc((size_t)width * height * 3)))
+      return 1;
+   make_image(bgr, width, height);
+
+   printf("%ux%u BGR24, %u iterations\n", width, height, iterations);
+
+   for (m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+   {
+      retro_time_t start, elapsed;
+      double mb = (double)width * height * 3 * iterations / (1024.0 * 1024.0);
+
+      start = cpu_features_get_time_usec();
+      for (i = 0; i < iterations; i++)
+      {
+         /* Stored bottom-up, like GPU readbacks */
+         if (!rpng_save_image_bgr24_ex(BENCH_PATH,
+                  bgr + (size_t)(height - 1) * width * 3,
+                  width, height, -(signed)(width * 3),
+                  modes[m].level, modes[m].flags))
+            break;
+      }
+      elapsed = cpu_features_get_time_usec() - start;
+
+      if (i != iterations)
+      {
+         printf("%-16s encode failed\n", modes[m].name);
+         ret = 1;
+         continue;
+      }
+
+      /* The decoder sees the rows top-down */
+      {
+         size_t row   = (size_t)width * 3;
+         uint8_t *td  = (uint8_t*)malloc(row * height);
+         int64_t size = 0;
+         bool ok      = false;
+         if (td)
+         {
+            unsigned y;
+            for (y = 0; y < height; y++)
+               memcpy(td + y * row, bgr + (height - 1 - y) * row, row);
+            ok = check_png(BENCH_PATH, td, width, height, &size);
+            free(td);
+         }
+         if (!ok)
+            ret = 1;
+
+         printf("%-16s %8.1f MB/s %10u bytes %s\n", modes[m].name,
+               mb / ((double)elapsed / 1000000.0),
+               (unsigned)size,
+               ok ? "ok" : "MISMATCH");
+      }
+   }
+
+   remove(BENCH_PATH);
+   free(bgr);
+   return ret;
+}
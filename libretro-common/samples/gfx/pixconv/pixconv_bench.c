@@ -0,0 +1,246 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (pixconv_bench.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Checks and times every pixel converter kernel.
+ *
+ * For each format pair supported by pixconv_get(), every kernel built
+ * for an instruction set the running CPU supports is first compared
+ * bit for bit against the scalar kernel, over a range of widths (to
+ * exercise the SIMD tails) and with padded strides. It is then timed
+ * on a full frame and the throughput is printed in Mpix/s.
+ *
+ * Usage: pixconv_bench [width height [iterations]]
+ *
+ * Returns non-zero if any kernel disagrees with the scalar one.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <features/features_cpu.h>
+#include <gfx/scaler/pixconv.h>
+#include <gfx/scaler/scaler.h>
+
+#define BENCH_MAX_CHECK_WIDTH 67
+#define BENCH_CHECK_HEIGHT    3
+/* Stride padding, in bytes, for the correctness checks */
+#define BENCH_PAD             16
+
+static const char *bench_fmt_names[] = {
+   "ARGB8888",
+   "ABGR8888",
+   "0RGB1555",
+   "RGB565",
+   "BGR24",
+   "YUYV",
+   "RGBA4444",
+};
+
+static int bench_fmt_bpp(enum scaler_pix_fmt fmt)
+{
+   switch (fmt)
+   {
+      case SCALER_FMT_ARGB8888:
+      case SCALER_FMT_ABGR8888:
+         return 4;
+      case SCALER_FMT_BGR24:
+         return 3;
+      default:
+         break;
+   }
+
+   return 2;
+}
+
+static bool bench_isa_usable(enum pixconv_isa isa, uint64_t features)
+{
+   switch (isa)
+   {
+      case PIXCONV_ISA_AVX2:
+         return (features & RETRO_SIMD_AVX2) != 0;
+      default:
+         break;
+   }
+
+   /* Everything else is only built when the target has it */
+   return true;
+}
+
+static void bench_fill(uint8_t *buf, size_t len, uint32_t seed)
+{
+   size_t i;
+   for (i = 0; i < len; i++)
+   {
+      seed   = seed * 1664525u + 1013904223u;
+      buf[i] = (uint8_t)(seed >> 24);
+   }
+}
+
+static bool bench_check(pixconv_fn_t ref, pixconv_fn_t fn,
+      enum scaler_pix_fmt in_fmt, enum scaler_pix_fmt out_fmt,
+      int *bad_width)
+{
+   int width;
+   int in_bpp  = bench_fmt_bpp(in_fmt);
+   int out_bpp = bench_fmt_bpp(out_fmt);
+   int step    = in_fmt == SCALER_FMT_YUYV ? 2 : 1;
+
+   for (width = step; width <= BENCH_MAX_CHECK_WIDTH; width += step)
+   {
+      int in_stride    = width * in_bpp  + BENCH_PAD;
+      int out_stride   = width * out_bpp + BENCH_PAD;
+      size_t in_size   = (size_t)in_stride  * BENCH_CHECK_HEIGHT;
+      size_t out_size  = (size_t)out_stride * BENCH_CHECK_HEIGHT;
+      uint8_t *in      = (uint8_t*)malloc(in_size);
+      uint8_t *out_ref = (uint8_t*)malloc(out_size);
+      uint8_t *out     = (uint8_t*)malloc(out_size);
+      bool ok          = in && out_ref && out;
+
+      if (ok)
+      {
+         bench_fill(in, in_size, (uint32_t)width);
+         /* Same canary in both so the padding has to match too */
+         memset(out_ref, 0x5a, out_size);
+         memset(out,     0x5a, out_size);
+
+         ref(out_ref, in, width, BENCH_CHECK_HEIGHT, out_stride, in_stride);
+         fn (out,     in, width, BENCH_CHECK_HEIGHT, out_stride, in_stride);
+
+         ok = !memcmp(out_ref, out, out_size);
+      }
+
+      free(in);
+      free(out_ref);
+      free(out);
+
+      if (!ok)
+      {
+         *bad_width = width;
+         return false;
+      }
+   }
+
+   return true;
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned in_fmt, out_fmt;
+   int width          = 640;
+   int height         = 480;
+   int iterations     = 200;
+   int failures       = 0;
+   uint64_t features  = cpu_features_get();
+   uint8_t *in        = NULL;
+   uint8_t *out       = NULL;
+
+   if (argc >= 3)
+   {
+      width  = atoi(argv[1]) & ~1;
+      height = atoi(argv[2]);
+   }
+   if (argc >= 4)
+      iterations = atoi(argv[3]);
+
+   if (width <= 0 || height <= 0 || iterations <= 0)
+   {
+      fprintf(stderr, "Usage: %s [width height [iterations]]\n", argv[0]);
+      return 1;
+   }
+
+   in  = (uint8_t*)malloc((size_t)width * height * 4);
+   out = (uint8_t*)malloc((size_t)width * height * 4);
+   if (!in || !out)
+      return 1;
+
+   bench_fill(in, (size_t)width * height * 4, 1);
+
+   printf("%-20s %-10s %10s  %s\n", "pair", "isa", "Mpix/s", "check");
+
+   for (in_fmt = SCALER_FMT_ARGB8888; in_fmt <= SCALER_FMT_RGBA4444; in_fmt++)
+   {
+      for (out_fmt = SCALER_FMT_ARGB8888; out_fmt <= SCALER_FMT_RGBA4444; out_fmt++)
+      {
+         unsigned isa;
+         char pair[32];
+         pixconv_fn_t ref = pixconv_get_kernel((enum scaler_pix_fmt)in_fmt,
+               (enum scaler_pix_fmt)out_fmt, PIXCONV_ISA_C);
+
+         if (!ref)
+            continue;
+
+         snprintf(pair, sizeof(pair), "%s>%s",
+               bench_fmt_names[in_fmt], bench_fmt_names[out_fmt]);
+
+         for (isa = PIXCONV_ISA_C; isa < PIXCONV_ISA_LAST; isa++)
+         {
+            int i;
+            int bad_width     = 0;
+            bool ok           = true;
+            retro_time_t start, elapsed;
+            pixconv_fn_t fn   = pixconv_get_kernel(
+                  (enum scaler_pix_fmt)in_fmt,
+                  (enum scaler_pix_fmt)out_fmt, (enum pixconv_isa)isa);
+
+            if (!fn || !bench_isa_usable((enum pixconv_isa)isa, features))
+               continue;
+
+            if (isa != PIXCONV_ISA_C)
+               ok = bench_check(ref, fn, (enum scaler_pix_fmt)in_fmt,
+                     (enum scaler_pix_fmt)out_fmt, &bad_width);
+
+            start = cpu_features_get_time_usec();
+            for (i = 0; i < iterations; i++)
+               fn(out, in, width, height,
+                     width * bench_fmt_bpp((enum scaler_pix_fmt)out_fmt),
+                     width * bench_fmt_bpp((enum scaler_pix_fmt)in_fmt));
+            elapsed = cpu_features_get_time_usec() - start;
+            if (elapsed <= 0)
+               elapsed = 1;
+
+            if (ok)
+               printf("%-20s %-10s %10.1f  ok\n", pair,
+                     pixconv_isa_name((enum pixconv_isa)isa),
+                     (double)width * height * iterations / elapsed);
+            else
+            {
+               printf("%-20s %-10s %10.1f  MISMATCH (width %d)\n", pair,
+                     pixconv_isa_name((enum pixconv_isa)isa),
+                     (double)width * height * iterations / elapsed,
+                     bad_width);
+               failures++;
+            }
+         }
+      }
+   }
+
+   free(in);
+   free(out);
+
+   if (failures)
+      fprintf(stderr, "%d kernel(s) disagree with the scalar kernel.\n",
+            failures);
+
+   return failures ? 1 : 0;
+}
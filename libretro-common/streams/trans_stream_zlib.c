@@ -33,6 +33,7 @@ struct zlib_trans_stream
    int window_bits;
    int level;
    bool inited;
+   bool sync_flush;
 };
 
 static void *zlib_deflate_stream_new(void)
@@ -42,6 +43,7 @@ static void *zlib_deflate_stream_new(void)
    if (!ret)
       return NULL;
    ret->inited      = false;
+   ret->sync_flush  = false;
    ret->level       = 9;
    ret->window_bits = 15;
 
@@ -125,6 +127,10 @@ static bool zlib_deflate_define(void *data, const char *prop, uint32_t val)
       z->level = (int) val;
    else if (string_is_equal(prop, "window_bits"))
       z->window_bits = (int) val;
+   /* Flushing ends on a byte boundary instead of finishing
+    * the stream, so the output can be followed by more */
+   else if (string_is_equal(prop, "sync_flush"))
+      z->sync_flush  = (val != 0);
    else
       return false;
 
@@ -209,7 +215,8 @@ static bool zlib_deflate_trans(
 
    pre_avail_in  = z->avail_in;
    pre_avail_out = z->avail_out;
-   zret          = deflate(z, flush ? Z_FINISH : Z_NO_FLUSH);
+   zret          = deflate(z, !flush ? Z_NO_FLUSH
+         : zt->sync_flush ? Z_SYNC_FLUSH : Z_FINISH);
 
    if (zret == Z_OK)
    {
@@ -2238,8 +2238,8 @@ static int generic_action_ok(const char *path,
                   settings->paths.path_menu_wallpaper,
                   action_path);
 
-            task_push_image_load(action_path,
-                  video_driver_supports_rgba(), 0,
+            task_push_wallpaper_load(action_path,
+                  video_driver_supports_rgba(),
                   menu_display_handle_wallpaper_upload, NULL);
          }
          break;
@@ -7303,6 +7303,8 @@ static void materialui_frame(void *data, video_frame_info_t *video_info)
    font_unbind(&mui->font_data.list);
    font_unbind(&mui->font_data.hint);
 
+   gfx_display_flush(p_disp);
+
    if (video_st->current_video && video_st->current_video->set_viewport)
       video_st->current_video->set_viewport(
             video_st->data, video_width, video_height, false, true);
@@ -8843,8 +8845,8 @@ static void materialui_context_reset(void *data, bool is_threaded)
    menu_screensaver_context_destroy(mui->screensaver);
 
    if (path_is_valid(path_menu_wallpaper))
-      task_push_image_load(path_menu_wallpaper,
-            video_driver_supports_rgba(), 0,
+      task_push_wallpaper_load(path_menu_wallpaper,
+            video_driver_supports_rgba(),
             menu_display_handle_wallpaper_upload, NULL);
 
    video_driver_monitor_reset();
@@ -11860,6 +11860,8 @@ static void ozone_frame(void *data, video_frame_info_t *video_info)
    font_unbind(&ozone->fonts.entries_sublabel);
    font_unbind(&ozone->fonts.sidebar);
 
+   gfx_display_flush(p_disp);
+
    if (video_st->current_video && video_st->current_video->set_viewport)
       video_st->current_video->set_viewport(
             video_st->data, video_width, video_height, false, true);
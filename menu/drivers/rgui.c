@@ -274,7 +274,10 @@ enum rgui_flags
    RGUI_FLAG_ENTRY_HAS_LEFT_THUMBNAIL  = (1 << 22),
    RGUI_FLAG_SHOW_FULLSCREEN_THUMBNAIL = (1 << 23),
    RGUI_FLAG_IS_PLAYLISTS_TAB          = (1 << 24),
-   RGUI_FLAG_IS_QUICK_MENU             = (1 << 25)
+   RGUI_FLAG_IS_QUICK_MENU             = (1 << 25),
+   /* Upload the next frame in full, even if it
+    * matches what the video driver already has */
+   RGUI_FLAG_FULL_UPLOAD               = (1 << 26)
 };
 
 typedef struct
@@ -284,6 +287,9 @@ typedef struct
    struct
    {
       bitmapfont_lut_t *regular;
+      /* Rows of each regular glyph as bitmasks,
+       * bit 0 being the leftmost pixel */
+      uint8_t regular_rows[RGUI_NUM_FONT_GLYPHS_EXTENDED][FONT_HEIGHT];
 
 #ifdef HAVE_LANGEXTRA
       bitmapfont_lut_t *eng_6x10;
@@ -299,6 +305,10 @@ typedef struct
    frame_buf_t frame_buf;
    frame_buf_t background_buf;
    frame_buf_t upscale_buf;
+   frame_buf_t uploaded_buf;  /* Copy of the last frame given to the video driver */
+   uint8_t *dirty_rows;       /* Rows of frame_buf that differ from uploaded_buf */
+   unsigned uploaded_width;   /* Size of the texture last uploaded */
+   unsigned uploaded_height;
 
    thumbnail_t fs_thumbnail;
    thumbnail_t mini_thumbnail;
@@ -1616,6 +1626,23 @@ english:
       return false;
    }
 
+   {
+      unsigned symbol, i, j;
+      for (symbol = 0; symbol < RGUI_NUM_FONT_GLYPHS_EXTENDED; symbol++)
+      {
+         bool *symbol_lut = rgui->fonts.regular->lut[symbol];
+
+         for (j = 0; j < FONT_HEIGHT; j++)
+         {
+            uint8_t row = 0;
+            for (i = 0; i < FONT_WIDTH; i++)
+               if (symbol_lut[i + (j * FONT_WIDTH)])
+                  row |= 1 << i;
+            rgui->fonts.regular_rows[symbol][j] = row;
+         }
+      }
+   }
+
    rgui->font_width         = FONT_WIDTH;
    rgui->font_height        = FONT_HEIGHT;
    rgui->font_width_stride  = FONT_WIDTH_STRIDE;
@@ -1789,11 +1816,19 @@ static void rgui_color_rect(
    if (y_end > fb_height)
       y_end         = fb_height;
 
-   for (y_index = y_start; y_index < y_end; y_index++)
+   if (x_start >= x_end || y_start >= y_end)
+      return;
+
+   /* Fill the first row, then copy it down */
    {
-      uint16_t *data_ptr = data + (y_index * fb_width);
-      for (x_index = x_start; x_index < x_end; x_index++)
-         *(data_ptr + x_index) = color;
+      uint16_t *src = data + (y_start * fb_width) + x_start;
+      size_t x_size = (x_end - x_start) * sizeof(uint16_t);
+
+      for (x_index = 0; x_index < x_end - x_start; x_index++)
+         src[x_index] = color;
+
+      for (y_index = y_start + 1; y_index < y_end; y_index++)
+         memcpy(data + (y_index * fb_width) + x_start, src, x_size);
    }
 }
 
@@ -2681,14 +2716,8 @@ static void rgui_render_background(
 
    /* If screensaver is active, 'zero out' framebuffer */
    if (rgui->flags & RGUI_FLAG_SHOW_SCREENSAVER)
-   {
-      size_t i;
-      uint16_t ss_bg_color    = rgui->colors.ss_bg_color;
-      uint16_t *frame_buf_ptr = frame_buf->data;
-
-      for (i = 0; i < frame_buf->width * frame_buf->height; i++)
-         *(frame_buf_ptr++) = ss_bg_color;
-   }
+      rgui_color_rect(frame_buf->data, fb_width, fb_height,
+            0, 0, fb_width, fb_height, rgui->colors.ss_bg_color);
    /* Otherwise copy background to framebuffer */
    else if (background_buf->data)
       memcpy(frame_buf->data, background_buf->data,
@@ -3353,6 +3382,48 @@ static void rgui_prepare_colors(
 
 /* rgui_blit_line() */
 
+static INLINE void rgui_blit_glyph_regular(uint16_t *dst,
+      unsigned fb_width, const uint8_t *rows, uint16_t color)
+{
+   unsigned j;
+
+   for (j = 0; j < FONT_HEIGHT; j++, dst += fb_width)
+   {
+      unsigned i;
+      unsigned row = rows[j];
+
+      for (i = 0; row; i++, row >>= 1)
+         if (row & 1)
+            dst[i] = color;
+   }
+}
+
+static INLINE void rgui_blit_glyph_regular_shadow(uint16_t *dst,
+      unsigned fb_width, const uint8_t *rows,
+      const uint16_t *color_buf, const uint16_t *shadow_color_buf)
+{
+   unsigned j;
+
+   for (j = 0; j < FONT_HEIGHT; j++, dst += fb_width)
+   {
+      unsigned i;
+      unsigned row = rows[j];
+
+      for (i = 0; row; i++, row >>= 1)
+      {
+         if (row & 1)
+         {
+            /* Text pixel + right shadow */
+            memcpy(dst + i, color_buf, 2 * sizeof(uint16_t));
+
+            /* Bottom shadow */
+            memcpy(dst + i + fb_width, shadow_color_buf,
+                  2 * sizeof(uint16_t));
+         }
+      }
+   }
+}
+
 static void rgui_blit_line_regular(
       rgui_t *rgui,
       unsigned fb_width,
@@ -3363,31 +3434,17 @@ static void rgui_blit_line_regular(
       uint16_t shadow_color)
 {
    uint16_t *frame_buf_data = rgui->frame_buf.data;
-   bool **lut               = rgui->fonts.regular->lut;
 
    while (!string_is_empty(message))
    {
-      unsigned i, j;
       uint8_t symbol = (uint8_t)*message++;
 
       if (symbol >= RGUI_NUM_FONT_GLYPHS_REGULAR)
          continue;
 
       if (symbol != ' ')
-      {
-         bool *symbol_lut = lut[symbol];
-
-         for (j = 0; j < FONT_HEIGHT; j++)
-         {
-            unsigned buff_offset = ((y + j) * fb_width) + x;
-
-            for (i = 0; i < FONT_WIDTH; i++)
-            {
-               if (*(symbol_lut + i + (j * FONT_WIDTH)))
-                  *(frame_buf_data + buff_offset + i) = color;
-            }
-         }
-      }
+         rgui_blit_glyph_regular(frame_buf_data + (y * fb_width) + x,
+               fb_width, rgui->fonts.regular_rows[symbol], color);
 
       x += FONT_WIDTH_STRIDE;
    }
@@ -3403,7 +3460,6 @@ static void rgui_blit_line_regular_shadow(
       uint16_t shadow_color)
 {
    uint16_t *frame_buf_data = rgui->frame_buf.data;
-   bool **lut               = rgui->fonts.regular->lut;
    uint16_t color_buf[2];
    uint16_t shadow_color_buf[2];
 
@@ -3415,36 +3471,15 @@ static void rgui_blit_line_regular_shadow(
 
    while (!string_is_empty(message))
    {
-      unsigned i, j;
       uint8_t symbol = (uint8_t)*message++;
 
       if (symbol >= RGUI_NUM_FONT_GLYPHS_REGULAR)
          continue;
 
       if (symbol != ' ')
-      {
-         bool *symbol_lut = lut[symbol];
-
-         for (j = 0; j < FONT_HEIGHT; j++)
-         {
-            unsigned buff_offset = ((y + j) * fb_width) + x;
-
-            for (i = 0; i < FONT_WIDTH; i++)
-            {
-               if (*(symbol_lut + i + (j * FONT_WIDTH)))
-               {
-                  uint16_t *frame_buf_ptr = frame_buf_data + buff_offset + i;
-
-                  /* Text pixel + right shadow */
-                  memcpy(frame_buf_ptr, color_buf, sizeof(color_buf));
-
-                  /* Bottom shadow */
-                  frame_buf_ptr += fb_width;
-                  memcpy(frame_buf_ptr, shadow_color_buf, sizeof(shadow_color_buf));
-               }
-            }
-         }
-      }
+         rgui_blit_glyph_regular_shadow(frame_buf_data + (y * fb_width) + x,
+               fb_width, rgui->fonts.regular_rows[symbol],
+               color_buf, shadow_color_buf);
 
       x += FONT_WIDTH_STRIDE;
    }
@@ -3460,7 +3495,6 @@ static void rgui_blit_line_extended(
       uint16_t shadow_color)
 {
    uint16_t *frame_buf_data = rgui->frame_buf.data;
-   bool **lut               = rgui->fonts.regular->lut;
 
    while (!string_is_empty(message))
    {
@@ -3469,8 +3503,6 @@ static void rgui_blit_line_extended(
          message++;
       else
       {
-         unsigned i, j;
-         bool *symbol_lut = NULL;
          uint32_t symbol  = utf8_walk(&message);
 
          /* Stupid cretinous hack: 'oe' ligatures are not
@@ -3486,18 +3518,8 @@ static void rgui_blit_line_extended(
          if (symbol >= RGUI_NUM_FONT_GLYPHS_EXTENDED)
             continue;
 
-         symbol_lut = lut[symbol];
-
-         for (j = 0; j < FONT_HEIGHT; j++)
-         {
-            unsigned buff_offset = ((y + j) * fb_width) + x;
-
-            for (i = 0; i < FONT_WIDTH; i++)
-            {
-               if (*(symbol_lut + i + (j * FONT_WIDTH)))
-                  *(frame_buf_data + buff_offset + i) = color;
-            }
-         }
+         rgui_blit_glyph_regular(frame_buf_data + (y * fb_width) + x,
+               fb_width, rgui->fonts.regular_rows[symbol], color);
       }
 
       x += FONT_WIDTH_STRIDE;
@@ -3516,7 +3538,6 @@ static void rgui_blit_line_extended_shadow(
    uint16_t color_buf[2];
    uint16_t shadow_color_buf[2];
    uint16_t *frame_buf_data = rgui->frame_buf.data;
-   bool **lut               = rgui->fonts.regular->lut;
 
    color_buf[0]             = color;
    color_buf[1]             = shadow_color;
@@ -3531,8 +3552,6 @@ static void rgui_blit_line_extended_shadow(
          message++;
       else
       {
-         unsigned i, j;
-         bool *symbol_lut   = NULL;
          uint32_t symbol    = utf8_walk(&message);
 
          /* Stupid cretinous hack: 'oe' ligatures are not
@@ -3548,27 +3567,9 @@ static void rgui_blit_line_extended_shadow(
          if (symbol >= RGUI_NUM_FONT_GLYPHS_EXTENDED)
             continue;
 
-         symbol_lut = lut[symbol];
-
-         for (j = 0; j < FONT_HEIGHT; j++)
-         {
-            unsigned buff_offset = ((y + j) * fb_width) + x;
-
-            for (i = 0; i < FONT_WIDTH; i++)
-            {
-               if (*(symbol_lut + i + (j * FONT_WIDTH)))
-               {
-                  uint16_t *frame_buf_ptr = frame_buf_data + buff_offset + i;
-
-                  /* Text pixel + right shadow */
-                  memcpy(frame_buf_ptr, color_buf, sizeof(color_buf));
-
-                  /* Bottom shadow */
-                  frame_buf_ptr += fb_width;
-                  memcpy(frame_buf_ptr, shadow_color_buf, sizeof(shadow_color_buf));
-               }
-            }
-         }
+         rgui_blit_glyph_regular_shadow(frame_buf_data + (y * fb_width) + x,
+               fb_width, rgui->fonts.regular_rows[symbol],
+               color_buf, shadow_color_buf);
       }
 
       x += FONT_WIDTH_STRIDE;
@@ -6630,6 +6631,9 @@ static void rgui_free(void *data)
    rgui_framebuffer_free(&rgui->frame_buf);
    rgui_framebuffer_free(&rgui->background_buf);
    rgui_framebuffer_free(&rgui->upscale_buf);
+   rgui_framebuffer_free(&rgui->uploaded_buf);
+   free(rgui->dirty_rows);
+   rgui->dirty_rows = NULL;
 
    rgui_thumbnail_free(&rgui->fs_thumbnail);
    rgui_thumbnail_free(&rgui->mini_thumbnail);
@@ -6646,9 +6650,67 @@ static void rgui_set_texture_frame(video_driver_state_t *video_st,
             frame, rgb32, width, height, alpha);
 }
 
+/* Compares the framebuffer row by row against the copy
+ * of what was last uploaded, updates the copy and flags
+ * the rows that changed in rgui->dirty_rows.
+ * Returns the number of changed rows. Without a copy
+ * (i.e. on allocation failure) every row is changed */
+static unsigned rgui_update_dirty_rows(rgui_t *rgui,
+      unsigned fb_width, unsigned fb_height)
+{
+   unsigned y;
+   unsigned dirty              = 0;
+   frame_buf_t *frame_buf      = &rgui->frame_buf;
+   frame_buf_t *uploaded_buf   = &rgui->uploaded_buf;
+   size_t row_size             = fb_width * sizeof(uint16_t);
+
+   if (     (uploaded_buf->width  != fb_width)
+         || (uploaded_buf->height != fb_height)
+         || !uploaded_buf->data)
+   {
+      rgui_framebuffer_free(uploaded_buf);
+      free(rgui->dirty_rows);
+
+      rgui->dirty_rows     = (uint8_t*)malloc(fb_height);
+      uploaded_buf->data   = (uint16_t*)malloc(fb_height * row_size);
+
+      if (!rgui->dirty_rows || !uploaded_buf->data)
+      {
+         rgui_framebuffer_free(uploaded_buf);
+         free(rgui->dirty_rows);
+         rgui->dirty_rows  = NULL;
+         return fb_height;
+      }
+
+      uploaded_buf->width  = fb_width;
+      uploaded_buf->height = fb_height;
+      rgui->flags         |= RGUI_FLAG_FULL_UPLOAD;
+   }
+
+   for (y = 0; y < fb_height; y++)
+   {
+      const uint16_t *src = frame_buf->data    + (y * fb_width);
+      uint16_t *dst       = uploaded_buf->data + (y * fb_width);
+
+      if (     (rgui->flags & RGUI_FLAG_FULL_UPLOAD)
+            || memcmp(dst, src, row_size))
+      {
+         memcpy(dst, src, row_size);
+         rgui->dirty_rows[y] = 1;
+         dirty++;
+      }
+      else
+         rgui->dirty_rows[y] = 0;
+   }
+
+   return dirty;
+}
+
 static void rgui_set_texture(void *data)
 {
-   unsigned fb_width, fb_height;
+   unsigned fb_width, fb_height, dirty;
+   unsigned out_width, out_height;
+   bool full_upload;
    video_driver_state_t *video_st  = video_state_get_ptr();
    settings_t            *settings = config_get_ptr();
    gfx_display_t          *p_disp  = disp_get_ptr();
@@ -6665,13 +6727,12 @@ static void rgui_set_texture(void *data)
 
    fb_width               = p_disp->framebuf_width;
    fb_height              = p_disp->framebuf_height;
+   out_width              = fb_width;
+   out_height             = fb_height;
 
    p_disp->flags         &= ~GFX_DISP_FLAG_FB_DIRTY;
 
-   if (internal_upscale_level == RGUI_UPSCALE_NONE)
-      rgui_set_texture_frame(video_st, rgui->frame_buf.data,
-            false, fb_width, fb_height, 1.0f);
-   else
+   if (internal_upscale_level != RGUI_UPSCALE_NONE)
    {
       struct video_viewport vp;
 
@@ -6680,19 +6741,8 @@ static void rgui_set_texture(void *data)
 
       /* If viewport is currently the same size (or smaller)
        * than the menu framebuffer, no scaling is required */
-      if ((vp.width <= fb_width) && (vp.height <= fb_height))
-         rgui_set_texture_frame(video_st, rgui->frame_buf.data,
-               false, fb_width, fb_height, 1.0f);
-      else
+      if ((vp.width > fb_width) || (vp.height > fb_height))
       {
-         unsigned out_width;
-         unsigned out_height;
-         uint32_t x_ratio, y_ratio;
-         unsigned x_src, y_src;
-         unsigned x_dst, y_dst;
-         frame_buf_t *frame_buf   = &rgui->frame_buf;
-         frame_buf_t *upscale_buf = &rgui->upscale_buf;
-
          /* Determine output size */
          if (internal_upscale_level == RGUI_UPSCALE_AUTO)
          {
@@ -6704,56 +6754,106 @@ static void rgui_set_texture(void *data)
             out_width  = internal_upscale_level * fb_width;
             out_height = internal_upscale_level * fb_height;
          }
+      }
+   }
 
-         /* Allocate upscaling buffer, if required */
-         if (     (upscale_buf->width  != out_width)
-               || (upscale_buf->height != out_height)
-               || !upscale_buf->data)
-         {
-            upscale_buf->width  = out_width;
-            upscale_buf->height = out_height;
+   /* Most redraws are for animations (tickers, the cursor)
+    * that only touch a few rows, or none at all by the time
+    * they reach the framebuffer. Only those rows need to be
+    * upscaled, and the upload can be skipped when nothing
+    * changed - the video driver keeps the last texture */
+   dirty                  = rgui_update_dirty_rows(rgui, fb_width, fb_height);
+   full_upload            = (rgui->flags & RGUI_FLAG_FULL_UPLOAD)
+                         || !rgui->dirty_rows
+                         || (rgui->uploaded_width  != out_width)
+                         || (rgui->uploaded_height != out_height);
 
-            if (upscale_buf->data)
-            {
-               free(upscale_buf->data);
-               upscale_buf->data = NULL;
-            }
+   if (!dirty && !full_upload)
+      return;
 
-            if (!(upscale_buf->data = (uint16_t*)
-                  calloc(out_width * out_height, sizeof(uint16_t))))
-            {
-               /* Uh oh... This could mean we don't have enough
-                * memory, so disable upscaling and draw the usual
-                * framebuffer... */
-               configuration_set_uint(settings,
-                     settings->uints.menu_rgui_internal_upscale_level,
-                     RGUI_UPSCALE_NONE);
-               rgui_set_texture_frame(video_st, frame_buf->data,
-                     false, fb_width, fb_height, 1.0f);
-               return;
-            }
+   rgui->flags           &= ~RGUI_FLAG_FULL_UPLOAD;
+   rgui->uploaded_width   = out_width;
+   rgui->uploaded_height  = out_height;
+   /* The new texture has yet to be presented */
+   p_disp->flags         |=  GFX_DISP_FLAG_DAMAGED;
+
+   if ((out_width == fb_width) && (out_height == fb_height))
+      rgui_set_texture_frame(video_st, rgui->frame_buf.data,
+            false, fb_width, fb_height, 1.0f);
+   else
+   {
+      uint32_t x_ratio, y_ratio;
+      unsigned x_dst, y_dst;
+      frame_buf_t *frame_buf   = &rgui->frame_buf;
+      frame_buf_t *upscale_buf = &rgui->upscale_buf;
+
+      /* Allocate upscaling buffer, if required */
+      if (     (upscale_buf->width  != out_width)
+            || (upscale_buf->height != out_height)
+            || !upscale_buf->data)
+      {
+         upscale_buf->width  = out_width;
+         upscale_buf->height = out_height;
+         full_upload         = true;
+
+         if (upscale_buf->data)
+         {
+            free(upscale_buf->data);
+            upscale_buf->data = NULL;
          }
 
-         /* Perform nearest neighbour upscaling
-          * NB: We're duplicating code here, but trying to handle
-          * this with a polymorphic function is too much of a drag... */
-         x_ratio = ((fb_width  << 16) / out_width);
-         y_ratio = ((fb_height << 16) / out_height);
+         if (!(upscale_buf->data = (uint16_t*)
+               calloc(out_width * out_height, sizeof(uint16_t))))
+         {
+            /* Uh oh... This could mean we don't have enough
+             * memory, so disable upscaling and draw the usual
+             * framebuffer... */
+            configuration_set_uint(settings,
+                  settings->uints.menu_rgui_internal_upscale_level,
+                  RGUI_UPSCALE_NONE);
+            rgui_set_texture_frame(video_st, frame_buf->data,
+                  false, fb_width, fb_height, 1.0f);
+            rgui->uploaded_width  = fb_width;
+            rgui->uploaded_height = fb_height;
+            return;
+         }
+      }
+
+      /* Perform nearest neighbour upscaling of the rows
+       * that changed. Every source row is scaled once and
+       * copied to the rest of the output rows it covers */
+      x_ratio = ((fb_width  << 16) / out_width);
+      y_ratio = ((fb_height << 16) / out_height);
 
-         for (y_dst = 0; y_dst < out_height; y_dst++)
+      for (y_dst = 0; y_dst < out_height; )
+      {
+         unsigned y_src  = (y_dst * y_ratio) >> 16;
+         unsigned y_next = y_dst + 1;
+
+         while (     (y_next < out_height)
+               && (((y_next * y_ratio) >> 16) == y_src))
+            y_next++;
+
+         if (full_upload || rgui->dirty_rows[y_src])
          {
-            y_src = (y_dst * y_ratio) >> 16;
+            const uint16_t *src = frame_buf->data   + (y_src * fb_width);
+            uint16_t *dst       = upscale_buf->data + (y_dst * out_width);
+            unsigned y;
+
             for (x_dst = 0; x_dst < out_width; x_dst++)
-            {
-               x_src = (x_dst * x_ratio) >> 16;
-               upscale_buf->data[(y_dst * out_width) + x_dst] = frame_buf->data[(y_src * fb_width) + x_src];
-            }
+               dst[x_dst] = src[(x_dst * x_ratio) >> 16];
+
+            for (y = y_dst + 1; y < y_next; y++)
+               memcpy(upscale_buf->data + (y * out_width), dst,
+                     out_width * sizeof(uint16_t));
          }
 
-         /* Draw upscaled texture */
-         rgui_set_texture_frame(video_st, upscale_buf->data,
-            false, out_width, out_height, 1.0f);
+         y_dst = y_next;
       }
+
+      /* Draw upscaled texture */
+      rgui_set_texture_frame(video_st, upscale_buf->data,
+         false, out_width, out_height, 1.0f);
    }
 }
 
@@ -7839,6 +7939,10 @@ static void rgui_toggle(void *userdata, bool menu_on)
 
    if (menu_on)
    {
+      /* Some video drivers drop the menu texture
+       * while the menu is off */
+      rgui->flags |= RGUI_FLAG_FULL_UPLOAD;
+
       if (aspect_ratio_lock != RGUI_ASPECT_RATIO_LOCK_NONE)
       {
          /* Cache content video settings */
@@ -7880,6 +7984,12 @@ static void rgui_toggle(void *userdata, bool menu_on)
          free(rgui->upscale_buf.data);
          rgui->upscale_buf.data = NULL;
       }
+
+      /* Same for the copy used to find changed rows,
+       * the next frame is uploaded in full anyway */
+      rgui_framebuffer_free(&rgui->uploaded_buf);
+      free(rgui->dirty_rows);
+      rgui->dirty_rows = NULL;
    }
 }
 
@@ -7897,6 +8007,8 @@ static void rgui_context_reset(void *data, bool is_threaded)
       gfx_display_init_white_texture();
    }
 #endif
+   /* The menu texture went away with the old context */
+   rgui->flags |= RGUI_FLAG_FULL_UPLOAD;
    video_driver_monitor_reset();
 }
 
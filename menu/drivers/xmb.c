@@ -1195,8 +1195,8 @@ static void xmb_update_dynamic_wallpaper(xmb_handle_t *xmb, bool reset)
    {
       if (path_is_valid(path))
       {
-         task_push_image_load(path,
-               video_driver_supports_rgba(), 0,
+         task_push_wallpaper_load(path,
+               video_driver_supports_rgba(),
                menu_display_handle_wallpaper_upload, NULL);
 
          if (xmb->bg_file_path)
@@ -7419,6 +7419,8 @@ static void xmb_frame(void *data, video_frame_info_t *video_info)
                video_height);
    }
 
+   gfx_display_flush(p_disp);
+
    if (video_st->current_video && video_st->current_video->set_viewport)
       video_st->current_video->set_viewport(
             video_st->data, video_width, video_height, false, true);
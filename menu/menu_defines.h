@@ -48,7 +48,10 @@ enum menu_state_flags
     * - Does menu driver support screensaver functionality?
     * - Is screensaver currently active? */
    MENU_ST_FLAG_SCREENSAVER_SUPPORTED       = (1 << 10),
-   MENU_ST_FLAG_SCREENSAVER_ACTIVE          = (1 << 11)
+   MENU_ST_FLAG_SCREENSAVER_ACTIVE          = (1 << 11),
+   /* The last frame was not presented, see
+    * menu_driver_needs_redraw() */
+   MENU_ST_FLAG_FRAME_SKIPPED               = (1 << 12)
 };
 
 enum menu_scroll_mode
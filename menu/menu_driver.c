@@ -65,6 +65,7 @@
 #endif
 
 #include "../gfx/gfx_animation.h"
+#include "../gfx/gfx_thumbnail.h"
 #include "../input/input_driver.h"
 #include "../input/input_remapping.h"
 #include "../performance_counters.h"
@@ -4476,7 +4477,63 @@ void menu_driver_frame(bool menu_is_alive, video_frame_info_t *video_info)
 {
    struct menu_state    *menu_st = &menu_driver_state;
    if (menu_is_alive && menu_st->driver_ctx->frame)
+   {
+      gfx_display_t      *p_disp = (gfx_display_t*)video_info->disp_userdata;
+
+      p_disp->flags             &= ~GFX_DISP_FLAG_ANIMATED;
       menu_st->driver_ctx->frame(menu_st->userdata, video_info);
+      /* Drivers that reset the viewport flush before doing so,
+       * this catches the others */
+      gfx_display_flush(p_disp);
+
+      /* Tickers are only known to scroll once they are drawn */
+      if (anim_get_ptr()->flags & GFX_ANIM_FLAG_TICKER_IS_ACTIVE)
+         p_disp->flags          |=  GFX_DISP_FLAG_ANIMATED;
+   }
+}
+
+/* Even a static menu is presented this often, so that
+ * window resizes and the like are picked up eventually */
+#define MENU_STATIC_FRAME_INTERVAL 1000000
+
+bool menu_driver_needs_redraw(
+      struct menu_state *menu_st,
+      gfx_display_t *p_disp,
+      gfx_animation_t *p_anim,
+      settings_t *settings,
+      retro_time_t current_time)
+{
+   static retro_time_t last_redraw_time        = 0;
+   static menu_input_pointer_hw_state_t last_pointer;
+   menu_input_pointer_hw_state_t *pointer      = &menu_st->input_pointer_hw_state;
+   bool pointer_moved                          =
+            pointer->x     != last_pointer.x
+         || pointer->y     != last_pointer.y
+         || pointer->flags != last_pointer.flags;
+
+   last_pointer                                = *pointer;
+
+   if (     !settings->bools.menu_skip_static_frames
+         || (p_disp->flags & (GFX_DISP_FLAG_DAMAGED | GFX_DISP_FLAG_ANIMATED))
+         || ANIM_IS_ACTIVE(p_anim)
+         || pointer_moved
+         || (menu_st->flags & MENU_ST_FLAG_SCREENSAVER_ACTIVE)
+         || menu_input_dialog_get_display_kb()
+         || runloop_state_get_ptr()->msg_queue_size
+         || settings->bools.video_fps_show
+         || settings->bools.video_statistics_show
+         || settings->bools.video_framecount_show
+         || settings->bools.video_memory_show
+         || (current_time - last_redraw_time) >= MENU_STATIC_FRAME_INTERVAL)
+   {
+      last_redraw_time                         = current_time;
+      p_disp->flags                           &= ~GFX_DISP_FLAG_DAMAGED;
+      menu_st->flags                          &= ~MENU_ST_FLAG_FRAME_SKIPPED;
+      return true;
+   }
+
+   menu_st->flags                             |=  MENU_ST_FLAG_FRAME_SKIPPED;
+   return false;
 }
 
 /* Teardown function for the menu driver. */
@@ -6637,6 +6694,7 @@ bool menu_driver_ctl(enum rarch_menu_ctl_state state, void *data)
          if (     menu_st->driver_ctx
                && menu_st->driver_ctx->context_destroy)
             menu_st->driver_ctx->context_destroy(menu_st->userdata);
+         gfx_thumbnail_cache_unload_textures();
 
          if (menu_st->flags & MENU_ST_FLAG_DATA_OWN)
             return true;
@@ -6706,6 +6764,7 @@ bool menu_driver_ctl(enum rarch_menu_ctl_state state, void *data)
             if (menu_st->thumbnail_path_data)
                free(menu_st->thumbnail_path_data);
             menu_st->thumbnail_path_data    = NULL;
+            gfx_thumbnail_cache_free();
 
             if (menu_st->driver_data->core_buf)
                free(menu_st->driver_data->core_buf);
@@ -7040,6 +7099,10 @@ static int generic_menu_iterate(
    iterate_type                    = action_iterate_type(label);
    menu_st->flags                 &= ~MENU_ST_FLAG_IS_BINDING;
 
+   if (     action != MENU_ACTION_NOOP
+         || MENU_ENTRIES_NEEDS_REFRESH(menu_st))
+      p_disp->flags |= GFX_DISP_FLAG_DAMAGED;
+
    if (     action != MENU_ACTION_NOOP
          || MENU_ENTRIES_NEEDS_REFRESH(menu_st)
          || GFX_DISPLAY_GET_UPDATE_PENDING(p_anim, p_disp))
@@ -622,6 +622,23 @@ bool menu_driver_ctl(enum rarch_menu_ctl_state state, void *data);
 
 void menu_driver_frame(bool menu_is_alive, video_frame_info_t *video_info);
 
+/**
+ * menu_driver_needs_redraw:
+ *
+ * Damage tracking for the menu. With menu_skip_static_frames
+ * enabled, returns false when nothing on screen can have changed
+ * since the last frame that was presented: no input, no entries
+ * refresh, no running animation or scrolling text, and nothing
+ * reported as damaged through GFX_DISP_FLAG_DAMAGED. The frontend
+ * then leaves that frame on screen and skips drawing.
+ **/
+bool menu_driver_needs_redraw(
+      struct menu_state *menu_st,
+      gfx_display_t *p_disp,
+      gfx_animation_t *p_anim,
+      settings_t *settings,
+      retro_time_t current_time);
+
 int menu_driver_deferred_push_content_list(file_list_t *list);
 
 bool menu_driver_init(bool video_is_threaded);
@@ -3565,6 +3565,7 @@ bool command_event(enum event_command cmd, void *data)
                   settings->bools.content_runtime_log_aggregate,
                   settings->paths.directory_runtime_log,
                   settings->paths.directory_playlist);
+            video_frame_delay_model_save();
             if (settings->bools.savestate_auto_save &&
                 runloop_st->current_core_type != CORE_TYPE_DUMMY)
                command_event_save_auto_state();
@@ -4124,6 +4125,7 @@ bool command_event(enum event_command cmd, void *data)
                   settings->bools.content_runtime_log_aggregate,
                   settings->paths.directory_runtime_log,
                   settings->paths.directory_playlist);
+            video_frame_delay_model_save();
 
             if (     runloop_st->flags & RUNLOOP_FLAG_CORE_RUNNING
                   && settings->bools.savestate_auto_save)
@@ -5756,6 +5758,7 @@ void main_exit(void *args)
    retroarch_ctl(RARCH_CTL_STATE_FREE,  NULL);
    global_free(p_rarch);
    task_queue_deinit();
+   task_image_deinit();
 
    ui_companion_driver_deinit();
    retroarch_config_deinit();
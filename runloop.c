@@ -4747,6 +4747,10 @@ bool runloop_event_init_core(
    runloop_st->frame_limit_last_time    = cpu_features_get_time_usec();
 
    runloop_runtime_log_init(runloop_st);
+
+   if (settings->bools.video_frame_delay_auto)
+      video_frame_delay_model_load(runloop_st->name.savefile,
+            runloop_st->system.info.library_name);
    return true;
 }
 
@@ -6017,11 +6021,15 @@ static enum runloop_state_enum runloop_check_state(
                         (runloop_st->flags & RUNLOOP_FLAG_IDLE) ? true : false);
             }
 
+            menu_st->flags &= ~MENU_ST_FLAG_FRAME_SKIPPED;
+
             if (      (menu_st->flags & MENU_ST_FLAG_ALIVE)
                   && !(runloop_st->flags & RUNLOOP_FLAG_IDLE))
                if (display_menu_libretro(runloop_st, input_st,
                         settings->floats.slowmotion_ratio,
-                        libretro_running, current_time))
+                        libretro_running, current_time)
+                     && menu_driver_needs_redraw(menu_st, p_disp,
+                        anim_get_ptr(), settings, current_time))
                   video_driver_cached_frame();
 
             if (menu->driver_ctx->set_texture)
@@ -6991,11 +6999,15 @@ int runloop_iterate(void)
             rcheevos_idle();
 #endif
 #ifdef HAVE_MENU
-         /* Rely on vsync throttling unless VRR is enabled and menu throttle is disabled. */
-         if (vrr_runloop_enable && !settings->bools.menu_throttle_framerate)
-            return 0;
-         else if (settings->bools.video_vsync)
-            goto end;
+         /* Rely on vsync throttling unless VRR is enabled and menu throttle is disabled.
+          * A frame that was not presented did not wait for vsync either. */
+         if (!(menu_state_get_ptr()->flags & MENU_ST_FLAG_FRAME_SKIPPED))
+         {
+            if (vrr_runloop_enable && !settings->bools.menu_throttle_framerate)
+               return 0;
+            else if (settings->bools.video_vsync)
+               goto end;
+         }
 
          /* Otherwise run menu in video refresh rate speed. */
          if (menu_state_get_ptr()->flags & MENU_ST_FLAG_ALIVE)
@@ -7232,6 +7244,8 @@ end:
               || (runloop_st->flags & RUNLOOP_FLAG_FASTMOTION)
 #ifdef HAVE_MENU
               || (menu_state_get_ptr()->flags & MENU_ST_FLAG_ALIVE && !(settings->bools.video_vsync))
+              || (     (menu_state_get_ptr()->flags & MENU_ST_FLAG_ALIVE)
+                    && (menu_state_get_ptr()->flags & MENU_ST_FLAG_FRAME_SKIPPED))
 #endif
               || (runloop_st->flags & RUNLOOP_FLAG_PAUSED)))
    {
@@ -0,0 +1,194 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Tween throughput of gfx_animation.
+ *
+ * Mimics a menu scrolling through a long list: every entry gets a
+ * handful of tweens with a few easing types, tagged per entry, and
+ * most of them are killed and pushed again on the next scroll step.
+ * Reports tweens stepped per millisecond and how long pushing and
+ * killing by tag take, then checks that finished tweens landed on
+ * their target, fired their callback once, and that killed ones
+ * were left alone.
+ *
+ * Usage: gfx_animation_bench [entries] [frames]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <features/features_cpu.h>
+
+#include "../../../gfx/gfx_animation.h"
+
+#define TWEENS_PER_ENTRY 4
+
+typedef struct
+{
+   float value[TWEENS_PER_ENTRY];
+   float target[TWEENS_PER_ENTRY];
+   unsigned done[TWEENS_PER_ENTRY];
+   bool killed;
+} entry_t;
+
+static entry_t *entries;
+
+/* Not reached, tickers are not used here */
+int font_driver_get_message_width(void *font_data,
+      const char *msg, size_t len, float scale)
+{
+   return 0;
+}
+
+static void tween_done(void *userdata)
+{
+   (*(unsigned*)userdata)++;
+}
+
+static void push_entry(unsigned i, unsigned generation)
+{
+   unsigned j;
+   static const enum gfx_animation_easing_type easings[TWEENS_PER_ENTRY] = {
+      EASING_OUT_QUAD, EASING_OUT_CUBIC, EASING_LINEAR, EASING_IN_OUT_SINE
+   };
+
+   for (j = 0; j < TWEENS_PER_ENTRY; j++)
+   {
+      gfx_animation_ctx_entry_t anim;
+
+      entries[i].target[j] = (float)(generation * 100 + i + j + 1);
+
+      anim.easing_enum     = easings[j];
+      anim.duration        = 100.0f + (float)((i * 7 + j * 13) % 200);
+      anim.target_value    = entries[i].target[j];
+      anim.subject         = &entries[i].value[j];
+      anim.tag             = (uintptr_t)&entries[i];
+      anim.cb              = tween_done;
+      anim.userdata        = &entries[i].done[j];
+
+      gfx_animation_push(&anim);
+   }
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned i, j, f;
+   retro_time_t start, update_time = 0, push_time = 0, kill_time = 0;
+   uint64_t stepped    = 0;
+   unsigned pushed     = 0;
+   unsigned killed     = 0;
+   unsigned errors     = 0;
+   unsigned count      = argc > 1 ? (unsigned)atoi(argv[1]) : 5000;
+   unsigned frames     = argc > 2 ? (unsigned)atoi(argv[2]) : 600;
+   retro_time_t now    = 1000000;
+   gfx_animation_t *p_anim = anim_get_ptr();
+
+   if (!count || !(entries = (entry_t*)calloc(count, sizeof(*entries))))
+      return 1;
+
+   start = cpu_features_get_time_usec();
+   for (i = 0; i < count; i++)
+      push_entry(i, 0);
+   push_time += cpu_features_get_time_usec() - start;
+   pushed    += count * TWEENS_PER_ENTRY;
+
+   for (f = 0; f < frames; f++)
+   {
+      /* Scroll: a window of entries gets its tweens restarted */
+      if (f % 8 == 0)
+      {
+         unsigned first = (f * 37) % count;
+         unsigned last  = first + count / 16 + 1;
+
+         if (last > count)
+            last = count;
+
+         start = cpu_features_get_time_usec();
+         for (i = first; i < last; i++)
+         {
+            uintptr_t tag = (uintptr_t)&entries[i];
+            gfx_animation_kill_by_tag(&tag);
+         }
+         kill_time += cpu_features_get_time_usec() - start;
+         killed    += last - first;
+
+         start = cpu_features_get_time_usec();
+         for (i = first; i < last; i++)
+            push_entry(i, f + 1);
+         push_time += cpu_features_get_time_usec() - start;
+         pushed    += (last - first) * TWEENS_PER_ENTRY;
+      }
+
+      stepped += p_anim->count;
+      now     += 16667;
+
+      start = cpu_features_get_time_usec();
+      gfx_animation_update(now, false, 1.0f, 1920, 1080);
+      update_time += cpu_features_get_time_usec() - start;
+   }
+
+   printf("%u entries, %u frames\n", count, frames);
+   printf("update: %8.0f tweens/ms\n",
+         update_time ? (double)stepped * 1000.0 / (double)update_time : 0.0);
+   printf("push:   %8.0f tweens/ms\n",
+         push_time ? (double)pushed * 1000.0 / (double)push_time : 0.0);
+   printf("kill:   %8.0f tags/ms\n",
+         kill_time ? (double)killed * 1000.0 / (double)kill_time : 0.0);
+
+   /* Let everything finish, then kill a few entries before
+    * starting them again and run them to the end too */
+   for (f = 0; f < 60 && p_anim->count; f++)
+      gfx_animation_update(now += 16667, false, 1.0f, 1920, 1080);
+
+   for (i = 0; i < count; i++)
+      for (j = 0; j < TWEENS_PER_ENTRY; j++)
+      {
+         if (entries[i].value[j] != entries[i].target[j])
+            errors++;
+         entries[i].value[j] = 0.0f;
+         entries[i].done[j]  = 0;
+      }
+
+   for (i = 0; i < count; i++)
+      push_entry(i, frames + 1);
+   gfx_animation_update(now += 16667, false, 1.0f, 1920, 1080);
+   for (i = 0; i < count; i += 3)
+   {
+      uintptr_t tag      = (uintptr_t)&entries[i];
+      entries[i].killed  = true;
+      gfx_animation_kill_by_tag(&tag);
+   }
+   for (f = 0; f < 60 && p_anim->count; f++)
+      gfx_animation_update(now += 16667, false, 1.0f, 1920, 1080);
+
+   for (i = 0; i < count; i++)
+      for (j = 0; j < TWEENS_PER_ENTRY; j++)
+      {
+         bool at_target = entries[i].value[j] == entries[i].target[j];
+         if (entries[i].killed
+               ? (at_target || entries[i].done[j])
+               : (!at_target || entries[i].done[j] != 1))
+            errors++;
+      }
+
+   if (p_anim->count)
+      errors++;
+
+   gfx_animation_deinit();
+   free(entries);
+
+   printf(errors ? "FAIL (%u errors)\n" : "OK\n", errors);
+   return errors ? 1 : 0;
+}
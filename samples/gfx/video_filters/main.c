@@ -0,0 +1,544 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Runs every .filt preset over a set of synthetic reference frames.
+ *
+ * Each preset is run twice: once with an empty SIMD mask (the plain C
+ * code) and once with the host's SIMD mask. The two outputs must be
+ * bit-identical. A CRC of each output is printed, and can be written
+ * to / checked against a golden file so regressions in the C code
+ * itself are caught too. Throughput of both paths is reported.
+ * -m replaces the host's mask, e.g. -m 2 to check the SSE2 kernels
+ * on a machine that would otherwise pick AVX2.
+ *
+ * Filters with SIMD paths: Scale2x, Scanline2x, EPX, 2xSaI, LQ2x.
+ * Still scalar: Super2xSaI, SuperEagle, 2xBR, Blargg NTSC.
+ *
+ * Usage: video_filter_test [-d filter_dir] [-w golden.txt | -g golden.txt]
+ *                          [-n iterations] [-m simd_mask]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <compat/strl.h>
+#include <encodings/crc32.h>
+#include <features/features_cpu.h>
+#include <file/config_file.h>
+#include <file/config_file_userdata.h>
+#include <file/file_path.h>
+#include <lists/dir_list.h>
+#include <string/stdstring.h>
+
+#include "../../../gfx/video_filters/softfilter.h"
+
+#define TEST_FRAME_WIDTH  256
+#define TEST_FRAME_HEIGHT 224
+/* Some filters peek a little outside the frame, as cores' own
+ * framebuffers usually have room around them */
+#define TEST_FRAME_GUARD  (TEST_FRAME_WIDTH * 4 * sizeof(uint32_t))
+
+extern const struct softfilter_implementation *blargg_ntsc_snes_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *lq2x_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *phosphor2x_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *twoxbr_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *epx_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *twoxsai_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *supereagle_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *supertwoxsai_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *darken_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *scale2x_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *normal2x_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *normal2x_width_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *normal2x_height_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *normal4x_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *scanline2x_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *grid2x_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *grid3x_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *gameboy3x_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *gameboy4x_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *dot_matrix_3x_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *dot_matrix_4x_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *upscale_1_5x_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *upscale_1_66x_fast_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *upscale_256x_320x240_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *picoscale_256x_320x240_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *upscale_240x160_320x240_get_implementation(softfilter_simd_mask_t simd);
+extern const struct softfilter_implementation *upscale_mix_240x160_320x240_get_implementation(softfilter_simd_mask_t simd);
+
+static const softfilter_get_implementation_t soft_plugs[] = {
+   blargg_ntsc_snes_get_implementation,
+   lq2x_get_implementation,
+   phosphor2x_get_implementation,
+   twoxbr_get_implementation,
+   darken_get_implementation,
+   twoxsai_get_implementation,
+   supertwoxsai_get_implementation,
+   supereagle_get_implementation,
+   epx_get_implementation,
+   scale2x_get_implementation,
+   normal2x_get_implementation,
+   normal2x_width_get_implementation,
+   normal2x_height_get_implementation,
+   normal4x_get_implementation,
+   scanline2x_get_implementation,
+   grid2x_get_implementation,
+   grid3x_get_implementation,
+   gameboy3x_get_implementation,
+   gameboy4x_get_implementation,
+   dot_matrix_3x_get_implementation,
+   dot_matrix_4x_get_implementation,
+   upscale_1_5x_get_implementation,
+   upscale_1_66x_fast_get_implementation,
+   upscale_256x_320x240_get_implementation,
+   picoscale_256x_320x240_get_implementation,
+   upscale_240x160_320x240_get_implementation,
+   upscale_mix_240x160_320x240_get_implementation,
+};
+
+static const struct softfilter_config softfilter_config = {
+   config_userdata_get_float,
+   config_userdata_get_int,
+   config_userdata_get_hex,
+   config_userdata_get_float_array,
+   config_userdata_get_int_array,
+   config_userdata_get_string,
+   config_userdata_free,
+};
+
+struct test_frame
+{
+   const char *ident;
+   unsigned width;
+   unsigned height;
+};
+
+/* Sizes the bundled presets are written for */
+static const struct test_frame test_frames[] = {
+   { "sprites", TEST_FRAME_WIDTH, TEST_FRAME_HEIGHT },
+   { "noise",   TEST_FRAME_WIDTH, TEST_FRAME_HEIGHT },
+   { "gba",     240,              160               },
+   { "odd",     253,              37                },
+   { "dither",  TEST_FRAME_WIDTH, TEST_FRAME_HEIGHT },
+};
+
+struct filter_run
+{
+   void *data;
+   struct softfilter_work_packet *packets;
+   unsigned num_packets;
+};
+
+static uint32_t test_rand_state = 1;
+
+static uint32_t test_rand(void)
+{
+   test_rand_state = test_rand_state * 1103515245 + 12345;
+   return test_rand_state >> 8;
+}
+
+/* "sprites" is made of flat 8x8 blocks from a small palette with a
+ * few diagonal edges, which is what the pixel-art scalers actually
+ * look for. "noise" has almost no equal neighbours. "dither" is
+ * checkerboarded blocks with a few stray pixels, which is where
+ * 2xSaI and friends fall back to counting neighbours. */
+static void test_frame_fill(uint32_t *pixels, unsigned width,
+      unsigned height, unsigned frame)
+{
+   static const uint32_t palette[8] = {
+      0x000000, 0xffffff, 0xf83800, 0x3cbcfc,
+      0x00a800, 0xfca044, 0x6844fc, 0x787878
+   };
+   unsigned x, y;
+
+   test_rand_state = 1 + frame;
+
+   for (y = 0; y < height; y++)
+   {
+      for (x = 0; x < width; x++)
+      {
+         uint32_t c;
+
+         if (frame == 1)
+            c = test_rand() & 0xffffff;
+         else if (frame == 4)
+         {
+            unsigned block = (y >> 3) * 37 + (x >> 3) * 11;
+            c              = palette[((x ^ y) & 1) ? (block & 7)
+               : ((block >> 3) & 7)];
+            if (!(test_rand() & 31))
+               c           = palette[test_rand() & 7];
+         }
+         else
+         {
+            unsigned block = ((y >> 3) * 37 + (x >> 3) * 11) ^ frame;
+            c              = palette[block & 7];
+            if (((x & 7) + (y & 7)) == 7 && (block & 8))
+               c           = palette[(block + 3) & 7];
+         }
+
+         pixels[y * width + x] = c;
+      }
+   }
+}
+
+static void test_frame_convert(void *out, unsigned fmt,
+      const uint32_t *in, unsigned width, unsigned height)
+{
+   unsigned i;
+
+   if (fmt == SOFTFILTER_FMT_XRGB8888)
+   {
+      memcpy(out, in, width * height * sizeof(uint32_t));
+      return;
+   }
+
+   for (i = 0; i < width * height; i++)
+   {
+      uint32_t c = in[i];
+      ((uint16_t*)out)[i] = (uint16_t)(
+              ((c >> 8) & 0xf800)
+            | ((c >> 5) & 0x07e0)
+            | ((c >> 3) & 0x001f));
+   }
+}
+
+static bool filter_run_init(struct filter_run *run,
+      const struct softfilter_implementation *impl,
+      config_file_t *conf, unsigned fmt, softfilter_simd_mask_t simd)
+{
+   struct config_file_userdata userdata;
+
+   userdata.conf      = conf;
+   userdata.prefix[0] = "filter";
+   userdata.prefix[1] = impl->short_ident;
+
+   if (!(run->data = impl->create(&softfilter_config, fmt, fmt,
+         TEST_FRAME_WIDTH, TEST_FRAME_HEIGHT, 1, simd, &userdata)))
+      return false;
+
+   run->num_packets = impl->query_num_threads(run->data);
+   run->packets     = (struct softfilter_work_packet*)
+      calloc(run->num_packets, sizeof(*run->packets));
+
+   return run->packets != NULL;
+}
+
+static void filter_run_deinit(struct filter_run *run,
+      const struct softfilter_implementation *impl)
+{
+   if (run->data)
+      impl->destroy(run->data);
+   free(run->packets);
+}
+
+static void filter_run_process(struct filter_run *run,
+      const struct softfilter_implementation *impl,
+      void *output, size_t output_stride,
+      const void *input, unsigned width, unsigned height,
+      size_t input_stride)
+{
+   unsigned i;
+
+   impl->get_work_packets(run->data, run->packets,
+         output, output_stride, input, width, height, input_stride);
+
+   for (i = 0; i < run->num_packets; i++)
+      run->packets[i].work(run->data, run->packets[i].thread_data);
+}
+
+static const struct softfilter_implementation *find_implementation(
+      const char *ident)
+{
+   unsigned i;
+
+   for (i = 0; i < sizeof(soft_plugs) / sizeof(soft_plugs[0]); i++)
+   {
+      const struct softfilter_implementation *impl = soft_plugs[i](0);
+      if (impl && string_is_equal(impl->short_ident, ident))
+         return impl;
+   }
+
+   return NULL;
+}
+
+/* Looks up 'key' in a golden file written by -w. Returns false if
+ * the key is not present. */
+static bool golden_lookup(const char *path, const char *key, uint32_t *crc)
+{
+   char line[512];
+   bool found = false;
+   FILE *fp   = fopen(path, "r");
+
+   if (!fp)
+      return false;
+
+   while (fgets(line, sizeof(line), fp))
+   {
+      char name[400];
+      unsigned value;
+
+      if (     sscanf(line, "%399s %x", name, &value) == 2
+            && string_is_equal(name, key))
+      {
+         *crc  = value;
+         found = true;
+         break;
+      }
+   }
+
+   fclose(fp);
+   return found;
+}
+
+static double mpix_per_sec(retro_time_t usec, unsigned iterations,
+      unsigned width, unsigned height)
+{
+   if (usec <= 0)
+      return 0.0;
+   return (double)width * height * iterations / (double)usec;
+}
+
+int main(int argc, char *argv[])
+{
+   int i;
+   size_t j;
+   const char *filter_dir         = "../../../gfx/video_filters";
+   const char *golden_path        = NULL;
+   FILE *golden_out               = NULL;
+   unsigned iterations            = 50;
+   unsigned failures              = 0;
+   unsigned presets               = 0;
+   softfilter_simd_mask_t simd    = (softfilter_simd_mask_t)cpu_features_get();
+   struct string_list *list       = NULL;
+   uint32_t *reference            = NULL;
+   uint8_t *input_buf             = NULL;
+   uint8_t *input                 = NULL;
+   uint8_t *out_generic           = NULL;
+   uint8_t *out_simd              = NULL;
+   /* Every bundled filter scales by at most 4x; leave some slack
+    * for the NTSC filter's wider lines */
+   size_t out_size                = (size_t)TEST_FRAME_WIDTH * 8
+      * TEST_FRAME_HEIGHT * 4 * sizeof(uint32_t);
+
+   for (i = 1; i < argc; i++)
+   {
+      if (string_is_equal(argv[i], "-d") && i + 1 < argc)
+         filter_dir = argv[++i];
+      else if (string_is_equal(argv[i], "-g") && i + 1 < argc)
+         golden_path = argv[++i];
+      else if (string_is_equal(argv[i], "-w") && i + 1 < argc)
+      {
+         if (!(golden_out = fopen(argv[++i], "w")))
+         {
+            fprintf(stderr, "Could not open %s for writing.\n", argv[i]);
+            return 1;
+         }
+      }
+      else if (string_is_equal(argv[i], "-n") && i + 1 < argc)
+         iterations = (unsigned)strtoul(argv[++i], NULL, 10);
+      else if (string_is_equal(argv[i], "-m") && i + 1 < argc)
+         simd       = (softfilter_simd_mask_t)strtoul(argv[++i], NULL, 16);
+      else
+      {
+         fprintf(stderr, "Usage: %s [-d filter_dir] "
+               "[-w golden.txt | -g golden.txt] [-n iterations] "
+               "[-m simd_mask]\n",
+               argv[0]);
+         return 1;
+      }
+   }
+
+   if (!iterations)
+      iterations = 1;
+
+   if (!(list = dir_list_new(filter_dir, "filt", false, false, false, false)))
+   {
+      fprintf(stderr, "No .filt presets found in %s.\n", filter_dir);
+      return 1;
+   }
+   dir_list_sort(list, true);
+
+   reference   = (uint32_t*)malloc(TEST_FRAME_WIDTH * TEST_FRAME_HEIGHT
+         * sizeof(uint32_t));
+   input_buf   = (uint8_t*)calloc(1, TEST_FRAME_WIDTH * TEST_FRAME_HEIGHT
+         * sizeof(uint32_t) + 2 * TEST_FRAME_GUARD);
+   input       = input_buf ? input_buf + TEST_FRAME_GUARD : NULL;
+   out_generic = (uint8_t*)malloc(out_size);
+   out_simd    = (uint8_t*)malloc(out_size);
+
+   if (!reference || !input || !out_generic || !out_simd)
+      return 1;
+
+   printf("SIMD mask: 0x%x\n", (unsigned)simd);
+
+   for (j = 0; j < list->size; j++)
+   {
+      unsigned f;
+      char name[64];
+      const struct softfilter_implementation *impl = NULL;
+      const char *path   = list->elems[j].data;
+      config_file_t *conf = config_file_new_from_path_to_string(path);
+
+      if (!conf)
+         continue;
+
+      if (     !config_get_array(conf, "filter", name, sizeof(name))
+            || !(impl = find_implementation(name)))
+      {
+         /* NULL.filt and the like */
+         config_file_free(conf);
+         continue;
+      }
+
+      presets++;
+
+      for (f = SOFTFILTER_FMT_RGB565; f <= SOFTFILTER_FMT_XRGB8888; f <<= 1)
+      {
+         unsigned k, out_fmt, out_bpp;
+         struct filter_run generic, vec;
+         unsigned output_fmts;
+
+         if (!(impl->query_input_formats() & f))
+            continue;
+
+         /* Same output format selection as the frontend */
+         output_fmts = impl->query_output_formats(f);
+         if (output_fmts & f)
+            out_fmt = f;
+         else if (output_fmts & SOFTFILTER_FMT_XRGB8888)
+            out_fmt = SOFTFILTER_FMT_XRGB8888;
+         else
+            out_fmt = SOFTFILTER_FMT_RGB565;
+         out_bpp    = (out_fmt == SOFTFILTER_FMT_XRGB8888)
+            ? SOFTFILTER_BPP_XRGB8888 : SOFTFILTER_BPP_RGB565;
+
+         memset(&generic, 0, sizeof(generic));
+         memset(&vec,     0, sizeof(vec));
+
+         if (     !filter_run_init(&generic, impl, conf, f, 0)
+               || !filter_run_init(&vec,     impl, conf, f, simd))
+         {
+            printf("%-48s %-8s FAIL (create)\n", path_basename(path),
+                  f == SOFTFILTER_FMT_XRGB8888 ? "xrgb8888" : "rgb565");
+            failures++;
+            filter_run_deinit(&generic, impl);
+            filter_run_deinit(&vec, impl);
+            continue;
+         }
+
+         for (k = 0; k < sizeof(test_frames) / sizeof(test_frames[0]); k++)
+         {
+            char key[400];
+            unsigned it, y, out_width, out_height;
+            retro_time_t t0, t_generic, t_simd;
+            uint32_t crc          = 0;
+            uint32_t golden       = 0;
+            bool ok               = true;
+            const struct test_frame *frame = &test_frames[k];
+            size_t in_stride      = frame->width
+               * ((f == SOFTFILTER_FMT_XRGB8888)
+                     ? SOFTFILTER_BPP_XRGB8888 : SOFTFILTER_BPP_RGB565);
+            size_t out_stride;
+
+            impl->query_output_size(generic.data, &out_width, &out_height,
+                  frame->width, frame->height);
+            out_stride = out_width * out_bpp;
+
+            test_frame_fill(reference, frame->width, frame->height, k);
+            test_frame_convert(input, f, reference,
+                  frame->width, frame->height);
+
+            /* Some filters keep state across frames, so both
+             * instances see exactly the same sequence */
+            memset(out_generic, 0, out_size);
+            memset(out_simd,    0, out_size);
+
+            t0 = cpu_features_get_time_usec();
+            for (it = 0; it < iterations; it++)
+               filter_run_process(&generic, impl, out_generic, out_stride,
+                     input, frame->width, frame->height, in_stride);
+            t_generic = cpu_features_get_time_usec() - t0;
+
+            t0 = cpu_features_get_time_usec();
+            for (it = 0; it < iterations; it++)
+               filter_run_process(&vec, impl, out_simd, out_stride,
+                     input, frame->width, frame->height, in_stride);
+            t_simd = cpu_features_get_time_usec() - t0;
+
+            for (y = 0; y < out_height; y++)
+            {
+               const uint8_t *row_g = out_generic + y * out_stride;
+               const uint8_t *row_s = out_simd    + y * out_stride;
+               if (memcmp(row_g, row_s, out_width * out_bpp))
+                  ok = false;
+               crc = encoding_crc32(crc, row_g, out_width * out_bpp);
+            }
+
+            snprintf(key, sizeof(key), "%s/%s/%s",
+                  path_basename(path),
+                  f == SOFTFILTER_FMT_XRGB8888 ? "xrgb8888" : "rgb565",
+                  frame->ident);
+
+            if (golden_out)
+               fprintf(golden_out, "%s %08x\n", key, (unsigned)crc);
+            else if (golden_path)
+            {
+               if (!golden_lookup(golden_path, key, &golden))
+               {
+                  printf("%-64s missing from golden file\n", key);
+                  ok = false;
+               }
+               else if (golden != crc)
+               {
+                  printf("%-64s golden %08x != %08x\n", key,
+                        (unsigned)golden, (unsigned)crc);
+                  ok = false;
+               }
+            }
+
+            printf("%-64s %4ux%-4u C %8.1f Mpix/s  SIMD %8.1f Mpix/s  %s\n",
+                  key, frame->width, frame->height,
+                  mpix_per_sec(t_generic, iterations,
+                     frame->width, frame->height),
+                  mpix_per_sec(t_simd, iterations,
+                     frame->width, frame->height),
+                  ok ? "ok" : "FAIL");
+
+            if (!ok)
+               failures++;
+         }
+
+         filter_run_deinit(&generic, impl);
+         filter_run_deinit(&vec, impl);
+      }
+
+      config_file_free(conf);
+   }
+
+   printf("%u presets, %u failures\n", presets, failures);
+
+   if (golden_out)
+      fclose(golden_out);
+   string_list_free(list);
+   free(reference);
+   free(input_buf);
+   free(out_generic);
+   free(out_simd);
+
+   return failures ? 1 : 0;
+}
@@ -18,16 +18,27 @@
 #include <string.h>
 
 #include <file/nbio.h>
+#include <file/file_path.h>
 #include <formats/image.h>
+#ifdef HAVE_RPNG
+#include <formats/rpng.h>
+#endif
+#include <lists/dir_list.h>
 #include <compat/strl.h>
+#include <streams/file_stream.h>
 #include <string/stdstring.h>
 #include <retro_miscellaneous.h>
 #include <features/features_cpu.h>
 
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+
 #include "task_file_transfer.h"
 #include "tasks_internal.h"
 
 #include "../configuration.h"
+#include "../gfx/video_driver.h"
 
 enum image_status_enum
 {
@@ -35,30 +46,81 @@ enum image_status_enum
    IMAGE_STATUS_TRANSFER,
    IMAGE_STATUS_TRANSFER_PARSE,
    IMAGE_STATUS_PROCESS_TRANSFER,
-   IMAGE_STATUS_PROCESS_TRANSFER_PARSE
+   IMAGE_STATUS_PROCESS_TRANSFER_PARSE,
+   IMAGE_STATUS_DECODE
 };
 
 enum image_flags_enum
 {
    IMAGE_FLAG_IS_BLOCKING                = (1 << 0),
    IMAGE_FLAG_IS_BLOCKING_ON_PROCESSING  = (1 << 1),
-   IMAGE_FLAG_IS_FINISHED                = (1 << 2)
+   IMAGE_FLAG_IS_FINISHED                = (1 << 2),
+   /* Aborted by task_image_cancel_thumbnail_loads() */
+   IMAGE_FLAG_IS_THUMBNAIL               = (1 << 3)
+};
+
+enum image_decode_state
+{
+   IMAGE_DECODE_IDLE = 0,
+   IMAGE_DECODE_QUEUED,
+   IMAGE_DECODE_RUNNING,
+   IMAGE_DECODE_DONE
 };
 
 struct nbio_image_handle
 {
    void *handle;
    transfer_cb_t  cb;
+   char *cache_path;
+   struct nbio_image_handle *decode_next;
+   /* Buffer allocated by the decoder. ti.pixels walks through
+    * it row by row until the decode ends, so a decode that is
+    * abandoned half-way has to free this instead */
+   void *decode_buf;
    struct texture_image ti; /* ptr alignment */
    size_t size;
    int processing_final_state;
    unsigned frame_duration;
    unsigned upscale_threshold;
+   unsigned max_width;
+   unsigned max_height;
+   /* Size passed to image_transfer_set_max_size(), which
+    * lets JPEG images decode at a reduced scale */
+   unsigned decode_width;
+   unsigned decode_height;
+   unsigned generation;
    enum image_type_enum type;
    enum image_status_enum status;
+   enum image_decode_state decode_state;
    uint8_t flags;
+   bool decode_cancel;
+};
+
+/* Incremented to abort all pending thumbnail loads */
+static unsigned task_image_thumbnail_generation = 0;
+
+#ifdef HAVE_THREADS
+#define IMAGE_DECODE_MAX_WORKERS 4
+
+/* Images are decoded in one go on a small pool of worker
+ * threads, instead of a slice per iteration on the task
+ * thread. Jobs are taken newest first: when scrolling
+ * through a list, the thumbnails requested last are the
+ * ones on screen now */
+struct task_image_decode_pool
+{
+   sthread_t *workers[IMAGE_DECODE_MAX_WORKERS];
+   slock_t *lock;
+   scond_t *cond;      /* Job queued, or quit */
+   scond_t *done_cond; /* Job finished */
+   struct nbio_image_handle *queue;
+   unsigned num_workers;
+   bool quit;
 };
 
+static struct task_image_decode_pool *task_image_decode_pool = NULL;
+#endif
+
 static int cb_image_upload_generic(void *data, size_t len)
 {
    unsigned r_shift, g_shift, b_shift, a_shift;
@@ -107,6 +169,12 @@ static int task_image_process(
          &image->ti.pixels, image->size, width, height)) == IMAGE_PROCESS_ERROR)
       return IMAGE_PROCESS_ERROR;
 
+   if (     retval == IMAGE_PROCESS_END
+         || retval == IMAGE_PROCESS_ERROR_END)
+      image->decode_buf = NULL;
+   else if (!image->decode_buf)
+      image->decode_buf = image->ti.pixels;
+
    image->ti.width  = *width;
    image->ti.height = *height;
 
@@ -160,16 +228,465 @@ static int task_image_iterate_process_transfer(struct nbio_image_handle *image)
    return -1;
 }
 
+/* Shrinks an image to fit within (max_width x max_height),
+ * averaging the source pixels that fall on each output
+ * pixel */
+static bool downscale_image(
+      unsigned max_width, unsigned max_height,
+      struct texture_image *image_src,
+      struct texture_image *image_dst)
+{
+   unsigned x_dst, y_dst;
+   unsigned *x_bounds = NULL;
+
+   if (!image_src->pixels || (image_src->width < 1) || (image_src->height < 1))
+      return false;
+
+   /* Get output dimensions, preserving aspect ratio */
+   if ((uint64_t)image_src->width * max_height
+         > (uint64_t)image_src->height * max_width)
+   {
+      image_dst->width  = max_width;
+      image_dst->height = (unsigned)(((uint64_t)image_src->height
+               * max_width + image_src->width / 2) / image_src->width);
+   }
+   else
+   {
+      image_dst->height = max_height;
+      image_dst->width  = (unsigned)(((uint64_t)image_src->width
+               * max_height + image_src->height / 2) / image_src->height);
+   }
+
+   if (image_dst->width  < 1)
+      image_dst->width  = 1;
+   if (image_dst->height < 1)
+      image_dst->height = 1;
+
+   if (!(image_dst->pixels = (uint32_t*)malloc(
+         (size_t)image_dst->width * image_dst->height * sizeof(uint32_t))))
+      return false;
+
+   if (!(x_bounds = (unsigned*)malloc((image_dst->width + 1) * sizeof(unsigned))))
+   {
+      free(image_dst->pixels);
+      image_dst->pixels = NULL;
+      return false;
+   }
+
+   for (x_dst = 0; x_dst <= image_dst->width; x_dst++)
+      x_bounds[x_dst] = (unsigned)((uint64_t)x_dst
+            * image_src->width / image_dst->width);
+
+   for (y_dst = 0; y_dst < image_dst->height; y_dst++)
+   {
+      unsigned y0    = (unsigned)((uint64_t)y_dst
+            * image_src->height / image_dst->height);
+      unsigned y1    = (unsigned)((uint64_t)(y_dst + 1)
+            * image_src->height / image_dst->height);
+      uint32_t *out  = image_dst->pixels + (size_t)y_dst * image_dst->width;
+
+      for (x_dst = 0; x_dst < image_dst->width; x_dst++)
+      {
+         unsigned x, y;
+         unsigned x0    = x_bounds[x_dst];
+         unsigned x1    = x_bounds[x_dst + 1];
+         uint32_t count = (x1 - x0) * (y1 - y0);
+         uint32_t a     = count / 2;
+         uint32_t r     = a;
+         uint32_t g     = a;
+         uint32_t b     = a;
+
+         for (y = y0; y < y1; y++)
+         {
+            const uint32_t *in = image_src->pixels
+               + (size_t)y * image_src->width;
+
+            for (x = x0; x < x1; x++)
+            {
+               uint32_t col = in[x];
+               a += (col >> 24);
+               r += (col >> 16) & 0xFF;
+               g += (col >>  8) & 0xFF;
+               b += (col      ) & 0xFF;
+            }
+         }
+
+         out[x_dst] = ((a / count) << 24)
+                    | ((r / count) << 16)
+                    | ((g / count) <<  8)
+                    |  (b / count);
+      }
+   }
+
+   free(x_bounds);
+   return true;
+}
+
+#ifdef HAVE_RPNG
+/* Saves a shrunk image to the disk cache as a PNG,
+ * unless that takes more space than the image it was
+ * shrunk from
+ * > Written to a temporary file first, so that a
+ *   concurrent reader never sees a partial image */
+static bool task_image_write_cache(const char *path,
+      const struct texture_image *image, size_t source_size)
+{
+   size_t _len;
+   int32_t size;
+   char dir[PATH_MAX_LENGTH];
+   char tmp_path[PATH_MAX_LENGTH];
+
+   strlcpy(dir, path, sizeof(dir));
+   path_basedir(dir);
+
+   if (!path_is_directory(dir) && !path_mkdir(dir))
+      return false;
+
+   _len = strlcpy(tmp_path, path, sizeof(tmp_path));
+   strlcpy(tmp_path + _len, ".tmp", sizeof(tmp_path) - _len);
+
+   if (     rpng_save_image_argb(tmp_path, image->pixels,
+               image->width, image->height,
+               image->width * sizeof(uint32_t))
+         && ((size = path_get_size(tmp_path)) > 0)
+         && ((size_t)size < source_size)
+         && !filestream_rename(tmp_path, path))
+      return true;
+
+   filestream_delete(tmp_path);
+   return false;
+}
+#endif
+
+/* Shrinks the decoded image to the requested size,
+ * saving it to the disk cache if required
+ * > Does nothing if the image already fits */
+static void task_image_shrink(struct nbio_image_handle *image)
+{
+   struct texture_image img_resampled = {
+      NULL,
+      0,
+      0,
+      false
+   };
+
+   if (     (image->max_width  < 1)
+         || (image->max_height < 1)
+         || ((image->ti.width  <= image->max_width)
+         &&  (image->ti.height <= image->max_height)))
+      return;
+
+   if (!downscale_image(image->max_width, image->max_height,
+            &image->ti, &img_resampled))
+      return;
+
+   image->ti.width  = img_resampled.width;
+   image->ti.height = img_resampled.height;
+
+   if (image->ti.pixels)
+      free(image->ti.pixels);
+   image->ti.pixels = img_resampled.pixels;
+
+#ifdef HAVE_RPNG
+   /* JPEG sources are already decoded at a reduced
+    * scale, and a PNG of them is rarely any smaller */
+   if (image->cache_path && image->type != IMAGE_TYPE_JPEG)
+      task_image_write_cache(image->cache_path, &image->ti, image->size);
+#endif
+}
+
+/* Returns true if a thumbnail load has been aborted
+ * by task_image_cancel_thumbnail_loads()
+ * > Once the decode pool exists, the generation
+ *   counter is shared with its threads, and only
+ *   accessed under its lock */
+static bool task_image_is_stale(struct nbio_image_handle *image)
+{
+   bool stale;
+#ifdef HAVE_THREADS
+   struct task_image_decode_pool *pool = task_image_decode_pool;
+
+   if (pool)
+      slock_lock(pool->lock);
+#endif
+   stale = (image->flags & IMAGE_FLAG_IS_THUMBNAIL)
+      && (image->generation != task_image_thumbnail_generation);
+#ifdef HAVE_THREADS
+   if (pool)
+   {
+      stale = stale || image->decode_cancel;
+      slock_unlock(pool->lock);
+   }
+#endif
+   return stale;
+}
+
+#ifdef HAVE_THREADS
+/* Runs a whole decode, checking for cancellation
+ * between steps. Returns the final process state */
+static int task_image_decode(struct nbio_image_handle *image)
+{
+   int retval;
+   unsigned width  = 0;
+   unsigned height = 0;
+
+   while (image_transfer_iterate(image->handle, image->type))
+   {
+      if (task_image_is_stale(image))
+         return IMAGE_PROCESS_ERROR;
+   }
+
+   do
+   {
+      if (task_image_is_stale(image))
+         return IMAGE_PROCESS_ERROR;
+      retval = task_image_process(image, &width, &height);
+   } while (retval == IMAGE_PROCESS_NEXT);
+
+   if (retval == IMAGE_PROCESS_END)
+      task_image_shrink(image);
+
+   return retval;
+}
+
+static void task_image_decode_thread(void *data)
+{
+   struct task_image_decode_pool *pool = (struct task_image_decode_pool*)data;
+
+   slock_lock(pool->lock);
+
+   for (;;)
+   {
+      int retval;
+      struct nbio_image_handle *image = NULL;
+
+      while (!pool->queue && !pool->quit)
+         scond_wait(pool->cond, pool->lock);
+
+      if (pool->quit)
+         break;
+
+      image               = pool->queue;
+      pool->queue         = image->decode_next;
+      image->decode_next  = NULL;
+      image->decode_state = IMAGE_DECODE_RUNNING;
+      slock_unlock(pool->lock);
+
+      retval              = task_image_decode(image);
+
+      slock_lock(pool->lock);
+      image->processing_final_state = retval;
+      image->decode_state           = IMAGE_DECODE_DONE;
+      scond_broadcast(pool->done_cond);
+   }
+
+   slock_unlock(pool->lock);
+}
+
+static struct task_image_decode_pool *task_image_decode_pool_get(void)
+{
+   unsigned i, num_workers;
+   struct task_image_decode_pool *pool = task_image_decode_pool;
+
+   if (pool)
+      return pool;
+
+   if (!(pool = (struct task_image_decode_pool*)calloc(1, sizeof(*pool))))
+      return NULL;
+
+   pool->lock      = slock_new();
+   pool->cond      = scond_new();
+   pool->done_cond = scond_new();
+
+   if (!pool->lock || !pool->cond || !pool->done_cond)
+      goto error;
+
+   /* Leave a core for the main thread */
+   num_workers = cpu_features_get_core_amount();
+   num_workers = (num_workers > 1) ? num_workers - 1 : 1;
+   if (num_workers > IMAGE_DECODE_MAX_WORKERS)
+      num_workers = IMAGE_DECODE_MAX_WORKERS;
+
+   for (i = 0; i < num_workers; i++)
+   {
+      if (!(pool->workers[i] = sthread_create(
+                  task_image_decode_thread, pool)))
+         break;
+      pool->num_workers++;
+   }
+
+   if (!pool->num_workers)
+      goto error;
+
+   task_image_decode_pool = pool;
+   return pool;
+
+error:
+   if (pool->done_cond)
+      scond_free(pool->done_cond);
+   if (pool->cond)
+      scond_free(pool->cond);
+   if (pool->lock)
+      slock_free(pool->lock);
+   free(pool);
+   return NULL;
+}
+
+static bool task_image_decode_push(struct nbio_image_handle *image)
+{
+   struct task_image_decode_pool *pool = task_image_decode_pool_get();
+
+   if (!pool)
+      return false;
+
+   slock_lock(pool->lock);
+   image->decode_cancel = false;
+   image->decode_state  = IMAGE_DECODE_QUEUED;
+   image->decode_next   = pool->queue;
+   pool->queue          = image;
+   scond_signal(pool->cond);
+   slock_unlock(pool->lock);
+
+   return true;
+}
+
+/* Returns true once the decode has finished. When
+ * not called from the main thread, waits a little
+ * for it, rather than have the task thread spin */
+static bool task_image_decode_poll(struct nbio_image_handle *image,
+      bool wait)
+{
+   bool done;
+   struct task_image_decode_pool *pool = task_image_decode_pool;
+
+   slock_lock(pool->lock);
+   if (wait && image->decode_state != IMAGE_DECODE_DONE)
+      scond_wait_timeout(pool->done_cond, pool->lock, 1000);
+   done = (image->decode_state == IMAGE_DECODE_DONE);
+   slock_unlock(pool->lock);
+
+   return done;
+}
+
+/* Takes an image out of the pool, waiting for its
+ * decode to stop if it has already started */
+static void task_image_decode_cancel(struct nbio_image_handle *image)
+{
+   struct task_image_decode_pool *pool = task_image_decode_pool;
+
+   if (!pool)
+      return;
+
+   slock_lock(pool->lock);
+
+   if (image->decode_state == IMAGE_DECODE_IDLE)
+   {
+      slock_unlock(pool->lock);
+      return;
+   }
+
+   if (image->decode_state == IMAGE_DECODE_QUEUED)
+   {
+      struct nbio_image_handle **link = &pool->queue;
+      while (*link != image)
+         link = &(*link)->decode_next;
+      *link = image->decode_next;
+   }
+   else
+   {
+      image->decode_cancel = true;
+      while (image->decode_state == IMAGE_DECODE_RUNNING)
+         scond_wait(pool->done_cond, pool->lock);
+   }
+
+   image->decode_next  = NULL;
+   image->decode_state = IMAGE_DECODE_IDLE;
+   slock_unlock(pool->lock);
+}
+#endif
+
+static unsigned task_image_get_generation(void)
+{
+   unsigned generation;
+#ifdef HAVE_THREADS
+   struct task_image_decode_pool *pool = task_image_decode_pool;
+
+   if (pool)
+      slock_lock(pool->lock);
+#endif
+   generation = task_image_thumbnail_generation;
+#ifdef HAVE_THREADS
+   if (pool)
+      slock_unlock(pool->lock);
+#endif
+   return generation;
+}
+
+void task_image_cancel_thumbnail_loads(void)
+{
+#ifdef HAVE_THREADS
+   struct task_image_decode_pool *pool = task_image_decode_pool;
+
+   if (pool)
+      slock_lock(pool->lock);
+#endif
+   task_image_thumbnail_generation++;
+#ifdef HAVE_THREADS
+   if (pool)
+      slock_unlock(pool->lock);
+#endif
+}
+
+void task_image_deinit(void)
+{
+#ifdef HAVE_THREADS
+   unsigned i;
+   struct task_image_decode_pool *pool = task_image_decode_pool;
+
+   if (!pool)
+      return;
+
+   slock_lock(pool->lock);
+   pool->quit = true;
+   scond_broadcast(pool->cond);
+   slock_unlock(pool->lock);
+
+   for (i = 0; i < pool->num_workers; i++)
+      sthread_join(pool->workers[i]);
+
+   scond_free(pool->done_cond);
+   scond_free(pool->cond);
+   slock_free(pool->lock);
+   free(pool);
+   task_image_decode_pool = NULL;
+#endif
+}
+
 static void task_image_cleanup(nbio_handle_t *nbio)
 {
    struct nbio_image_handle *image = (struct nbio_image_handle*)nbio->data;
 
    if (image)
    {
+#ifdef HAVE_THREADS
+      task_image_decode_cancel(image);
+#endif
       image_transfer_free(image->handle, image->type);
 
-      image->handle  = NULL;
-      image->cb      = NULL;
+      /* Output of a failed or cancelled decode */
+      if (image->decode_buf)
+         free(image->decode_buf);
+      else if (image->ti.pixels)
+         free(image->ti.pixels);
+      image->decode_buf = NULL;
+      image->ti.pixels  = NULL;
+
+      if (image->cache_path)
+         free(image->cache_path);
+
+      image->handle     = NULL;
+      image->cb         = NULL;
+      image->cache_path = NULL;
    }
    if (!string_is_empty(nbio->path))
       free(nbio->path);
@@ -211,6 +728,8 @@ static int cb_nbio_image_thumbnail(void *data, size_t len)
    ptr                             = nbio_get_ptr(nbio->handle, &len);
 
    image_transfer_set_buffer_ptr(image->handle, image->type, ptr, len);
+   image_transfer_set_max_size(image->handle, image->type,
+         image->decode_width, image->decode_height);
 
    /* Set image size */
    image->size                     = len;
@@ -229,6 +748,15 @@ static int cb_nbio_image_thumbnail(void *data, size_t len)
       return -1;
    }
 
+#ifdef HAVE_THREADS
+   if (task_image_decode_push(image))
+   {
+      image->status                = IMAGE_STATUS_DECODE;
+      nbio->is_finished            = true;
+      return 0;
+   }
+#endif
+
    image->flags                   &= ~IMAGE_FLAG_IS_BLOCKING;
    image->flags                   &= ~IMAGE_FLAG_IS_FINISHED;
    nbio->is_finished               = true;
@@ -283,12 +811,30 @@ bool task_image_load_handler(retro_task_t *task)
    nbio_handle_t            *nbio  = (nbio_handle_t*)task->state;
    struct nbio_image_handle *image = (struct nbio_image_handle*)nbio->data;
 
+   /* Thumbnail loads are dropped as soon as they are no
+    * longer wanted, even part way through decoding */
+   if (image && task_image_is_stale(image))
+      task_set_flags(task, RETRO_TASK_FLG_CANCELLED, true);
+
+   if (task_get_flags(task) & RETRO_TASK_FLG_CANCELLED)
+      return false;
+
    if (image)
    {
       switch (image->status)
       {
          case IMAGE_STATUS_WAIT:
             return true;
+#ifdef HAVE_THREADS
+         case IMAGE_STATUS_DECODE:
+            if (!task_image_decode_poll(image, !task_is_on_main_thread()))
+               return true;
+            image->decode_state = IMAGE_DECODE_IDLE;
+            image->cb           = &cb_image_upload_generic;
+            if (image->cb(nbio, 0) == -1)
+               return false;
+            break;
+#endif
          case IMAGE_STATUS_PROCESS_TRANSFER:
             if (task_image_iterate_process_transfer(image) == -1)
                image->status = IMAGE_STATUS_PROCESS_TRANSFER_PARSE;
@@ -341,6 +887,11 @@ bool task_image_load_handler(retro_task_t *task)
 
       if (img)
       {
+         /* Downscale image, if required, and keep the
+          * result for the next time it is requested
+          * (already done if decoded on a worker thread) */
+         task_image_shrink(image);
+
          /* Upscale image, if required */
          if (image->upscale_threshold > 0)
          {
@@ -379,6 +930,7 @@ bool task_image_load_handler(retro_task_t *task)
          img->height        = image->ti.height;
          img->pixels        = image->ti.pixels;
          img->supports_rgba = image->ti.supports_rgba;
+         image->ti.pixels   = NULL;
       }
 
       task_set_data(task, img);
@@ -389,8 +941,11 @@ bool task_image_load_handler(retro_task_t *task)
    return true;
 }
 
-bool task_push_image_load(const char *fullpath,
+static bool task_image_push(const char *fullpath,
+      const char *cache_path,
       bool supports_rgba, unsigned upscale_threshold,
+      unsigned max_width, unsigned max_height,
+      unsigned decode_width, unsigned decode_height, bool thumbnail,
       retro_task_callback_t cb, void *user_data)
 {
    nbio_handle_t             *nbio   = NULL;
@@ -433,6 +988,25 @@ bool task_push_image_load(const char *fullpath,
    image->frame_duration             = 0;
    image->size                       = 0;
    image->upscale_threshold          = upscale_threshold;
+   image->max_width                  = max_width;
+   image->max_height                 = max_height;
+   image->decode_width               = decode_width;
+   image->decode_height              = decode_height;
+#ifdef HAVE_THREADS
+   /* Start the decode threads before the first task is
+    * queued, so that the generation counter is always
+    * accessed under the pool lock once other threads
+    * can see it */
+   task_image_decode_pool_get();
+#endif
+
+   image->cache_path                 = cache_path ? strdup(cache_path) : NULL;
+   image->decode_next                = NULL;
+   image->decode_buf                 = NULL;
+   image->generation                 = task_image_get_generation();
+   image->decode_state               = IMAGE_DECODE_IDLE;
+   image->decode_cancel              = false;
+   image->flags                      = thumbnail ? IMAGE_FLAG_IS_THUMBNAIL : 0;
    image->handle                     = NULL;
 
    image->ti.width                   = 0;
@@ -472,3 +1046,144 @@ bool task_push_image_load(const char *fullpath,
 
    return true;
 }
+
+bool task_push_image_load(const char *fullpath,
+      bool supports_rgba, unsigned upscale_threshold,
+      retro_task_callback_t cb, void *user_data)
+{
+   return task_image_push(fullpath, NULL, supports_rgba,
+         upscale_threshold, 0, 0, 0, 0, false, cb, user_data);
+}
+
+bool task_push_wallpaper_load(const char *fullpath,
+      bool supports_rgba, retro_task_callback_t cb, void *user_data)
+{
+   unsigned width  = 0;
+   unsigned height = 0;
+
+   video_driver_get_size(&width, &height);
+
+   return task_image_push(fullpath, NULL, supports_rgba,
+         0, 0, 0, width, height, false, cb, user_data);
+}
+
+bool task_push_thumbnail_load(const char *fullpath,
+      const char *cache_path,
+      bool supports_rgba, unsigned upscale_threshold,
+      unsigned max_width, unsigned max_height,
+      retro_task_callback_t cb, void *user_data)
+{
+   return task_image_push(fullpath, cache_path, supports_rgba,
+         upscale_threshold, max_width, max_height,
+         max_width, max_height, true, cb, user_data);
+}
+
+/* Shrunk thumbnail copies are deleted until they fit
+ * in this many bytes, see task_push_thumbnail_cache_trim() */
+typedef struct
+{
+   char *dir;
+   char *suffix;
+   uint64_t max_size;
+} thumbnail_cache_trim_t;
+
+static void task_thumbnail_cache_trim_handler(retro_task_t *task)
+{
+   size_t i;
+   int pass;
+   uint64_t total                = 0;
+   thumbnail_cache_trim_t *trim  = (thumbnail_cache_trim_t*)task->state;
+   struct string_list *list      = dir_list_new(trim->dir, NULL,
+         false, true, false, true);
+
+   if (list)
+   {
+      for (i = 0; i < list->size; i++)
+      {
+         const char *path = list->elems[i].data;
+         int32_t size     = path_get_size(path);
+
+         /* Left behind by an interrupted write */
+         if (string_ends_with(path, ".tmp"))
+         {
+            filestream_delete(path);
+            size = -1;
+         }
+
+         list->elems[i].attr.i = size;
+         if (size > 0)
+            total += (uint64_t)size;
+      }
+
+      /* VFS has no access times, so copies made for a
+       * different thumbnail size go first, then the rest
+       * in directory order */
+      for (pass = 0; pass < 2 && total > trim->max_size; pass++)
+      {
+         for (i = 0; i < list->size && total > trim->max_size; i++)
+         {
+            const char *path = list->elems[i].data;
+
+            if (     (list->elems[i].attr.i <= 0)
+                  || (pass == 0 && string_ends_with(path, trim->suffix)))
+               continue;
+
+            if (!filestream_delete(path))
+               total -= (uint64_t)list->elems[i].attr.i;
+            list->elems[i].attr.i = 0;
+         }
+      }
+
+      string_list_free(list);
+   }
+
+   task_set_flags(task, RETRO_TASK_FLG_FINISHED, true);
+}
+
+static void task_thumbnail_cache_trim_free(retro_task_t *task)
+{
+   thumbnail_cache_trim_t *trim = task
+      ? (thumbnail_cache_trim_t*)task->state : NULL;
+
+   if (trim)
+   {
+      free(trim->dir);
+      free(trim->suffix);
+      free(trim);
+   }
+}
+
+bool task_push_thumbnail_cache_trim(const char *dir,
+      const char *suffix, uint64_t max_size)
+{
+   retro_task_t *t              = NULL;
+   thumbnail_cache_trim_t *trim = NULL;
+
+   if (!path_is_directory(dir))
+      return false;
+
+   if (!(trim = (thumbnail_cache_trim_t*)malloc(sizeof(*trim))))
+      return false;
+
+   trim->dir      = strdup(dir);
+   trim->suffix   = strdup(suffix);
+   trim->max_size = max_size;
+
+   if (     !trim->dir
+         || !trim->suffix
+         || !(t = task_init()))
+   {
+      free(trim->dir);
+      free(trim->suffix);
+      free(trim);
+      return false;
+   }
+
+   t->state    = trim;
+   t->handler  = task_thumbnail_cache_trim_handler;
+   t->cleanup  = task_thumbnail_cache_trim_free;
+   t->flags   |= RETRO_TASK_FLG_MUTE;
+
+   task_queue_push(t);
+   return true;
+}
@@ -15,6 +15,7 @@
  *  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdio.h>
 #include <stdint.h>
 #include <stddef.h>
 #include <string.h>
@@ -46,6 +47,10 @@
 #include "../gfx/gfx_widgets.h"
 #endif
 
+#ifdef HAVE_MENU
+#include "../menu/menu_driver.h"
+#endif
+
 #include "../defaults.h"
 #include "../command.h"
 #include "../configuration.h"
@@ -77,9 +82,11 @@ struct screenshot_task_state
    void *userbuf;
 
    int pitch;
+   int png_level;
    unsigned width;
    unsigned height;
    unsigned pixel_format_type;
+   unsigned png_flags;
 
    uint8_t flags;
 
@@ -93,30 +100,46 @@ static bool screenshot_dump_direct(screenshot_task_state_t *state)
    bool ret                      = false;
 
 #if defined(HAVE_RPNG)
+   /* Viewport reads are BGR24 already, encode them
+    * bottom-up as they are instead of flipping a copy */
    if (state->flags & SS_TASK_FLAG_BGR24)
-      scaler->in_fmt             = SCALER_FMT_BGR24;
-   else if (state->pixel_format_type == RETRO_PIXEL_FORMAT_XRGB8888)
-      scaler->in_fmt             = SCALER_FMT_ARGB8888;
+      ret = rpng_save_image_bgr24_ex(
+            state->filename,
+            (const uint8_t*)state->frame + ((int)state->height - 1)
+            * state->pitch,
+            state->width,
+            state->height,
+            -state->pitch,
+            state->png_level,
+            state->png_flags
+            );
    else
-      scaler->in_fmt             = SCALER_FMT_RGB565;
-
-   video_frame_convert_to_bgr24(
-         scaler,
-         state->out_buffer,
-         (const uint8_t*)state->frame + ((int)state->height - 1)
-         * state->pitch,
-         state->width, state->height,
-         -state->pitch);
-
-   scaler_ctx_gen_reset(&state->scaler);
-
-   ret = rpng_save_image_bgr24(
-         state->filename,
-         state->out_buffer,
-         state->width,
-         state->height,
-         state->width * 3
-         );
+   {
+      if (state->pixel_format_type == RETRO_PIXEL_FORMAT_XRGB8888)
+         scaler->in_fmt          = SCALER_FMT_ARGB8888;
+      else
+         scaler->in_fmt          = SCALER_FMT_RGB565;
+
+      video_frame_convert_to_bgr24(
+            scaler,
+            state->out_buffer,
+            (const uint8_t*)state->frame + ((int)state->height - 1)
+            * state->pitch,
+            state->width, state->height,
+            -state->pitch);
+
+      scaler_ctx_gen_reset(&state->scaler);
+
+      ret = rpng_save_image_bgr24_ex(
+            state->filename,
+            state->out_buffer,
+            state->width,
+            state->height,
+            state->width * 3,
+            state->png_level,
+            state->png_flags
+            );
+   }
 
    free(state->out_buffer);
 #elif defined(HAVE_RBMP)
@@ -252,30 +275,33 @@ static void task_screenshot_callback(retro_task_t *task,
 }
 #endif
 
-/* Take frame bottom-up. */
-static bool screenshot_dump(
+/* Numbers the frames of a burst, "name.png" becomes "name-01.png" */
+static void screenshot_burst_name(char *s, size_t len, unsigned burst_index)
+{
+   size_t _len;
+   path_remove_extension(s);
+   _len = strlen(s);
+   snprintf(s + _len, len - _len, "-%02u." IMG_EXT, burst_index);
+}
+
+/* Works out where a screenshot goes. @burst_index numbers
+ * the frames of a burst from 1, 0 for a single screenshot. */
+static screenshot_task_state_t *screenshot_state_new(
       const char *screenshot_dir,
       const char *name_base,
-      const void *frame,
-      unsigned width,
-      unsigned height,
-      int pitch,
-      bool bgr24,
-      void *userbuf,
       bool savestate,
       uint32_t runloop_flags,
       bool fullpath,
-      bool use_thread,
-      unsigned pixel_format_type)
+      unsigned pixel_format_type,
+      unsigned burst_index)
 {
-   uint8_t *buf                   = NULL;
    settings_t *settings           = config_get_ptr();
    bool history_list_enable       = settings->bools.history_list_enable;
    screenshot_task_state_t *state = (screenshot_task_state_t*)
          calloc(1, sizeof(*state));
 
    if (!state)
-      return false;
+      return NULL;
 
    /* If fullpath is true, name_base already contains a
     * static path + filename to save the screenshot to. */
@@ -286,13 +312,6 @@ static bool screenshot_dump(
       state->flags              |= SS_TASK_FLAG_IS_IDLE;
    if (runloop_flags & RUNLOOP_FLAG_PAUSED)
       state->flags              |= SS_TASK_FLAG_IS_PAUSED;
-   if (bgr24)
-      state->flags              |= SS_TASK_FLAG_BGR24;
-   state->height                 = height;
-   state->width                  = width;
-   state->pitch                  = pitch;
-   state->frame                  = frame;
-   state->userbuf                = userbuf;
 #if defined(HAVE_GFX_WIDGETS)
    if (gfx_widgets_ready())
       state->flags              |= SS_TASK_FLAG_WIDGETS_READY;
@@ -303,6 +322,11 @@ static bool screenshot_dump(
    if (history_list_enable)
       state->flags              |= SS_TASK_FLAG_HISTORY_LIST_ENABLE;
    state->pixel_format_type      = pixel_format_type;
+#if defined(HAVE_RPNG)
+   state->png_level              = (int)settings->uints.screenshot_png_compression;
+   if (settings->bools.screenshot_png_fast_filter)
+      state->png_flags          |= RPNG_ENCODE_FAST_FILTER;
+#endif
 
    if (!fullpath)
    {
@@ -351,7 +375,7 @@ static bool screenshot_dump(
                if (!core_get_system_info(&sysinfo))
                {
                   free(state);
-                  return false;
+                  return NULL;
                }
 
                if (string_is_empty(sysinfo.library_name))
@@ -385,25 +409,41 @@ static bool screenshot_dump(
 
          /* Create screenshot directory, if required */
          if (!path_is_directory(new_screenshot_dir))
+         {
             if (!path_mkdir(new_screenshot_dir))
-               return false;
+            {
+               free(state);
+               return NULL;
+            }
+         }
       }
    }
 
-#if defined(HAVE_RPNG)
-   if (!(buf = (uint8_t*)malloc(width * height * 3)))
+   if (burst_index)
    {
-      free(state);
-      return false;
+      screenshot_burst_name(state->filename,
+            sizeof(state->filename), burst_index);
+      if (!string_is_empty(state->shotname))
+         screenshot_burst_name(state->shotname,
+               sizeof(state->shotname), burst_index);
    }
-   state->out_buffer     = buf;
-#endif
+
+   return state;
+}
+
+/* Encodes and saves @state, on the task thread if @use_thread.
+ * Takes over @state either way, but not the frame if the push fails. */
+static bool screenshot_task_push(screenshot_task_state_t *state,
+      bool savestate, bool use_thread, enum task_type type)
+{
+   bool ret;
+   settings_t *settings = config_get_ptr();
 
    if (use_thread)
    {
       retro_task_t *task = task_init();
 
-      task->type         = TASK_TYPE_BLOCKING;
+      task->type         = type;
       task->state        = state;
       task->handler      = task_screenshot_handler;
       if (savestate)
@@ -442,7 +482,115 @@ static bool screenshot_dump(
       return false;
    }
 
-   return screenshot_dump_direct(state);
+   ret = screenshot_dump_direct(state);
+   free(state);
+   return ret;
+}
+
+/* Take frame bottom-up. */
+static bool screenshot_dump(
+      const char *screenshot_dir,
+      const char *name_base,
+      const void *frame,
+      unsigned width,
+      unsigned height,
+      int pitch,
+      bool bgr24,
+      void *userbuf,
+      bool savestate,
+      uint32_t runloop_flags,
+      bool fullpath,
+      bool use_thread,
+      unsigned pixel_format_type)
+{
+   screenshot_task_state_t *state = screenshot_state_new(
+         screenshot_dir, name_base, savestate, runloop_flags,
+         fullpath, pixel_format_type, 0);
+
+   if (!state)
+      return false;
+
+   if (bgr24)
+      state->flags              |= SS_TASK_FLAG_BGR24;
+   state->height                 = height;
+   state->width                  = width;
+   state->pitch                  = pitch;
+   state->frame                  = frame;
+   state->userbuf                = userbuf;
+
+#if defined(HAVE_RPNG)
+   if (!bgr24)
+   {
+      if (!(state->out_buffer = (uint8_t*)malloc(width * height * 3)))
+      {
+         free(state);
+         return false;
+      }
+   }
+#endif
+
+   return screenshot_task_push(state, savestate, use_thread,
+         TASK_TYPE_BLOCKING);
+}
+
+/* A frame queued by take_screenshot_async() was read back */
+static void screenshot_readback_cb(void *userdata,
+      uint8_t *buffer, unsigned width, unsigned height)
+{
+   screenshot_task_state_t *state = (screenshot_task_state_t*)userdata;
+
+   if (!buffer)
+   {
+      free(state);
+      return;
+   }
+
+   state->height                  = height;
+   state->width                   = width;
+   state->pitch                   = width * 3;
+   state->frame                   = buffer;
+   state->userbuf                 = buffer;
+
+   /* Nothing waits on this one, so it queues up behind
+    * other screenshots rather than being turned away */
+   if (!screenshot_task_push(state, false, true, TASK_TYPE_NONE))
+      free(buffer);
+}
+
+/* Queues @frames consecutive viewport captures with the driver,
+ * which hands each over once the GPU is done with it. Encoding
+ * happens on the task thread, so gameplay never waits. */
+static bool take_screenshot_async(
+      video_driver_state_t *video_st,
+      const char *screenshot_dir,
+      const char *name_base,
+      uint32_t runloop_flags,
+      bool fullpath,
+      unsigned pixel_format_type,
+      unsigned frames)
+{
+   unsigned i;
+
+   for (i = 0; i < frames; i++)
+   {
+      screenshot_task_state_t *state = screenshot_state_new(
+            screenshot_dir, name_base, false, runloop_flags, fullpath,
+            pixel_format_type, (frames > 1) ? i + 1 : 0);
+
+      if (!state)
+         break;
+
+      state->flags |= SS_TASK_FLAG_BGR24;
+
+      if (!video_st->poke->read_viewport_async(video_st->data,
+               screenshot_readback_cb, state))
+      {
+         free(state);
+         break;
+      }
+   }
+
+   return i > 0;
 }
 
 static bool take_screenshot_viewport(
@@ -539,11 +687,18 @@ static bool take_screenshot_choice(
       bool use_thread,
       bool supports_vp_read,
       bool supports_read_frame_raw,
-      unsigned pixel_format_type
+      unsigned pixel_format_type,
+      unsigned async_frames
       )
 {
    if (supports_vp_read)
    {
+      if (     async_frames
+            && take_screenshot_async(video_st, screenshot_dir,
+               name_base, runloop_flags, fullpath,
+               pixel_format_type, async_frames))
+         return true;
+
       /* Avoid taking screenshot of GUI overlays. */
       if (video_st->poke && video_st->poke->set_texture_enable)
          video_st->poke->set_texture_enable(video_st->data,
@@ -600,6 +755,7 @@ bool take_screenshot(
    bool supports_vp_read          = video_st->current_video->read_viewport
          && (video_st->current_video->viewport_info);
    bool prefer_vp_read            = false;
+   unsigned async_frames          = 0;
    if (supports_vp_read)
    {
       /* Use VP read screenshots if it's a HW context core
@@ -612,6 +768,22 @@ bool take_screenshot(
          prefer_vp_read           = true;
    }
 
+   /* Read back in the background while the game runs on.
+    * Paused and menu screenshots re-render the cached frame
+    * without the menu, which needs the synchronous path. */
+   if (     prefer_vp_read
+         && use_thread
+         && !savestate
+         && settings->bools.video_gpu_screenshot_async
+         && video_st->poke
+         && video_st->poke->read_viewport_async
+         && !(runloop_flags & (RUNLOOP_FLAG_IDLE | RUNLOOP_FLAG_PAUSED))
+#ifdef HAVE_MENU
+         && !(menu_state_get_ptr()->flags & MENU_ST_FLAG_ALIVE)
+#endif
+         )
+      async_frames                = settings->uints.screenshot_burst_frames;
+
    /* No way to infer screenshot directory. */
    if (     string_is_empty(screenshot_dir)
          && string_is_empty(name_base))
@@ -628,7 +800,8 @@ bool take_screenshot(
          use_thread,
          prefer_vp_read,
          (video_st->current_video->read_frame_raw != NULL),
-         video_st->pix_fmt
+         video_st->pix_fmt,
+         async_frames
          );
 
    if (       (runloop_flags & RUNLOOP_FLAG_PAUSED)
@@ -183,6 +183,38 @@ bool task_push_image_load(const char *fullpath,
       bool supports_rgba, unsigned upscale_threshold,
       retro_task_callback_t cb, void *userdata);
 
+/* Like task_push_image_load(), but shrinks images larger
+ * than (max_width x max_height) to fit. If 'cache_path'
+ * is set, the shrunk image is also saved there as a PNG
+ * file (if smaller than the original), which can be
+ * loaded instead of the original next time */
+bool task_push_thumbnail_load(const char *fullpath,
+      const char *cache_path,
+      bool supports_rgba, unsigned upscale_threshold,
+      unsigned max_width, unsigned max_height,
+      retro_task_callback_t cb, void *userdata);
+
+/* Like task_push_image_load(), for wallpapers stretched
+ * over the whole screen. JPEG images at least twice the
+ * size of the screen are decoded at a reduced scale that
+ * still fits it */
+bool task_push_wallpaper_load(const char *fullpath,
+      bool supports_rgba, retro_task_callback_t cb, void *userdata);
+
+/* Deletes files under 'dir' until they take no more
+ * than 'max_size' bytes, starting with those whose
+ * name does not end with 'suffix' */
+bool task_push_thumbnail_cache_trim(const char *dir,
+      const char *suffix, uint64_t max_size);
+
+/* Aborts every pending task_push_thumbnail_load(),
+ * including decodes already in progress. Their
+ * callbacks still run, without image data */
+void task_image_cancel_thumbnail_loads(void);
+
+/* Stops the image decode worker threads */
+void task_image_deinit(void);
+
 #ifdef HAVE_LIBRETRODB
 bool task_push_dbscan(
       const char *playlist_directory,
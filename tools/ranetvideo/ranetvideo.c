@@ -0,0 +1,361 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Reference decoder for the encoded network video stream
+ * (NETWORK_VIDEO_ENCODE=1), see gfx/common/network_video_codec.h.
+ *
+ *    ranetvideo [-p port] [-o file]   receive a stream from RetroArch
+ *    ranetvideo -t                    encode/decode self test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compat/getopt.h"
+#include "net/net_compat.h"
+#include "net/net_socket.h"
+
+#include "../../gfx/common/network_video_codec.h"
+
+#define TILE NETWORK_VIDEO_TILE_SIZE
+
+typedef struct
+{
+   void *codec;
+   uint32_t *frame;
+   unsigned width;
+   unsigned height;
+} decoder_t;
+
+/* Rebuilds one frame from its tile records on top of the previous one */
+static bool decode_frame(decoder_t *dec,
+      const network_video_frame_header_t *header, const uint8_t *payload)
+{
+   unsigned x, y;
+   size_t pos = 0;
+
+   if (     header->width  != dec->width
+         || header->height != dec->height)
+   {
+      if (!(header->flags & NETWORK_VIDEO_FRAME_KEY))
+         return false;
+      free(dec->frame);
+      dec->width  = header->width;
+      dec->height = header->height;
+      if (!(dec->frame = (uint32_t*)malloc(
+                  (size_t)dec->width * dec->height * sizeof(uint32_t))))
+         return false;
+   }
+
+   if (header->flags & NETWORK_VIDEO_FRAME_KEY)
+      memset(dec->frame, 0,
+            (size_t)dec->width * dec->height * sizeof(uint32_t));
+
+   for (y = 0; y < dec->height; y += header->tile_size)
+   {
+      for (x = 0; x < dec->width; x += header->tile_size)
+      {
+         unsigned w  = dec->width  - x;
+         unsigned h  = dec->height - y;
+         size_t used;
+
+         if (w > header->tile_size)
+            w = header->tile_size;
+         if (h > header->tile_size)
+            h = header->tile_size;
+
+         if (!(used = network_video_decode_tile(dec->codec,
+                     payload + pos, header->size - pos,
+                     dec->frame + (size_t)y * dec->width + x,
+                     dec->width, w, h)))
+            return false;
+         pos += used;
+      }
+   }
+
+   return pos == header->size;
+}
+
+/* Synthetic content: a static background, a scrolling band and
+ * a moving sprite, which is roughly what games send */
+static void make_frame(uint32_t *frame, unsigned width, unsigned height,
+      unsigned n)
+{
+   unsigned x, y;
+
+   for (y = 0; y < height; y++)
+      for (x = 0; x < width; x++)
+         frame[y * width + x] = 0xFF000000 | ((x >> 4) << 16) | (y >> 2);
+
+   for (y = height / 2; y < height / 2 + 16 && y < height; y++)
+      for (x = 0; x < width; x++)
+         frame[y * width + x] = 0xFF000000 | (((x + n * 3) & 0xFF) << 8);
+
+   for (y = 0; y < 24; y++)
+      for (x = 0; x < 24; x++)
+      {
+         unsigned sx = (n * 5 + x) % width;
+         unsigned sy = (n * 2 + y) % height;
+         frame[sy * width + sx] = 0xFFFF00FF ^ (x * y);
+      }
+
+   /* A little noise now and then */
+   if (n % 7 == 0)
+      frame[(n * 7919) % (width * height)] ^= 0x00123456;
+}
+
+static int self_test(void)
+{
+   static const unsigned sizes[][2] = {
+      { 256, 224 }, { 320, 240 }, { 333, 201 }, { 640, 480 }
+   };
+   unsigned s, n, i;
+   int ret            = 0;
+   void *enc_codec    = network_video_codec_new(true,  TILE);
+   decoder_t dec;
+   size_t bound       = network_video_tile_bound(TILE);
+
+   memset(&dec, 0, sizeof(dec));
+   dec.codec          = network_video_codec_new(false, TILE);
+
+   if (!enc_codec || !dec.codec)
+      return 1;
+
+   for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+   {
+      unsigned width     = sizes[s][0];
+      unsigned height    = sizes[s][1];
+      unsigned tiles_x   = (width  + TILE - 1) / TILE;
+      unsigned tiles_y   = (height + TILE - 1) / TILE;
+      size_t pixels      = (size_t)width * height;
+      uint32_t *frame    = (uint32_t*)malloc(pixels * sizeof(uint32_t));
+      uint32_t *prev     = (uint32_t*)calloc(pixels, sizeof(uint32_t));
+      uint8_t *payload   = (uint8_t*)malloc(tiles_x * tiles_y * bound);
+      uint64_t total     = 0;
+      unsigned frames    = 120;
+
+      if (!frame || !prev || !payload)
+         return 1;
+
+      for (n = 0; n < frames; n++)
+      {
+         network_video_frame_header_t header;
+         size_t size = 0;
+         unsigned tx, ty;
+
+         make_frame(frame, width, height, n);
+
+         for (ty = 0; ty < tiles_y; ty++)
+            for (tx = 0; tx < tiles_x; tx++)
+            {
+               size_t offset = (size_t)ty * TILE * width + tx * TILE;
+               unsigned w    = width  - tx * TILE;
+               unsigned h    = height - ty * TILE;
+               size += network_video_encode_tile(enc_codec,
+                     payload + size, frame + offset, prev + offset, width,
+                     w > TILE ? TILE : w, h > TILE ? TILE : h);
+            }
+
+         header.size      = (uint32_t)size;
+         header.width     = width;
+         header.height    = height;
+         header.tile_size = TILE;
+         header.flags     = n == 0 ? NETWORK_VIDEO_FRAME_KEY : 0;
+         total           += NETWORK_VIDEO_FRAME_HEADER_SIZE + size;
+
+         if (!decode_frame(&dec, &header, payload))
+         {
+            printf("%ux%u frame %u: malformed stream\n", width, height, n);
+            ret = 1;
+            break;
+         }
+
+         for (i = 0; i < pixels; i++)
+            if (dec.frame[i] != frame[i])
+               break;
+         if (i != pixels)
+         {
+            printf("%ux%u frame %u: mismatch at pixel %u\n",
+                  width, height, n, i);
+            ret = 1;
+            break;
+         }
+      }
+
+      printf("%4ux%-4u %u frames ok, %7u bytes/frame (raw %7u, %5.1f%%)\n",
+            width, height, n, (unsigned)(total / frames),
+            (unsigned)(pixels * 4),
+            100.0 * (double)total / frames / (double)(pixels * 4));
+
+      free(frame);
+      free(prev);
+      free(payload);
+   }
+
+   network_video_codec_free(enc_codec);
+   network_video_codec_free(dec.codec);
+   free(dec.frame);
+   return ret;
+}
+
+static int receive(uint16_t port, const char *out_path)
+{
+   int fd, client;
+   uint8_t header_buf[NETWORK_VIDEO_FRAME_HEADER_SIZE];
+   struct addrinfo *addr = NULL;
+   uint8_t *payload      = NULL;
+   size_t payload_size   = 0;
+   uint64_t total        = 0;
+   unsigned frames       = 0;
+   FILE *out             = NULL;
+   decoder_t dec;
+
+   memset(&dec, 0, sizeof(dec));
+
+   if ((fd = socket_init((void**)&addr, port, NULL,
+               SOCKET_TYPE_STREAM, AF_INET)) < 0)
+   {
+      perror("socket");
+      return 1;
+   }
+
+   if (!socket_bind(fd, addr) || listen(fd, 1) < 0)
+   {
+      perror("bind");
+      return 1;
+   }
+   freeaddrinfo_retro(addr);
+
+   printf("Waiting for RetroArch on port %hu...\n", (unsigned short)port);
+   if ((client = accept(fd, NULL, NULL)) < 0)
+   {
+      perror("accept");
+      return 1;
+   }
+   socket_close(fd);
+
+   if (     !socket_receive_all_blocking(client, header_buf,
+               NETWORK_VIDEO_STREAM_HEADER_SIZE)
+         || !network_video_read_stream_header(header_buf))
+   {
+      fprintf(stderr, "Not an encoded stream, build RetroArch with NETWORK_VIDEO_ENCODE=1.\n");
+      return 1;
+   }
+
+   if (out_path && !(out = fopen(out_path, "wb")))
+   {
+      perror(out_path);
+      return 1;
+   }
+
+   dec.codec = network_video_codec_new(false, 255);
+
+   for (;;)
+   {
+      network_video_frame_header_t header;
+
+      if (!socket_receive_all_blocking(client, header_buf, sizeof(header_buf)))
+         break;
+      if (!network_video_read_frame_header(header_buf, &header))
+      {
+         fprintf(stderr, "Bad frame header.\n");
+         break;
+      }
+
+      if (header.size > payload_size)
+      {
+         payload_size = header.size;
+         if (!(payload = (uint8_t*)realloc(payload, payload_size)))
+            break;
+      }
+
+      if (     !socket_receive_all_blocking(client, payload, header.size)
+            || !decode_frame(&dec, &header, payload))
+      {
+         fprintf(stderr, "Bad frame.\n");
+         break;
+      }
+
+      frames++;
+      total += sizeof(header_buf) + header.size;
+
+      /* Raw BGRA8888 frames, e.g. for ffmpeg -f rawvideo -pix_fmt bgra */
+      if (out)
+         fwrite(dec.frame, sizeof(uint32_t),
+               (size_t)dec.width * dec.height, out);
+
+      if (frames % 60 == 0)
+         printf("%ux%u: %u frames, %u bytes/frame (raw %u)\n",
+               dec.width, dec.height, frames, (unsigned)(total / frames),
+               dec.width * dec.height * 4);
+   }
+
+   printf("Disconnected after %u frames.\n", frames);
+
+   if (out)
+      fclose(out);
+   socket_close(client);
+   network_video_codec_free(dec.codec);
+   free(dec.frame);
+   free(payload);
+   return 0;
+}
+
+static void usage(void)
+{
+   fprintf(stderr,
+         "Usage: ranetvideo [options]\n"
+         "Options:\n"
+         "   -p|--port <port>:     Port to listen on (default 4953).\n"
+         "   -o|--output <file>:   Write decoded BGRA8888 frames to a file.\n"
+         "   -t|--test:            Encode and decode synthetic frames and check\n"
+         "                         they come back exactly.\n");
+}
+
+int main(int argc, char **argv)
+{
+   const char *out_path = NULL;
+   uint16_t port        = 4953;
+   int c;
+   const struct option opt[] = {
+      {"port",   1, NULL, 'p'},
+      {"output", 1, NULL, 'o'},
+      {"test",   0, NULL, 't'},
+      {"help",   0, NULL, 'h'},
+      {NULL, 0, NULL, 0}
+   };
+
+   while ((c = getopt_long(argc, argv, "p:o:th", opt, NULL)) != -1)
+   {
+      switch (c)
+      {
+         case 'p':
+            port = (uint16_t)atoi(optarg);
+            break;
+         case 'o':
+            out_path = optarg;
+            break;
+         case 't':
+            return self_test();
+         default:
+            usage();
+            return 1;
+      }
+   }
+
+   return receive(port, out_path);
+}